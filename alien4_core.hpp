@@ -0,0 +1,77 @@
+/*
+ * Alien4 shared core
+ * Header-only loop playback kernel used by both Alien4 engines:
+ * - alien4_extension.cpp (vav.audio.alien4)
+ * - related_projects/VAV_AudioEngine/src/alien4_engine.hpp
+ *
+ * Keep this free of pybind11 and engine state so either side can include it.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Helper functions
+template<typename T>
+inline T clamp(T value, T min, T max) {
+    return std::max(min, std::min(max, value));
+}
+
+// Loop samples are stored as float32 or as 16-bit fixed point over [-1, 1]
+inline float loadSample(float x) { return x; }
+inline float loadSample(int16_t x) { return static_cast<float>(x) * (1.0f / 32767.0f); }
+
+// ============================================================================
+// Slice structure
+// ============================================================================
+struct Slice {
+    int startSample = 0;
+    int endSample = 0;
+    float peakAmplitude = 0.0f;
+    bool active = false;
+};
+
+// ============================================================================
+// Loop playhead
+// ============================================================================
+// Advance a playhead by speed samples, loop it inside its slice (or the whole
+// recording when the slice is missing or inactive) and return the linearly
+// interpolated loop read. recordedLength must be > 0.
+template<typename Sample>
+inline float advanceLoopPlayhead(const Sample* buffer, int recordedLength,
+                                 const std::vector<Slice>& slices, int sliceIndex,
+                                 float speed, int& position, float& phase) {
+    phase += speed;
+    int positionDelta = static_cast<int>(phase);
+    phase -= static_cast<float>(positionDelta);
+    position += positionDelta;
+
+    bool isReverse = speed < 0.0f;
+    if (sliceIndex >= 0 && sliceIndex < static_cast<int>(slices.size()) &&
+        slices[sliceIndex].active) {
+        // Loop current slice
+        const Slice& slice = slices[sliceIndex];
+        if (isReverse) {
+            if (position < slice.startSample) position = slice.endSample;
+        } else {
+            if (position > slice.endSample) position = slice.startSample;
+        }
+    } else {
+        // No slices: loop entire buffer
+        if (isReverse) {
+            if (position < 0) position = recordedLength - 1;
+        } else {
+            if (position >= recordedLength) position = 0;
+        }
+    }
+
+    // Read with interpolation
+    position = clamp(position, 0, recordedLength - 1);
+    int pos1 = (position + 1 == recordedLength) ? 0 : position + 1;
+    float frac = clamp(std::abs(phase), 0.0f, 1.0f);
+
+    return loadSample(buffer[position]) * (1.0f - frac) + loadSample(buffer[pos1]) * frac;
+}
@@ -3,13 +3,18 @@
  * Complete port of VCV Rack Alien4 module using pybind11
  *
  * Features:
- * - Loop buffer recording (2880000 samples, 60s @ 48kHz)
+ * - Loop buffer recording (max_loop_seconds, 60s default; committed as it records)
+ * - Loop save/load (memory-mapped, playable while it pages in)
  * - Slice detection with dynamic threshold
  * - Polyphonic playback (1-8 voices)
  * - 3-band EQ (Low/Mid/High)
  * - Stereo delay with independent L/R times
  * - Reverb with comb/allpass filters
  * - Feedback routing
+ * - Control-rate chaos and modulation matrix (vision CV as sources)
+ * - Portable build: hot kernels dispatched at import (SSE4.2/AVX2/AVX-512)
+ * - CallbackChain: 4-channel input mixer and ENV/SEQ CV outputs around an engine
+ * - SharedRing: lock-free SPSC float32 record ring in shared memory (CV/scope/meter frames)
  */
 
 #include <pybind11/pybind11.h>
@@ -18,51 +23,345 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
-#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <utility>
 
+#include "alien4_core.hpp"
+
+// Build with -DALIEN4_NO_EVENT_LOG to compile the engine event log out entirely
+// Build with -DALIEN4_NO_STATS to compile the stage timing counters out entirely
+// Build with -DALIEN4_NO_SIMD to force the scalar fallback paths
+// Build with -DALIEN4_NO_FTZ to leave the caller's floating-point mode alone
+// Build with -DALIEN4_NO_DISPATCH to run the hot kernels for the build's ISA only
+#if !defined(ALIEN4_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define ALIEN4_SIMD_SSE2 1
+#elif !defined(ALIEN4_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define ALIEN4_SIMD_NEON 1
+#endif
+
+// Worker thread placement (EngineGroup)
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#endif
+
+// Loop files are memory-mapped and SharedRing lives in POSIX shared memory
+// where mmap()/shm_open() are available
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Flush-to-zero control (see ScopedFlushToZero)
+#if !defined(ALIEN4_NO_FTZ) && (defined(__x86_64__) || defined(_M_X64))
+#include <xmmintrin.h>
+#define ALIEN4_FTZ_SSE 1
+#elif !defined(ALIEN4_NO_FTZ) && defined(__aarch64__)
+#define ALIEN4_FTZ_ARM64 1
+#endif
+
+// Per-ISA kernel clones (see DspKernels): GCC/Clang on x86. The arm64
+// baseline already includes NEON, and MSVC has no per-function target
+#if !defined(ALIEN4_NO_DISPATCH) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define ALIEN4_DISPATCH_X86 1
+#endif
+
 namespace py = pybind11;
 
-// Helper functions
-template<typename T>
-inline T clamp(T value, T min, T max) {
-    return std::max(min, std::min(max, value));
+// ============================================================================
+// Denormal handling
+// ============================================================================
+// Feedback paths (reverb combs, the delay ring, biquad and one-pole states)
+// decay into subnormal floats as they fade out, and subnormal arithmetic is
+// many times slower on most CPUs. -ffast-math only enables flush-to-zero in
+// an executable's startup code, never in a Python extension, so
+// processBlock() puts the calling thread into FTZ/DAZ itself and restores
+// the caller's mode when it returns.
+//
+// The DSP does not rely on that mode alone (ALIEN4_NO_FTZ, other CPUs):
+// recirculating rings are fed ANTI_DENORMAL, a DC offset around -400 dBFS
+// they settle on instead of decaying, and filter states with no such input
+// are flushed once per block.
+constexpr float ANTI_DENORMAL = 1e-20f;
+
+// Far below audibility, far above the subnormal range (1.2e-38)
+inline float flushDenormal(float x) {
+    return std::abs(x) < 1e-15f ? 0.0f : x;
+}
+
+// std::isfinite() folds to true under -ffast-math (finite-math-only), so
+// guards against NaN/inf test the exponent bits instead
+inline bool isFiniteBits(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return (bits & 0x7f800000u) != 0x7f800000u;
+}
+
+// Padé tanh, clamped where it reaches +/-1 (error < 1e-4). libm tanhf costs
+// more than the whole engine per sample and keeps loops around it scalar
+// (CallbackChain's mixer, FEEDBACK).
+inline float softClip(float x) {
+    x = clamp(x, -4.97f, 4.97f);
+    const float x2 = x * x;
+    const float num = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
+    const float den = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
+    return clamp(num / den, -1.0f, 1.0f);
 }
 
+class ScopedFlushToZero {
+public:
+    // enabled = false clears FTZ/DAZ instead (benchmarks of the fallback)
+    explicit ScopedFlushToZero(bool enabled = true) {
+#if defined(ALIEN4_FTZ_SSE)
+        saved = _mm_getcsr();
+        const unsigned int mode = enabled ? (saved | FTZ_DAZ) : (saved & ~FTZ_DAZ);
+        if (mode != saved) _mm_setcsr(mode);
+#elif defined(ALIEN4_FTZ_ARM64)
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(saved));
+        const uint64_t mode = enabled ? (saved | FPCR_FZ) : (saved & ~FPCR_FZ);
+        if (mode != saved) __asm__ __volatile__("msr fpcr, %0" : : "r"(mode));
+#else
+        (void)enabled;
+#endif
+    }
+
+    ~ScopedFlushToZero() {
+#if defined(ALIEN4_FTZ_SSE)
+        if (_mm_getcsr() != saved) _mm_setcsr(saved);
+#elif defined(ALIEN4_FTZ_ARM64)
+        uint64_t mode;
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(mode));
+        if (mode != saved) __asm__ __volatile__("msr fpcr, %0" : : "r"(saved));
+#endif
+    }
+
+    ScopedFlushToZero(const ScopedFlushToZero&) = delete;
+    ScopedFlushToZero& operator=(const ScopedFlushToZero&) = delete;
+
+private:
+#if defined(ALIEN4_FTZ_SSE)
+    static constexpr unsigned int FTZ_DAZ = 0x8040;  // MXCSR bit 15 (FTZ) | bit 6 (DAZ)
+    unsigned int saved;
+#elif defined(ALIEN4_FTZ_ARM64)
+    static constexpr uint64_t FPCR_FZ = 1ull << 24;  // Flushes inputs and results
+    uint64_t saved;
+#endif
+};
+
 // ============================================================================
-// Slice structure
+// Float4 - 4-lane float vector (SSE2 / NEON, scalar fallback otherwise)
 // ============================================================================
-struct Slice {
-    int startSample = 0;
-    int endSample = 0;
-    float peakAmplitude = 0.0f;
-    bool active = false;
+struct Float4 {
+#if defined(ALIEN4_SIMD_SSE2)
+    __m128 v;
+
+    static Float4 load(const float* p) { return {_mm_load_ps(p)}; }
+    static Float4 broadcast(float x) { return {_mm_set1_ps(x)}; }
+    static Float4 set(float a, float b, float c, float d) { return {_mm_setr_ps(a, b, c, d)}; }
+    void store(float* p) const { _mm_store_ps(p, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+
+    float sum() const {
+        __m128 hi = _mm_movehl_ps(v, v);
+        __m128 pair = _mm_add_ps(v, hi);
+        return _mm_cvtss_f32(_mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 1)));
+    }
+#elif defined(ALIEN4_SIMD_NEON)
+    float32x4_t v;
+
+    static Float4 load(const float* p) { return {vld1q_f32(p)}; }
+    static Float4 broadcast(float x) { return {vdupq_n_f32(x)}; }
+    static Float4 set(float a, float b, float c, float d) {
+        const float lanes[4] = {a, b, c, d};
+        return {vld1q_f32(lanes)};
+    }
+    void store(float* p) const { vst1q_f32(p, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+
+    float sum() const {
+        float32x2_t pair = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpadd_f32(pair, pair), 0);
+    }
+#else
+    float v[4];
+
+    static Float4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    static Float4 broadcast(float x) { return {{x, x, x, x}}; }
+    static Float4 set(float a, float b, float c, float d) { return {{a, b, c, d}}; }
+    void store(float* p) const { for (int k = 0; k < 4; k++) p[k] = v[k]; }
+
+    friend Float4 operator+(Float4 a, Float4 b) {
+        return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+    }
+    friend Float4 operator-(Float4 a, Float4 b) {
+        return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+    }
+    friend Float4 operator*(Float4 a, Float4 b) {
+        return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+    }
+
+    float sum() const { return (v[0] + v[1]) + (v[2] + v[3]); }
+#endif
 };
 
 // ============================================================================
-// Voice structure for polyphonic playback
+// VoiceBank - Structure-of-arrays polyphonic playback voices
 // ============================================================================
-struct Voice {
-    int sliceIndex = 0;
-    int playbackPosition = 0;
-    float playbackPhase = 0.0f;
-    float speedMultiplier = 1.0f;
+// All MAX_VOICES lanes are stepped every sample with branch-free selects so
+// the loops vectorize; lanes beyond the active count have zero pan gain.
+// Slice bounds and pan gains are cached and only rebuilt when the slice
+// table, a voice's slice or the voice count changes.
+struct VoiceBank {
+    static constexpr int MAX_VOICES = 8;
+
+    alignas(16) int position[MAX_VOICES];
+    alignas(16) float phase[MAX_VOICES];
+    alignas(16) float speedMultiplier[MAX_VOICES];
+    alignas(16) int sliceStart[MAX_VOICES];  // Loop bounds (inclusive) of the voice's slice
+    alignas(16) int sliceEnd[MAX_VOICES];
+    alignas(16) float gainL[MAX_VOICES];     // Pan gain divided by the channel's RMS pan energy
+    alignas(16) float gainR[MAX_VOICES];
+    int sliceIndex[MAX_VOICES];
+
+    VoiceBank() {
+        for (int v = 0; v < MAX_VOICES; v++) {
+            reset(v, 0, 0, 1.0f);
+            sliceStart[v] = sliceEnd[v] = 0;
+        }
+        setVoiceCount(1);
+    }
+
+    void reset(int v, int slice, int pos, float speedMult) {
+        sliceIndex[v] = slice;
+        position[v] = pos;
+        phase[v] = 0.0f;
+        speedMultiplier[v] = speedMult;
+    }
+
+    // Precompute pan gains and normalization for count voices
+    void setVoiceCount(int count) {
+        // Fixed stereo pan distribution:
+        // Voice 0: Center, 1: 25%L, 2: 25%R, 3: 50%L, 4: 50%R, 5: 75%L, 6: 75%R, 7: 100%L
+        static const float PAN_L[MAX_VOICES] = {0.5f, 0.75f, 0.25f, 1.0f, 0.0f, 0.875f, 0.125f, 1.0f};
+        static const float PAN_R[MAX_VOICES] = {0.5f, 0.25f, 0.75f, 0.0f, 1.0f, 0.125f, 0.875f, 0.0f};
+
+        // Normalize by RMS energy per channel
+        float totalEnergyL = 0.0f;
+        float totalEnergyR = 0.0f;
+        for (int v = 0; v < count; v++) {
+            totalEnergyL += PAN_L[v] * PAN_L[v];
+            totalEnergyR += PAN_R[v] * PAN_R[v];
+        }
+        float normL = totalEnergyL > 0.0f ? 1.0f / std::sqrt(totalEnergyL) : 1.0f;
+        float normR = totalEnergyR > 0.0f ? 1.0f / std::sqrt(totalEnergyR) : 1.0f;
+
+        for (int v = 0; v < MAX_VOICES; v++) {
+            gainL[v] = v < count ? PAN_L[v] * normL : 0.0f;
+            gainR[v] = v < count ? PAN_R[v] * normR : 0.0f;
+        }
+    }
+
+    // Refresh cached loop bounds; voices without a valid slice loop the entire buffer
+    void updateBounds(const std::vector<Slice>& slices, int recordedLength) {
+        for (int v = 0; v < MAX_VOICES; v++) {
+            int s = sliceIndex[v];
+            if (!slices.empty() && s >= 0 && s < static_cast<int>(slices.size()) && slices[s].active) {
+                sliceStart[v] = slices[s].startSample;
+                sliceEnd[v] = slices[s].endSample;
+            } else {
+                sliceStart[v] = 0;
+                sliceEnd[v] = std::max(recordedLength - 1, 0);
+            }
+        }
+    }
+
+    // Advance every lane by one sample and mix the interpolated loop reads
+    template<typename Sample>
+    void render(const Sample* buffer, int recordedLength, float speed, float& outL, float& outR) {
+        alignas(16) int pos1[MAX_VOICES];
+        alignas(16) float frac[MAX_VOICES];
+
+        for (int v = 0; v < MAX_VOICES; v++) {
+            float voiceSpeed = clamp(speed * speedMultiplier[v], -16.0f, 16.0f);
+            float ph = phase[v] + voiceSpeed;
+            int positionDelta = static_cast<int>(ph);
+            ph -= static_cast<float>(positionDelta);
+            int pos = position[v] + positionDelta;
+
+            // Loop the voice's slice in the direction of travel
+            bool reverse = voiceSpeed < 0.0f;
+            pos = (reverse && pos < sliceStart[v]) ? sliceEnd[v] : pos;
+            pos = (!reverse && pos > sliceEnd[v]) ? sliceStart[v] : pos;
+            pos = clamp(pos, 0, recordedLength - 1);
+
+            position[v] = pos;
+            phase[v] = ph;
+            pos1[v] = (pos + 1 == recordedLength) ? 0 : pos + 1;
+            frac[v] = clamp(std::abs(ph), 0.0f, 1.0f);
+        }
+
+        float sumL = 0.0f;
+        float sumR = 0.0f;
+        for (int v = 0; v < MAX_VOICES; v++) {
+            float sample = loadSample(buffer[position[v]]) * (1.0f - frac[v]) +
+                           loadSample(buffer[pos1[v]]) * frac[v];
+            if (isFiniteBits(sample)) {
+                sumL += sample * gainL[v];
+                sumR += sample * gainR[v];
+            }
+        }
+        outL = sumL;
+        outR = sumR;
+    }
+
+    // render() over a block, one speed per sample
+    template<typename Sample>
+    void renderBlock(const Sample* buffer, int recordedLength, const float* speed,
+                     float* outL, float* outR, int n) {
+        for (int i = 0; i < n; i++) {
+            render(buffer, recordedLength, speed[i], outL[i], outR[i]);
+        }
+    }
 };
 
 // ============================================================================
 // Biquad filter for EQ (cut-only, 0 to -20dB)
 // ============================================================================
-class BiquadFilter {
-public:
+struct BiquadCoefficients {
     enum Type {
         LOWSHELF,
         PEAK,
         HIGHSHELF
     };
 
-    BiquadFilter() : b0(1.0f), b1(0.0f), b2(0.0f), a1(0.0f), a2(0.0f),
-                     z1(0.0f), z2(0.0f) {}
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
 
     void setParameters(Type type, float normalizedFreq, float Q, float gain) {
         float w0 = 2.0f * M_PI * normalizedFreq;
@@ -103,23 +402,114 @@ public:
         a1 /= a0;
         a2 /= a0;
     }
+};
 
-    float process(float input) {
-        float output = b0 * input + z1;
-        z1 = b1 * input - a1 * output + z2;
-        z2 = b2 * input - a2 * output;
-        return output;
+// ============================================================================
+// StereoEqCascade - 3 biquad bands in series, L/R run as 2 SIMD lanes
+// ============================================================================
+// Transposed direct form II. Both channels share each band's coefficients,
+// so lanes 0/1 carry L/R and lanes 2/3 are idle.
+class StereoEqCascade {
+public:
+    static constexpr int NUM_BANDS = 3;
+
+    StereoEqCascade() { reset(); }
+
+    void setBand(int band, BiquadCoefficients::Type type, float normalizedFreq, float Q, float gain) {
+        coeffs[band].setParameters(type, normalizedFreq, Q, gain);
+    }
+
+    void process(float* bufL, float* bufR, int n) {
+        Float4 b0[NUM_BANDS], b1[NUM_BANDS], b2[NUM_BANDS], a1[NUM_BANDS], a2[NUM_BANDS];
+        Float4 z1[NUM_BANDS], z2[NUM_BANDS];
+        for (int k = 0; k < NUM_BANDS; k++) {
+            b0[k] = Float4::broadcast(coeffs[k].b0);
+            b1[k] = Float4::broadcast(coeffs[k].b1);
+            b2[k] = Float4::broadcast(coeffs[k].b2);
+            a1[k] = Float4::broadcast(coeffs[k].a1);
+            a2[k] = Float4::broadcast(coeffs[k].a2);
+            z1[k] = Float4::load(state1[k]);
+            z2[k] = Float4::load(state2[k]);
+        }
+
+        alignas(16) float out[4];
+        for (int i = 0; i < n; i++) {
+            Float4 x = Float4::set(bufL[i], bufR[i], 0.0f, 0.0f);
+            for (int k = 0; k < NUM_BANDS; k++) {
+                Float4 y = b0[k] * x + z1[k];
+                z1[k] = b1[k] * x - a1[k] * y + z2[k];
+                z2[k] = b2[k] * x - a2[k] * y;
+                x = y;
+            }
+            x.store(out);
+            bufL[i] = out[0];
+            bufR[i] = out[1];
+        }
+
+        for (int k = 0; k < NUM_BANDS; k++) {
+            z1[k].store(state1[k]);
+            z2[k].store(state2[k]);
+        }
+        flushState();
+    }
+
+    // One stereo frame, for loops that cannot batch (FEEDBACK); call
+    // flushState() once after the run, as process() does per block
+    void processFrame(float& left, float& right) {
+        float l = left;
+        float r = right;
+        for (int k = 0; k < NUM_BANDS; k++) {
+            const BiquadCoefficients& c = coeffs[k];
+            float yl = c.b0 * l + state1[k][0];
+            float yr = c.b0 * r + state1[k][1];
+            state1[k][0] = c.b1 * l - c.a1 * yl + state2[k][0];
+            state1[k][1] = c.b1 * r - c.a1 * yr + state2[k][1];
+            state2[k][0] = c.b2 * l - c.a2 * yl;
+            state2[k][1] = c.b2 * r - c.a2 * yr;
+            l = yl;
+            r = yr;
+        }
+        left = l;
+        right = r;
+    }
+
+    void flushState() {
+        for (int k = 0; k < NUM_BANDS; k++) {
+            for (int lane = 0; lane < 2; lane++) {
+                state1[k][lane] = flushDenormal(state1[k][lane]);
+                state2[k][lane] = flushDenormal(state2[k][lane]);
+            }
+        }
     }
 
     void reset() {
-        z1 = z2 = 0.0f;
+        for (int k = 0; k < NUM_BANDS; k++) {
+            for (int lane = 0; lane < 4; lane++) {
+                state1[k][lane] = 0.0f;
+                state2[k][lane] = 0.0f;
+            }
+        }
+    }
+
+    // True once the filter memory has decayed below audibility
+    bool isSettled() const {
+        for (int k = 0; k < NUM_BANDS; k++) {
+            for (int lane = 0; lane < 2; lane++) {
+                if (std::abs(state1[k][lane]) > 1e-6f || std::abs(state2[k][lane]) > 1e-6f) {
+                    return false;
+                }
+            }
+        }
+        return true;
     }
 
 private:
-    float b0, b1, b2, a1, a2;
-    float z1, z2;
+    BiquadCoefficients coeffs[NUM_BANDS];
+    alignas(16) float state1[NUM_BANDS][4];
+    alignas(16) float state2[NUM_BANDS][4];
 };
 
+
 // ============================================================================
 // ChaosGenerator - Lorenz attractor chaos generator
 // ============================================================================
@@ -134,16 +524,27 @@ struct ChaosGenerator {
         z = 0.1f;
     }
 
-    float process(float rate) {
-        float dt = rate * 0.001f;
+    // Largest Euler step, the per-sample step at the top stepped-shape rate
+    static constexpr float MAX_STEP = 0.01f;
 
-        float dx = 7.5f * (y - x);
-        float dy = x * (30.9f - z) - y;
-        float dz = x * y - 1.02f * z;
+    float process(float rate) { return advance(rate, 1); }
 
-        x += dx * dt;
-        y += dy * dt;
-        z += dz * dt;
+    // Move the system on by `samples` samples' worth of time at once, in as
+    // few Euler steps as MAX_STEP allows (one per control tick at smooth rates)
+    float advance(float rate, int samples) {
+        const float total = rate * 0.001f * static_cast<float>(samples);
+        const int steps = std::max(1, static_cast<int>(std::ceil(total / MAX_STEP)));
+        const float dt = total / static_cast<float>(steps);
+
+        for (int i = 0; i < steps; i++) {
+            float dx = 7.5f * (y - x);
+            float dy = x * (30.9f - z) - y;
+            float dz = x * y - 1.02f * z;
+
+            x += dx * dt;
+            y += dy * dt;
+            z += dz * dt;
+        }
 
         // Prevent numerical explosion
         if (std::isnan(x) || std::isnan(y) || std::isnan(z) ||
@@ -155,30 +556,223 @@ struct ChaosGenerator {
     }
 };
 
+// ============================================================================
+// ModulationEngine - Control-rate chaos and modulation routing
+// ============================================================================
+// Chaos rates are sub-audio, so the Lorenz system, the stepped-shape sample
+// and hold and the routing matrix all run once per control tick (every
+// `interval` samples) instead of per sample. Between ticks each output lane
+// ramps linearly to its new value, reaching it at the next tick; the stepped
+// chaos lane jumps instead, like the hardware's sample and hold. With an
+// interval of 1 the output matches the old per-sample generator.
+//
+// Sources: the chaos signal plus six external CVs (VAV's vision CV: a
+// CallbackChain feeds ENV1-4/SEQ1-2 every block). Targets get the sum of
+// depth * source added in their own units: seconds for delay time, the 0-1
+// knob range for the others.
+struct ModulationEngine {
+    enum Source { SOURCE_CHAOS = 0, SOURCE_CV1, NUM_SOURCES = SOURCE_CV1 + 6 };
+    enum Target {
+        TARGET_DELAY_TIME = 0,
+        TARGET_DELAY_FEEDBACK,
+        TARGET_GRAIN_DENSITY,
+        TARGET_GRAIN_POSITION,
+        TARGET_REVERB_ROOM,
+        TARGET_REVERB_DECAY,
+        NUM_TARGETS
+    };
+    static constexpr int NUM_CV = NUM_SOURCES - SOURCE_CV1;
+    static constexpr int CHAOS_LANE = NUM_TARGETS;  // Lanes 0..NUM_TARGETS-1 are the targets
+    static constexpr int NUM_LANES = NUM_TARGETS + 1;
+    static constexpr int DEFAULT_INTERVAL = 32;
+    static constexpr int MAX_INTERVAL = 256;
+
+    static constexpr const char* SOURCE_NAMES[NUM_SOURCES] = {
+        "chaos", "cv1", "cv2", "cv3", "cv4", "cv5", "cv6"};
+    static constexpr const char* TARGET_NAMES[NUM_TARGETS] = {
+        "delay_time", "delay_feedback", "grain_density", "grain_position",
+        "reverb_room", "reverb_decay"};
+
+    // Everything a tick reads, gathered by the engine once per chunk
+    struct Inputs {
+        int interval;
+        float chaosRate;    // Already mapped to the shape's range
+        float chaosAmount;
+        bool chaosShape;    // Stepped
+        float sampleRate;
+        const float (*depth)[NUM_TARGETS];  // [NUM_SOURCES][NUM_TARGETS]
+        const float* cv;                    // NUM_CV values
+    };
+
+    ChaosGenerator chaos;
+    float stepValue = 0.0f;   // Stepped chaos sample-and-hold
+    float stepPhase = 0.0f;
+    int countdown = 0;        // Samples until the next tick
+    float value[NUM_LANES] = {};
+    float increment[NUM_LANES] = {};
+
+    void reset() {
+        chaos.reset();
+        stepValue = 0.0f;
+        stepPhase = 0.0f;
+        countdown = 0;
+        std::fill(value, value + NUM_LANES, 0.0f);
+        std::fill(increment, increment + NUM_LANES, 0.0f);
+    }
+
+    static int findSource(const std::string& name) { return findName(SOURCE_NAMES, NUM_SOURCES, name, "source"); }
+    static int findTarget(const std::string& name) { return findName(TARGET_NAMES, NUM_TARGETS, name, "target"); }
+
+    // Render n samples of the lanes in laneMask (bit = lane) into lanes[lane]
+    void render(float* const* lanes, uint32_t laneMask, int n, const Inputs& in) {
+        int done = 0;
+        while (done < n) {
+            if (countdown == 0) {
+                tick(in);
+                countdown = in.interval;
+            }
+            const int run = std::min(n - done, countdown);
+            for (uint32_t mask = laneMask; mask != 0; mask &= mask - 1) {
+                const int lane = lowestLane(mask);
+                float* out = lanes[lane] + done;
+                const float step = increment[lane];
+                const float start = value[lane];
+                for (int i = 0; i < run; i++) {
+                    out[i] = start + step * static_cast<float>(i + 1);
+                }
+            }
+            // Lanes outside the mask keep moving so they are right when routed
+            for (int lane = 0; lane < NUM_LANES; lane++) {
+                value[lane] += increment[lane] * static_cast<float>(run);
+            }
+            done += run;
+            countdown -= run;
+        }
+    }
+
+private:
+    void tick(const Inputs& in) {
+        float chaosValue = chaos.advance(in.chaosRate, in.interval) * in.chaosAmount;
+        if (in.chaosShape) {
+            stepPhase += in.chaosRate * 10.0f * static_cast<float>(in.interval) / in.sampleRate;
+            if (stepPhase >= 1.0f) {
+                stepValue = chaosValue;
+                stepPhase = 0.0f;
+            }
+            chaosValue = stepValue;
+        }
+
+        float source[NUM_SOURCES];
+        source[SOURCE_CHAOS] = chaosValue;
+        std::copy(in.cv, in.cv + NUM_CV, source + SOURCE_CV1);
+
+        const float steps = static_cast<float>(in.interval);
+        for (int t = 0; t < NUM_TARGETS; t++) {
+            float target = 0.0f;
+            for (int src = 0; src < NUM_SOURCES; src++) target += in.depth[src][t] * source[src];
+            increment[t] = (target - value[t]) / steps;
+        }
+        if (in.chaosShape) {
+            value[CHAOS_LANE] = chaosValue;
+            increment[CHAOS_LANE] = 0.0f;
+        } else {
+            increment[CHAOS_LANE] = (chaosValue - value[CHAOS_LANE]) / steps;
+        }
+    }
+
+    static int lowestLane(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(mask);
+#else
+        int i = 0;
+        while (!(mask & 1u)) {
+            mask >>= 1;
+            i++;
+        }
+        return i;
+#endif
+    }
+
+    static int findName(const char* const* names, int count, const std::string& name,
+                        const char* what) {
+        for (int i = 0; i < count; i++) {
+            if (name == names[i]) return i;
+        }
+        std::string known;
+        for (int i = 0; i < count; i++) known += std::string(i ? ", " : "") + names[i];
+        throw std::runtime_error("Unknown modulation " + std::string(what) + " '" + name +
+                                 "' (one of: " + known + ")");
+    }
+};
+
 // ============================================================================
 // GrainProcessor - Granular synthesis processor
 // ============================================================================
 struct GrainProcessor {
-    static constexpr int GRAIN_BUFFER_SIZE = 8192;
+    static constexpr int GRAIN_BUFFER_SIZE = 8192;  // Power of two
+    static constexpr int GRAIN_BUFFER_MASK = GRAIN_BUFFER_SIZE - 1;
     float grainBuffer[GRAIN_BUFFER_SIZE];
     int grainWriteIndex = 0;
 
     struct Grain {
-        bool active = false;
         float position = 0.0f;
-        float size = 0.0f;
-        float envelope = 0.0f;
+        int envelope = 0;        // Samples since the grain started
+        float invSize = 0.0f;    // 1 / grain length in samples
         float direction = 1.0f;
         float pitch = 1.0f;
     };
 
     static constexpr int MAX_GRAINS = 16;
     Grain grains[MAX_GRAINS];
+    uint32_t activeMask = 0;  // Bit i set = grains[i] is playing
+    int activeGrains = 0;
 
     float phase = 0.0f;
     std::default_random_engine randomEngine;
 
+    // Hann window 0.5 * (1 - cos(2*pi*x)) sampled over x in [0, 1], plus a guard point
+    static constexpr int ENVELOPE_TABLE_SIZE = 2048;
+
+    static const float* envelopeTable() {
+        static const std::vector<float> table = [] {
+            std::vector<float> t(ENVELOPE_TABLE_SIZE + 1);
+            for (int i = 0; i <= ENVELOPE_TABLE_SIZE; i++) {
+                t[i] = 0.5f * (1.0f - std::cos(2.0 * M_PI * i / ENVELOPE_TABLE_SIZE));
+            }
+            return t;
+        }();
+        return table.data();
+    }
+
+    // 1 / sqrt(n) output normalization for n active grains
+    static const float* normalizationTable() {
+        static const std::vector<float> table = [] {
+            std::vector<float> t(MAX_GRAINS + 1, 1.0f);
+            for (int n = 1; n <= MAX_GRAINS; n++) {
+                t[n] = 1.0f / std::sqrt(static_cast<float>(n));
+            }
+            return t;
+        }();
+        return table.data();
+    }
+
+    static int lowestBit(uint32_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(bits);
+#else
+        int i = 0;
+        while (!(bits & 1u)) {
+            bits >>= 1;
+            i++;
+        }
+        return i;
+#endif
+    }
+
     GrainProcessor() : randomEngine(std::random_device()()) {
+        // Build the shared tables here rather than on the first audio callback
+        envelopeTable();
+        normalizationTable();
         reset();
     }
 
@@ -188,9 +782,8 @@ struct GrainProcessor {
         }
         grainWriteIndex = 0;
 
-        for (int i = 0; i < MAX_GRAINS; i++) {
-            grains[i].active = false;
-        }
+        activeMask = 0;
+        activeGrains = 0;
         phase = 0.0f;
     }
 
@@ -198,7 +791,7 @@ struct GrainProcessor {
                   bool chaosEnabled, float chaosOutput, float sampleRate) {
 
         grainBuffer[grainWriteIndex] = input;
-        grainWriteIndex = (grainWriteIndex + 1) % GRAIN_BUFFER_SIZE;
+        grainWriteIndex = (grainWriteIndex + 1) & GRAIN_BUFFER_MASK;
 
         float grainSizeMs = grainSize * 99.0f + 1.0f;
         float grainSamples = (grainSizeMs / 1000.0f) * sampleRate;
@@ -215,88 +808,167 @@ struct GrainProcessor {
         if (phase >= 1.0f) {
             phase -= 1.0f;
 
-            for (int i = 0; i < MAX_GRAINS; i++) {
-                if (!grains[i].active) {
-                    grains[i].active = true;
-                    grains[i].size = grainSamples;
-                    grains[i].envelope = 0.0f;
-
-                    float pos = position;
-                    if (chaosEnabled) {
-                        pos += chaosOutput * 20.0f; // Enhanced shift 10x from 2.0f
-
-                        std::uniform_real_distribution<float> uniformDist(0.0f, 1.0f);
-                        if (uniformDist(randomEngine) < 0.3f) {
-                            grains[i].direction = -1.0f;
-                        } else {
-                            grains[i].direction = 1.0f;
-                        }
-
-                        if (densityValue > 0.7f && uniformDist(randomEngine) < 0.2f) {
-                            grains[i].pitch = uniformDist(randomEngine) < 0.5f ? 0.5f : 2.0f;
-                        } else {
-                            grains[i].pitch = 1.0f;
-                        }
+            uint32_t freeSlots = ~activeMask & ((1u << MAX_GRAINS) - 1);
+            if (freeSlots != 0) {
+                int i = lowestBit(freeSlots);
+                activeMask |= 1u << i;
+                activeGrains++;
+                grains[i].invSize = 1.0f / grainSamples;
+                grains[i].envelope = 0;
+
+                float pos = position;
+                if (chaosEnabled) {
+                    pos += chaosOutput * 20.0f; // Enhanced shift 10x from 2.0f
+
+                    std::uniform_real_distribution<float> uniformDist(0.0f, 1.0f);
+                    if (uniformDist(randomEngine) < 0.3f) {
+                        grains[i].direction = -1.0f;
                     } else {
                         grains[i].direction = 1.0f;
-                        grains[i].pitch = 1.0f;
                     }
 
-                    pos = clamp(pos, 0.0f, 1.0f);
-                    grains[i].position = pos * GRAIN_BUFFER_SIZE;
-                    break;
+                    if (densityValue > 0.7f && uniformDist(randomEngine) < 0.2f) {
+                        grains[i].pitch = uniformDist(randomEngine) < 0.5f ? 0.5f : 2.0f;
+                    } else {
+                        grains[i].pitch = 1.0f;
+                    }
+                } else {
+                    grains[i].direction = 1.0f;
+                    grains[i].pitch = 1.0f;
                 }
+
+                pos = clamp(pos, 0.0f, 1.0f);
+                grains[i].position = pos * GRAIN_BUFFER_SIZE;
             }
         }
 
+        const float* envTable = envelopeTable();
         float output = 0.0f;
-        int activeGrains = 0;
 
-        for (int i = 0; i < MAX_GRAINS; i++) {
-            if (grains[i].active) {
-                float envPhase = grains[i].envelope / grains[i].size;
+        for (uint32_t bits = activeMask; bits != 0; bits &= bits - 1) {
+            int i = lowestBit(bits);
+            Grain& g = grains[i];
 
-                if (envPhase >= 1.0f) {
-                    grains[i].active = false;
-                    continue;
-                }
+            float envPhase = static_cast<float>(g.envelope) * g.invSize;
+            if (envPhase >= 1.0f) {
+                activeMask &= ~(1u << i);
+                activeGrains--;
+                continue;
+            }
 
-                float env = 0.5f * (1.0f - std::cos(envPhase * 2.0f * M_PI));
+            // Linear interpolation in the envelope table
+            float tablePos = envPhase * ENVELOPE_TABLE_SIZE;
+            int tableIndex = static_cast<int>(tablePos);
+            float frac = tablePos - static_cast<float>(tableIndex);
+            float env = envTable[tableIndex] + (envTable[tableIndex + 1] - envTable[tableIndex]) * frac;
+
+            // Position is kept in [0, GRAIN_BUFFER_SIZE]; the mask folds the upper edge to 0
+            int readPos = static_cast<int>(g.position) & GRAIN_BUFFER_MASK;
+            output += grainBuffer[readPos] * env;
+
+            // Step is at most 2 samples, so one wrap per direction is enough
+            g.position += g.direction * g.pitch;
+            if (g.position >= GRAIN_BUFFER_SIZE) {
+                g.position -= GRAIN_BUFFER_SIZE;
+            } else if (g.position < 0.0f) {
+                g.position += GRAIN_BUFFER_SIZE;
+            }
 
-                int readPos = static_cast<int>(grains[i].position);
-                // Ensure readPos is always valid
-                readPos = ((readPos % GRAIN_BUFFER_SIZE) + GRAIN_BUFFER_SIZE) % GRAIN_BUFFER_SIZE;
+            g.envelope++;
+        }
 
-                float sample = grainBuffer[readPos];
-                output += sample * env;
+        return output * normalizationTable()[activeGrains];
+    }
 
-                // Update position with proper boundary handling
-                grains[i].position += grains[i].direction * grains[i].pitch;
+    // process() over a block: density and position plus per-sample offsets,
+    // chaos scaled by chaosScale (the right channel runs it inverted)
+    void processBlock(const float* input, float* output, int n, float grainSize,
+                      float density, const float* densityMod, float position,
+                      const float* positionMod, bool chaosEnabled, const float* chaosIn,
+                      float chaosScale, float sampleRate) {
+        for (int i = 0; i < n; i++) {
+            output[i] = process(input[i], grainSize, density + densityMod[i],
+                                position + positionMod[i], chaosEnabled,
+                                chaosIn[i] * chaosScale, sampleRate);
+        }
+    }
+};
 
-                // Handle position wrapping to prevent accumulated floating point errors
-                while (grains[i].position >= GRAIN_BUFFER_SIZE) {
-                    grains[i].position -= GRAIN_BUFFER_SIZE;
-                }
-                while (grains[i].position < 0) {
-                    grains[i].position += GRAIN_BUFFER_SIZE;
-                }
+// ============================================================================
+// CombBank - Eight parallel Freeverb combs (4 per channel) as 4-lane vectors
+// ============================================================================
+// Structure-of-arrays layout: all eight delay lines share one interleaved ring
+// (ring[position * 8 + lane], lanes 0-3 left, 4-7 right) and one write
+// position, each lane reading back its own delay length. A stereo sample is
+// eight lane reads, two vector lowpass updates and two vector stores into
+// the same cache line.
+struct CombBank {
+    static constexpr int LANES = 8;
+    static constexpr int RING_SIZE = 2048;  // Power of two >= longest comb
+    static constexpr int RING_MASK = RING_SIZE - 1;
+
+    alignas(16) float ring[RING_SIZE * LANES];
+    alignas(16) float lp[LANES];  // Lowpass filters in comb feedback loops
+    int delays[LANES];
+    int writePos = 0;
+
+    explicit CombBank(const int (&combDelays)[LANES]) {
+        std::copy(std::begin(combDelays), std::end(combDelays), delays);
+        reset();
+    }
 
-                grains[i].envelope += 1.0f;
-                activeGrains++;
-            }
-        }
+    void reset() {
+        std::fill(std::begin(ring), std::end(ring), 0.0f);
+        std::fill(std::begin(lp), std::end(lp), 0.0f);
+        writePos = 0;
+    }
 
-        if (activeGrains > 0) {
-            output /= std::sqrt(activeGrains);
+    // Feeds inputL to lanes 0-3 and inputR to lanes 4-7, returns each
+    // channel's summed comb output
+    void process(float inputL, float inputR, float feedback, float damping,
+                 float& outL, float& outR) {
+        alignas(16) float delayed[LANES];
+        for (int k = 0; k < LANES; k++) {
+            delayed[k] = ring[((writePos - delays[k]) & RING_MASK) * LANES + k];
         }
 
-        return output;
+        Float4 dampingV = Float4::broadcast(damping);
+        Float4 feedbackV = Float4::broadcast(feedback);
+        float* frame = &ring[writePos * LANES];
+
+        Float4 outputL = Float4::load(delayed);
+        Float4 outputR = Float4::load(delayed + 4);
+        Float4 stateL = Float4::load(lp);
+        Float4 stateR = Float4::load(lp + 4);
+
+        // Apply lowpass filter to feedback signal
+        stateL = stateL + (outputL - stateL) * dampingV;
+        stateR = stateR + (outputR - stateR) * dampingV;
+        stateL.store(lp);
+        stateR.store(lp + 4);
+
+        // Write input + filtered feedback; the offset keeps the loop (and
+        // the allpasses and highpass after it) out of the subnormal range
+        (Float4::broadcast(inputL + ANTI_DENORMAL) + stateL * feedbackV).store(frame);
+        (Float4::broadcast(inputR + ANTI_DENORMAL) + stateR * feedbackV).store(frame + 4);
+        writePos = (writePos + 1) & RING_MASK;
+
+        outL = outputL.sum();
+        outR = outputR.sum();
+    }
+
+    // Read lane's line `offset` samples behind the latest write (0 = latest)
+    float tap(int lane, int offset) const {
+        return ring[((writePos - 1 - offset) & RING_MASK) * LANES + lane];
     }
 };
 
 // ============================================================================
 // ReverbProcessor - Full Ellen Ripley version with 8 comb filters
 // ============================================================================
+// True stereo: both channels run in one pass over a block, sharing one
+// parameter derivation, with all comb, allpass and highpass state stored
+// interleaved L/R.
 struct ReverbProcessor {
     // Freeverb-style parallel comb filters + series allpass
     static constexpr int COMB_1_SIZE = 1557;  // ~32ms at 48kHz
@@ -308,165 +980,123 @@ struct ReverbProcessor {
     static constexpr int COMB_7_SIZE = 1188;  // ~25ms (for stereo)
     static constexpr int COMB_8_SIZE = 1116;  // ~23ms (for stereo)
 
-    float combBuffer1[COMB_1_SIZE];
-    float combBuffer2[COMB_2_SIZE];
-    float combBuffer3[COMB_3_SIZE];
-    float combBuffer4[COMB_4_SIZE];
-    float combBuffer5[COMB_5_SIZE];
-    float combBuffer6[COMB_6_SIZE];
-    float combBuffer7[COMB_7_SIZE];
-    float combBuffer8[COMB_8_SIZE];
-
-    int combIndex1 = 0, combIndex2 = 0, combIndex3 = 0, combIndex4 = 0;
-    int combIndex5 = 0, combIndex6 = 0, combIndex7 = 0, combIndex8 = 0;
-
-    // Lowpass filters in comb feedback loops
-    float combLp1 = 0.0f, combLp2 = 0.0f, combLp3 = 0.0f, combLp4 = 0.0f;
-    float combLp5 = 0.0f, combLp6 = 0.0f, combLp7 = 0.0f, combLp8 = 0.0f;
-
-    // Highpass filter for reverb output (to remove sub-100Hz)
-    float hpState = 0.0f;
-
-    // Series allpass filters for diffusion
-    static constexpr int ALLPASS_1_SIZE = 556;
-    static constexpr int ALLPASS_2_SIZE = 441;
-    static constexpr int ALLPASS_3_SIZE = 341;
-    static constexpr int ALLPASS_4_SIZE = 225;
-
-    float allpassBuffer1[ALLPASS_1_SIZE];
-    float allpassBuffer2[ALLPASS_2_SIZE];
-    float allpassBuffer3[ALLPASS_3_SIZE];
-    float allpassBuffer4[ALLPASS_4_SIZE];
-
-    int allpassIndex1 = 0, allpassIndex2 = 0, allpassIndex3 = 0, allpassIndex4 = 0;
-
-    ReverbProcessor() { reset(); }
+    // Combs 1-4 (left character) in lanes 0-3, 5-8 (right character) in 4-7
+    static constexpr int COMB_SIZES[CombBank::LANES] = {
+        COMB_1_SIZE, COMB_2_SIZE, COMB_3_SIZE, COMB_4_SIZE,
+        COMB_5_SIZE, COMB_6_SIZE, COMB_7_SIZE, COMB_8_SIZE
+    };
+    CombBank combs{COMB_SIZES};
 
-    void reset() {
-        for (int i = 0; i < COMB_1_SIZE; i++) combBuffer1[i] = 0.0f;
-        for (int i = 0; i < COMB_2_SIZE; i++) combBuffer2[i] = 0.0f;
-        for (int i = 0; i < COMB_3_SIZE; i++) combBuffer3[i] = 0.0f;
-        for (int i = 0; i < COMB_4_SIZE; i++) combBuffer4[i] = 0.0f;
-        for (int i = 0; i < COMB_5_SIZE; i++) combBuffer5[i] = 0.0f;
-        for (int i = 0; i < COMB_6_SIZE; i++) combBuffer6[i] = 0.0f;
-        for (int i = 0; i < COMB_7_SIZE; i++) combBuffer7[i] = 0.0f;
-        for (int i = 0; i < COMB_8_SIZE; i++) combBuffer8[i] = 0.0f;
+    // Highpass filters for reverb output (to remove sub-100Hz), L/R
+    float hpState[2] = {0.0f, 0.0f};
 
-        for (int i = 0; i < ALLPASS_1_SIZE; i++) allpassBuffer1[i] = 0.0f;
-        for (int i = 0; i < ALLPASS_2_SIZE; i++) allpassBuffer2[i] = 0.0f;
-        for (int i = 0; i < ALLPASS_3_SIZE; i++) allpassBuffer3[i] = 0.0f;
-        for (int i = 0; i < ALLPASS_4_SIZE; i++) allpassBuffer4[i] = 0.0f;
+    // Series allpass filters for diffusion, buffers interleaved L/R
+    static constexpr int NUM_ALLPASS = 4;
+    static constexpr int ALLPASS_SIZES[NUM_ALLPASS] = {556, 441, 341, 225};
+    static constexpr int ALLPASS_TOTAL = 556 + 441 + 341 + 225;
 
-        combIndex1 = combIndex2 = combIndex3 = combIndex4 = 0;
-        combIndex5 = combIndex6 = combIndex7 = combIndex8 = 0;
-        allpassIndex1 = allpassIndex2 = allpassIndex3 = allpassIndex4 = 0;
+    float allpassBuffer[ALLPASS_TOTAL * 2];
+    float* allpassLines[NUM_ALLPASS];
+    int allpassIndex[NUM_ALLPASS];
 
-        combLp1 = combLp2 = combLp3 = combLp4 = 0.0f;
-        combLp5 = combLp6 = combLp7 = combLp8 = 0.0f;
-        hpState = 0.0f;
+    ReverbProcessor() {
+        float* line = allpassBuffer;
+        for (int k = 0; k < NUM_ALLPASS; k++) {
+            allpassLines[k] = line;
+            line += ALLPASS_SIZES[k] * 2;
+        }
+        reset();
     }
 
-    float processComb(float input, float* buffer, int size, int& index, float feedback, float& lp, float damping) {
-        float output = buffer[index];
-
-        // Apply lowpass filter to feedback signal
-        lp = lp + (output - lp) * damping;
-
-        // Write input + filtered feedback
-        buffer[index] = input + lp * feedback;
-        index = (index + 1) % size;
+    // Copies would leave allpassLines pointing into the source object
+    ReverbProcessor(const ReverbProcessor&) = delete;
+    ReverbProcessor& operator=(const ReverbProcessor&) = delete;
 
-        return output;
+    void reset() {
+        combs.reset();
+        std::fill(std::begin(allpassBuffer), std::end(allpassBuffer), 0.0f);
+        std::fill(std::begin(allpassIndex), std::end(allpassIndex), 0);
+        hpState[0] = hpState[1] = 0.0f;
     }
 
-    float processAllpass(float input, float* buffer, int size, int& index, float gain) {
-        float delayed = buffer[index];
-        float output = -input * gain + delayed;
-        buffer[index] = input + delayed * gain;
-        index = (index + 1) % size;
-        return output;
+    // Processes one allpass stage for both channels in place
+    void processAllpass(int stage, float (&x)[2], float gain) {
+        float* frame = allpassLines[stage] + allpassIndex[stage] * 2;
+        for (int ch = 0; ch < 2; ch++) {
+            float delayed = frame[ch];
+            float output = -x[ch] * gain + delayed;
+            frame[ch] = x[ch] + delayed * gain;
+            x[ch] = output;
+        }
+        if (++allpassIndex[stage] == ALLPASS_SIZES[stage]) {
+            allpassIndex[stage] = 0;
+        }
     }
 
-    float process(float inputL, float inputR, float grainDensity,
-                  float roomSize, float damping, float decay, bool isLeftChannel,
-                  bool chaosEnabled, float chaosOutput, float sampleRate) {
-
-        // Use proper stereo input instead of mixing to mono
-        float input = isLeftChannel ? inputL : inputR;
+    // Writes the wet reverb signal for a block of stereo input
+    void process(const float* inputL, const float* inputR, float* outputL, float* outputR,
+                 const float* chaosIn, int numSamples, float roomSize, float damping,
+                 float decay, bool chaosEnabled, float sampleRate) {
 
         // Calculate feedback based on decay - much wider range for 10+ second tails
-        float feedback = 0.5f + decay * 0.485f; // 0.5 to 0.985 (near infinite at max)
-        if (chaosEnabled) {
-            feedback += chaosOutput * 0.5f; // Enhanced chaos effect 10x from 0.05f
-            feedback = clamp(feedback, 0.0f, 0.995f);
-        }
+        const float baseFeedback = 0.5f + decay * 0.485f; // 0.5 to 0.985 (near infinite at max)
 
         // Damping: low value = more damping (darker), high value = less damping (brighter)
-        float dampingCoeff = 0.05f + damping * 0.9f;
+        const float dampingCoeff = 0.05f + damping * 0.9f;
 
         // Room size affects delay buffer read positions dramatically
-        float roomScale = 0.3f + roomSize * 1.4f; // 0.3 to 1.7 scaling
+        const float roomScale = 0.3f + roomSize * 1.4f; // 0.3 to 1.7 scaling
 
-        float combOut = 0.0f;
+        // Highpass to remove frequencies below ~100Hz
+        // Cutoff frequency calculation for 100Hz at 48kHz: fc = 100/(48000/2) = 0.00416
+        float hpCutoff = 100.0f / (sampleRate * 0.5f); // Normalized frequency
+        hpCutoff = clamp(hpCutoff, 0.001f, 0.1f); // Safety clamp
 
-        if (isLeftChannel) {
-            // Room size creates variable delay taps for room simulation
-            // Ensure room offsets are always positive
-            int roomOffset1 = std::max(0, static_cast<int>(roomSize * 400 + chaosOutput * 50)); // 0-450 samples
-            int roomOffset2 = std::max(0, static_cast<int>(roomSize * 350 + chaosOutput * 40));
+        for (int i = 0; i < numSamples; i++) {
+            float chaosOutput = chaosIn[i];
 
-            // Use room-modulated delay reads with safe modulo operation
-            int readIdx1 = ((combIndex1 - roomOffset1) % COMB_1_SIZE + COMB_1_SIZE) % COMB_1_SIZE;
-            int readIdx2 = ((combIndex2 - roomOffset2) % COMB_2_SIZE + COMB_2_SIZE) % COMB_2_SIZE;
+            float feedback = baseFeedback;
+            if (chaosEnabled) {
+                feedback += chaosOutput * 0.5f; // Enhanced chaos effect 10x from 0.05f
+                feedback = clamp(feedback, 0.0f, 0.995f);
+            }
 
-            float roomInput = input * roomScale;
-            combOut += processComb(roomInput, combBuffer1, COMB_1_SIZE, combIndex1, feedback, combLp1, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer2, COMB_2_SIZE, combIndex2, feedback, combLp2, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer3, COMB_3_SIZE, combIndex3, feedback, combLp3, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer4, COMB_4_SIZE, combIndex4, feedback, combLp4, dampingCoeff);
+            float x[2];
+            combs.process(inputL[i] * roomScale, inputR[i] * roomScale,
+                          feedback, dampingCoeff, x[0], x[1]);
 
-            // Add room reflections
-            combOut += combBuffer1[readIdx1] * roomSize * 0.15f;
-            combOut += combBuffer2[readIdx2] * roomSize * 0.12f;
-        } else {
-            // Right channel: different room characteristics
+            // Room size creates variable delay taps for room simulation, with
+            // different characteristics per channel
             // Ensure room offsets are always positive
+            int roomOffset1 = std::max(0, static_cast<int>(roomSize * 400 + chaosOutput * 50)); // 0-450 samples
+            int roomOffset2 = std::max(0, static_cast<int>(roomSize * 350 + chaosOutput * 40));
             int roomOffset5 = std::max(0, static_cast<int>(roomSize * 380 + chaosOutput * 45));
             int roomOffset6 = std::max(0, static_cast<int>(roomSize * 420 + chaosOutput * 55));
 
-            // Use safe modulo operation
-            int readIdx5 = ((combIndex5 - roomOffset5) % COMB_5_SIZE + COMB_5_SIZE) % COMB_5_SIZE;
-            int readIdx6 = ((combIndex6 - roomOffset6) % COMB_6_SIZE + COMB_6_SIZE) % COMB_6_SIZE;
-
-            float roomInput = input * roomScale;
-            combOut += processComb(roomInput, combBuffer5, COMB_5_SIZE, combIndex5, feedback, combLp5, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer6, COMB_6_SIZE, combIndex6, feedback, combLp6, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer7, COMB_7_SIZE, combIndex7, feedback, combLp7, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer8, COMB_8_SIZE, combIndex8, feedback, combLp8, dampingCoeff);
-
             // Add room reflections
-            combOut += combBuffer5[readIdx5] * roomSize * 0.13f;
-            combOut += combBuffer6[readIdx6] * roomSize * 0.11f;
-        }
-
-        // Scale comb output
-        combOut *= 0.25f;
-
-        // Series allpass diffusion
-        float diffused = combOut;
-        diffused = processAllpass(diffused, allpassBuffer1, ALLPASS_1_SIZE, allpassIndex1, 0.5f);
-        diffused = processAllpass(diffused, allpassBuffer2, ALLPASS_2_SIZE, allpassIndex2, 0.5f);
-        diffused = processAllpass(diffused, allpassBuffer3, ALLPASS_3_SIZE, allpassIndex3, 0.5f);
-        diffused = processAllpass(diffused, allpassBuffer4, ALLPASS_4_SIZE, allpassIndex4, 0.5f);
+            x[0] += combs.tap(0, roomOffset1) * roomSize * 0.15f;
+            x[0] += combs.tap(1, roomOffset2) * roomSize * 0.12f;
+            x[1] += combs.tap(4, roomOffset5) * roomSize * 0.13f;
+            x[1] += combs.tap(5, roomOffset6) * roomSize * 0.11f;
+
+            // Scale comb output
+            x[0] *= 0.25f;
+            x[1] *= 0.25f;
+
+            // Series allpass diffusion
+            for (int k = 0; k < NUM_ALLPASS; k++) {
+                processAllpass(k, x, 0.5f);
+            }
 
-        // Apply highpass filter to remove frequencies below ~100Hz
-        // Cutoff frequency calculation for 100Hz at 48kHz: fc = 100/(48000/2) = 0.00416
-        float hpCutoff = 100.0f / (sampleRate * 0.5f); // Normalized frequency
-        hpCutoff = clamp(hpCutoff, 0.001f, 0.1f); // Safety clamp
-        hpState += (diffused - hpState) * hpCutoff;
-        float hpOutput = diffused - hpState;
+            // Apply highpass filter
+            for (int ch = 0; ch < 2; ch++) {
+                hpState[ch] += (x[ch] - hpState[ch]) * hpCutoff;
+                x[ch] -= hpState[ch];
+            }
 
-        return hpOutput;
+            outputL[i] = x[0];
+            outputR[i] = x[1];
+        }
     }
 };
 
@@ -475,996 +1105,4770 @@ struct ReverbProcessor {
 // ============================================================================
 class DelayProcessor {
 public:
-    static constexpr int DELAY_BUFFER_SIZE = 96000;
+    // Power of two holding 2 s at 48 kHz; L/R are interleaved in one ring
+    static constexpr int DELAY_BUFFER_SIZE = 131072;
+    static constexpr int DELAY_BUFFER_MASK = DELAY_BUFFER_SIZE - 1;
+    static constexpr float MAX_DELAY_SAMPLES = static_cast<float>(DELAY_BUFFER_SIZE - 2);
 
-    DelayProcessor() {
-        leftBuffer.resize(DELAY_BUFFER_SIZE, 0.0f);
-        rightBuffer.resize(DELAY_BUFFER_SIZE, 0.0f);
-        leftWriteIndex = 0;
-        rightWriteIndex = 0;
-    }
+    DelayProcessor() : ring(DELAY_BUFFER_SIZE * 2, 0.0f) {}
 
     void reset() {
-        std::fill(leftBuffer.begin(), leftBuffer.end(), 0.0f);
-        std::fill(rightBuffer.begin(), rightBuffer.end(), 0.0f);
-        leftWriteIndex = 0;
-        rightWriteIndex = 0;
+        std::fill(ring.begin(), ring.end(), 0.0f);
+        writeIndex = 0;
     }
 
-    std::pair<float, float> process(float inputL, float inputR, float delayTimeL,
-                                     float delayTimeR, float feedback, float sampleRate) {
-        // Left channel
-        int delaySamplesL = static_cast<int>(delayTimeL * sampleRate);
-        delaySamplesL = clamp(delaySamplesL, 1, DELAY_BUFFER_SIZE - 1);
-
-        int readIndexL = (leftWriteIndex - delaySamplesL + DELAY_BUFFER_SIZE) % DELAY_BUFFER_SIZE;
-        float delayedSignalL = leftBuffer[readIndexL];
-
-        leftBuffer[leftWriteIndex] = inputL + delayedSignalL * feedback;
-        leftWriteIndex = (leftWriteIndex + 1) % DELAY_BUFFER_SIZE;
+    // General path: per-sample delay times (in samples) and feedback, read
+    // with linear interpolation so modulated times glide instead of stepping
+    void process(const float* inL, const float* inR, float* outL, float* outR, int n,
+                 const float* delayL, const float* delayR, const float* feedback) {
+        float* buf = ring.data();
+        for (int i = 0; i < n; i++) {
+            float delayedL = read(buf, 0, clampDelay(delayL[i]));
+            float delayedR = read(buf, 1, clampDelay(delayR[i]));
+            write(buf, inL[i] + delayedL * feedback[i], inR[i] + delayedR * feedback[i]);
+            outL[i] = delayedL;
+            outR[i] = delayedR;
+        }
+    }
 
-        // Right channel
-        int delaySamplesR = static_cast<int>(delayTimeR * sampleRate);
-        delaySamplesR = clamp(delaySamplesR, 1, DELAY_BUFFER_SIZE - 1);
+    // Fast path: delay times and feedback are constant over the block, so the
+    // tap offsets and interpolation weights are computed once
+    void processFixed(const float* inL, const float* inR, float* outL, float* outR, int n,
+                      float delayL, float delayR, float feedback) {
+        delayL = clampDelay(delayL);
+        delayR = clampDelay(delayR);
+        const int intL = static_cast<int>(delayL);
+        const int intR = static_cast<int>(delayR);
+        const float fracL = delayL - static_cast<float>(intL);
+        const float fracR = delayR - static_cast<float>(intR);
+
+        float* buf = ring.data();
+        for (int i = 0; i < n; i++) {
+            float delayedL = buf[((writeIndex - intL) & DELAY_BUFFER_MASK) * 2] * (1.0f - fracL) +
+                             buf[((writeIndex - intL - 1) & DELAY_BUFFER_MASK) * 2] * fracL;
+            float delayedR = buf[((writeIndex - intR) & DELAY_BUFFER_MASK) * 2 + 1] * (1.0f - fracR) +
+                             buf[((writeIndex - intR - 1) & DELAY_BUFFER_MASK) * 2 + 1] * fracR;
+            write(buf, inL[i] + delayedL * feedback, inR[i] + delayedR * feedback);
+            outL[i] = delayedL;
+            outR[i] = delayedR;
+        }
+    }
 
-        int readIndexR = (rightWriteIndex - delaySamplesR + DELAY_BUFFER_SIZE) % DELAY_BUFFER_SIZE;
-        float delayedSignalR = rightBuffer[readIndexR];
+private:
+    static float clampDelay(float samples) {
+        return clamp(samples, 1.0f, MAX_DELAY_SAMPLES);
+    }
 
-        rightBuffer[rightWriteIndex] = inputR + delayedSignalR * feedback;
-        rightWriteIndex = (rightWriteIndex + 1) % DELAY_BUFFER_SIZE;
+    float read(const float* buf, int channel, float delay) const {
+        int whole = static_cast<int>(delay);
+        float frac = delay - static_cast<float>(whole);
+        float a = buf[((writeIndex - whole) & DELAY_BUFFER_MASK) * 2 + channel];
+        float b = buf[((writeIndex - whole - 1) & DELAY_BUFFER_MASK) * 2 + channel];
+        return a + (b - a) * frac;
+    }
 
-        return std::make_pair(delayedSignalL, delayedSignalR);
+    // The offset keeps the recirculating ring out of the subnormal range
+    void write(float* buf, float left, float right) {
+        buf[writeIndex * 2] = left + ANTI_DENORMAL;
+        buf[writeIndex * 2 + 1] = right + ANTI_DENORMAL;
+        writeIndex = (writeIndex + 1) & DELAY_BUFFER_MASK;
     }
 
-private:
-    std::vector<float> leftBuffer;
-    std::vector<float> rightBuffer;
-    int leftWriteIndex;
-    int rightWriteIndex;
+    std::vector<float> ring;  // Interleaved L/R
+    int writeIndex = 0;
 };
 
 // ============================================================================
-// Main AudioEngine class
+// DspKernels - Hot kernels built per ISA level, picked once at import
 // ============================================================================
-class AudioEngine {
-public:
-    static constexpr int LOOP_BUFFER_SIZE = 2880000; // 60 seconds at 48kHz
+// The module is built for the baseline ISA (x86-64 SSE2, arm64 NEON) so one
+// binary runs everywhere. On x86 the EQ, reverb, grain and voice loops are
+// compiled again for SSE4.2, AVX2+FMA and AVX-512: each clone is a wrapper
+// with a target attribute and `flatten`, which inlines the whole kernel body
+// into it, so the compiler vectorizes it for that ISA. dspKernels() picks
+// the best level the CPU and OS support; ALIEN4_CPU (baseline, sse4.2,
+// avx2, avx512) caps it, for comparing levels on one machine. An unknown
+// value is reported on stderr and ignored.
+enum class CpuLevel { BASELINE, SSE42, AVX2, AVX512, NUM_LEVELS };
+
+inline const char* cpuLevelName(CpuLevel level) {
+    static constexpr const char* NAMES[] = {
+#if defined(__aarch64__) || defined(_M_ARM64)
+        "neon",
+#else
+        "baseline",
+#endif
+        "sse4.2", "avx2", "avx512"};
+    return NAMES[static_cast<int>(level)];
+}
 
-    AudioEngine(double sample_rate)
-        : sampleRate(sample_rate),
-          loopBuffer(LOOP_BUFFER_SIZE, 0.0f),
-          tempBuffer(LOOP_BUFFER_SIZE, 0.0f),
-          randomEngine(std::random_device()())
-    {
-        // Initialize default parameters
-        isRecording = false;
-        isLooping = true;
+struct DspKernels {
+    CpuLevel level;
+    void (*eq)(StereoEqCascade& eq, float* bufL, float* bufR, int n);
+    void (*reverb)(ReverbProcessor& reverb, const float* inL, const float* inR,
+                   float* outL, float* outR, const float* chaosIn, int n, float roomSize,
+                   float damping, float decay, bool chaosEnabled, float sampleRate);
+    void (*grain)(GrainProcessor& grain, const float* input, float* output, int n,
+                  float grainSize, float density, const float* densityMod, float position,
+                  const float* positionMod, bool chaosEnabled, const float* chaosIn,
+                  float chaosScale, float sampleRate);
+    void (*voicesF32)(VoiceBank& voices, const float* buffer, int recordedLength,
+                      const float* speed, float* outL, float* outR, int n);
+    void (*voicesI16)(VoiceBank& voices, const int16_t* buffer, int recordedLength,
+                      const float* speed, float* outL, float* outR, int n);
+};
 
-        scanValue = 0.0f;
-        gateThresholdKnob = 0.2f; // Default 0.2 → ~0.008 threshold - good for medium audio
-        mixValue = 0.0f;
-        feedbackValue = 0.0f;
-        speedValue = 1.0f;
+#if defined(__GNUC__) || defined(__clang__)
+#define ALIEN4_KERNEL_BASELINE __attribute__((flatten))
+#else
+#define ALIEN4_KERNEL_BASELINE
+#endif
+
+// One set of wrappers per level; Attributes selects the ISA they compile for
+#define ALIEN4_DEFINE_KERNELS(Namespace, Level, Attributes)                                      \
+    namespace Namespace {                                                                      \
+    Attributes inline void eq(StereoEqCascade& eq, float* bufL, float* bufR, int n) {            \
+        eq.process(bufL, bufR, n);                                                             \
+    }                                                                                          \
+    Attributes inline void reverb(ReverbProcessor& reverb, const float* inL, const float* inR,   \
+                                  float* outL, float* outR, const float* chaosIn, int n,       \
+                                  float roomSize, float damping, float decay,                  \
+                                  bool chaosEnabled, float sampleRate) {                       \
+        reverb.process(inL, inR, outL, outR, chaosIn, n, roomSize, damping, decay,             \
+                       chaosEnabled, sampleRate);                                              \
+    }                                                                                          \
+    Attributes inline void grain(GrainProcessor& grain, const float* input, float* output,       \
+                                 int n, float grainSize, float density,                        \
+                                 const float* densityMod, float position,                      \
+                                 const float* positionMod, bool chaosEnabled,                  \
+                                 const float* chaosIn, float chaosScale, float sampleRate) {   \
+        grain.processBlock(input, output, n, grainSize, density, densityMod, position,         \
+                           positionMod, chaosEnabled, chaosIn, chaosScale, sampleRate);        \
+    }                                                                                          \
+    Attributes inline void voicesF32(VoiceBank& voices, const float* buffer,                     \
+                                     int recordedLength, const float* speed, float* outL,      \
+                                     float* outR, int n) {                                     \
+        voices.renderBlock(buffer, recordedLength, speed, outL, outR, n);                      \
+    }                                                                                          \
+    Attributes inline void voicesI16(VoiceBank& voices, const int16_t* buffer,                   \
+                                     int recordedLength, const float* speed, float* outL,      \
+                                     float* outR, int n) {                                     \
+        voices.renderBlock(buffer, recordedLength, speed, outL, outR, n);                      \
+    }                                                                                          \
+    inline constexpr DspKernels kernels = {Level, eq, reverb, grain, voicesF32, voicesI16};    \
+    }
 
-        delayTimeL = 0.25f;
-        delayTimeR = 0.25f;
-        delayFeedback = 0.3f;
-        delayWet = 0.0f;
+ALIEN4_DEFINE_KERNELS(kernels_baseline, CpuLevel::BASELINE, ALIEN4_KERNEL_BASELINE)
+#ifdef ALIEN4_DISPATCH_X86
+ALIEN4_DEFINE_KERNELS(kernels_sse42, CpuLevel::SSE42,
+                      __attribute__((target("sse4.2,popcnt"), flatten)))
+ALIEN4_DEFINE_KERNELS(kernels_avx2, CpuLevel::AVX2,
+                      __attribute__((target("avx2,fma"), flatten)))
+ALIEN4_DEFINE_KERNELS(kernels_avx512, CpuLevel::AVX512,
+                      __attribute__((target("avx512f,avx512vl,avx512bw,avx512dq,avx2,fma"), flatten)))
+#endif
+#undef ALIEN4_DEFINE_KERNELS
+
+// Whether this CPU (and OS, for the AVX register state) can run a level
+inline bool cpuSupports(CpuLevel level) {
+#ifdef ALIEN4_DISPATCH_X86
+    __builtin_cpu_init();
+    switch (level) {
+        case CpuLevel::BASELINE: return true;
+        case CpuLevel::SSE42: return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+        case CpuLevel::AVX2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case CpuLevel::AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+                   __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq") &&
+                   cpuSupports(CpuLevel::AVX2);
+        default: return false;
+    }
+#else
+    return level == CpuLevel::BASELINE;
+#endif
+}
 
-        reverbRoom = 1.0f;
-        reverbDamping = 1.0f;
-        reverbDecay = 0.6f;
-        reverbWet = 0.0f;
+inline const DspKernels& kernelsFor(CpuLevel level) {
+    switch (level) {
+#ifdef ALIEN4_DISPATCH_X86
+        case CpuLevel::AVX512: return kernels_avx512::kernels;
+        case CpuLevel::AVX2: return kernels_avx2::kernels;
+        case CpuLevel::SSE42: return kernels_sse42::kernels;
+#endif
+        default: return kernels_baseline::kernels;
+    }
+}
 
-        numVoices = 1;
-        voices.resize(1);
+// Highest supported level, at most ALIEN4_CPU
+inline CpuLevel selectCpuLevel() {
+    int cap = static_cast<int>(CpuLevel::NUM_LEVELS) - 1;
+    const char* env = std::getenv("ALIEN4_CPU");
+    if (env != nullptr && *env != '\0') {
+        int requested = -1;
+        for (int i = 0; i < static_cast<int>(CpuLevel::NUM_LEVELS); i++) {
+            if (std::strcmp(env, cpuLevelName(static_cast<CpuLevel>(i))) == 0) requested = i;
+        }
+        if (requested >= 0) {
+            cap = requested;
+        } else {
+            // Runs at import: warn instead of failing it, a typo should not cost the module
+            std::fprintf(stderr, "alien4: ignoring unknown ALIEN4_CPU=%s (expected %s, %s, %s or %s)\n", env,
+                         cpuLevelName(CpuLevel::BASELINE), cpuLevelName(CpuLevel::SSE42),
+                         cpuLevelName(CpuLevel::AVX2), cpuLevelName(CpuLevel::AVX512));
+        }
+    }
+    for (int i = cap; i > 0; i--) {
+        if (cpuSupports(static_cast<CpuLevel>(i))) return static_cast<CpuLevel>(i);
+    }
+    return CpuLevel::BASELINE;
+}
 
-        playbackPosition = 0;
-        playbackPhase = 0.0f;
-        recordedLength = 0;
-        currentSliceIndex = 0;
-        lastAmplitude = 0.0f;
-        lastScanTargetIndex = -1;
-        lastScanValue = -1.0f;
+// The kernels in use; decided on first call (module import), then fixed
+inline const DspKernels& dspKernels() {
+    static const DspKernels& selected = kernelsFor(selectCpuLevel());
+    return selected;
+}
+
+// ============================================================================
+// LinearRamp - Per-sample linear parameter ramp
+// ============================================================================
+// Ramps run over a fixed time, so smoothing no longer depends on buffer size
+struct LinearRamp {
+    float value = 0.0f;
+    float target = 0.0f;
+    float step = 0.0f;
+    int remaining = 0;
+
+    void reset(float v) {
+        value = target = v;
+        step = 0.0f;
+        remaining = 0;
+    }
+
+    // Ramp from the current value to newTarget over rampSamples
+    void setTarget(float newTarget, int rampSamples) {
+        if (newTarget == target) return;
+        target = newTarget;
+        if (rampSamples <= 0) {
+            value = target;
+            remaining = 0;
+            return;
+        }
+        step = (target - value) / static_cast<float>(rampSamples);
+        remaining = rampSamples;
+    }
+
+    float next() {
+        if (remaining > 0) {
+            value += step;
+            if (--remaining == 0) value = target;
+        }
+        return value;
+    }
+
+    // Advance n samples at once, for parameters consumed once per chunk
+    float advance(int n) {
+        if (remaining > 0) {
+            if (n >= remaining) {
+                value = target;
+                remaining = 0;
+            } else {
+                value += step * static_cast<float>(n);
+                remaining -= n;
+            }
+        }
+        return value;
+    }
+
+    bool isRamping() const { return remaining > 0; }
+
+    // At rest on exactly zero, so gated stages can bypass
+    bool isSilent() const { return remaining == 0 && value == 0.0f; }
+};
+
+// ============================================================================
+// EngineParams - Complete control state, published as one snapshot
+// ============================================================================
+struct EngineParams {
+    // Recording / looper
+    bool recording = false;
+    bool looping = true;
+    unsigned clearCount = 0;     // Bumped by clear(), applied when it changes
+    int polyVoices = 1;
+    float scan = 0.0f;
+    float gateThreshold = 0.2f;  // Default 0.2 → ~0.008 threshold - good for medium audio
+    float mix = 0.0f;
+    float feedback = 0.0f;
+    float speed = 1.0f;
+
+    // EQ (cut-only: 0 to -20dB)
+    float eqLowDb = 0.0f;
+    float eqMidDb = 0.0f;
+    float eqHighDb = 0.0f;
+
+    // Delay
+    float delayTimeL = 0.25f;
+    float delayTimeR = 0.25f;
+    float delayFeedback = 0.3f;
+    float delayWet = 0.0f;
+
+    // Reverb
+    float reverbRoom = 1.0f;
+    float reverbDamping = 1.0f;
+    float reverbDecay = 0.6f;
+    float reverbWet = 0.0f;
+
+    // Chaos
+    float chaosRate = 0.01f;
+    float chaosAmount = 1.0f;
+    bool chaosShape = false;  // false = smooth (0.01-1.0), true = stepped (1.0-10.0)
+    bool delayChaos = false;
+    bool reverbChaos = false;
+
+    // Grain
+    float grainSize = 0.3f;     // 0.0-1.0
+    float grainDensity = 0.4f;  // Break parameter
+    float grainWetDry = 0.0f;   // Dry/Wet mix
+
+    // Modulation: samples per control tick and the routing matrix
+    int controlInterval = ModulationEngine::DEFAULT_INTERVAL;
+    float modDepth[ModulationEngine::NUM_SOURCES][ModulationEngine::NUM_TARGETS] = {};
+};
+
+// ============================================================================
+// TripleBuffer - Lock-free single-producer/single-consumer snapshot mailbox
+// ============================================================================
+// The producer fills its private back slot and swaps it with the shared
+// middle slot; the consumer swaps a freshly published middle slot into its
+// private front slot. Neither side ever blocks, and the consumer always sees
+// one complete snapshot.
+template<typename T>
+class TripleBuffer {
+public:
+    // Before either side runs, e.g. to reserve capacity in every slot
+    template<typename Function>
+    void initSlots(Function init) {
+        for (T& slot : slots) init(slot);
+    }
+
+    // Producer side
+    void publish(const T& value) {
+        back() = value;
+        publishBack();
+    }
+
+    // Producer side, in place: fill back(), then publishBack()
+    T& back() { return slots[backIndex]; }
+    void publishBack() {
+        int previous = middle.exchange(backIndex | NEW_DATA, std::memory_order_acq_rel);
+        backIndex = previous & INDEX_MASK;
+    }
+
+    // Consumer side: returns true (and updates front()) if a new value arrived
+    bool consume() {
+        if (!(middle.load(std::memory_order_relaxed) & NEW_DATA)) return false;
+        int previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& front() const { return slots[frontIndex]; }
+    T& front() { return slots[frontIndex]; }  // Consumer may move data out of its slot
+
+private:
+    static constexpr int INDEX_MASK = 0x3;
+    static constexpr int NEW_DATA = 0x4;
+
+    T slots[3];
+    std::atomic<int> middle{1};
+    int backIndex = 0;   // Owned by the producer
+    int frontIndex = 2;  // Owned by the consumer
+};
+
+// ============================================================================
+// EventRing - Real-time-safe event log
+// ============================================================================
+// Fixed-size records pushed by the audio thread without locking or
+// allocating, drained (and only then formatted) from a control thread.
+enum class EngineEventType : uint32_t {
+    RECORDING_STOPPED,  // a = length (samples)
+    SLICES_REQUESTED,   // x = slice length (s), y = scan
+    SLICES_READY,       // a = slice count, b = scan offset (samples), x = slice length (s), y = scan
+    POLY_CHANGED,       // a = old voices, b = new voices, i.e. old -> new
+    LOOP_LOADED,        // a = length (samples), b = slice count
+};
+
+struct EngineEvent {
+    int64_t frame;      // Engine sample clock at the start of the block
+    EngineEventType type;
+    int32_t a;
+    int32_t b;
+    float x;
+    float y;
+};
+
+class EventRing {
+public:
+    static constexpr uint32_t CAPACITY = 256;  // Power of two
+
+    // Producer (audio thread): drops the event if the ring is full
+    bool push(const EngineEvent& event) {
+        uint32_t head = writeIndex.load(std::memory_order_relaxed);
+        uint32_t tail = readIndex.load(std::memory_order_acquire);
+        if (head - tail >= CAPACITY) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        events[head & (CAPACITY - 1)] = event;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer (control thread)
+    bool pop(EngineEvent& event) {
+        uint32_t tail = readIndex.load(std::memory_order_relaxed);
+        if (tail == writeIndex.load(std::memory_order_acquire)) return false;
+        event = events[tail & (CAPACITY - 1)];
+        readIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: number of events lost to overflow since the last call
+    uint32_t takeDropped() {
+        return dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    EngineEvent events[CAPACITY];
+    std::atomic<uint32_t> writeIndex{0};
+    std::atomic<uint32_t> readIndex{0};
+    std::atomic<uint32_t> dropped{0};
+};
+
+// ============================================================================
+// EngineStats - Hot-path timing counters (audio thread -> get_stats())
+// ============================================================================
+// Counters only ever grow and have a single writer, so the audio thread
+// updates them with a relaxed load + store (no read-modify-write) and other
+// threads read them without tearing. reset_stats() works on the reader side
+// by remembering a baseline snapshot.
+enum StatStage : int {
+    STAGE_LOOPER,
+    STAGE_EQ,
+    STAGE_CHAOS,
+    STAGE_DELAY,
+    STAGE_GRAIN,
+    STAGE_REVERB,
+    NUM_STAT_STAGES
+};
+
+struct EngineStats {
+    // Call durations: bucket 0 is < 1 us, bucket k is [2^(k-1), 2^k) us,
+    // and the last bucket is open-ended (>= 16.4 ms)
+    static constexpr int HISTOGRAM_BUCKETS = 16;
+
+    struct Snapshot {
+        uint64_t calls = 0;
+        uint64_t frames = 0;
+        uint64_t totalNs = 0;
+        uint64_t deadlineMisses = 0;
+        uint64_t stageFrames = 0;  // Frames covered by stageNs
+        uint64_t stageNs[NUM_STAT_STAGES] = {};
+        uint64_t histogram[HISTOGRAM_BUCKETS] = {};
+    };
+
+    EngineStats() {
+        for (auto& c : stageNs) c.store(0, std::memory_order_relaxed);
+        for (auto& c : histogram) c.store(0, std::memory_order_relaxed);
+    }
+
+    void addStage(int stage, uint64_t ns) { add(stageNs[stage], ns); }
+    void addStageFrames(uint64_t n) { add(stageFrames, n); }
+
+    void recordCall(uint64_t ns, uint64_t numFrames, uint64_t deadlineNs) {
+        add(calls, 1);
+        add(frames, numFrames);
+        add(totalNs, ns);
+        add(histogram[bucketFor(ns)], 1);
+        if (ns > deadlineNs) add(deadlineMisses, 1);
+    }
+
+    Snapshot snapshot() const {
+        Snapshot snap;
+        snap.calls = calls.load(std::memory_order_relaxed);
+        snap.frames = frames.load(std::memory_order_relaxed);
+        snap.totalNs = totalNs.load(std::memory_order_relaxed);
+        snap.deadlineMisses = deadlineMisses.load(std::memory_order_relaxed);
+        snap.stageFrames = stageFrames.load(std::memory_order_relaxed);
+        for (int i = 0; i < NUM_STAT_STAGES; i++) {
+            snap.stageNs[i] = stageNs[i].load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+            snap.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+        }
+        return snap;
+    }
+
+    static int bucketFor(uint64_t ns) {
+        uint64_t us = ns / 1000;
+        int bucket = 0;
+        while (us != 0 && bucket < HISTOGRAM_BUCKETS - 1) {
+            us >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    static const char* stageName(int stage) {
+        static const char* const NAMES[NUM_STAT_STAGES] = {
+            "looper", "eq", "chaos", "delay", "grain", "reverb"};
+        return NAMES[stage];
+    }
+
+private:
+    static void add(std::atomic<uint64_t>& counter, uint64_t delta) {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> deadlineMisses{0};
+    std::atomic<uint64_t> stageFrames{0};
+    std::atomic<uint64_t> stageNs[NUM_STAT_STAGES];
+    std::atomic<uint64_t> histogram[HISTOGRAM_BUCKETS];
+};
+
+// ============================================================================
+// LoopBuffer - Lazily committed loop storage (float32 or 16-bit)
+// ============================================================================
+// calloc() hands buffers this large to the OS as untouched zero pages, so an
+// engine costs neither startup time nor resident memory until it records,
+// and only the recorded part of a take is ever committed. INT16 halves the
+// memory and the playback cache traffic; it keeps [-1, 1] at 16-bit
+// resolution and clips anything louder.
+enum class LoopFormat { FLOAT32, INT16 };
+
+inline LoopFormat parseLoopFormat(const std::string& name) {
+    if (name == "float32") return LoopFormat::FLOAT32;
+    if (name == "int16") return LoopFormat::INT16;
+    throw std::runtime_error("loop_format must be 'float32' or 'int16'");
+}
+
+// Read-only reference to loop storage, handed to the scanner and peak index
+struct LoopView {
+    const void* data = nullptr;
+    LoopFormat format = LoopFormat::FLOAT32;
+
+    template<typename Sample>
+    const Sample* samples() const { return static_cast<const Sample*>(data); }
+};
+
+class LoopBuffer {
+public:
+    LoopBuffer(int capacity, LoopFormat format)
+        : storage(std::calloc(static_cast<size_t>(std::max(capacity, 1)), sampleBytes(format))),
+          capacitySamples(capacity), loopFormat(format) {
+        if (storage == nullptr) {
+            throw std::runtime_error("Failed to allocate loop buffer");
+        }
+    }
+
+    ~LoopBuffer() { std::free(storage); }
+
+    LoopBuffer(const LoopBuffer&) = delete;
+    LoopBuffer& operator=(const LoopBuffer&) = delete;
+
+    void swap(LoopBuffer& other) noexcept {
+        std::swap(storage, other.storage);
+        std::swap(capacitySamples, other.capacitySamples);
+        std::swap(loopFormat, other.loopFormat);
+        std::swap(attached, other.attached);
+    }
+
+    // Play back from samples owned elsewhere (a loaded loop file) instead of
+    // the own storage until detach(); write() always targets the own storage
+    void attach(const LoopView& external) { attached = external; }
+    void detach() { attached = LoopView{}; }
+
+    // Store input[0, count) at [start, start + count)
+    void write(int start, const float* input, int count) {
+        if (loopFormat == LoopFormat::INT16) {
+            int16_t* out = static_cast<int16_t*>(storage) + start;
+            for (int i = 0; i < count; i++) {
+                float x = clamp(input[i], -1.0f, 1.0f) * 32767.0f;
+                out[i] = static_cast<int16_t>(x + (x >= 0.0f ? 0.5f : -0.5f));
+            }
+        } else {
+            std::copy(input, input + count, static_cast<float*>(storage) + start);
+        }
+    }
+
+    template<typename Sample>
+    const Sample* samples() const { return static_cast<const Sample*>(data()); }
+
+    LoopView view() const { return attached.data ? attached : LoopView{storage, loopFormat}; }
+    const void* data() const { return attached.data ? attached.data : storage; }
+    const void* storageData() const { return storage; }  // What write() writes to
+    int capacity() const { return capacitySamples; }
+    LoopFormat format() const { return attached.data ? attached.format : loopFormat; }
+
+    static size_t sampleBytes(LoopFormat format) {
+        return format == LoopFormat::INT16 ? sizeof(int16_t) : sizeof(float);
+    }
+
+private:
+    void* storage;
+    int capacitySamples;
+    LoopFormat loopFormat;
+    LoopView attached;  // data == nullptr unless attach()ed
+};
+
+// ============================================================================
+// PeakPyramid - Min/max mip-map over a loop buffer
+// ============================================================================
+// Level 0 holds the min/max of each BLOCK_SIZE-sample block; every level
+// above halves the resolution. It is appended to while recording, so a range
+// peak query costs O(BLOCK_SIZE + log(length)) instead of a full scan.
+//
+// Entries are relaxed atomics: get_waveform_overview() reads the pyramid of
+// the take being recorded while the audio thread appends to it. On x86-64
+// and arm64 they compile to plain 8-byte loads and stores.
+class PeakPyramid {
+public:
+    static constexpr int BLOCK_SHIFT = 5;
+    static constexpr int BLOCK_SIZE = 1 << BLOCK_SHIFT;  // 32 samples
+
+    struct MinMax {
+        float min;
+        float max;
+    };
+
+    explicit PeakPyramid(int capacity) {
+        int blocks = (capacity + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        while (blocks > 0) {
+            levels.emplace_back(new Entry[static_cast<size_t>(blocks)]());
+            if (blocks == 1) break;
+            blocks = (blocks + 1) / 2;
+        }
+    }
+
+    // Forget the previous take; entries are overwritten as samples arrive
+    void reset() { length = 0; }
+
+    // Extend the pyramid with loop[start, start + count), where start == length
+    void append(const LoopView& loop, int start, int count) {
+        if (loop.format == LoopFormat::INT16) {
+            appendSamples(loop.samples<int16_t>(), start, count);
+        } else {
+            appendSamples(loop.samples<float>(), start, count);
+        }
+    }
+
+    // Min/max of loop[start, end] (inclusive); the range must lie within length
+    MinMax query(const LoopView& loop, int start, int end) const {
+        return loop.format == LoopFormat::INT16 ? querySamples(loop.samples<int16_t>(), start, end)
+                                                : querySamples(loop.samples<float>(), start, end);
+    }
+
+    float peak(const LoopView& loop, int start, int end) const {
+        MinMax m = query(loop, start, end);
+        return std::max(-m.min, m.max);
+    }
+
+    // Min/max of [0, samples) split into width equal columns, from the
+    // entries alone (column edges round to blocks), so it never touches the
+    // samples and may run while samples past the first blockCount(samples)
+    // blocks are appended. Narrow columns repeat the block they fall in.
+    void overview(int samples, int width, float* outMin, float* outMax) const {
+        const int numBlocks = blockCount(samples);
+        for (int c = 0; c < width; c++) {
+            if (numBlocks <= 0) {
+                outMin[c] = outMax[c] = 0.0f;
+                continue;
+            }
+            const int lo = static_cast<int>(static_cast<int64_t>(c) * numBlocks / width);
+            const int hi = static_cast<int>(static_cast<int64_t>(c + 1) * numBlocks / width);
+            MinMax m = levels[0][lo].load(std::memory_order_relaxed);
+            addBlocks(m, lo + 1, std::max(hi, lo + 1));
+            outMin[c] = m.min;
+            outMax[c] = m.max;
+        }
+    }
+
+    int size() const { return length; }
+
+    // Level-0 entries covering [0, size()); enough to restore() the whole pyramid
+    static int blockCount(int samples) { return (samples + BLOCK_SIZE - 1) >> BLOCK_SHIFT; }
+    void copyBlocks(MinMax* out, int count) const {
+        for (int i = 0; i < count; i++) out[i] = levels[0][i].load(std::memory_order_relaxed);
+    }
+
+    // Take over saved level-0 entries for samples [0, count); count must fit the capacity
+    void restore(const MinMax* saved, int count) {
+        length = count;
+        if (count <= 0) return;
+        const int numBlocks = blockCount(count);
+        for (int i = 0; i < numBlocks; i++) levels[0][i].store(saved[i], std::memory_order_relaxed);
+        rebuildParents(0, numBlocks - 1);
+    }
+
+private:
+    using Entry = std::atomic<MinMax>;
+
+    static MinMax merge(MinMax a, MinMax b) {
+        return MinMax{std::min(a.min, b.min), std::max(a.max, b.max)};
+    }
+
+    template<typename Sample>
+    void appendSamples(const Sample* data, int start, int count) {
+        if (count <= 0) return;
+        const int end = start + count;
+
+        // Level 0: one store per block touched; the first sample of a block
+        // initializes its entry, a block started earlier is extended
+        Entry* base = levels[0].get();
+        for (int i = start; i < end;) {
+            const int block = i >> BLOCK_SHIFT;
+            const int blockEnd = std::min(end, (block + 1) << BLOCK_SHIFT);
+            MinMax m;
+            if ((i & (BLOCK_SIZE - 1)) == 0) {
+                m.min = m.max = loadSample(data[i]);
+            } else {
+                m = base[block].load(std::memory_order_relaxed);
+            }
+            for (; i < blockEnd; i++) {
+                float x = loadSample(data[i]);
+                m.min = std::min(m.min, x);
+                m.max = std::max(m.max, x);
+            }
+            base[block].store(m, std::memory_order_relaxed);
+        }
+        length = end;
+        rebuildParents(start >> BLOCK_SHIFT, (end - 1) >> BLOCK_SHIFT);
+    }
+
+    // Upper levels: rebuild parents of level-0 entries [first, last] from their written children
+    void rebuildParents(int first, int last) {
+        int written = last + 1;  // Entries in use at the current level
+        for (size_t level = 1; level < levels.size(); level++) {
+            const Entry* children = levels[level - 1].get();
+            Entry* parents = levels[level].get();
+            first >>= 1;
+            last >>= 1;
+            for (int p = first; p <= last; p++) {
+                MinMax m = children[2 * p].load(std::memory_order_relaxed);
+                if (2 * p + 1 < written) {
+                    m = merge(m, children[2 * p + 1].load(std::memory_order_relaxed));
+                }
+                parents[p].store(m, std::memory_order_relaxed);
+            }
+            written = (written + 1) / 2;
+        }
+    }
+
+    // Merge level-0 entries [lo, hi) into acc: bottom-up segment walk over the levels
+    void addBlocks(MinMax& acc, int lo, int hi) const {
+        for (size_t level = 0; lo < hi; level++) {
+            const Entry* entries = levels[level].get();
+            if (lo & 1) acc = merge(acc, entries[lo++].load(std::memory_order_relaxed));
+            if (hi & 1) acc = merge(acc, entries[--hi].load(std::memory_order_relaxed));
+            lo >>= 1;
+            hi >>= 1;
+        }
+    }
+
+    template<typename Sample>
+    MinMax querySamples(const Sample* data, int start, int end) const {
+        MinMax acc{loadSample(data[start]), loadSample(data[start])};
+        auto addSamples = [&](int from, int to) {
+            for (int i = from; i < to; i++) {
+                float x = loadSample(data[i]);
+                acc.min = std::min(acc.min, x);
+                acc.max = std::max(acc.max, x);
+            }
+        };
+
+        // Whole blocks in [lo, hi); partial blocks at either edge are read directly
+        int lo = (start + BLOCK_SIZE - 1) >> BLOCK_SHIFT;
+        int hi = (end + 1) >> BLOCK_SHIFT;
+        if (lo >= hi) {
+            addSamples(start, end + 1);
+            return acc;
+        }
+        addSamples(start, lo << BLOCK_SHIFT);
+        addSamples(hi << BLOCK_SHIFT, end + 1);
+        addBlocks(acc, lo, hi);
+        return acc;
+    }
+
+    std::vector<std::unique_ptr<Entry[]>> levels;
+    int length = 0;  // Samples covered
+};
+
+// ============================================================================
+// LoopFile - Saved loops (save_loop / load_loop)
+// ============================================================================
+// A loop file is a fixed header, the slice table, PeakPyramid level 0 and the
+// raw samples in their loop format, starting on a page boundary. Loading maps
+// the file and plays the samples in place: a full-length loop is playable at
+// once and the OS faults its pages in as the playheads reach them. Fields are
+// native-endian, so files only move between machines of the same byte order.
+struct LoopFileHeader {
+    static constexpr char MAGIC[8] = {'A', 'L', 'I', 'E', 'N', '4', 'L', 'P'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint64_t AUDIO_ALIGNMENT = 4096;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t format;              // LoopFormat
+    double sampleRate;
+    int32_t recordedLength;       // Samples
+    int32_t numSlices;
+    int32_t numPeakBlocks;        // PeakPyramid level-0 entries
+    int32_t currentSliceIndex;
+    int32_t playbackPosition;
+    float playbackPhase;
+    int32_t voiceSlice[VoiceBank::MAX_VOICES];
+    int32_t voicePosition[VoiceBank::MAX_VOICES];
+    float voicePhase[VoiceBank::MAX_VOICES];
+    float voiceSpeed[VoiceBank::MAX_VOICES];
+    uint64_t slicesOffset;        // Bytes from the start of the file
+    uint64_t peaksOffset;
+    uint64_t audioOffset;
+};
+
+struct LoopFileSlice {
+    int32_t startSample;
+    int32_t endSample;
+    float peakAmplitude;
+    int32_t active;
+};
+
+// Playheads stored alongside a loop
+struct LoopPlayState {
+    int currentSliceIndex = 0;
+    int playbackPosition = 0;
+    float playbackPhase = 0.0f;
+    int voiceSlice[VoiceBank::MAX_VOICES] = {};
+    int voicePosition[VoiceBank::MAX_VOICES] = {};
+    float voicePhase[VoiceBank::MAX_VOICES] = {};
+    float voiceSpeed[VoiceBank::MAX_VOICES] = {};
+};
+
+// Loop drawing state the audio thread publishes every block for
+// get_waveform_overview(); the pyramids are read while recording goes on
+struct WaveformState {
+    const PeakPyramid* loopPeaks = nullptr;
+    int loopLength = 0;
+    const PeakPyramid* takePeaks = nullptr;  // Take being recorded, if any
+    int takeLength = 0;                      // Samples of the take in takePeaks
+    int currentSlice = 0;
+    int numPlayheads = 0;
+    int playheads[VoiceBank::MAX_VOICES] = {};
+    unsigned generation = 0;                 // Pyramid resets so far
+};
+
+struct SliceBounds {
+    int32_t start;
+    int32_t end;  // Inclusive
+};
+
+// Copy of an engine's loop, taken by save_loop() and written without any lock
+struct SavedLoop {
+    LoopFormat format = LoopFormat::FLOAT32;
+    int length = 0;
+    std::vector<Slice> slices;
+    LoopPlayState play;
+    std::vector<PeakPyramid::MinMax> peaks;  // Level 0
+    std::vector<char> audio;
+};
+
+// Read-only view of a whole file. POSIX systems map it, so pages are read
+// on first access; elsewhere the file is read into memory up front.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#if !defined(_WIN32)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open loop file: " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot read loop file: " + path);
+        }
+        bytes = static_cast<size_t>(info.st_size);
+        void* mapped = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // The mapping keeps the file open
+        if (mapped == MAP_FAILED) {
+            throw std::runtime_error("Cannot map loop file: " + path);
+        }
+        base = static_cast<const char*>(mapped);
+#else
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            throw std::runtime_error("Cannot open loop file: " + path);
+        }
+        std::fseek(file, 0, SEEK_END);
+        long end = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        if (end > 0) {
+            contents.resize(static_cast<size_t>(end));
+            if (std::fread(contents.data(), 1, contents.size(), file) != contents.size()) {
+                contents.clear();
+            }
+        }
+        std::fclose(file);
+        if (contents.empty()) {
+            throw std::runtime_error("Cannot read loop file: " + path);
+        }
+        bytes = contents.size();
+        base = contents.data();
+#endif
+    }
+
+    ~MappedFile() {
+#if !defined(_WIN32)
+        ::munmap(const_cast<char*>(base), bytes);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return base; }
+    size_t size() const { return bytes; }
+
+private:
+    const char* base = nullptr;
+    size_t bytes = 0;
+#if defined(_WIN32)
+    std::vector<char> contents;
+#endif
+};
+
+// A loaded loop: built by load_loop(), then owned by the engine playing it
+struct LoopImage {
+    std::unique_ptr<MappedFile> file;
+    LoopView view;                       // Samples inside file
+    int length = 0;
+    std::vector<Slice> slices;
+    std::unique_ptr<PeakPyramid> peaks;
+    LoopPlayState play;
+    LoopImage* nextRetired = nullptr;    // AudioEngine retire list
+};
+
+// Writes to path + ".tmp" and renames it over path, so a file some engine
+// still has mapped is replaced by a new one instead of changing underneath it
+inline void writeLoopFile(const std::string& path, double sampleRate, const SavedLoop& loop) {
+    LoopFileHeader header{};
+    std::memcpy(header.magic, LoopFileHeader::MAGIC, sizeof(header.magic));
+    header.version = LoopFileHeader::VERSION;
+    header.format = static_cast<uint32_t>(loop.format);
+    header.sampleRate = sampleRate;
+    header.recordedLength = loop.length;
+    header.numSlices = static_cast<int32_t>(loop.slices.size());
+    header.numPeakBlocks = static_cast<int32_t>(loop.peaks.size());
+    header.currentSliceIndex = loop.play.currentSliceIndex;
+    header.playbackPosition = loop.play.playbackPosition;
+    header.playbackPhase = loop.play.playbackPhase;
+    for (int v = 0; v < VoiceBank::MAX_VOICES; v++) {
+        header.voiceSlice[v] = loop.play.voiceSlice[v];
+        header.voicePosition[v] = loop.play.voicePosition[v];
+        header.voicePhase[v] = loop.play.voicePhase[v];
+        header.voiceSpeed[v] = loop.play.voiceSpeed[v];
+    }
+    header.slicesOffset = sizeof(LoopFileHeader);
+    header.peaksOffset = header.slicesOffset + loop.slices.size() * sizeof(LoopFileSlice);
+    const uint64_t peaksEnd = header.peaksOffset + loop.peaks.size() * sizeof(PeakPyramid::MinMax);
+    header.audioOffset = (peaksEnd + LoopFileHeader::AUDIO_ALIGNMENT - 1) /
+                         LoopFileHeader::AUDIO_ALIGNMENT * LoopFileHeader::AUDIO_ALIGNMENT;
+
+    std::vector<LoopFileSlice> fileSlices;
+    fileSlices.reserve(loop.slices.size());
+    for (const Slice& s : loop.slices) {
+        fileSlices.push_back(LoopFileSlice{s.startSample, s.endSample, s.peakAmplitude,
+                                           s.active ? 1 : 0});
+    }
+    const std::vector<char> padding(static_cast<size_t>(header.audioOffset - peaksEnd), 0);
+
+    const std::string tempPath = path + ".tmp";
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot create loop file: " + tempPath);
+    }
+    auto put = [file](const void* data, size_t size) {
+        return size == 0 || std::fwrite(data, 1, size, file) == size;
+    };
+    bool ok = put(&header, sizeof(header)) &&
+              put(fileSlices.data(), fileSlices.size() * sizeof(LoopFileSlice)) &&
+              put(loop.peaks.data(), loop.peaks.size() * sizeof(PeakPyramid::MinMax)) &&
+              put(padding.data(), padding.size()) &&
+              put(loop.audio.data(), loop.audio.size());
+    ok = (std::fclose(file) == 0) && ok;
+#if defined(_WIN32)
+    if (ok) std::remove(path.c_str());  // rename() does not replace on Windows
+#endif
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("Failed to write loop file: " + path);
+    }
+}
+
+// Validates everything playback relies on; the samples themselves are not
+// touched, so only the header, slices and peak pages are read here
+inline std::unique_ptr<LoopImage> readLoopFile(const std::string& path, double sampleRate,
+                                               int peakCapacity) {
+    std::unique_ptr<LoopImage> image(new LoopImage());
+    image->file.reset(new MappedFile(path));
+    const char* data = image->file->data();
+    const uint64_t size = image->file->size();
+    const std::runtime_error invalid("Not a valid loop file: " + path);
+
+    LoopFileHeader header;
+    if (size < sizeof(header)) throw invalid;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, LoopFileHeader::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != LoopFileHeader::VERSION ||
+        header.format > static_cast<uint32_t>(LoopFormat::INT16)) {
+        throw invalid;
+    }
+    if (header.sampleRate != sampleRate) {
+        std::ostringstream msg;
+        msg << "Loop file was saved at " << header.sampleRate << " Hz, engine runs at "
+            << sampleRate << " Hz: " << path;
+        throw std::runtime_error(msg.str());
+    }
+
+    const LoopFormat format = static_cast<LoopFormat>(header.format);
+    const int length = header.recordedLength;
+    if (length <= 0 || header.numSlices < 0 ||
+        header.numPeakBlocks != PeakPyramid::blockCount(length) ||
+        header.slicesOffset > size || header.peaksOffset > size || header.audioOffset > size ||
+        header.peaksOffset % alignof(PeakPyramid::MinMax) != 0 ||
+        header.audioOffset % LoopFileHeader::AUDIO_ALIGNMENT != 0 ||
+        header.slicesOffset + static_cast<uint64_t>(header.numSlices) * sizeof(LoopFileSlice) > size ||
+        header.peaksOffset + static_cast<uint64_t>(header.numPeakBlocks) *
+            sizeof(PeakPyramid::MinMax) > size ||
+        header.audioOffset + static_cast<uint64_t>(length) * LoopBuffer::sampleBytes(format) > size) {
+        throw invalid;
+    }
+
+    image->slices.reserve(static_cast<size_t>(header.numSlices));
+    for (int i = 0; i < header.numSlices; i++) {
+        LoopFileSlice s;
+        std::memcpy(&s, data + header.slicesOffset + i * sizeof(LoopFileSlice), sizeof(s));
+        if (s.startSample < 0 || s.startSample > s.endSample || s.endSample >= length) {
+            throw invalid;
+        }
+        Slice slice;
+        slice.startSample = s.startSample;
+        slice.endSample = s.endSample;
+        slice.peakAmplitude = isFiniteBits(s.peakAmplitude) ? s.peakAmplitude : 0.0f;
+        slice.active = s.active != 0;
+        image->slices.push_back(slice);
+    }
+
+    // Out-of-range playheads are pulled back in rather than rejected
+    const int lastSlice = std::max(header.numSlices - 1, 0);
+    LoopPlayState& play = image->play;
+    play.currentSliceIndex = clamp(header.currentSliceIndex, 0, lastSlice);
+    play.playbackPosition = clamp(header.playbackPosition, 0, length - 1);
+    play.playbackPhase = isFiniteBits(header.playbackPhase) ? header.playbackPhase : 0.0f;
+    for (int v = 0; v < VoiceBank::MAX_VOICES; v++) {
+        play.voiceSlice[v] = clamp(header.voiceSlice[v], 0, lastSlice);
+        play.voicePosition[v] = clamp(header.voicePosition[v], 0, length - 1);
+        play.voicePhase[v] = isFiniteBits(header.voicePhase[v]) ? header.voicePhase[v] : 0.0f;
+        play.voiceSpeed[v] = isFiniteBits(header.voiceSpeed[v]) ? header.voiceSpeed[v] : 1.0f;
+    }
+
+    image->peaks.reset(new PeakPyramid(std::max(peakCapacity, length)));
+    image->peaks->restore(
+        reinterpret_cast<const PeakPyramid::MinMax*>(data + header.peaksOffset), length);
+    image->view = LoopView{data + header.audioOffset, format};
+    image->length = length;
+    return image;
+}
+
+// ============================================================================
+// SliceScanner - Background slice generation
+// ============================================================================
+// Slicing a full loop touches every recorded sample, so it runs on a worker
+// thread. The audio thread posts a job and later adopts the finished slice
+// table by swapping vectors, so it never allocates, frees or scans.
+struct SliceJob {
+    unsigned generation = 0;
+    LoopView loop;                 // Loop buffer; read-only while the job runs
+    const PeakPyramid* peaks = nullptr;  // Peak index of loop
+    int length = 0;                // Recorded length in samples
+    float sliceLength = 0.0f;      // Seconds
+    float scan = 0.0f;             // SCAN offset (0-1 of a slice)
+    double sampleRate = 48000.0;
+    bool redistribute = false;     // Redistribute poly voices once adopted
+};
+
+struct SliceTable {
+    unsigned generation = 0;
+    std::vector<Slice> slices;
+    bool redistribute = false;
+    int scanOffset = 0;        // Samples
+    float sliceLength = 0.0f;  // Seconds
+    float scan = 0.0f;
+};
+
+class SliceScanner {
+public:
+    SliceScanner() : worker(&SliceScanner::run, this) {}
+
+    ~SliceScanner() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            running = false;
+        }
+        wakeCondition.notify_one();
+        worker.join();
+    }
+
+    SliceScanner(const SliceScanner&) = delete;
+    SliceScanner& operator=(const SliceScanner&) = delete;
+
+    // Audio thread: queue a scan, superseding any job still pending or running.
+    // Only on LENGTH/SCAN changes; the worker holds wakeMutex just to check
+    // for a job, so the lock here is short.
+    void request(SliceJob job) {
+        job.generation = ++nextGeneration;
+        latestGeneration.store(job.generation);
+        requestedData = job.loop.data;
+        jobs.publish(job);
+        {
+            // Between the worker's check and its wait, a notify would be lost
+            std::lock_guard<std::mutex> lock(wakeMutex);
+        }
+        wakeCondition.notify_one();
+    }
+
+    // Audio thread: drop any pending or running job and its result
+    void invalidate() {
+        latestGeneration.store(++nextGeneration);
+        requestedData = nullptr;
+    }
+
+    // Audio thread: cancel any scan of buffer; never waits. A scan of a
+    // superseded job bails out at the next slice; until then reading() is
+    // true and buffer must not be overwritten or freed.
+    void release(const void* buffer) {
+        if (requestedData == buffer) {
+            invalidate();
+        }
+    }
+
+    // Whether a scan still reads buffer (pairs with the claim in computeSlices)
+    bool reading(const void* buffer) const {
+        return buffer != nullptr && scanning.load() == buffer;
+    }
+
+    // Control thread: release(buffer), then wait until no scan reads it
+    void waitReleased(const void* buffer) {
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        scanDone.wait(lock, [this, buffer] { return !reading(buffer); });
+    }
+
+    // Audio thread: returns the next finished table for the latest request, if any
+    SliceTable* poll() {
+        if (!results.consume()) return nullptr;
+        SliceTable& table = results.front();
+        if (table.generation != nextGeneration) return nullptr;
+        requestedData = nullptr;  // The worker is done with the buffer
+        return &table;
+    }
+
+    // Audio thread: whether the latest request is still waiting for its table
+    bool pending() const { return requestedData != nullptr; }
+
+private:
+    void run() {
+        SliceTable table;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeCondition.wait(lock, [this] { return !running || jobs.consume(); });
+                if (!running) return;
+            }
+            SliceJob job = jobs.front();
+
+            table.generation = job.generation;
+            table.redistribute = job.redistribute;
+            table.sliceLength = job.sliceLength;
+            table.scan = job.scan;
+            if (computeSlices(job, table.slices, table.scanOffset)) {
+                results.publish(table);
+            }
+        }
+    }
+
+    bool superseded(const SliceJob& job) const {
+        return latestGeneration.load() != job.generation;
+    }
+
+    bool peakOf(const SliceJob& job, int start, int end, float& peakAmp) const {
+        if (superseded(job)) return false;
+        peakAmp = job.peaks->peak(job.loop, start, end);
+        return true;
+    }
+
+    // Fixed-length slicing; returns false if the job was superseded mid-scan
+    bool computeSlices(const SliceJob& job, std::vector<Slice>& slices, int& scanOffset) {
+        slices.clear();
+        scanOffset = 0;
+
+        // Claim the buffer first, then re-check: pairs with release()
+        scanning.store(job.loop.data);
+        bool complete = !superseded(job) && scanSlices(job, slices, scanOffset);
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            scanning.store(nullptr);
+        }
+        scanDone.notify_all();
+        return complete;
+    }
+
+    bool scanSlices(const SliceJob& job, std::vector<Slice>& slices, int& scanOffset) const {
+        const int recordedLength = job.length;
+        if (recordedLength <= 0) return true;
+
+        // Fixed-length slicing: divide recording into equal-length slices
+        // SCAN parameter determines starting offset (0.0 = start, 1.0 = end)
+        int sliceLengthSamples = static_cast<int>(job.sliceLength * job.sampleRate);
+
+        // SCAN offset: shift starting position within first slice
+        int scanOffsetSamples = static_cast<int>(job.scan * sliceLengthSamples);
+        if (scanOffsetSamples >= recordedLength) {
+            scanOffsetSamples = recordedLength - 1;
+        }
+
+        // Create slices starting from scan offset
+        int pos = scanOffsetSamples;
+
+        while (pos < recordedLength) {
+            int sliceStart = pos;
+            int sliceEnd = std::min(pos + sliceLengthSamples - 1, recordedLength - 1);
+
+            // Calculate peak amplitude for this slice
+            float peakAmp;
+            if (!peakOf(job, sliceStart, sliceEnd, peakAmp)) return false;
+
+            Slice newSlice;
+            newSlice.startSample = sliceStart;
+            newSlice.endSample = sliceEnd;
+            newSlice.active = true;
+            newSlice.peakAmplitude = peakAmp;
+            slices.push_back(newSlice);
+
+            pos += sliceLengthSamples;
+        }
+
+        // If scan offset > 0, also create slice for the beginning part (wrap around)
+        if (scanOffsetSamples > 0) {
+            int wrapStart = 0;
+            int wrapEnd = std::min(scanOffsetSamples - 1, recordedLength - 1);
+
+            float peakAmp;
+            if (!peakOf(job, wrapStart, wrapEnd, peakAmp)) return false;
+
+            Slice wrapSlice;
+            wrapSlice.startSample = wrapStart;
+            wrapSlice.endSample = wrapEnd;
+            wrapSlice.active = true;
+            wrapSlice.peakAmplitude = peakAmp;
+            slices.push_back(wrapSlice);
+        }
+
+        scanOffset = scanOffsetSamples;
+        return true;
+    }
+
+    TripleBuffer<SliceJob> jobs;        // Audio thread -> worker
+    TripleBuffer<SliceTable> results;   // Worker -> audio thread
+
+    // Audio-thread state
+    unsigned nextGeneration = 0;
+    const void* requestedData = nullptr;
+
+    std::atomic<unsigned> latestGeneration{0};
+    std::atomic<const void*> scanning{nullptr};  // Buffer the worker is reading
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;  // Job published or shutdown
+    std::condition_variable scanDone;       // scanning cleared
+    bool running = true;  // Guarded by wakeMutex
+    std::thread worker;   // Last member: started after everything above exists
+};
+
+// ============================================================================
+// Main AudioEngine class
+// ============================================================================
+// Threading: all set_* methods and clear() only write a parameter snapshot
+// that the audio thread picks up at the start of the next block, so control
+// may come from a different thread than process()/process_into(). Setters
+// must come from one control thread at a time (in Python the GIL ensures
+// this). get_* queries report the state as of the last processed block.
+//
+// All DSP state, including random generators, is per instance: separate
+// engines share nothing and may run process()/process_into() concurrently
+// on different threads (process_into() releases the GIL while rendering).
+// A single engine must still be processed by one thread at a time.
+class AudioEngine {
+public:
+    static constexpr int LOOP_BUFFER_SIZE = 2880000; // 60 seconds at 48kHz
+    static constexpr double DEFAULT_MAX_LOOP_SECONDS = 60.0;
+    static constexpr int MAX_BLOCK_SIZE = 256;       // Pipeline chunk size
+    static constexpr int MAX_OVERVIEW_WIDTH = 16384; // get_waveform_overview() columns
+
+    static constexpr float PARAM_RAMP_SECONDS = 0.02f;       // General parameter ramps
+    static constexpr float DELAY_TIME_RAMP_SECONDS = 0.1f;   // Much slower for delay time to prevent clicks
+
+    // max_loop_seconds bounds a take; the two loop buffers are committed lazily
+    explicit AudioEngine(double sample_rate, double max_loop_seconds = DEFAULT_MAX_LOOP_SECONDS,
+                         LoopFormat loop_format = LoopFormat::FLOAT32)
+        : sampleRate(sample_rate),
+          loopCapacity(loopCapacityFor(sample_rate, max_loop_seconds)),
+          loopBuffer(loopCapacity, loop_format),
+          loopPeaks(new PeakPyramid(loopCapacity)),
+          tempBuffer(loopCapacity, loop_format),
+          tempPeaks(new PeakPyramid(loopCapacity)),
+          randomEngine(std::random_device()())
+    {
+        paramRampSamples = static_cast<int>(PARAM_RAMP_SECONDS * sampleRate);
+        delayTimeRampSamples = static_cast<int>(DELAY_TIME_RAMP_SECONDS * sampleRate);
+        recordBacklog.assign(static_cast<size_t>(RECORD_BACKLOG_SECONDS * sampleRate) + MAX_BLOCK_SIZE, 0.0f);
+
+        // Room for any table the scanner produces (LENGTH >= 1 ms), so the
+        // audio thread never allocates publishing one; a larger loaded table is cut short
+        const size_t maxSlices = static_cast<size_t>(
+            loopCapacity / std::max(1, static_cast<int>(0.001 * sampleRate)) + 2);
+        sliceMirror.initSlots([maxSlices](std::vector<SliceBounds>& slot) { slot.reserve(maxSlices); });
+
+        // Initialize default parameters
+        isRecording = false;
+        isLooping = params.looping;
+        scanValue = params.scan;
+        gateThresholdKnob = params.gateThreshold;
+
+        numVoices = 1;
+
+        playbackPosition = 0;
+        playbackPhase = 0.0f;
+        recordedLength = 0;
+        currentSliceIndex = 0;
+        lastAmplitude = 0.0f;
+        lastScanTargetIndex = -1;
+        lastScanValue = -1.0f;
+
+        tempRecordPosition = 0;
+        tempRecordedLength = 0;
+        tempLastAmplitude = 0.0f;
+
+        lastOutputL = 0.0f;
+        lastOutputR = 0.0f;
+
+        // Initialize ramped parameters at their defaults
+        mixRamp.reset(params.mix);
+        feedbackRamp.reset(params.feedback);
+        speedRamp.reset(params.speed);
+        eqLowRamp.reset(params.eqLowDb);
+        eqMidRamp.reset(params.eqMidDb);
+        eqHighRamp.reset(params.eqHighDb);
+        delayTimeLRamp.reset(params.delayTimeL);
+        delayTimeRRamp.reset(params.delayTimeR);
+        delayFeedbackRamp.reset(params.delayFeedback);
+        delayWetRamp.reset(params.delayWet);
+        reverbRoomRamp.reset(params.reverbRoom);
+        reverbDampingRamp.reset(params.reverbDamping);
+        reverbDecayRamp.reset(params.reverbDecay);
+        reverbWetRamp.reset(params.reverbWet);
+        grainWetRamp.reset(params.grainWetDry);
+    }
+
+    ~AudioEngine() {
+        // The slice scanner may still be reading a mapped loop
+        for (LoopImage* image : {loopImage, tempImage}) {
+            if (image != nullptr) {
+                sliceScanner.release(image->view.data);
+                sliceScanner.waitReleased(image->view.data);
+                delete image;
+            }
+        }
+        delete pendingLoop.exchange(nullptr);
+        reclaimRetiredLoops();
+    }
+
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+
+    // ========================================================================
+    // Recording control
+    // ========================================================================
+    void set_recording(bool enabled) {
+        controlParams.recording = enabled;
+        publishParams();
+    }
+
+    void set_looping(bool enabled) {
+        controlParams.looping = enabled;
+        publishParams();
+    }
+
+    void clear() {
+        controlParams.clearCount++;
+        publishParams();
+    }
+
+    // ========================================================================
+    // Slice control
+    // ========================================================================
+    void set_scan(double value) {
+        controlParams.scan = clamp(static_cast<float>(value), 0.0f, 1.0f);
+        publishParams();
+    }
+
+    void set_gate_threshold(double value) {
+        controlParams.gateThreshold = clamp(static_cast<float>(value), 0.0f, 1.0f);
+        publishParams();
+    }
+
+    void set_poly(int voices_count) {
+        controlParams.polyVoices = clamp(voices_count, 1, 8);
+        publishParams();
+    }
+
+    // ========================================================================
+    // Debug / Query functions
+    // ========================================================================
+    int get_num_slices() const {
+        return publishedNumSlices.load(std::memory_order_relaxed);
+    }
+
+    int get_num_voices() const {
+        return publishedNumVoices.load(std::memory_order_relaxed);
+    }
+
+    int get_recorded_length() const {
+        return publishedRecordedLength.load(std::memory_order_relaxed);
+    }
+
+    int get_max_loop_length() const { return loopCapacity; }
+
+    double get_sample_rate() const { return sampleRate; }
+
+    // Loop drawing for the GUI, from what the audio thread publishes every
+    // block (it never waits for this): min/max per column of the loop and
+    // of the take being recorded, read from their peak pyramids, plus slice
+    // bounds and playheads. O(width * log(length)). Call from one thread only.
+    py::dict get_waveform_overview(int width) {
+        if (width < 1 || width > MAX_OVERVIEW_WIDTH) {
+            throw std::runtime_error("width must be in 1.." + std::to_string(MAX_OVERVIEW_WIDTH));
+        }
+        std::vector<float> columns(static_cast<size_t>(width) * 4);  // Loop min, max, take min, max
+        std::vector<SliceBounds> bounds;
+        WaveformState state;
+        {
+            py::gil_scoped_release release;
+            // Pyramids published in a state are only freed by reclaiming retired loops
+            std::lock_guard<std::mutex> lock(reclaimMutex);
+            sliceMirror.consume();
+            bounds = sliceMirror.front();
+
+            // A take that starts while this reads may reset a pyramid: read again
+            for (int attempt = 0; attempt < 2; attempt++) {
+                waveformMailbox.consume();
+                state = waveformMailbox.front();
+                float* column = columns.data();
+                for (const auto& [peaks, length] : {std::make_pair(state.loopPeaks, state.loopLength),
+                                                        std::make_pair(state.takePeaks, state.takeLength)}) {
+                    if (peaks != nullptr) {
+                        peaks->overview(length, width, column, column + width);
+                    } else {
+                        std::fill(column, column + 2 * width, 0.0f);
+                    }
+                    column += 2 * width;
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (waveformGeneration.load(std::memory_order_relaxed) == state.generation) break;
+            }
+        }
+
+        auto columnArray = [&](int index) {
+            py::array_t<float> array(width);
+            const float* from = columns.data() + static_cast<size_t>(index) * width;
+            std::copy(from, from + width, array.mutable_data());
+            return array;
+        };
+
+        py::array_t<int32_t> sliceArray(std::vector<ssize_t>{static_cast<ssize_t>(bounds.size()), 2});
+        auto sliceView = sliceArray.mutable_unchecked<2>();
+        for (size_t i = 0; i < bounds.size(); i++) {
+            sliceView(i, 0) = bounds[i].start;
+            sliceView(i, 1) = bounds[i].end;
+        }
+
+        py::array_t<int32_t> playheadArray(static_cast<ssize_t>(state.numPlayheads));
+        std::copy(state.playheads, state.playheads + state.numPlayheads, playheadArray.mutable_data());
+
+        py::dict result;
+        result["length"] = state.loopLength;
+        result["min"] = columnArray(0);
+        result["max"] = columnArray(1);
+        result["slices"] = sliceArray;
+        result["current_slice"] = state.currentSlice;
+        result["voices"] = playheadArray;
+        result["recording"] = state.takePeaks != nullptr;
+        result["take_length"] = state.takeLength;
+        result["take_min"] = columnArray(2);
+        result["take_max"] = columnArray(3);
+        return result;
+    }
+
+    // ========================================================================
+    // Offline rendering (C++ only; call before processing starts)
+    // ========================================================================
+    // Fix the random sequences (grain scheduling, voice redistribution) so
+    // that a render repeats sample for sample
+    void seedRandom(uint32_t seed) {
+        randomEngine.seed(seed);
+        leftGrainProcessor.randomEngine.seed(seed + 1);
+        rightGrainProcessor.randomEngine.seed(seed + 2);
+    }
+
+    // Wait for the slice scanner instead of adopting its table whenever it is
+    // ready, so the output does not depend on how fast blocks are processed.
+    // Only for offline rendering: it blocks the processing thread.
+    void setSynchronousSlicing(bool enabled) { synchronousSlicing = enabled; }
+
+    // The slice table as of the last block; from the processing thread only
+    const std::vector<Slice>& getSliceTable() const { return slices; }
+
+    // ========================================================================
+    // Saved loops
+    // ========================================================================
+    // Write the current loop, its slice table and the playheads to path
+    void save_loop(const std::string& path) {
+        py::gil_scoped_release release;
+        std::lock_guard<std::mutex> reclaimLock(reclaimMutex);  // Retired loops stay mapped
+        reclaimRetiredLoopsLocked();
+
+        // Snapshot under the lock the audio thread holds while it changes the
+        // loop, then copy the samples without it: savingLoop keeps the next
+        // take from recording over them meanwhile (see recordTake())
+        SavedLoop saved;
+        LoopView loop;
+        const PeakPyramid* peaks = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(loopStateMutex);
+            if (recordedLength <= 0) {
+                throw std::runtime_error("No loop recorded");
+            }
+            loop = loopBuffer.view();
+            peaks = loopPeaks.get();
+            saved.format = loop.format;
+            saved.length = recordedLength;
+            saved.slices = slices;
+            saved.play = savedPlayState;
+            savingLoop.store(loop.data);
+        }
+        try {
+            const size_t bytes = static_cast<size_t>(saved.length) * LoopBuffer::sampleBytes(loop.format);
+            saved.peaks.resize(static_cast<size_t>(PeakPyramid::blockCount(saved.length)));
+            peaks->copyBlocks(saved.peaks.data(), static_cast<int>(saved.peaks.size()));
+            saved.audio.assign(static_cast<const char*>(loop.data),
+                               static_cast<const char*>(loop.data) + bytes);
+        } catch (...) {
+            savingLoop.store(nullptr);
+            throw;
+        }
+        savingLoop.store(nullptr);
+        writeLoopFile(path, sampleRate, saved);
+    }
+
+    // Play a loop written by save_loop(). The file is mapped, not read: it is
+    // playable from the next block on and pages load as playback reaches them.
+    void load_loop(const std::string& path) {
+        py::gil_scoped_release release;
+        reclaimRetiredLoops();
+
+        std::unique_ptr<LoopImage> image = readLoopFile(path, sampleRate, loopCapacity);
+        // A load the audio thread has not picked up yet is simply replaced
+        delete pendingLoop.exchange(image.release());
+    }
+
+    // Timing counters since the last reset_stats(). Call from one thread only.
+    py::dict get_stats() const {
+        py::dict result;
+#ifndef ALIEN4_NO_STATS
+        EngineStats::Snapshot now = stats.snapshot();
+        const EngineStats::Snapshot& base = statsBaseline;
+
+        py::dict stageNs;
+        for (int i = 0; i < NUM_STAT_STAGES; i++) {
+            stageNs[EngineStats::stageName(i)] = now.stageNs[i] - base.stageNs[i];
+        }
+
+        py::array_t<uint64_t> histogram(EngineStats::HISTOGRAM_BUCKETS);
+        py::list edges;
+        auto h = histogram.mutable_unchecked<1>();
+        for (int i = 0; i < EngineStats::HISTOGRAM_BUCKETS; i++) {
+            h(i) = now.histogram[i] - base.histogram[i];
+            edges.append(i == 0 ? 0 : (1 << (i - 1)));
+        }
+
+        result["enabled"] = true;
+        result["calls"] = now.calls - base.calls;
+        result["frames"] = now.frames - base.frames;
+        result["total_ns"] = now.totalNs - base.totalNs;
+        result["deadline_misses"] = now.deadlineMisses - base.deadlineMisses;
+        result["deadline_fraction"] = statsDeadlineFraction.load(std::memory_order_relaxed);
+        result["stage_ns"] = stageNs;
+        result["stage_frames"] = now.stageFrames - base.stageFrames;
+        result["histogram"] = histogram;
+        result["histogram_edges_us"] = edges;
+#else
+        result["enabled"] = false;
+#endif
+        return result;
+    }
+
+    void reset_stats() {
+#ifndef ALIEN4_NO_STATS
+        statsBaseline = stats.snapshot();
+#endif
+    }
+
+    // A call misses its deadline when it takes longer than fraction * frames / sample_rate
+    void set_stats_deadline(float fraction) {
+        if (!(fraction > 0.0f)) {
+            throw std::runtime_error("deadline fraction must be > 0");
+        }
+#ifndef ALIEN4_NO_STATS
+        statsDeadlineFraction.store(fraction, std::memory_order_relaxed);
+#endif
+    }
+
+    // Pop all pending engine events, oldest first. Call from one thread only.
+    py::list drain_events() {
+        py::list result;
+#ifndef ALIEN4_NO_EVENT_LOG
+        uint32_t dropped = eventRing.takeDropped();
+        if (dropped > 0) {
+            py::dict d;
+            d["frame"] = publishedFrames.load(std::memory_order_relaxed);
+            d["type"] = "events_dropped";
+            d["message"] = std::to_string(dropped) + " events dropped (ring full)";
+            result.append(d);
+        }
+
+        EngineEvent e;
+        while (eventRing.pop(e)) {
+            py::dict d;
+            d["frame"] = e.frame;
+            d["type"] = eventTypeName(e.type);
+            d["message"] = formatEvent(e);
+            result.append(d);
+        }
+#endif
+        return result;
+    }
+
+    // ========================================================================
+    // Documenta parameters
+    // ========================================================================
+    void set_mix(double value) {
+        controlParams.mix = clamp(static_cast<float>(value), 0.0f, 1.0f);
+        publishParams();
+    }
+
+    void set_feedback(double value) {
+        // Limit to 0.8 with additional safety scaling in process()
+        controlParams.feedback = clamp(static_cast<float>(value), 0.0f, 0.8f);
+        publishParams();
+    }
+
+    void set_speed(double value) {
+        controlParams.speed = clamp(static_cast<float>(value), -8.0f, 8.0f);
+        publishParams();
+    }
+
+    // ========================================================================
+    // EQ parameters (cut-only: 0 to -20dB)
+    // ========================================================================
+    void set_eq_low(double db) {
+        controlParams.eqLowDb = clamp(static_cast<float>(db), -20.0f, 0.0f);
+        publishParams();
+    }
+
+    void set_eq_mid(double db) {
+        controlParams.eqMidDb = clamp(static_cast<float>(db), -20.0f, 0.0f);
+        publishParams();
+    }
+
+    void set_eq_high(double db) {
+        controlParams.eqHighDb = clamp(static_cast<float>(db), -20.0f, 0.0f);
+        publishParams();
+    }
+
+    // ========================================================================
+    // Delay parameters
+    // ========================================================================
+    void set_delay_time(double time_l, double time_r) {
+        controlParams.delayTimeL = clamp(static_cast<float>(time_l), 0.001f, 2.0f);
+        controlParams.delayTimeR = clamp(static_cast<float>(time_r), 0.001f, 2.0f);
+        publishParams();
+    }
+
+    void set_delay_feedback(double value) {
+        controlParams.delayFeedback = clamp(static_cast<float>(value), 0.0f, 0.95f);
+        publishParams();
+    }
+
+    void set_delay_wet(double value) {
+        controlParams.delayWet = clamp(static_cast<float>(value), 0.0f, 1.0f);
+        publishParams();
+    }
+
+    // ========================================================================
+    // Reverb parameters
+    // ========================================================================
+    void set_reverb_room(double value) {
+        controlParams.reverbRoom = clamp(static_cast<float>(value), 0.0f, 1.0f);
+        publishParams();
+    }
+
+    void set_reverb_damping(double value) {
+        controlParams.reverbDamping = clamp(static_cast<float>(value), 0.0f, 1.0f);
+        publishParams();
+    }
+
+    void set_reverb_decay(double value) {
+        controlParams.reverbDecay = clamp(static_cast<float>(value), 0.0f, 1.0f);
+        publishParams();
+    }
+
+    void set_reverb_wet(double value) {
+        controlParams.reverbWet = clamp(static_cast<float>(value), 0.0f, 1.0f);
+        publishParams();
+    }
+
+    // ========================================================================
+    // Chaos control methods
+    // ========================================================================
+    void set_chaos_rate(float rate) { controlParams.chaosRate = clamp(rate, 0.0f, 1.0f); publishParams(); }
+    void set_chaos_amount(float amount) { controlParams.chaosAmount = clamp(amount, 0.0f, 1.0f); publishParams(); }
+    void set_chaos_shape(bool shape) { controlParams.chaosShape = shape; publishParams(); }
+    void set_delay_chaos(bool enabled) { controlParams.delayChaos = enabled; publishParams(); }
+    void set_reverb_chaos(bool enabled) { controlParams.reverbChaos = enabled; publishParams(); }
+
+    // ========================================================================
+    // Modulation (control rate, see ModulationEngine)
+    // ========================================================================
+    void set_control_interval(int samples) {
+        controlParams.controlInterval = clamp(samples, 1, ModulationEngine::MAX_INTERVAL);
+        publishParams();
+    }
+
+    int get_control_interval() const { return controlParams.controlInterval; }
+
+    // depth * source is added to the target (0 removes the route)
+    void set_mod_route(const std::string& source, const std::string& target, double depth) {
+        controlParams.modDepth[ModulationEngine::findSource(source)]
+                              [ModulationEngine::findTarget(target)] = static_cast<float>(depth);
+        publishParams();
+    }
+
+    void clear_mod_routes() {
+        for (auto& row : controlParams.modDepth) std::fill(std::begin(row), std::end(row), 0.0f);
+        publishParams();
+    }
+
+    py::dict get_mod_routes() const {
+        py::dict routes;
+        for (int src = 0; src < ModulationEngine::NUM_SOURCES; src++) {
+            for (int t = 0; t < ModulationEngine::NUM_TARGETS; t++) {
+                const float depth = controlParams.modDepth[src][t];
+                if (depth != 0.0f) {
+                    routes[py::make_tuple(ModulationEngine::SOURCE_NAMES[src],
+                                          ModulationEngine::TARGET_NAMES[t])] = depth;
+                }
+            }
+        }
+        return routes;
+    }
+
+    // CV sources cv1-6, from any thread; picked up at the next block
+    void set_mod_cv(int index, double value) {
+        if (index < 0 || index >= ModulationEngine::NUM_CV) {
+            throw py::index_error("cv index out of range");
+        }
+        modCv[index].store(static_cast<float>(value), std::memory_order_relaxed);
+    }
+
+    // Same from the audio thread, all of them (CallbackChain, before processBlock())
+    void setModulationCv(const float* cv) {
+        for (int i = 0; i < ModulationEngine::NUM_CV; i++) {
+            modCv[i].store(cv[i], std::memory_order_relaxed);
+        }
+    }
+
+    // ========================================================================
+    // Grain control methods
+    // ========================================================================
+    void set_grain_size(float size) { controlParams.grainSize = clamp(size, 0.0f, 1.0f); publishParams(); }
+    void set_grain_density(float density) { controlParams.grainDensity = clamp(density, 0.0f, 1.0f); publishParams(); }
+    void set_grain_wet_dry(float wet) { controlParams.grainWetDry = clamp(wet, 0.0f, 1.0f); publishParams(); }
+
+    // ========================================================================
+    // Process audio
+    // ========================================================================
+    std::pair<py::array_t<float>, py::array_t<float>>
+    process(py::array_t<float> left_in, py::array_t<float> right_in) {
+        auto left_buf = left_in.request();
+        auto right_buf = right_in.request();
+
+        if (left_buf.ndim != 1 || right_buf.ndim != 1) {
+            throw std::runtime_error("Input arrays must be 1-dimensional");
+        }
+
+        size_t num_samples = left_buf.shape[0];
+        if (right_buf.shape[0] != static_cast<ssize_t>(num_samples)) {
+            throw std::runtime_error("Left and right inputs must have same length");
+        }
+
+        const float* left_in_ptr = static_cast<const float*>(left_buf.ptr);
+        const float* right_in_ptr = static_cast<const float*>(right_buf.ptr);
+
+        // Allocate output
+        py::array_t<float> left_out(num_samples);
+        py::array_t<float> right_out(num_samples);
+
+        auto left_out_buf = left_out.request();
+        auto right_out_buf = right_out.request();
+
+        float* left_out_ptr = static_cast<float*>(left_out_buf.ptr);
+        float* right_out_ptr = static_cast<float*>(right_out_buf.ptr);
+
+        {
+            py::gil_scoped_release release;
+            processBlock(left_in_ptr, right_in_ptr, left_out_ptr, right_out_ptr, num_samples);
+        }
+
+        return std::make_pair(left_out, right_out);
+    }
+
+    // ========================================================================
+    // Process audio into caller-owned buffers (no allocation, GIL released)
+    //
+    // All four arrays must be 1-D float32 of the same length. Each may be
+    // contiguous (planar) or a strided view into an interleaved buffer, e.g.
+    // process_into(indata[:, 0], indata[:, 1], outdata[:, 0], outdata[:, 1]).
+    // ========================================================================
+    void process_into(py::array left_in, py::array right_in,
+                      py::array left_out, py::array right_out) {
+        StridedBuffer inL = checkBuffer(left_in, "left_in", false);
+        StridedBuffer inR = checkBuffer(right_in, "right_in", false);
+        StridedBuffer outL = checkBuffer(left_out, "left_out", true);
+        StridedBuffer outR = checkBuffer(right_out, "right_out", true);
+
+        size_t num_samples = inL.length;
+        if (inR.length != num_samples || outL.length != num_samples ||
+            outR.length != num_samples) {
+            throw std::runtime_error("All input and output arrays must have same length");
+        }
+
+        // Interleaved outputs are written channel by channel, so the left and
+        // right outputs must not alias each other
+        if (outL.ptr == outR.ptr && num_samples > 0) {
+            throw std::runtime_error("left_out and right_out must not share memory");
+        }
+
+        py::gil_scoped_release release;
+        processBlock(inL.ptr, inR.ptr, outL.ptr, outR.ptr, num_samples,
+                     inL.stride, inR.stride, outL.stride, outR.stride);
+    }
+
+    // ========================================================================
+    // Raw-pointer processing core (touches no Python objects, runs without the GIL)
+    // Strides are in samples: 1 for planar buffers, channel count for interleaved
+    // ========================================================================
+    void processBlock(const float* left_in_ptr, const float* right_in_ptr,
+                      float* left_out_ptr, float* right_out_ptr, size_t num_samples,
+                      ptrdiff_t inStrideL = 1, ptrdiff_t inStrideR = 1,
+                      ptrdiff_t outStrideL = 1, ptrdiff_t outStrideR = 1) {
+        (void)right_in_ptr;  // Mono input: right channel is accepted but unused
+        (void)inStrideR;
+
+        ScopedFlushToZero flushToZero;  // Caller's mode is restored on return
+
+#ifndef ALIEN4_NO_STATS
+        const auto callStart = std::chrono::steady_clock::now();
+#endif
+
+        // ====================================================================
+        // Pre-process: Check parameter changes (once per buffer, not per sample)
+        // ====================================================================
+
+        // Pick up the latest parameter snapshot once per block: transport,
+        // clear() and every parameter take effect in this block
+        if (paramMailbox.consume()) {
+            applyParams(paramMailbox.front());
+        }
+
+        // Everything that replaces the loop or its slices holds loopStateMutex.
+        // While save_loop() is taking its snapshot (microseconds) that waits
+        // for a later block; playback of the current loop carries on meanwhile.
+        std::unique_lock<std::mutex> loopLock(loopStateMutex, std::try_to_lock);
+        if (loopLock.owns_lock()) {
+            updateLoopState();
+            loopLock.unlock();
+        }
+
+        // Apply SCAN parameter to jump to target slice
+        if (slices.size() > 1) {
+            bool useManualScan = scanValue > 0.01f;
+
+            if (useManualScan) {
+                int targetSliceIndex = static_cast<int>(
+                    std::round(scanValue * (slices.size() - 1)));
+                targetSliceIndex = clamp(targetSliceIndex, 0,
+                                       static_cast<int>(slices.size()) - 1);
+
+                if (targetSliceIndex != lastScanTargetIndex &&
+                    slices[targetSliceIndex].active) {
+                    currentSliceIndex = targetSliceIndex;
+                    playbackPosition = slices[targetSliceIndex].startSample;
+                    playbackPhase = 0.0f;
+                    lastScanTargetIndex = targetSliceIndex;
+
+                    if (numVoices > 1) {
+                        voices.reset(0, targetSliceIndex, slices[targetSliceIndex].startSample,
+                                     voices.speedMultiplier[0]);
+                        voices.updateBounds(slices, recordedLength);
+                    }
+                }
+            } else {
+                lastScanTargetIndex = -1;
+            }
+        }
+
+        // ====================================================================
+        // Run the stage pipeline over the buffer in scratch-sized chunks
+        // ====================================================================
+        // While FEEDBACK is up the kernel is a processFeedbackChunk(), which
+        // runs the effects one sample at a time inside the chunk
+        const bool timeStages = feedbackRamp.isSilent();
+        const ChunkKernel kernel = selectChunkKernel();
+        for (int i = 0; i < ModulationEngine::NUM_CV; i++) {
+            blockModCv[i] = modCv[i].load(std::memory_order_relaxed);
+        }
+
+        for (size_t offset = 0; offset < num_samples; offset += MAX_BLOCK_SIZE) {
+            const int n = static_cast<int>(std::min<size_t>(MAX_BLOCK_SIZE, num_samples - offset));
+
+            for (int i = 0; i < n; i++) {
+                inputBuffer[i] = left_in_ptr[(offset + i) * inStrideL]; // Mono input
+            }
+
+            beginStageTiming(n, timeStages);
+            (this->*kernel)(inputBuffer, n);
+
+            // Store for feedback
+            lastOutputL = stageL[n - 1];
+            lastOutputR = stageR[n - 1];
+
+            // Output (clamp to safe range)
+            for (int i = 0; i < n; i++) {
+                left_out_ptr[(offset + i) * outStrideL] = clamp(stageL[i], -10.0f, 10.0f);
+                right_out_ptr[(offset + i) * outStrideR] = clamp(stageR[i], -10.0f, 10.0f);
+            }
+        }
+
+        processedFrames += static_cast<int64_t>(num_samples);
+        publishStatus();
+
+#ifndef ALIEN4_NO_STATS
+        if (num_samples > 0) {
+            const uint64_t callNs = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - callStart).count());
+            const double deadlineNs = 1e9 * static_cast<double>(num_samples) / sampleRate *
+                                      statsDeadlineFraction.load(std::memory_order_relaxed);
+            stats.recordCall(callNs, num_samples, static_cast<uint64_t>(deadlineNs));
+        }
+#endif
+    }
+
+private:
+    // Validated view of a 1-D float32 NumPy array
+    struct StridedBuffer {
+        float* ptr;
+        size_t length;
+        ptrdiff_t stride;  // In samples
+    };
+
+    static StridedBuffer checkBuffer(py::array& arr, const char* name, bool writable) {
+        if (!arr.dtype().is(py::dtype::of<float>())) {
+            throw std::runtime_error(std::string(name) + " must be a float32 array");
+        }
+        if (arr.ndim() != 1) {
+            throw std::runtime_error(std::string(name) + " must be 1-dimensional");
+        }
+        if (writable && !arr.writeable()) {
+            throw std::runtime_error(std::string(name) + " must be writable");
+        }
+
+        StridedBuffer buf;
+        buf.length = static_cast<size_t>(arr.shape(0));
+        buf.stride = 1;
+        if (buf.length > 1) {
+            ssize_t strideBytes = arr.strides(0);
+            if (strideBytes <= 0 || strideBytes % static_cast<ssize_t>(sizeof(float)) != 0) {
+                throw std::runtime_error(std::string(name) +
+                                         " must have a positive stride aligned to float32");
+            }
+            buf.stride = strideBytes / static_cast<ssize_t>(sizeof(float));
+        }
+        buf.ptr = writable ? static_cast<float*>(arr.mutable_data())
+                           : const_cast<float*>(static_cast<const float*>(arr.data()));
+        return buf;
+    }
+
+    double sampleRate;
+
+    // Loop buffer
+    int loopCapacity;  // Samples per buffer (max_loop_seconds)
+    LoopBuffer loopBuffer;
+    std::unique_ptr<PeakPyramid> loopPeaks;  // Peak index of loopBuffer, swapped along with it
+    int playbackPosition;
+    float playbackPhase;
+    int recordedLength;
+    int currentSliceIndex;
+    float lastAmplitude;
+    int lastScanTargetIndex;
+
+    // Temp buffer (during recording)
+    LoopBuffer tempBuffer;
+    std::unique_ptr<PeakPyramid> tempPeaks;
+    std::vector<Slice> tempSlices;
+    int tempRecordPosition;
+    int tempRecordedLength;
+    float tempLastAmplitude;
+    int finishedTakeLength = -1;   // Stopped take waiting for finishTake(), -1 if none
+
+    // Input of a take whose buffer is not free yet (see recordTake())
+    static constexpr double RECORD_BACKLOG_SECONDS = 1.0;
+    static constexpr float silenceBlock[MAX_BLOCK_SIZE] = {};
+    std::vector<float> recordBacklog;
+    int backlogLength = 0;
+    bool takeHeld = false;         // Take samples go to recordBacklog
+    bool loopClearPending = false; // clear() waiting for applyLoopClear()
+
+    // Slices
+    std::vector<Slice> slices;
+
+    // Polyphonic voices
+    VoiceBank voices;
+    int numVoices;
+    std::default_random_engine randomEngine;
+    float lastScanValue;
+
+    // EQ filters (stereo, cut-only)
+    StereoEqCascade eq;  // Bands: 0 = low, 1 = mid, 2 = high
+
+    // Effects processors
+    DelayProcessor delay;  // Single delay processor with L/R separation
+    ReverbProcessor reverb;  // Fused stereo reverb
+
+    // Chaos/modulation and Grain processors
+    ModulationEngine modulation;
+    GrainProcessor leftGrainProcessor;
+    GrainProcessor rightGrainProcessor;
+
+    // Background slicing
+    SliceScanner sliceScanner;
+    bool synchronousSlicing = false;  // Offline rendering, see setSynchronousSlicing()
+
+    // Saved loops (save_loop / load_loop)
+    std::mutex loopStateMutex;        // Held by the audio thread in updateLoopState()
+    LoopPlayState savedPlayState;     // Guarded by loopStateMutex
+    std::atomic<const void*> savingLoop{nullptr};  // Loop samples save_loop() is copying
+    std::mutex reclaimMutex;          // Control threads: freeing retired loops vs reading them
+    std::atomic<LoopImage*> pendingLoop{nullptr};   // load_loop() -> audio thread
+    std::atomic<LoopImage*> retiredLoops{nullptr};  // Audio thread -> control thread
+    LoopImage* loopImage = nullptr;   // Loaded loop attached to loopBuffer, if any
+    LoopImage* tempImage = nullptr;   // Same for tempBuffer
+
+    // State
+    bool isRecording;
+    bool isLooping;
+
+    // Feedback state
+    float lastOutputL;
+    float lastOutputR;
+
+    // Parameter snapshots: controlParams is written by the setters (control
+    // thread), params is the copy the audio thread is currently running with
+    EngineParams controlParams;
+    EngineParams params;
+    TripleBuffer<EngineParams> paramMailbox;
+
+    // Event log (audio thread -> drain_events())
+    EventRing eventRing;
+    int64_t processedFrames = 0;
+
+#ifndef ALIEN4_NO_STATS
+    // Timing counters (audio thread -> get_stats())
+    EngineStats stats;
+    EngineStats::Snapshot statsBaseline;           // Reader side, see reset_stats()
+    std::atomic<float> statsDeadlineFraction{1.0f};
+    std::chrono::steady_clock::time_point stageMark;
+    bool stageTimed = false;                       // Whether the current chunk is timed
+#endif
+
+    // Loop drawing state (audio thread -> get_waveform_overview())
+    TripleBuffer<WaveformState> waveformMailbox;
+    TripleBuffer<std::vector<SliceBounds>> sliceMirror;
+    bool slicesChanged = true;
+    std::atomic<unsigned> waveformGeneration{0};
+
+    // Status published to the control thread at the end of each block
+    std::atomic<int> publishedNumSlices{0};
+    std::atomic<int> publishedNumVoices{1};
+    std::atomic<int> publishedRecordedLength{0};
+    std::atomic<int64_t> publishedFrames{0};
+
+    // Audio-thread copies of the structural parameters
+    float scanValue;
+    float gateThresholdKnob;  // Renamed from minSliceTimeKnob
+
+    // LENGTH/SCAN values the current slice table was requested for
+    float lastSliceLength = -1.0f;
+    float lastScanForSlicing = -1.0f;
+
+    // Modulation CV sources: set_mod_cv() or a CallbackChain, read once per block
+    std::atomic<float> modCv[ModulationEngine::NUM_CV] = {};
+    float blockModCv[ModulationEngine::NUM_CV] = {};
+    uint32_t modTargetMask = 0;  // Bit per ModulationEngine::Target with a route
+
+    // Fixed grain / chaos settings
+    bool grainChaosMod = true;   // 固定 on
+    float grainPosition = 0.5f;  // Shift parameter, 固定 50% = 0.5
+
+    // Ramped parameters (ramp lengths in samples)
+    int paramRampSamples;
+    int delayTimeRampSamples;
+    LinearRamp mixRamp, feedbackRamp, speedRamp;
+    LinearRamp eqLowRamp, eqMidRamp, eqHighRamp;
+    LinearRamp delayTimeLRamp, delayTimeRRamp, delayFeedbackRamp, delayWetRamp;
+    LinearRamp reverbRoomRamp, reverbDampingRamp, reverbDecayRamp, reverbWetRamp;
+    LinearRamp grainWetRamp;
+
+    // EQ gains the filter coefficients were last computed for (NaN forces the first update)
+    float appliedEqLowDb = NAN;
+    float appliedEqMidDb = NAN;
+    float appliedEqHighDb = NAN;
+
+    // Pipeline scratch buffers (one chunk of up to MAX_BLOCK_SIZE samples)
+    float inputBuffer[MAX_BLOCK_SIZE];
+    float stageL[MAX_BLOCK_SIZE];
+    float stageR[MAX_BLOCK_SIZE];
+    float chaosBuffer[MAX_BLOCK_SIZE];
+    float modBuffer[ModulationEngine::NUM_TARGETS][MAX_BLOCK_SIZE];  // Routed target offsets
+    float zeroLane[MAX_BLOCK_SIZE] = {};  // Stands in for targets without a route
+    float effectL[MAX_BLOCK_SIZE];   // Wet output of the current effect stage
+    float effectR[MAX_BLOCK_SIZE];
+    float speedBuffer[MAX_BLOCK_SIZE];  // Per-sample SPEED for the voice kernel
+    float delaySamplesL[MAX_BLOCK_SIZE];  // Per-sample modulated delay times (samples)
+    float delaySamplesR[MAX_BLOCK_SIZE];
+    float delayFeedbackBuffer[MAX_BLOCK_SIZE];
+
+    // Set when a stage has been bypassed and its state must be cleared on resume
+    bool eqBypassed = false;  // Tail has settled, state cleared
+    bool delayNeedsReset = false;
+    bool grainNeedsReset = false;
+    bool reverbNeedsReset = false;
+
+    // ========================================================================
+    // Parameter snapshot handling
+    // ========================================================================
+
+    // Stage timing; compiles to nothing with ALIEN4_NO_STATS. FEEDBACK
+    // chunks are left untimed: their effect stages interleave sample by
+    // sample. stage_frames counts what was timed.
+    void beginStageTiming(int n, bool timed) {
+#ifndef ALIEN4_NO_STATS
+        stageTimed = timed;
+        if (stageTimed) {
+            stats.addStageFrames(static_cast<uint64_t>(n));
+            stageMark = std::chrono::steady_clock::now();
+        }
+#else
+        (void)n;
+        (void)timed;
+#endif
+    }
+
+    void markStage(StatStage stage) {
+#ifndef ALIEN4_NO_STATS
+        if (!stageTimed) return;
+        const auto now = std::chrono::steady_clock::now();
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - stageMark).count();
+        stats.addStage(stage, static_cast<uint64_t>(ns));
+        stageMark = now;
+#else
+        (void)stage;
+#endif
+    }
+
+    // Audio thread, under loopStateMutex: everything save_loop() snapshots,
+    // i.e. cleared or replaced loops, loads and re-slicing
+    void updateLoopState() {
+        if (loopClearPending) {
+            applyLoopClear();
+        }
+
+        // A stopped take becomes the loop once all of it is in tempBuffer
+        if (finishedTakeLength >= 0 && (!takeHeld || claimTakeBuffer())) {
+            finishTake();
+        }
+
+        // Switch to a loop posted by load_loop(). After the parameters, so a
+        // POLY change sent along with the load does not scatter its voices.
+        if (LoopImage* image = pendingLoop.exchange(nullptr)) {
+            adoptLoop(image);
+        }
+
+        // Check if LENGTH or SCAN changed (both affect slicing)
+        float sliceLength = getSliceLength();
+
+        // Track LENGTH changes separately (don't trigger redistribution)
+        bool lengthChanged = std::abs(sliceLength - lastSliceLength) > 0.0001f;
+        // Track SCAN changes separately (do trigger redistribution for Seq1 control)
+        bool scanChanged = std::abs(scanValue - lastScanForSlicing) > 0.001f;
+
+        if (!isRecording && recordedLength > 0 && (lengthChanged || scanChanged)) {
+            logEvent(EngineEventType::SLICES_REQUESTED, 0, 0, sliceLength, scanValue);
+            // Only SCAN triggers redistribution (for Seq1 control), not LENGTH
+            requestSlices(sliceLength, scanChanged);
+            lastSliceLength = sliceLength;
+            lastScanForSlicing = scanValue;
+        }
+
+        // Adopt a slice table finished by the background scanner
+        SliceTable* table = sliceScanner.poll();
+        while (table == nullptr && synchronousSlicing && sliceScanner.pending()) {
+            std::this_thread::yield();
+            table = sliceScanner.poll();
+        }
+        if (table != nullptr) {
+            adoptSlices(*table);
+        }
+
+        // Playheads at the start of this block, for save_loop()
+        LoopPlayState& play = savedPlayState;
+        play.currentSliceIndex = currentSliceIndex;
+        play.playbackPosition = playbackPosition;
+        play.playbackPhase = playbackPhase;
+        for (int v = 0; v < VoiceBank::MAX_VOICES; v++) {
+            play.voiceSlice[v] = voices.sliceIndex[v];
+            play.voicePosition[v] = voices.position[v];
+            play.voicePhase[v] = voices.phase[v];
+            play.voiceSpeed[v] = voices.speedMultiplier[v];
+        }
+    }
+
+    // Audio thread: play a loaded loop from its saved playheads. Its slices
+    // are kept until LENGTH or SCAN change again; nothing is freed here.
+    void adoptLoop(LoopImage* image) {
+        sliceScanner.invalidate();  // A pending table would be for the old loop
+        if (loopImage != nullptr) {
+            retireLoop(loopImage);
+        }
+        loopImage = image;
+        loopBuffer.attach(image->view);
+        std::swap(loopPeaks, image->peaks);
+        slices.swap(image->slices);
+        slicesChanged = true;
+        recordedLength = image->length;
+
+        const LoopPlayState& play = image->play;
+        currentSliceIndex = play.currentSliceIndex;
+        playbackPosition = play.playbackPosition;
+        playbackPhase = play.playbackPhase;
+        lastAmplitude = 0.0f;
+        for (int v = 0; v < VoiceBank::MAX_VOICES; v++) {
+            voices.reset(v, play.voiceSlice[v], play.voicePosition[v], play.voiceSpeed[v]);
+            voices.phase[v] = play.voicePhase[v];
+        }
+        voices.updateBounds(slices, recordedLength);
+
+        lastSliceLength = getSliceLength();
+        lastScanForSlicing = scanValue;
+        lastScanTargetIndex = -1;
+        logEvent(EngineEventType::LOOP_LOADED, recordedLength, static_cast<int32_t>(slices.size()));
+    }
+
+    // Audio thread: hand a loop no longer played to the control thread,
+    // which frees it once the slice scanner has let go of it
+    void retireLoop(LoopImage* image) {
+        sliceScanner.release(image->view.data);
+        image->nextRetired = retiredLoops.load(std::memory_order_relaxed);
+        while (!retiredLoops.compare_exchange_weak(image->nextRetired, image,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed)) {
+        }
+    }
+
+    // Control thread: free retired loops (unmaps their files)
+    void reclaimRetiredLoops() {
+        std::lock_guard<std::mutex> lock(reclaimMutex);
+        reclaimRetiredLoopsLocked();
+    }
+
+    // Same, for a caller holding reclaimMutex
+    void reclaimRetiredLoopsLocked() {
+        LoopImage* image = retiredLoops.exchange(nullptr, std::memory_order_acquire);
+        while (image != nullptr) {
+            LoopImage* next = image->nextRetired;
+            sliceScanner.waitReleased(image->view.data);  // Cancelled by retireLoop()
+            delete image;
+            image = next;
+        }
+    }
+
+    // Audio thread: record an event; compiles to nothing with ALIEN4_NO_EVENT_LOG
+    void logEvent(EngineEventType type, int32_t a = 0, int32_t b = 0, float x = 0.0f, float y = 0.0f) {
+#ifndef ALIEN4_NO_EVENT_LOG
+        eventRing.push(EngineEvent{processedFrames, type, a, b, x, y});
+#else
+        (void)type; (void)a; (void)b; (void)x; (void)y;
+#endif
+    }
+
+    static const char* eventTypeName(EngineEventType type) {
+        switch (type) {
+            case EngineEventType::RECORDING_STOPPED: return "recording_stopped";
+            case EngineEventType::SLICES_REQUESTED:  return "slices_requested";
+            case EngineEventType::SLICES_READY:      return "slices_ready";
+            case EngineEventType::POLY_CHANGED:      return "poly_changed";
+            case EngineEventType::LOOP_LOADED:       return "loop_loaded";
+        }
+        return "unknown";
+    }
+
+    std::string formatEvent(const EngineEvent& e) const {
+        std::ostringstream msg;
+        switch (e.type) {
+            case EngineEventType::RECORDING_STOPPED:
+                msg << "Recording stopped: length=" << e.a
+                    << " samples (" << e.a / sampleRate << "s)";
+                break;
+            case EngineEventType::SLICES_REQUESTED:
+                msg << "Generating slices: length=" << e.x << "s, scan=" << e.y;
+                break;
+            case EngineEventType::SLICES_READY:
+                msg << "Slices ready: sliceLength=" << e.x << "s, scan=" << e.y
+                    << " (offset=" << e.b << " samples), found " << e.a << " slices";
+                break;
+            case EngineEventType::POLY_CHANGED:
+                msg << "POLY changed: " << e.a << " -> " << e.b;
+                break;
+            case EngineEventType::LOOP_LOADED:
+                msg << "Loop loaded: length=" << e.a << " samples ("
+                    << e.a / sampleRate << "s), " << e.b << " slices";
+                break;
+        }
+        return msg.str();
+    }
+
+    // Control thread: hand the current control state to the audio thread
+    void publishParams() {
+        paramMailbox.publish(controlParams);
+    }
+
+    // Audio thread: report state for the get_* queries
+    void publishStatus() {
+        publishedNumSlices.store(static_cast<int>(slices.size()), std::memory_order_relaxed);
+        publishedNumVoices.store(numVoices, std::memory_order_relaxed);
+        publishedRecordedLength.store(recordedLength, std::memory_order_relaxed);
+        publishedFrames.store(processedFrames, std::memory_order_relaxed);
+
+        WaveformState& waveform = waveformMailbox.back();
+        waveform.loopPeaks = loopPeaks.get();
+        waveform.loopLength = loopClearPending ? 0 : recordedLength;
+        const bool takeVisible = isRecording && !takeHeld;
+        waveform.takePeaks = takeVisible ? tempPeaks.get() : nullptr;
+        waveform.takeLength = takeVisible ? tempPeaks->size() : 0;
+        waveform.currentSlice = currentSliceIndex;
+        waveform.numPlayheads = waveform.loopLength <= 0 ? 0 : numVoices;
+        for (int v = 0; v < waveform.numPlayheads; v++) {
+            waveform.playheads[v] = numVoices > 1 ? voices.position[v] : playbackPosition;
+        }
+        waveform.generation = waveformGeneration.load(std::memory_order_relaxed);
+        waveformMailbox.publishBack();
+
+        // Slots have room for any scanner table, so this never allocates
+        if (slicesChanged) {
+            std::vector<SliceBounds>& mirror = sliceMirror.back();
+            mirror.clear();
+            const size_t count = std::min(slices.size(), mirror.capacity());
+            for (size_t i = 0; i < count; i++) {
+                mirror.push_back(SliceBounds{slices[i].startSample, slices[i].endSample});
+            }
+            sliceMirror.publishBack();
+            slicesChanged = false;
+        }
+    }
+
+    // Audio thread: apply a new snapshot at the start of a block
+    void applyParams(const EngineParams& next) {
+        if (next.clearCount != params.clearCount) {
+            clearState();
+        }
+
+        isLooping = next.looping;
+        scanValue = next.scan;
+        gateThresholdKnob = next.gateThreshold;
+
+        mixRamp.setTarget(next.mix, paramRampSamples);
+        feedbackRamp.setTarget(next.feedback, paramRampSamples);
+        speedRamp.setTarget(next.speed, paramRampSamples);
+        eqLowRamp.setTarget(next.eqLowDb, paramRampSamples);
+        eqMidRamp.setTarget(next.eqMidDb, paramRampSamples);
+        eqHighRamp.setTarget(next.eqHighDb, paramRampSamples);
+        delayTimeLRamp.setTarget(next.delayTimeL, delayTimeRampSamples);
+        delayTimeRRamp.setTarget(next.delayTimeR, delayTimeRampSamples);
+        delayFeedbackRamp.setTarget(next.delayFeedback, paramRampSamples);
+        delayWetRamp.setTarget(next.delayWet, paramRampSamples);
+        reverbRoomRamp.setTarget(next.reverbRoom, paramRampSamples);
+        reverbDampingRamp.setTarget(next.reverbDamping, paramRampSamples);
+        reverbDecayRamp.setTarget(next.reverbDecay, paramRampSamples);
+        reverbWetRamp.setTarget(next.reverbWet, paramRampSamples);
+        grainWetRamp.setTarget(next.grainWetDry, paramRampSamples);
+
+        modTargetMask = 0;
+        for (int t = 0; t < ModulationEngine::NUM_TARGETS; t++) {
+            for (int src = 0; src < ModulationEngine::NUM_SOURCES; src++) {
+                if (next.modDepth[src][t] != 0.0f) modTargetMask |= 1u << t;
+            }
+        }
+        // A longer interval left over must not delay the first tick at the new rate
+        modulation.countdown = std::min(modulation.countdown, next.controlInterval);
+
+        if (next.recording != isRecording) {
+            if (next.recording) {
+                startRecording();
+            } else {
+                stopRecording();
+            }
+        }
+
+        if (next.polyVoices != numVoices) {
+            applyPoly(next.polyVoices);
+        }
+
+        params = next;
+    }
+
+    // Nothing is cleared here: a take only ever reads back what it recorded.
+    // Capture starts now; the buffer is set up by the first recordTake() that
+    // finds it free. A stopped take still waiting to become the loop (only
+    // while save_loop() held the loop lock for both blocks in between) is
+    // dropped for the new one.
+    void startRecording() {
+        finishedTakeLength = -1;
+        tempSlices.clear();
+        tempRecordPosition = 0;
+        tempRecordedLength = 0;
+        tempLastAmplitude = 0.0f;
+        takeHeld = true;
+        backlogLength = 0;
+        isRecording = true;
+    }
+
+    // Stop recording: the length is final now, finishTake() swaps the take in
+    void stopRecording() {
+        logEvent(EngineEventType::RECORDING_STOPPED, tempRecordedLength);
+        finishedTakeLength = tempRecordedLength;
+        isRecording = false;
+    }
+
+    // Under loopStateMutex: make the finished take the loop
+    void finishTake() {
+        // Swap temp and main (O(1)); the old loop becomes the next take's buffer
+        loopBuffer.swap(tempBuffer);
+        std::swap(loopPeaks, tempPeaks);
+        std::swap(loopImage, tempImage);
+        recordedLength = finishedTakeLength;
+        finishedTakeLength = -1;
+
+        // Generate fixed-length slices based on current LENGTH parameter.
+        // Until the scanner delivers them, playback runs over the whole take.
+        float sliceLength = getSliceLength();
+        logEvent(EngineEventType::SLICES_REQUESTED, 0, 0, sliceLength, scanValue);
+        slices.clear();
+        slicesChanged = true;
+        requestSlices(sliceLength, numVoices > 1);
+        playbackPosition = 0;
+        playbackPhase = 0.0f;
+        currentSliceIndex = 0;
+        lastAmplitude = 0.0f;
+
+        // Reset voices
+        for (int v = 0; v < VoiceBank::MAX_VOICES; v++) {
+            voices.reset(v, 0, 0, 1.0f);
+        }
+        voices.updateBounds(slices, recordedLength);
+    }
+
+    // Record input into the take. While tempBuffer is still being read
+    // (save_loop() copying the loop that was swapped out, or a superseded
+    // scan of it that has not bailed out yet) or holds a take
+    // waiting to become the loop, the input is kept in recordBacklog instead
+    // and written out once the buffer is free; the take's timing is never
+    // shifted. Beyond RECORD_BACKLOG_SECONDS of waiting it records silence.
+    void recordTake(const float* input, int n) {
+        if (!isRecording || tempRecordPosition >= loopCapacity) return;
+        const int count = std::min(n, loopCapacity - tempRecordPosition);
+        if (takeHeld && !claimTakeBuffer()) {
+            const int kept = std::max(0, std::min(count, static_cast<int>(recordBacklog.size()) - backlogLength));
+            std::copy(input, input + kept, recordBacklog.data() + backlogLength);
+            backlogLength += kept;
+        } else {
+            tempBuffer.write(tempRecordPosition, input, count);
+            tempPeaks->append(tempBuffer.view(), tempRecordPosition, count);
+        }
+        tempRecordPosition += count;
+        tempRecordedLength = tempRecordPosition;
+    }
+
+    // Set tempBuffer up for the held take and write out its backlog, if
+    // nothing reads the buffer any more; returns whether it did
+    bool claimTakeBuffer() {
+        // Cancel a scan of the old loop first: it bails out within a slice
+        sliceScanner.release(tempBuffer.data());
+        sliceScanner.release(tempBuffer.storageData());
+        if (bufferInUse(tempBuffer.data()) || bufferInUse(tempBuffer.storageData())) return false;
+
+        if (tempImage != nullptr) {
+            // The take goes to the buffer's own storage, the loaded loop is done
+            tempBuffer.detach();
+            retireLoop(tempImage);
+            tempImage = nullptr;
+        }
+        // get_waveform_overview() may still be reading the pyramid as the loop
+        waveformGeneration.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        tempPeaks->reset();
+
+        // [0, backlogLength) waited in the backlog, the rest of the wait is silence
+        int written = 0;
+        while (written < tempRecordPosition) {
+            const bool backlog = written < backlogLength;
+            const int count = backlog ? backlogLength - written
+                                      : std::min(tempRecordPosition - written, MAX_BLOCK_SIZE);
+            tempBuffer.write(written, backlog ? recordBacklog.data() + written : silenceBlock, count);
+            tempPeaks->append(tempBuffer.view(), written, count);
+            written += count;
+        }
+        backlogLength = 0;
+        takeHeld = false;
+        return true;
+    }
+
+    // Whether save_loop() or a cancelled slice scan (until it bails out)
+    // still reads loop samples at data
+    bool bufferInUse(const void* data) const {
+        return data != nullptr && (savingLoop.load() == data || sliceScanner.reading(data));
+    }
+
+    // Buffers are not zeroed: nothing past recordedLength is ever read. The
+    // loop goes silent now and is dropped by applyLoopClear() under the lock.
+    void clearState() {
+        sliceScanner.invalidate();
+        loopClearPending = true;
+        tempSlices.clear();
+        playbackPosition = 0;
+        playbackPhase = 0.0f;
+        currentSliceIndex = 0;
+        lastAmplitude = 0.0f;
+        lastScanTargetIndex = -1;
+        tempRecordPosition = 0;
+        tempRecordedLength = 0;
+        tempLastAmplitude = 0.0f;
+        backlogLength = 0;
+        finishedTakeLength = -1;
+        lastOutputL = 0.0f;
+        lastOutputR = 0.0f;
+
+        delay.reset();
+        reverb.reset();
+
+        // Reset Chaos and Grain processors
+        modulation.reset();
+        leftGrainProcessor.reset();
+        rightGrainProcessor.reset();
+
+        // Reset EQ filters
+        eq.reset();
+
+        eqBypassed = false;
+        delayNeedsReset = false;
+        grainNeedsReset = false;
+        reverbNeedsReset = false;
+    }
+
+    // Under loopStateMutex: the part of clearState() save_loop() could be reading
+    void applyLoopClear() {
+        slices.clear();
+        slicesChanged = true;
+        recordedLength = 0;
+        voices.updateBounds(slices, 0);
+        playbackPosition = 0;
+        playbackPhase = 0.0f;
+        currentSliceIndex = 0;
+        loopClearPending = false;
+    }
+
+    void applyPoly(int newVoices) {
+        logEvent(EngineEventType::POLY_CHANGED, numVoices, newVoices);
+        numVoices = newVoices;
+        voices.setVoiceCount(numVoices);
+
+        // Initialize all voices
+        for (int i = 0; i < VoiceBank::MAX_VOICES; i++) {
+            voices.reset(i, currentSliceIndex, playbackPosition, 1.0f);
+        }
+
+        if (!slices.empty() && numVoices > 1) {
+            // Redistribute voices to random slices
+            redistributeVoices();
+        } else if (slices.empty() && numVoices > 1 && recordedLength > 0) {
+            // No slices but have recording: distribute voices evenly across buffer
+            std::uniform_real_distribution<float> speedDist(-2.0f, 2.0f);
+            for (int i = 1; i < numVoices; i++) {
+                voices.reset(i, voices.sliceIndex[i], (recordedLength * i) / numVoices,
+                             speedDist(randomEngine));
+            }
+        }
+        voices.updateBounds(slices, recordedLength);
+    }
+
+    // ========================================================================
+    // Pipeline stages (each works on a whole chunk of up to MAX_BLOCK_SIZE)
+    // ========================================================================
+
+    // The whole pipeline for one chunk, specialised on engine state that only
+    // changes between blocks, so dead stages and per-sample tests compile out
+    using ChunkKernel = void (AudioEngine::*)(const float*, int);
+
+    template<bool Poly, bool Modulation, bool Grain, bool Reverb>
+    void processChunk(const float* input, int n) {
+        processLooperStage<Poly>(input, stageL, stageR, n);
+        feedbackRamp.advance(n);  // Silent: otherwise the block runs processFeedbackChunk()
+        markStage(STAGE_LOOPER);
+        processEqStage(stageL, stageR, n);
+        markStage(STAGE_EQ);
+        if constexpr (Modulation) {
+            processModulationStage(chaosBuffer, n);
+            markStage(STAGE_CHAOS);
+        }
+        processDelayStage(stageL, stageR, chaosBuffer, n);
+        markStage(STAGE_DELAY);
+        if constexpr (Grain) {
+            processGrainStage(stageL, stageR, chaosBuffer, n);
+            markStage(STAGE_GRAIN);
+        } else {
+            grainNeedsReset = true;
+        }
+        if constexpr (Reverb) {
+            processReverbStage(stageL, stageR, chaosBuffer, n);
+            markStage(STAGE_REVERB);
+        } else {
+            reverbRoomRamp.advance(n);
+            reverbDampingRamp.advance(n);
+            reverbDecayRamp.advance(n);
+            reverbNeedsReset = true;
+        }
+    }
+
+    // FEEDBACK adds each output sample back into the next one's loop mix,
+    // so past the looper the pipeline has to run sample by sample. What
+    // does not depend on the output - recording, loop playback, the chaos
+    // and modulation lanes, delay times, EQ coefficients and reverb
+    // settings - is still done for the whole chunk; the per-sample loop
+    // then calls the filters directly with lastOutput kept in registers.
+    template<bool Poly, bool Modulation, bool Grain, bool Reverb>
+    void processFeedbackChunk(const float* input, int n) {
+        processLooperStage<Poly>(input, stageL, stageR, n);
+        if constexpr (Modulation) {
+            processModulationStage(chaosBuffer, n);
+        }
+
+        const bool eqActive = prepareEqStage(n);
+        const DelayPath delayPath = prepareDelayStage(chaosBuffer, n);
+        const float sr = static_cast<float>(sampleRate);
+        const float fixedDelayL = delayTimeLRamp.value * sr;
+        const float fixedDelayR = delayTimeRRamp.value * sr;
+        const float fixedFeedback = delayFeedbackRamp.value;
+
+        bool grainActive = false;
+        if constexpr (Grain) {
+            grainActive = prepareGrainStage();
+        } else {
+            grainNeedsReset = true;
+        }
+        const float* densityMod = modulationFor(ModulationEngine::TARGET_GRAIN_DENSITY);
+        const float* positionMod = modulationFor(ModulationEngine::TARGET_GRAIN_POSITION);
+
+        ReverbSettings reverbSettings{};
+        bool reverbActive = false;
+        if constexpr (Reverb) {
+            reverbActive = prepareReverbStage(n, reverbSettings);
+        } else {
+            reverbRoomRamp.advance(n);
+            reverbDampingRamp.advance(n);
+            reverbDecayRamp.advance(n);
+            reverbNeedsReset = true;
+        }
+
+        float outL = lastOutputL;
+        float outR = lastOutputR;
+        for (int i = 0; i < n; i++) {
+            // FEEDBACK (with 0.8x safety scaling) of the previous output sample
+            float feedback = feedbackRamp.next();
+            float l = stageL[i] + softClip(outL * 0.3f) / 0.3f * feedback * 0.8f;
+            float r = stageR[i] + softClip(outR * 0.3f) / 0.3f * feedback * 0.8f;
+
+            if (eqActive) {
+                eq.processFrame(l, r);
+            }
+
+            if (delayPath != DelayPath::BYPASSED) {
+                float delayedL, delayedR;
+                if (delayPath == DelayPath::FIXED) {
+                    delay.processFixed(&l, &r, &delayedL, &delayedR, 1,
+                                       fixedDelayL, fixedDelayR, fixedFeedback);
+                } else {
+                    delay.process(&l, &r, &delayedL, &delayedR, 1,
+                                  delaySamplesL + i, delaySamplesR + i, delayFeedbackBuffer + i);
+                }
+                float delayWet = delayWetRamp.next();
+                l = l * (1.0f - delayWet) + delayedL * delayWet;
+                r = r * (1.0f - delayWet) + delayedR * delayWet;
+            }
+
+            if constexpr (Grain) {
+                if (grainActive) {
+                    float grainL = leftGrainProcessor.process(
+                        l, params.grainSize, params.grainDensity + densityMod[i],
+                        grainPosition + positionMod[i], grainChaosMod, chaosBuffer[i], sr);
+                    float grainR = rightGrainProcessor.process(
+                        r, params.grainSize, params.grainDensity + densityMod[i],
+                        grainPosition + positionMod[i], grainChaosMod, -chaosBuffer[i], sr);
+                    float grainWetDry = grainWetRamp.next();
+                    l = l * (1.0f - grainWetDry) + grainL * grainWetDry;
+                    r = r * (1.0f - grainWetDry) + grainR * grainWetDry;
+                }
+            }
+
+            if constexpr (Reverb) {
+                if (reverbActive) {
+                    float wetL, wetR;
+                    reverb.process(&l, &r, &wetL, &wetR, chaosBuffer + i, 1,
+                                   reverbSettings.room, reverbSettings.damping,
+                                   reverbSettings.decay, params.reverbChaos, sr);
+                    float reverbWet = reverbWetRamp.next();
+                    l = l * (1.0f - reverbWet) + wetL * reverbWet;
+                    r = r * (1.0f - reverbWet) + wetR * reverbWet;
+                }
+            }
+
+            stageL[i] = outL = l;
+            stageR[i] = outR = r;
+        }
+
+        if (eqActive) {
+            eq.flushState();
+        }
+    }
+
+    static constexpr int kernelIndex(bool poly, bool modulation, bool grain, bool reverb) {
+        return (poly ? 8 : 0) | (modulation ? 4 : 0) | (grain ? 2 : 0) | (reverb ? 1 : 0);
+    }
+
+    // Pick the processChunk (or, while FEEDBACK is up, processFeedbackChunk)
+    // instantiation for the current block. Wet ramps only gain a target in
+    // applyParams(), so a silent stage or FEEDBACK stays silent for the
+    // rest of the block; the chaos generator only runs while some active
+    // stage reads it or a modulation route is set.
+    ChunkKernel selectChunkKernel() const {
+        static constexpr ChunkKernel feedbackKernels[16] = {
+            &AudioEngine::processFeedbackChunk<false, false, false, false>,
+            &AudioEngine::processFeedbackChunk<false, false, false, true>,
+            &AudioEngine::processFeedbackChunk<false, false, true, false>,
+            &AudioEngine::processFeedbackChunk<false, false, true, true>,
+            &AudioEngine::processFeedbackChunk<false, true, false, false>,
+            &AudioEngine::processFeedbackChunk<false, true, false, true>,
+            &AudioEngine::processFeedbackChunk<false, true, true, false>,
+            &AudioEngine::processFeedbackChunk<false, true, true, true>,
+            &AudioEngine::processFeedbackChunk<true, false, false, false>,
+            &AudioEngine::processFeedbackChunk<true, false, false, true>,
+            &AudioEngine::processFeedbackChunk<true, false, true, false>,
+            &AudioEngine::processFeedbackChunk<true, false, true, true>,
+            &AudioEngine::processFeedbackChunk<true, true, false, false>,
+            &AudioEngine::processFeedbackChunk<true, true, false, true>,
+            &AudioEngine::processFeedbackChunk<true, true, true, false>,
+            &AudioEngine::processFeedbackChunk<true, true, true, true>,
+        };
+        static constexpr ChunkKernel kernels[16] = {
+            &AudioEngine::processChunk<false, false, false, false>,
+            &AudioEngine::processChunk<false, false, false, true>,
+            &AudioEngine::processChunk<false, false, true, false>,
+            &AudioEngine::processChunk<false, false, true, true>,
+            &AudioEngine::processChunk<false, true, false, false>,
+            &AudioEngine::processChunk<false, true, false, true>,
+            &AudioEngine::processChunk<false, true, true, false>,
+            &AudioEngine::processChunk<false, true, true, true>,
+            &AudioEngine::processChunk<true, false, false, false>,
+            &AudioEngine::processChunk<true, false, false, true>,
+            &AudioEngine::processChunk<true, false, true, false>,
+            &AudioEngine::processChunk<true, false, true, true>,
+            &AudioEngine::processChunk<true, true, false, false>,
+            &AudioEngine::processChunk<true, true, false, true>,
+            &AudioEngine::processChunk<true, true, true, false>,
+            &AudioEngine::processChunk<true, true, true, true>,
+        };
+
+        const bool poly = numVoices > 1;
+        const bool delayActive = !delayWetRamp.isSilent();
+        const bool grain = !grainWetRamp.isSilent();
+        const bool reverb = !reverbWetRamp.isSilent();
+        // Grain chaos modulation is always on, and the reverb's room taps
+        // follow the chaos signal even with REVERB CHAOS off
+        const bool modulationUsed = grain || reverb || (delayActive && params.delayChaos) ||
+                                    modTargetMask != 0;
+
+        const int index = kernelIndex(poly, modulationUsed, grain, reverb);
+        return feedbackRamp.isSilent() ? kernels[index] : feedbackKernels[index];
+    }
+
+    // Looper: record input, play back the loop against it by MIX
+    template<bool Poly>
+    void processLooperStage(const float* input, float* outL, float* outR, int n) {
+        // Recording (no slice detection during recording - done after stop)
+        recordTake(input, n);
+
+        // MIX control
+        if (mixRamp.isSilent()) {
+            // Loop is inaudible: skip playback entirely
+            std::copy(input, input + n, outL);
+            std::copy(input, input + n, outR);
+            speedRamp.advance(n);
+        } else if (recordedLength <= 0 || loopClearPending) {
+            for (int i = 0; i < n; i++) {
+                float mix = mixRamp.next();
+                outL[i] = outR[i] = input[i] * (1.0f - mix);
+            }
+            speedRamp.advance(n);
+        } else if (loopBuffer.format() == LoopFormat::INT16) {
+            renderLoop<Poly>(loopBuffer.samples<int16_t>(), input, outL, outR, n);
+        } else {
+            renderLoop<Poly>(loopBuffer.samples<float>(), input, outL, outR, n);
+        }
+    }
+
+    // Loop playback mixed against the input by MIX
+    template<bool Poly, typename Sample>
+    void renderLoop(const Sample* buffer, const float* input, float* outL, float* outR, int n) {
+        if constexpr (Poly) {
+            // All voices over the chunk in one kernel call, into the effect scratch
+            for (int i = 0; i < n; i++) speedBuffer[i] = speedRamp.next();
+            renderVoices(buffer, effectL, effectR, n);
+            for (int i = 0; i < n; i++) {
+                float mix = mixRamp.next();
+                outL[i] = input[i] * (1.0f - mix) + effectL[i] * mix;
+                outR[i] = input[i] * (1.0f - mix) + effectR[i] * mix;
+            }
+
+            // Update layer position to voice 0
+            playbackPosition = voices.position[0];
+            playbackPhase = voices.phase[0];
+            currentSliceIndex = voices.sliceIndex[0];
+        } else {
+            // Single voice mode
+            for (int i = 0; i < n; i++) {
+                float mix = mixRamp.next();
+                float loop = advanceLoopPlayhead(buffer, recordedLength, slices,
+                                                 currentSliceIndex, speedRamp.next(),
+                                                 playbackPosition, playbackPhase);
+                outL[i] = input[i] * (1.0f - mix) + loop * mix;
+                outR[i] = input[i] * (1.0f - mix) + loop * mix;
+            }
+        }
+    }
+
+    // Multiple voices mode: advance every voice over the chunk
+    void renderVoices(const float* buffer, float* outL, float* outR, int n) {
+        dspKernels().voicesF32(voices, buffer, recordedLength, speedBuffer, outL, outR, n);
+    }
+
+    void renderVoices(const int16_t* buffer, float* outL, float* outR, int n) {
+        dspKernels().voicesI16(voices, buffer, recordedLength, speedBuffer, outL, outR, n);
+    }
+
+    // 3-Band EQ - coefficients follow the gain ramps once per chunk and are
+    // only recomputed when a band's gain moved. Bypassed while all bands
+    // rest at 0 dB, where every band is an identity filter, once the tail
+    // left over from the last cut has decayed.
+    void processEqStage(float* bufL, float* bufR, int n) {
+        if (prepareEqStage(n)) {
+            dspKernels().eq(eq, bufL, bufR, n);
+        }
+    }
+
+    // Bypass test and coefficient update for a chunk; false while bypassed
+    bool prepareEqStage(int n) {
+        if (eqLowRamp.isSilent() && eqMidRamp.isSilent() && eqHighRamp.isSilent() &&
+            (eqBypassed || eq.isSettled())) {
+            if (!eqBypassed) {
+                eq.reset();
+                eqBypassed = true;
+            }
+            return false;
+        }
+        eqBypassed = false;
+
+        float lowDb = eqLowRamp.advance(n);
+        float midDb = eqMidRamp.advance(n);
+        float highDb = eqHighRamp.advance(n);
+
+        // Low: 200Hz lowshelf, Mid: 2kHz peaking, High: 8kHz highshelf
+        if (lowDb != appliedEqLowDb) {
+            eq.setBand(0, BiquadCoefficients::LOWSHELF, 200.0f / sampleRate, 0.707f,
+                       std::pow(10.0f, lowDb / 20.0f));
+            appliedEqLowDb = lowDb;
+        }
+        if (midDb != appliedEqMidDb) {
+            eq.setBand(1, BiquadCoefficients::PEAK, 2000.0f / sampleRate, 0.707f,
+                       std::pow(10.0f, midDb / 20.0f));
+            appliedEqMidDb = midDb;
+        }
+        if (highDb != appliedEqHighDb) {
+            eq.setBand(2, BiquadCoefficients::HIGHSHELF, 8000.0f / sampleRate, 0.707f,
+                       std::pow(10.0f, highDb / 20.0f));
+            appliedEqHighDb = highDb;
+        }
+        return true;
+    }
+
+    // Chaos signal shared by the delay, grain and reverb stages, plus the
+    // routed target offsets; both computed at control rate
+    void processModulationStage(float* chaosOut, int n) {
+        ModulationEngine::Inputs in;
+        in.interval = params.controlInterval;
+        // Shape ON: 1.0-10.0 range, OFF: 0.01-1.0 range
+        in.chaosRate = params.chaosShape ? 1.0f + params.chaosRate * 9.0f
+                                         : 0.01f + params.chaosRate * 0.99f;
+        in.chaosAmount = params.chaosAmount;
+        in.chaosShape = params.chaosShape;
+        in.sampleRate = static_cast<float>(sampleRate);
+        in.depth = params.modDepth;
+        in.cv = blockModCv;
+
+        float* lanes[ModulationEngine::NUM_LANES];
+        for (int t = 0; t < ModulationEngine::NUM_TARGETS; t++) lanes[t] = modBuffer[t];
+        lanes[ModulationEngine::CHAOS_LANE] = chaosOut;
+        modulation.render(lanes, modTargetMask | (1u << ModulationEngine::CHAOS_LANE), n, in);
+    }
+
+    // Offsets a target's route adds this chunk, all zero without a route
+    const float* modulationFor(ModulationEngine::Target target) const {
+        return (modTargetMask & (1u << target)) ? modBuffer[target] : zeroLane;
+    }
+
+    // Delay with chaos modulation, bypassed while DELAY WET is 0
+    void processDelayStage(float* bufL, float* bufR, const float* chaosIn, int n) {
+        const DelayPath path = prepareDelayStage(chaosIn, n);
+        if (path == DelayPath::BYPASSED) return;
+
+        if (path == DelayPath::FIXED) {
+            const float sr = static_cast<float>(sampleRate);
+            delay.processFixed(bufL, bufR, effectL, effectR, n,
+                               delayTimeLRamp.value * sr, delayTimeRRamp.value * sr,
+                               delayFeedbackRamp.value);
+        } else {
+            delay.process(bufL, bufR, effectL, effectR, n,
+                          delaySamplesL, delaySamplesR, delayFeedbackBuffer);
+        }
+
+        // Mix delayed signals independently for each channel
+        for (int i = 0; i < n; i++) {
+            float delayWet = delayWetRamp.next();
+            bufL[i] = bufL[i] * (1.0f - delayWet) + effectL[i] * delayWet;
+            bufR[i] = bufR[i] * (1.0f - delayWet) + effectR[i] * delayWet;
+        }
+    }
+
+    enum class DelayPath {
+        BYPASSED,
+        FIXED,      // Times and feedback are constant over the chunk (the ramps' values)
+        MODULATED   // Per-sample times and feedback in delaySamplesL/R, delayFeedbackBuffer
+    };
+
+    DelayPath prepareDelayStage(const float* chaosIn, int n) {
+        if (delayWetRamp.isSilent()) {
+            delayTimeLRamp.advance(n);
+            delayTimeRRamp.advance(n);
+            delayFeedbackRamp.advance(n);
+            delayNeedsReset = true;
+            return DelayPath::BYPASSED;
+        }
+        if (delayNeedsReset) {
+            // Don't replay a stale tail from before the bypass
+            delay.reset();
+            delayNeedsReset = false;
+        }
+
+        const uint32_t delayRoutes = (1u << ModulationEngine::TARGET_DELAY_TIME) |
+                                     (1u << ModulationEngine::TARGET_DELAY_FEEDBACK);
+        if (!params.delayChaos && !(modTargetMask & delayRoutes) && !delayTimeLRamp.isRamping() &&
+            !delayTimeRRamp.isRamping() && !delayFeedbackRamp.isRamping()) {
+            return DelayPath::FIXED;
+        }
+        if (params.delayChaos) {
+            fillDelayModulation<true>(chaosIn, n);
+        } else {
+            fillDelayModulation<false>(chaosIn, n);
+        }
+        return DelayPath::MODULATED;
+    }
+
+    // Per-sample delay times (in samples) and feedback for the general delay path
+    template<bool DelayChaos>
+    void fillDelayModulation(const float* chaosIn, int n) {
+        const float sr = static_cast<float>(sampleRate);
+        const float* timeMod = modulationFor(ModulationEngine::TARGET_DELAY_TIME);
+        const float* feedbackMod = modulationFor(ModulationEngine::TARGET_DELAY_FEEDBACK);
+
+        for (int i = 0; i < n; i++) {
+            float modDelayTimeL = delayTimeLRamp.next() + timeMod[i];
+            float modDelayTimeR = delayTimeRRamp.next() + timeMod[i];
+            float modDelayFeedback = delayFeedbackRamp.next() + feedbackMod[i];
+
+            // Apply chaos modulation to delay times if enabled
+            if constexpr (DelayChaos) {
+                float chaosOutput = chaosIn[i];
+                modDelayTimeL += chaosOutput * 0.1f;
+                modDelayTimeR += chaosOutput * 0.1f;
+                modDelayFeedback += chaosOutput * 0.1f;
+            }
+            modDelayTimeL = clamp(modDelayTimeL, 0.001f, 2.0f);
+            modDelayTimeR = clamp(modDelayTimeR, 0.001f, 2.0f);
+            modDelayFeedback = clamp(modDelayFeedback, 0.0f, 0.95f);
+
+            delaySamplesL[i] = modDelayTimeL * sr;
+            delaySamplesR[i] = modDelayTimeR * sr;
+            delayFeedbackBuffer[i] = modDelayFeedback;
+        }
+    }
+
+    // Granular processing, bypassed while GRAIN WET is 0
+    void processGrainStage(float* bufL, float* bufR, const float* chaosIn, int n) {
+        if (!prepareGrainStage()) return;
+
+        const float grainSize = params.grainSize;
+        const float grainDensity = params.grainDensity;
+        const float* densityMod = modulationFor(ModulationEngine::TARGET_GRAIN_DENSITY);
+        const float* positionMod = modulationFor(ModulationEngine::TARGET_GRAIN_POSITION);
+
+        const DspKernels& kernels = dspKernels();
+        kernels.grain(leftGrainProcessor, bufL, effectL, n, grainSize, grainDensity, densityMod,
+                      grainPosition, positionMod, grainChaosMod, chaosIn, 1.0f, sampleRate);
+        kernels.grain(rightGrainProcessor, bufR, effectR, n, grainSize, grainDensity, densityMod,
+                      grainPosition, positionMod, grainChaosMod, chaosIn, -1.0f, sampleRate);
+
+        for (int i = 0; i < n; i++) {
+            float grainWetDry = grainWetRamp.next();
+
+            // Grain wet/dry mix
+            bufL[i] = bufL[i] * (1.0f - grainWetDry) + effectL[i] * grainWetDry;
+            bufR[i] = bufR[i] * (1.0f - grainWetDry) + effectR[i] * grainWetDry;
+        }
+    }
+
+    bool prepareGrainStage() {
+        if (grainWetRamp.isSilent()) {
+            grainNeedsReset = true;
+            return false;
+        }
+        if (grainNeedsReset) {
+            leftGrainProcessor.reset();
+            rightGrainProcessor.reset();
+            grainNeedsReset = false;
+        }
+        return true;
+    }
+
+    // Reverb with chaos modulation, bypassed while REVERB WET is 0
+    void processReverbStage(float* bufL, float* bufR, const float* chaosIn, int n) {
+        ReverbSettings settings;
+        if (!prepareReverbStage(n, settings)) return;
+
+        dspKernels().reverb(reverb, bufL, bufR, effectL, effectR, chaosIn, n,
+                            settings.room, settings.damping, settings.decay,
+                            params.reverbChaos, static_cast<float>(sampleRate));
+
+        for (int i = 0; i < n; i++) {
+            float reverbWet = reverbWetRamp.next();
+            bufL[i] = bufL[i] * (1.0f - reverbWet) + effectL[i] * reverbWet;
+            bufR[i] = bufR[i] * (1.0f - reverbWet) + effectR[i] * reverbWet;
+        }
+    }
+
+    struct ReverbSettings {
+        float room;
+        float damping;
+        float decay;
+    };
+
+    // Room/damping/decay for a chunk (the reverb derives its coefficients
+    // from them once per call); false while REVERB WET is 0
+    bool prepareReverbStage(int n, ReverbSettings& settings) {
+        settings.room = reverbRoomRamp.advance(n);
+        settings.damping = reverbDampingRamp.advance(n);
+        settings.decay = reverbDecayRamp.advance(n);
+
+        if (reverbWetRamp.isSilent()) {
+            reverbNeedsReset = true;
+            return false;
+        }
+        if (reverbNeedsReset) {
+            reverb.reset();
+            reverbNeedsReset = false;
+        }
+        // Routed offsets follow the chunk, like the ramps (taken at its end)
+        if (modTargetMask & (1u << ModulationEngine::TARGET_REVERB_ROOM)) {
+            settings.room = clamp(settings.room + modBuffer[ModulationEngine::TARGET_REVERB_ROOM][n - 1],
+                                  0.0f, 1.0f);
+        }
+        if (modTargetMask & (1u << ModulationEngine::TARGET_REVERB_DECAY)) {
+            settings.decay = clamp(settings.decay + modBuffer[ModulationEngine::TARGET_REVERB_DECAY][n - 1],
+                                   0.0f, 1.0f);
+        }
+        return true;
+    }
+
+    // Convert LENGTH knob value (0-1) to actual slice length in seconds (0.001-5.0s)
+    // Lower values = shorter slices (more slices)
+    // Higher values = longer slices (fewer slices)
+    float getSliceLength() {
+        // Exponential mapping for better control
+        // 0.0 → 0.001s  (1ms, very short)
+        // ~0.48 → 0.5s   (500ms, medium)
+        // 1.0 → 5.0s   (5 seconds, very long)
+        return 0.001f * std::pow(5000.0f, gateThresholdKnob);
+    }
+
+    static int loopCapacityFor(double sampleRate, double maxLoopSeconds) {
+        double samples = maxLoopSeconds * sampleRate;
+        if (!(samples >= 1.0) || samples > static_cast<double>(INT32_MAX / 2)) {
+            throw std::runtime_error("max_loop_seconds must give between 1 sample and 2^30 samples");
+        }
+        return static_cast<int>(samples);
+    }
+
+    void requestSlices(float sliceLength, bool redistribute) {
+        if (recordedLength <= 0) return;
+
+        SliceJob job;
+        job.loop = loopBuffer.view();
+        job.peaks = loopPeaks.get();
+        job.length = recordedLength;
+        job.sliceLength = sliceLength;
+        job.scan = scanValue;
+        job.sampleRate = sampleRate;
+        job.redistribute = redistribute;
+        sliceScanner.request(job);
+    }
+
+    // Swap in a finished slice table; the old one goes back to the scanner
+    void adoptSlices(SliceTable& table) {
+        slices.swap(table.slices);
+        slicesChanged = true;
+        logEvent(EngineEventType::SLICES_READY, static_cast<int32_t>(slices.size()),
+                 table.scanOffset, table.sliceLength, table.scan);
+
+        if (currentSliceIndex >= static_cast<int>(slices.size())) {
+            currentSliceIndex = slices.empty() ? 0 : static_cast<int>(slices.size()) - 1;
+        }
+
+        // Ensure voice 0 is still valid
+        if (numVoices > 1 && !slices.empty()) {
+            // Keep voice 0 on a valid slice
+            voices.reset(0, currentSliceIndex, slices[currentSliceIndex].startSample,
+                         voices.speedMultiplier[0]);
+        }
 
-        tempRecordPosition = 0;
-        tempRecordedLength = 0;
-        tempLastAmplitude = 0.0f;
+        if (table.redistribute) {
+            redistributeVoices();
+        }
+        voices.updateBounds(slices, recordedLength);
+    }
 
-        lastOutputL = 0.0f;
-        lastOutputR = 0.0f;
+    void redistributeVoices() {
+        if (slices.empty() || numVoices <= 1) return;
+
+        std::uniform_int_distribution<int> sliceDist(0, slices.size() - 1);
+        std::uniform_real_distribution<float> speedDist(-4.0f, 4.0f);
+
+        for (int i = 1; i < numVoices; i++) {
+            int targetSliceIndex = sliceDist(randomEngine);
+            int attempts = 0;
+            while (attempts < 20 && (!slices[targetSliceIndex].active ||
+                   slices[targetSliceIndex].startSample >= recordedLength)) {
+                targetSliceIndex = sliceDist(randomEngine);
+                attempts++;
+            }
+
+            if (!slices[targetSliceIndex].active ||
+                slices[targetSliceIndex].startSample >= recordedLength) {
+                continue;
+            }
 
-        // Initialize EQ parameters (cut-only: 0 to -20dB)
-        eqLowDb = 0.0f;
-        eqMidDb = 0.0f;
-        eqHighDb = 0.0f;
-
-        // Initialize smoothed parameters
-        smoothMix = mixValue;
-        smoothFeedback = feedbackValue;
-        smoothSpeed = speedValue;
-        smoothEqLow = eqLowDb;
-        smoothEqMid = eqMidDb;
-        smoothEqHigh = eqHighDb;
-        smoothDelayTimeL = delayTimeL;
-        smoothDelayTimeR = delayTimeR;
-        smoothDelayFeedback = delayFeedback;
-        smoothDelayWet = delayWet;
-        smoothReverbRoom = reverbRoom;
-        smoothReverbDamping = reverbDamping;
-        smoothReverbDecay = reverbDecay;
-        smoothReverbWet = reverbWet;
+            voices.reset(i, targetSliceIndex, slices[targetSliceIndex].startSample,
+                         speedDist(randomEngine));
+        }
+        voices.updateBounds(slices, recordedLength);
     }
+};
 
-    // ========================================================================
-    // Recording control
-    // ========================================================================
-    void set_recording(bool enabled) {
-        if (enabled == isRecording) return;
-
-        if (enabled) {
-            // Start recording
-            std::fill(tempBuffer.begin(), tempBuffer.end(), 0.0f);
-            tempSlices.clear();
-            tempRecordPosition = 0;
-            tempRecordedLength = 0;
-            tempLastAmplitude = 0.0f;
-            isRecording = true;
-        } else {
-            // Stop recording: finalize
-            std::cout << "[DEBUG] Recording stopped: length=" << tempRecordedLength
-                      << " samples (" << tempRecordedLength / sampleRate << "s)" << std::endl;
+// ============================================================================
+// WorkerPool - Persistent threads for EngineGroup
+// ============================================================================
+// Workers spin briefly on a job epoch before parking on a condition
+// variable, so back-to-back audio callbacks wake them without a syscall.
+// The calling thread takes part in every job.
+class WorkerPool {
+public:
+    WorkerPool(int numWorkers, bool pinThreads) {
+        for (int i = 0; i < numWorkers; i++) {
+            threads.emplace_back(&WorkerPool::workerLoop, this, i, pinThreads);
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+            stopping = true;
+        }
+        parkCondition.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int size() const { return static_cast<int>(threads.size()); }
+
+    // Run task(i) for every i in [0, count) and return when all have finished.
+    // Not reentrant: one run() at a time.
+    void run(int count, const std::function<void(int)>& task) {
+        if (count <= 0) return;
+        if (threads.empty() || count == 1) {
+            for (int i = 0; i < count; i++) task(i);
+            return;
+        }
+
+        currentTask.store(&task, std::memory_order_relaxed);
+        taskCount.store(count, std::memory_order_relaxed);
+        pending.store(count, std::memory_order_relaxed);
+
+        // Publishing the new epoch (index 0) releases the job description above
+        uint32_t epoch = ++jobEpoch;
+        cursor.store(static_cast<uint64_t>(epoch) << 32, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+            if (parked == 0) epoch = 0;  // Nobody to wake
+        }
+        if (epoch != 0) parkCondition.notify_all();
+
+        runTasks(jobEpoch);
 
-            // Copy temp to main
-            std::copy(tempBuffer.begin(), tempBuffer.end(), loopBuffer.begin());
-            recordedLength = tempRecordedLength;
+        // Wait for in-flight tasks on the workers
+        for (int spin = 0; pending.load(std::memory_order_acquire) > 0; spin++) {
+            if (spin < SPIN_ITERATIONS) cpuRelax();
+            else std::this_thread::yield();
+        }
+    }
+
+private:
+    static constexpr int SPIN_ITERATIONS = 20000;
+
+    static void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    static uint32_t epochOf(uint64_t v) { return static_cast<uint32_t>(v >> 32); }
+
+    // Claim tasks of the given epoch until none are left
+    void runTasks(uint32_t epoch) {
+        uint64_t v = cursor.load(std::memory_order_acquire);
+        for (;;) {
+            if (epochOf(v) != epoch) return;
+            int index = static_cast<int>(v & 0xffffffffu);
+            if (index >= taskCount.load(std::memory_order_relaxed)) return;
+            if (!cursor.compare_exchange_weak(v, v + 1, std::memory_order_acq_rel)) continue;
+
+            (*currentTask.load(std::memory_order_relaxed))(index);
+            pending.fetch_sub(1, std::memory_order_acq_rel);
+            v = cursor.load(std::memory_order_acquire);
+        }
+    }
 
-            // Generate fixed-length slices based on current LENGTH parameter
-            float sliceLength = getSliceLength();
-            std::cout << "[DEBUG] Generating slices with length=" << sliceLength << "s" << std::endl;
-            rescanSlices(sliceLength);
-            playbackPosition = 0;
-            playbackPhase = 0.0f;
-            currentSliceIndex = 0;
-            lastAmplitude = 0.0f;
+    void workerLoop(int index, bool pinThreads) {
+        if (pinThreads) placeThread(index);
 
-            // Reset voices
-            for (auto& v : voices) {
-                v.sliceIndex = 0;
-                v.playbackPosition = 0;
-                v.playbackPhase = 0.0f;
-                v.speedMultiplier = 1.0f;
+        uint32_t seen = 0;
+        for (;;) {
+            uint32_t epoch = epochOf(cursor.load(std::memory_order_acquire));
+            for (int spin = 0; epoch == seen && spin < SPIN_ITERATIONS; spin++) {
+                cpuRelax();
+                epoch = epochOf(cursor.load(std::memory_order_acquire));
             }
 
-            // Redistribute if poly
-            if (numVoices > 1) {
-                redistributeVoices();
+            if (epoch == seen) {
+                std::unique_lock<std::mutex> lock(parkMutex);
+                parked++;
+                parkCondition.wait(lock, [&] {
+                    return stopping || epochOf(cursor.load(std::memory_order_acquire)) != seen;
+                });
+                parked--;
+                if (stopping) return;
+                epoch = epochOf(cursor.load(std::memory_order_acquire));
             }
 
-            isRecording = false;
+            seen = epoch;
+            runTasks(epoch);
         }
     }
 
-    void set_looping(bool enabled) {
-        isLooping = enabled;
+    // Linux: pin worker i to core i + 1 (core 0 is left to the caller).
+    // macOS does not support pinning, so raise the QoS class instead.
+    static void placeThread(int index) {
+#if defined(__linux__)
+        unsigned cores = std::thread::hardware_concurrency();
+        if (cores > 1) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET((index + 1) % cores, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+#elif defined(__APPLE__)
+        (void)index;
+        pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+#else
+        (void)index;
+#endif
     }
 
-    void clear() {
-        std::fill(loopBuffer.begin(), loopBuffer.end(), 0.0f);
-        std::fill(tempBuffer.begin(), tempBuffer.end(), 0.0f);
-        slices.clear();
-        tempSlices.clear();
-        playbackPosition = 0;
-        playbackPhase = 0.0f;
-        recordedLength = 0;
-        currentSliceIndex = 0;
-        lastAmplitude = 0.0f;
-        lastScanTargetIndex = -1;
-        tempRecordPosition = 0;
-        tempRecordedLength = 0;
-        tempLastAmplitude = 0.0f;
-        lastOutputL = 0.0f;
-        lastOutputR = 0.0f;
+    std::vector<std::thread> threads;
 
-        delay.reset();
-        reverbL.reset();
-        reverbR.reset();
+    // Job description, published by the release store to cursor
+    std::atomic<const std::function<void(int)>*> currentTask{nullptr};
+    std::atomic<int> taskCount{0};
+    std::atomic<int> pending{0};
+    std::atomic<uint64_t> cursor{0};  // (epoch << 32) | next task index
+    uint32_t jobEpoch = 0;            // Caller-owned
 
-        // Reset Chaos and Grain processors
-        chaos.reset();
-        leftGrainProcessor.reset();
-        rightGrainProcessor.reset();
+    std::mutex parkMutex;
+    std::condition_variable parkCondition;
+    int parked = 0;         // Guarded by parkMutex
+    bool stopping = false;  // Guarded by parkMutex
+};
 
-        // Reset EQ filters
-        eqLowL.reset();
-        eqLowR.reset();
-        eqMidL.reset();
-        eqMidR.reset();
-        eqHighL.reset();
-        eqHighR.reset();
+// ============================================================================
+// EngineGroup - N independent engines processed in one call
+// ============================================================================
+// Audio is passed as (N, 2, frames) float32 arrays: engine n reads
+// input[n, 0] / input[n, 1] and writes output[n, 0] / output[n, 1].
+// Engines are spread over a persistent WorkerPool with the GIL released.
+class EngineGroup {
+public:
+    // num_threads < 0 picks min(count, hardware threads) - 1 workers
+    EngineGroup(int count, double sample_rate, int num_threads, bool pin_threads,
+                double max_loop_seconds = AudioEngine::DEFAULT_MAX_LOOP_SECONDS,
+                LoopFormat loop_format = LoopFormat::FLOAT32)
+        : pool(workerCount(count, num_threads), pin_threads)
+    {
+        if (count < 1) {
+            throw std::runtime_error("EngineGroup needs at least one engine");
+        }
+        for (int i = 0; i < count; i++) {
+            engines.emplace_back(new AudioEngine(sample_rate, max_loop_seconds, loop_format));
+        }
     }
 
-    // ========================================================================
-    // Slice control
-    // ========================================================================
-    void set_scan(double value) {
-        scanValue = clamp(static_cast<float>(value), 0.0f, 1.0f);
+    int size() const { return static_cast<int>(engines.size()); }
+    int num_threads() const { return pool.size() + 1; }
+
+    AudioEngine& engine(int index) {
+        if (index < 0 || index >= size()) {
+            throw py::index_error("engine index out of range");
+        }
+        return *engines[index];
     }
 
-    void set_gate_threshold(double value) {
-        gateThresholdKnob = clamp(static_cast<float>(value), 0.0f, 1.0f);
+    py::array_t<float> process(py::array_t<float, py::array::c_style | py::array::forcecast> input) {
+        GroupBuffer in = checkGroupBuffer(input, "input", false);
+
+        py::array_t<float> output(std::vector<ssize_t>{static_cast<ssize_t>(size()), 2,
+                                                       static_cast<ssize_t>(in.frames)});
+        GroupBuffer out = checkGroupBuffer(output, "output", true);
+
+        py::gil_scoped_release release;
+        processAll(in, out);
+        return output;
     }
 
-    void set_poly(int voices_count) {
-        int newVoices = clamp(voices_count, 1, 8);
-        if (newVoices != numVoices) {
-            std::cout << "[DEBUG] POLY changed: " << numVoices << " -> " << newVoices
-                      << " (slices=" << slices.size() << ", recorded=" << recordedLength << ")" << std::endl;
-            numVoices = newVoices;
-            voices.resize(numVoices);
-
-            // Initialize all voices
-            for (size_t i = 0; i < voices.size(); i++) {
-                voices[i].sliceIndex = currentSliceIndex;
-                voices[i].playbackPosition = playbackPosition;
-                voices[i].playbackPhase = 0.0f;
-                voices[i].speedMultiplier = 1.0f;
-            }
-
-            if (!slices.empty() && numVoices > 1) {
-                // Redistribute voices to random slices
-                redistributeVoices();
-            } else if (slices.empty() && numVoices > 1 && recordedLength > 0) {
-                // No slices but have recording: distribute voices evenly across buffer
-                std::uniform_real_distribution<float> speedDist(-2.0f, 2.0f);
-                for (int i = 1; i < numVoices; i++) {
-                    voices[i].playbackPosition = (recordedLength * i) / numVoices;
-                    voices[i].playbackPhase = 0.0f;
-                    voices[i].speedMultiplier = speedDist(randomEngine);
-                }
+    void process_into(py::array input, py::array output) {
+        GroupBuffer in = checkGroupBuffer(input, "input", false);
+        GroupBuffer out = checkGroupBuffer(output, "output", true);
+        if (out.frames != in.frames) {
+            throw std::runtime_error("input and output must have the same shape");
+        }
+
+        py::gil_scoped_release release;
+        processAll(in, out);
+    }
+
+private:
+    // Validated view of an (N, 2, frames) float32 array; strides in floats
+    struct GroupBuffer {
+        float* ptr;
+        size_t frames;
+        ptrdiff_t engineStride;
+        ptrdiff_t channelStride;
+        ptrdiff_t frameStride;
+    };
+
+    static int workerCount(int count, int numThreads) {
+        if (numThreads < 0) {
+            int hw = static_cast<int>(std::thread::hardware_concurrency());
+            numThreads = std::max(1, std::min(count, hw));
+        }
+        return std::max(0, std::min(numThreads, count) - 1);
+    }
+
+    GroupBuffer checkGroupBuffer(py::array& arr, const char* name, bool writable) const {
+        if (!arr.dtype().is(py::dtype::of<float>())) {
+            throw std::runtime_error(std::string(name) + " must be a float32 array");
+        }
+        if (arr.ndim() != 3 || arr.shape(0) != size() || arr.shape(1) != 2) {
+            throw std::runtime_error(std::string(name) + " must have shape (" +
+                                     std::to_string(size()) + ", 2, frames)");
+        }
+        if (writable && !arr.writeable()) {
+            throw std::runtime_error(std::string(name) + " must be writable");
+        }
+
+        ptrdiff_t strides[3];
+        for (int d = 0; d < 3; d++) {
+            ssize_t strideBytes = arr.strides(d);
+            if (strideBytes % static_cast<ssize_t>(sizeof(float)) != 0) {
+                throw std::runtime_error(std::string(name) + " strides must be aligned to float32");
             }
+            strides[d] = strideBytes / static_cast<ssize_t>(sizeof(float));
         }
+
+        GroupBuffer buf;
+        buf.ptr = writable ? static_cast<float*>(arr.mutable_data())
+                           : const_cast<float*>(static_cast<const float*>(arr.data()));
+        buf.frames = static_cast<size_t>(arr.shape(2));
+        buf.engineStride = strides[0];
+        buf.channelStride = strides[1];
+        buf.frameStride = strides[2];
+        return buf;
     }
 
-    // ========================================================================
-    // Debug / Query functions
-    // ========================================================================
-    int get_num_slices() const {
-        return static_cast<int>(slices.size());
+    void processAll(const GroupBuffer& in, const GroupBuffer& out) {
+        if (in.frames == 0) return;
+        pool.run(size(), [&](int n) {
+            const float* inL = in.ptr + n * in.engineStride;
+            float* outL = out.ptr + n * out.engineStride;
+            engines[n]->processBlock(inL, inL + in.channelStride,
+                                     outL, outL + out.channelStride, in.frames,
+                                     in.frameStride, in.frameStride,
+                                     out.frameStride, out.frameStride);
+        });
     }
 
-    int get_num_voices() const {
-        return numVoices;
+    std::vector<std::unique_ptr<AudioEngine>> engines;
+    WorkerPool pool;
+};
+
+// ============================================================================
+// SharedRing - Lock-free SPSC ring of float32 records in shared memory
+// ============================================================================
+// Carries CV/scope/meter frames between processes without pickling or locks.
+// One process creates the ring under a POSIX shared memory name (and unlinks
+// the name when it goes away), the other attaches by name; exactly one side
+// pushes and exactly one side reads. Layout, in native byte order:
+//
+//   0    SharedRingHeader (192 bytes): magic, version, record size, capacity,
+//        then head, dropped and tail on their own cache lines
+//   192  capacity records of recordSize float32 each
+//
+// head counts records ever pushed, tail records ever released; both only
+// grow, and the slot of record i is i & (capacity - 1). When the ring is full
+// the producer drops the new record and counts it, so it never blocks and
+// never overwrites anything the consumer may still be reading. push() is
+// real-time safe. read() returns NumPy views straight into the ring; they stay
+// valid until the next read() or release(), which hands the slots back.
+struct SharedRingHeader {
+    static constexpr char MAGIC[8] = {'A', '4', 'R', 'I', 'N', 'G', '\0', '\0'};
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;  // floats per record
+    uint64_t capacity;    // records, a power of two
+    uint64_t reserved[5];
+    alignas(64) std::atomic<uint64_t> head;     // Written by the producer only
+    std::atomic<uint64_t> dropped;              // Records pushed into a full ring
+    alignas(64) std::atomic<uint64_t> tail;     // Written by the consumer only
+};
+static_assert(sizeof(SharedRingHeader) == 192, "SharedRing header layout changed");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "SharedRing needs address-free 64-bit atomics to work across processes");
+
+class SharedRing {
+public:
+    static constexpr int MAX_RECORD_SIZE = 1024;
+    static constexpr uint64_t MAX_CAPACITY = uint64_t(1) << 24;
+
+    // Create a new ring; fails if the name is already taken
+    static std::shared_ptr<SharedRing> create(const std::string& name, int record_size,
+                                              int64_t capacity) {
+        if (record_size < 1 || record_size > MAX_RECORD_SIZE) {
+            throw std::runtime_error("record_size must be 1-" + std::to_string(MAX_RECORD_SIZE));
+        }
+        if (capacity < 2 || static_cast<uint64_t>(capacity) > MAX_CAPACITY) {
+            throw std::runtime_error("capacity must be 2-" + std::to_string(MAX_CAPACITY));
+        }
+        uint64_t slots = 2;
+        while (slots < static_cast<uint64_t>(capacity)) slots <<= 1;
+
+        std::shared_ptr<Mapping> map =
+            Mapping::open(name, true, mappedBytes(record_size, slots));
+        SharedRingHeader* header = map->header();
+        std::memcpy(header->magic, SharedRingHeader::MAGIC, sizeof(header->magic));
+        header->version = SharedRingHeader::VERSION;
+        header->recordSize = static_cast<uint32_t>(record_size);
+        header->capacity = slots;
+        header->head.store(0, std::memory_order_relaxed);
+        header->dropped.store(0, std::memory_order_relaxed);
+        header->tail.store(0, std::memory_order_release);
+        return std::shared_ptr<SharedRing>(new SharedRing(map, name, true));
     }
 
-    int get_recorded_length() const {
-        return recordedLength;
+    // Attach to a ring another process created
+    static std::shared_ptr<SharedRing> attach(const std::string& name) {
+        std::shared_ptr<Mapping> map = Mapping::open(name, false, 0);
+        return std::shared_ptr<SharedRing>(new SharedRing(map, name, false));
     }
 
-    // ========================================================================
-    // Documenta parameters
-    // ========================================================================
-    void set_mix(double value) {
-        mixValue = clamp(static_cast<float>(value), 0.0f, 1.0f);
+    ~SharedRing() {
+        if (owner) unlink();
     }
 
-    void set_feedback(double value) {
-        // Limit to 0.8 with additional safety scaling in process()
-        feedbackValue = clamp(static_cast<float>(value), 0.0f, 0.8f);
+    SharedRing(const SharedRing&) = delete;
+    SharedRing& operator=(const SharedRing&) = delete;
+
+    const std::string& get_name() const { return name; }
+    int get_record_size() const { return recordSize; }
+    int64_t get_capacity() const { return static_cast<int64_t>(capacity); }
+    bool is_owner() const { return owner; }
+
+    uint64_t get_dropped() const {
+        return header->dropped.load(std::memory_order_relaxed);
     }
 
-    void set_speed(double value) {
-        speedValue = clamp(static_cast<float>(value), -8.0f, 8.0f);
+    // Records pushed and not yet released
+    int64_t available() const {
+        return static_cast<int64_t>(header->head.load(std::memory_order_acquire) -
+                                    header->tail.load(std::memory_order_relaxed));
     }
 
-    // ========================================================================
-    // EQ parameters (cut-only: 0 to -20dB)
-    // ========================================================================
-    void set_eq_low(double db) {
-        eqLowDb = clamp(static_cast<float>(db), -20.0f, 0.0f);
+    // Remove the name; attached processes keep their mapping
+    void unlink() {
+        if (linked) {
+#if !defined(_WIN32)
+            ::shm_unlink(name.c_str());
+#endif
+            linked = false;
+        }
     }
 
-    void set_eq_mid(double db) {
-        eqMidDb = clamp(static_cast<float>(db), -20.0f, 0.0f);
+    // ========================================================================
+    // Producer side
+    // ========================================================================
+    // Copy up to count records in; returns how many fit (real-time safe)
+    size_t pushRecords(const float* records, size_t count) {
+        const uint64_t head = header->head.load(std::memory_order_relaxed);
+        const uint64_t tail = header->tail.load(std::memory_order_acquire);
+        const size_t space = static_cast<size_t>(capacity - (head - tail));
+        const size_t n = std::min(count, space);
+
+        // At most two runs: up to the end of the ring, then from its start
+        const size_t start = static_cast<size_t>(head & (capacity - 1));
+        const size_t first = std::min(n, static_cast<size_t>(capacity) - start);
+        std::memcpy(slot(start), records, first * recordSize * sizeof(float));
+        std::memcpy(slot(0), records + first * recordSize,
+                    (n - first) * recordSize * sizeof(float));
+
+        header->head.store(head + n, std::memory_order_release);
+        if (n < count) {
+            header->dropped.fetch_add(count - n, std::memory_order_relaxed);
+        }
+        return n;
     }
 
-    void set_eq_high(double db) {
-        eqHighDb = clamp(static_cast<float>(db), -20.0f, 0.0f);
+    // One record of record_size floats, or an (n, record_size) array
+    int64_t push(py::array_t<float, py::array::c_style | py::array::forcecast> records) {
+        const bool single = records.ndim() == 1;
+        if (!(single || records.ndim() == 2) ||
+            records.shape(records.ndim() - 1) != recordSize) {
+            throw std::runtime_error("records must have shape (" + std::to_string(recordSize) +
+                                     ",) or (n, " + std::to_string(recordSize) + ")");
+        }
+        const size_t count = single ? 1 : static_cast<size_t>(records.shape(0));
+        return static_cast<int64_t>(pushRecords(records.data(), count));
     }
 
     // ========================================================================
-    // Delay parameters
+    // Consumer side
     // ========================================================================
-    void set_delay_time(double time_l, double time_r) {
-        delayTimeL = clamp(static_cast<float>(time_l), 0.001f, 2.0f);
-        delayTimeR = clamp(static_cast<float>(time_r), 0.001f, 2.0f);
+    // Hand back the records of the previous read(), then return views of up
+    // to max_records waiting ones (oldest first, all if < 0) as one or two
+    // read-only (n, record_size) arrays, two when they wrap around the end
+    py::list read(int64_t max_records) {
+        release();
+        const uint64_t tail = header->tail.load(std::memory_order_relaxed);
+        uint64_t n = header->head.load(std::memory_order_acquire) - tail;
+        if (max_records >= 0) n = std::min(n, static_cast<uint64_t>(max_records));
+        leased = n;
+
+        py::list views;
+        const size_t start = static_cast<size_t>(tail & (capacity - 1));
+        const size_t first = static_cast<size_t>(std::min<uint64_t>(n, capacity - start));
+        if (first > 0) views.append(view(start, first));
+        if (n > first) views.append(view(0, static_cast<size_t>(n - first)));
+        return views;
     }
 
-    void set_delay_feedback(double value) {
-        delayFeedback = clamp(static_cast<float>(value), 0.0f, 0.95f);
+    // Hand back the records of the last read() without reading more
+    void release() {
+        if (leased > 0) {
+            header->tail.fetch_add(leased, std::memory_order_release);
+            leased = 0;
+        }
     }
 
-    void set_delay_wet(double value) {
-        delayWet = clamp(static_cast<float>(value), 0.0f, 1.0f);
+    // Native consumers: release the last read(), then copy up to count
+    // waiting records out and hand them back at once; returns how many
+    size_t popRecords(float* records, size_t count) {
+        release();
+        const uint64_t tail = header->tail.load(std::memory_order_relaxed);
+        const uint64_t waiting = header->head.load(std::memory_order_acquire) - tail;
+        const size_t n = static_cast<size_t>(std::min<uint64_t>(waiting, count));
+
+        const size_t start = static_cast<size_t>(tail & (capacity - 1));
+        const size_t first = std::min(n, static_cast<size_t>(capacity) - start);
+        std::memcpy(records, slot(start), first * recordSize * sizeof(float));
+        std::memcpy(records + first * recordSize, slot(0),
+                    (n - first) * recordSize * sizeof(float));
+
+        header->tail.store(tail + n, std::memory_order_release);
+        return n;
     }
 
-    // ========================================================================
-    // Reverb parameters
-    // ========================================================================
-    void set_reverb_room(double value) {
-        reverbRoom = clamp(static_cast<float>(value), 0.0f, 1.0f);
+private:
+    // The shared memory itself; NumPy views hold a reference so they outlive
+    // the SharedRing object safely
+    class Mapping {
+    public:
+        static std::shared_ptr<Mapping> open(const std::string& name, bool create, size_t bytes) {
+#if !defined(_WIN32)
+            if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos) {
+                throw std::runtime_error("Shared ring name must look like \"/name\": " + name);
+            }
+            int fd = create ? ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600)
+                            : ::shm_open(name.c_str(), O_RDWR, 0);
+            if (fd < 0) {
+                throw std::runtime_error(std::string(create ? "Cannot create" : "Cannot open") +
+                                         " shared ring " + name + ": " + std::strerror(errno));
+            }
+            if (create) {
+                if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                    ::close(fd);
+                    ::shm_unlink(name.c_str());
+                    throw std::runtime_error("Cannot size shared ring " + name);
+                }
+            } else {
+                struct stat info;
+                if (::fstat(fd, &info) != 0 ||
+                    static_cast<size_t>(info.st_size) < sizeof(SharedRingHeader)) {
+                    ::close(fd);
+                    throw std::runtime_error("Not a shared ring: " + name);
+                }
+                bytes = static_cast<size_t>(info.st_size);
+            }
+            void* mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);  // The mapping keeps the memory alive
+            if (mapped == MAP_FAILED) {
+                if (create) ::shm_unlink(name.c_str());
+                throw std::runtime_error("Cannot map shared ring " + name);
+            }
+            return std::shared_ptr<Mapping>(new Mapping(mapped, bytes));
+#else
+            (void)create;
+            (void)bytes;
+            throw std::runtime_error("Shared rings need POSIX shared memory: " + name);
+#endif
+        }
+
+        ~Mapping() {
+#if !defined(_WIN32)
+            ::munmap(base, bytes);
+#endif
+        }
+
+        SharedRingHeader* header() const { return static_cast<SharedRingHeader*>(base); }
+        size_t size() const { return bytes; }
+
+    private:
+        Mapping(void* base, size_t bytes) : base(base), bytes(bytes) {}
+
+        void* base;
+        size_t bytes;
+    };
+
+    static size_t mappedBytes(int recordSize, uint64_t capacity) {
+        return sizeof(SharedRingHeader) + static_cast<size_t>(capacity) * recordSize * sizeof(float);
     }
 
-    void set_reverb_damping(double value) {
-        reverbDamping = clamp(static_cast<float>(value), 0.0f, 1.0f);
+    SharedRing(std::shared_ptr<Mapping> mapping, const std::string& name, bool owner)
+        : map(std::move(mapping)), header(map->header()), name(name), owner(owner), linked(owner)
+    {
+        if (std::memcmp(header->magic, SharedRingHeader::MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != SharedRingHeader::VERSION) {
+            throw std::runtime_error("Not a shared ring (or an incompatible version): " + name);
+        }
+        recordSize = static_cast<int>(header->recordSize);
+        capacity = header->capacity;
+        if (recordSize < 1 || recordSize > MAX_RECORD_SIZE || capacity < 2 ||
+            capacity > MAX_CAPACITY || (capacity & (capacity - 1)) != 0 ||
+            map->size() < mappedBytes(recordSize, capacity)) {
+            throw std::runtime_error("Corrupt shared ring header: " + name);
+        }
+        records = reinterpret_cast<float*>(reinterpret_cast<char*>(header) + sizeof(SharedRingHeader));
     }
 
-    void set_reverb_decay(double value) {
-        reverbDecay = clamp(static_cast<float>(value), 0.0f, 1.0f);
+    float* slot(size_t index) const { return records + index * recordSize; }
+
+    py::array view(size_t start, size_t count) const {
+        // The capsule keeps the mapping alive for as long as NumPy uses it
+        auto* keep = new std::shared_ptr<Mapping>(map);
+        py::capsule base(keep, [](void* p) { delete static_cast<std::shared_ptr<Mapping>*>(p); });
+        py::array_t<float> result(
+            std::vector<ssize_t>{static_cast<ssize_t>(count), static_cast<ssize_t>(recordSize)},
+            std::vector<ssize_t>{static_cast<ssize_t>(recordSize * sizeof(float)),
+                                 static_cast<ssize_t>(sizeof(float))},
+            slot(start), base);
+        result.attr("flags").attr("writeable") = false;
+        return result;
     }
 
-    void set_reverb_wet(double value) {
-        reverbWet = clamp(static_cast<float>(value), 0.0f, 1.0f);
+    std::shared_ptr<Mapping> map;
+    SharedRingHeader* header;
+    float* records;
+    std::string name;
+    int recordSize;
+    uint64_t capacity;
+    uint64_t leased = 0;  // Records handed out by the last read(), consumer only
+    bool owner;
+    bool linked;
+};
+
+// ============================================================================
+// CallbackChain - Input mixer -> AudioEngine -> CV outputs in one call
+// ============================================================================
+// Everything VAV's audio callback does around the engine, on the sound
+// card's own (frames, channels) float32 buffers: the 4-channel input mixer
+// (level, volume, pan, mute, solo, master, tanh soft clip), the ENV1-4 decay
+// envelopes and the SEQ1/SEQ2 CV outputs. Outputs 0/1 carry the engine's
+// L/R; on interfaces with at least 8 outputs 2-5 carry ENV1-4 and 6-7
+// SEQ1-2 (0-1 maps to 0-10V). Any other output channel is written silent.
+//
+// Setters follow the AudioEngine contract (one control thread, picked up at
+// the start of the next block); trigger_envelope() may come from any thread.
+// With a SharedRing attached, each block also pushes ENV1-4/SEQ1-2 records
+// (6 floats) for another process's meters and scopes. ENV1-4/SEQ1-2 are
+// also fed to the engine as modulation sources cv1-6 at the start of each block.
+
+struct ChainParams {
+    static constexpr int NUM_CHANNELS = 4;
+    static constexpr int NUM_ENVELOPES = 4;
+
+    float level[NUM_CHANNELS] = {1.0f, 1.0f, 1.0f, 1.0f};   // Input level
+    float volume[NUM_CHANNELS] = {1.0f, 1.0f, 1.0f, 1.0f};  // 0-2
+    float pan[NUM_CHANNELS] = {};                           // -1 (left) to 1 (right)
+    bool mute[NUM_CHANNELS] = {};
+    bool solo[NUM_CHANNELS] = {};
+    float masterVolume = 1.0f;
+    double decayCoeff[NUM_ENVELOPES] = {};                  // Per-sample decay multiplier
+    SharedRing* cvRing = nullptr;                           // Kept alive by CallbackChain
+    int cvRingInterval = 0;                                 // Frames per record, 0 = per block
+};
+
+// Exponential decay envelopes, retriggered to 1.0 and stopped below 0.001
+struct DecayEnvelopeBank {
+    static constexpr double STOP_LEVEL = 0.001;
+
+    double value[ChainParams::NUM_ENVELOPES] = {};
+    bool active[ChainParams::NUM_ENVELOPES] = {};
+
+    void trigger(int index) {
+        value[index] = 1.0;
+        active[index] = true;
     }
 
-    // ========================================================================
-    // Chaos control methods
-    // ========================================================================
-    void set_chaos_rate(float rate) { chaosRate = clamp(rate, 0.0f, 1.0f); }
-    void set_chaos_amount(float amount) { chaosAmount = clamp(amount, 0.0f, 1.0f); }
-    void set_chaos_shape(bool shape) { chaosShape = shape; }
-    void set_delay_chaos(bool enabled) { delayChaosMod = enabled; }
-    void set_reverb_chaos(bool enabled) { reverbChaosMod = enabled; }
+    // Render n samples of one envelope, strided like the output buffer
+    void render(int index, double coeff, float* out, size_t n, ptrdiff_t stride) {
+        double v = value[index];
+        size_t i = 0;
+        if (active[index]) {
+            for (; i < n; i++) {
+                v *= coeff;
+                if (v < STOP_LEVEL) {
+                    v = 0.0;
+                    active[index] = false;
+                    break;
+                }
+                out[i * stride] = static_cast<float>(v);
+            }
+        }
+        for (; i < n; i++) out[i * stride] = static_cast<float>(v);
+        value[index] = v;
+    }
+};
+
+class CallbackChain {
+public:
+    static constexpr int CV_FIRST_OUTPUT = 2;
+    static constexpr int CV_OUTPUTS = 6;  // ENV1-4, SEQ1-2
+    static constexpr int CV_MIN_CHANNELS = CV_FIRST_OUTPUT + CV_OUTPUTS;
+    static constexpr int SCRATCH_FRAMES = 4096;  // Frames mixed per engine call
+    static constexpr double DEFAULT_DECAY_SECONDS = 1.0;
+
+    explicit CallbackChain(AudioEngine& engine)
+        : engine(engine), sampleRate(engine.get_sample_rate()),
+          mixL(SCRATCH_FRAMES), mixR(SCRATCH_FRAMES),
+          envScratch(static_cast<size_t>(SCRATCH_FRAMES) * ChainParams::NUM_ENVELOPES),
+          cvRecords(static_cast<size_t>(SCRATCH_FRAMES) * CV_OUTPUTS)
+    {
+        for (int i = 0; i < ChainParams::NUM_ENVELOPES; i++) {
+            controlParams.decayCoeff[i] = decayCoeffFor(DEFAULT_DECAY_SECONDS);
+        }
+        params = controlParams;
+        std::fill(lastCv, lastCv + CV_OUTPUTS, 0.0f);
+    }
+
+    CallbackChain(const CallbackChain&) = delete;
+    CallbackChain& operator=(const CallbackChain&) = delete;
 
     // ========================================================================
-    // Grain control methods
+    // Mixer
     // ========================================================================
-    void set_grain_size(float size) { grainSize = clamp(size, 0.0f, 1.0f); }
-    void set_grain_density(float density) { grainDensity = clamp(density, 0.0f, 1.0f); }
-    void set_grain_wet_dry(float wet) { grainWetDry = clamp(wet, 0.0f, 1.0f); }
+    void set_channel_level(int channel, double level) {
+        controlParams.level[checkIndex(channel, ChainParams::NUM_CHANNELS, "channel")] =
+            std::max(static_cast<float>(level), 0.0f);
+        publishParams();
+    }
+
+    void set_channel_volume(int channel, double volume) {
+        controlParams.volume[checkIndex(channel, ChainParams::NUM_CHANNELS, "channel")] =
+            clamp(static_cast<float>(volume), 0.0f, 2.0f);
+        publishParams();
+    }
+
+    void set_channel_pan(int channel, double pan) {
+        controlParams.pan[checkIndex(channel, ChainParams::NUM_CHANNELS, "channel")] =
+            clamp(static_cast<float>(pan), -1.0f, 1.0f);
+        publishParams();
+    }
+
+    void set_channel_mute(int channel, bool mute) {
+        controlParams.mute[checkIndex(channel, ChainParams::NUM_CHANNELS, "channel")] = mute;
+        publishParams();
+    }
+
+    void set_channel_solo(int channel, bool solo) {
+        controlParams.solo[checkIndex(channel, ChainParams::NUM_CHANNELS, "channel")] = solo;
+        publishParams();
+    }
+
+    void set_master_volume(double volume) {
+        controlParams.masterVolume = clamp(static_cast<float>(volume), 0.0f, 2.0f);
+        publishParams();
+    }
 
     // ========================================================================
-    // Process audio
+    // Envelopes
     // ========================================================================
-    std::pair<py::array_t<float>, py::array_t<float>>
-    process(py::array_t<float> left_in, py::array_t<float> right_in) {
-        auto left_buf = left_in.request();
-        auto right_buf = right_in.request();
+    void set_envelope_decay(int index, double seconds) {
+        seconds = clamp(seconds, 0.01, 10.0);
+        controlParams.decayCoeff[checkIndex(index, ChainParams::NUM_ENVELOPES, "envelope")] =
+            decayCoeffFor(seconds);
+        publishParams();
+    }
 
-        if (left_buf.ndim != 1 || right_buf.ndim != 1) {
-            throw std::runtime_error("Input arrays must be 1-dimensional");
+    // Restart an envelope at 1.0 from the next block on
+    void trigger_envelope(int index) {
+        checkIndex(index, ChainParams::NUM_ENVELOPES, "envelope");
+        pendingTriggers.fetch_or(1u << index, std::memory_order_relaxed);
+    }
+
+    // Push ENV1-4/SEQ1-2 records into `ring` (None detaches): one per block
+    // with interval_frames 0, else one every interval_frames frames. Rings
+    // stay referenced until the chain goes away, so the audio thread never
+    // sees one freed under it.
+    void set_cv_ring(std::shared_ptr<SharedRing> ring, int interval_frames) {
+        if (ring && ring->get_record_size() != CV_OUTPUTS) {
+            throw std::runtime_error("CV ring needs records of " + std::to_string(CV_OUTPUTS) +
+                                     " floats");
+        }
+        if (interval_frames < 0) {
+            throw std::runtime_error("interval_frames must be >= 0");
         }
+        if (ring && std::find(cvRings.begin(), cvRings.end(), ring) == cvRings.end()) {
+            cvRings.push_back(ring);
+        }
+        controlParams.cvRing = ring.get();
+        controlParams.cvRingInterval = interval_frames;
+        publishParams();
+    }
 
-        size_t num_samples = left_buf.shape[0];
-        if (right_buf.shape[0] != static_cast<ssize_t>(num_samples)) {
-            throw std::runtime_error("Left and right inputs must have same length");
+    // ========================================================================
+    // Process one callback
+    //
+    // indata: (frames, inputs) float32, inputs 0-3 feed mixer channels 0-3
+    // outdata: (frames, outputs) float32, outputs >= 2, filled completely
+    // cv_values: None, or a float32 array of 6 that receives the last
+    //            ENV1-4/SEQ1-2 values of the block (for the GUI meters)
+    // seq1_to_scan: SEQ1 also sets the engine's scan and gate threshold
+    // ========================================================================
+    void process_into(py::array indata, py::array outdata, double seq1, double seq2,
+                      py::object cv_values, bool seq1_to_scan) {
+        FrameBuffer in = checkFrameBuffer(indata, "indata", false);
+        FrameBuffer out = checkFrameBuffer(outdata, "outdata", true);
+        if (in.frames != out.frames) {
+            throw std::runtime_error("indata and outdata must have the same number of frames");
+        }
+        if (out.channels < 2) {
+            throw std::runtime_error("outdata needs at least 2 channels");
         }
 
-        float* left_in_ptr = static_cast<float*>(left_buf.ptr);
-        float* right_in_ptr = static_cast<float*>(right_buf.ptr);
+        float* cvOut = nullptr;
+        if (!cv_values.is_none()) {
+            py::array cv = cv_values.cast<py::array>();
+            if (!cv.dtype().is(py::dtype::of<float>()) || cv.ndim() != 1 ||
+                cv.shape(0) < CV_OUTPUTS || !cv.writeable() ||
+                !(cv.flags() & py::array::c_style)) {
+                throw std::runtime_error("cv_values must be a writable contiguous float32 array of " +
+                                         std::to_string(CV_OUTPUTS));
+            }
+            cvOut = static_cast<float*>(cv.mutable_data());
+        }
 
-        // Allocate output
-        py::array_t<float> left_out(num_samples);
-        py::array_t<float> right_out(num_samples);
+        if (seq1_to_scan) {
+            engine.set_scan(seq1);
+            engine.set_gate_threshold(seq1);
+        }
 
-        auto left_out_buf = left_out.request();
-        auto right_out_buf = right_out.request();
+        {
+            py::gil_scoped_release release;
+            processFrames(in, out, static_cast<float>(seq1), static_cast<float>(seq2));
+        }
+        if (cvOut != nullptr) {
+            std::copy(lastCv, lastCv + CV_OUTPUTS, cvOut);
+        }
+    }
 
-        float* left_out_ptr = static_cast<float*>(left_out_buf.ptr);
-        float* right_out_ptr = static_cast<float*>(right_out_buf.ptr);
+    // Validated view of a (frames, channels) float32 array; strides in floats
+    struct FrameBuffer {
+        float* ptr;
+        size_t frames;
+        int channels;
+        ptrdiff_t frameStride;
+        ptrdiff_t channelStride;
+    };
 
-        // ====================================================================
-        // Pre-process: Check parameter changes (once per buffer, not per sample)
-        // ====================================================================
+    // Raw-buffer core (touches no Python objects, runs without the GIL)
+    void processFrames(const FrameBuffer& in, const FrameBuffer& out, float seq1, float seq2) {
+        if (paramsMailbox.consume()) {
+            params = paramsMailbox.front();
+        }
+        const uint32_t triggers = pendingTriggers.exchange(0, std::memory_order_relaxed);
+        for (int i = 0; i < ChainParams::NUM_ENVELOPES; i++) {
+            if (triggers & (1u << i)) envelopes.trigger(i);
+        }
 
-        // Check if LENGTH or SCAN changed (both affect slicing)
-        float sliceLength = getSliceLength();
-        static float lastSliceLength = -1.0f;
-        static float lastScanForSlicing = -1.0f;
+        // The same CVs are the engine's modulation sources cv1-6
+        float cv[CV_OUTPUTS];
+        for (int e = 0; e < ChainParams::NUM_ENVELOPES; e++) {
+            cv[e] = static_cast<float>(envelopes.value[e]);
+        }
+        cv[ChainParams::NUM_ENVELOPES] = seq1;
+        cv[ChainParams::NUM_ENVELOPES + 1] = seq2;
+        engine.setModulationCv(cv);
+
+        // Per-channel gains for this block (linear pan law, as mixer.py)
+        float gainL[ChainParams::NUM_CHANNELS];
+        float gainR[ChainParams::NUM_CHANNELS];
+        const bool anySolo = std::any_of(params.solo, params.solo + ChainParams::NUM_CHANNELS,
+                                         [](bool s) { return s; });
+        for (int c = 0; c < ChainParams::NUM_CHANNELS; c++) {
+            const bool audible = c < in.channels && !params.mute[c] && (!anySolo || params.solo[c]);
+            const float gain = audible ? params.level[c] * params.volume[c] * params.masterVolume
+                                       : 0.0f;
+            const float pan = params.pan[c];
+            gainL[c] = gain * (pan < 0.0f ? 1.0f : 1.0f - pan);
+            gainR[c] = gain * (pan < 0.0f ? 1.0f + pan : 1.0f);
+        }
+        const int mixChannels = std::min(in.channels, ChainParams::NUM_CHANNELS);
+
+        for (size_t offset = 0; offset < in.frames; offset += SCRATCH_FRAMES) {
+            const size_t n = std::min(static_cast<size_t>(SCRATCH_FRAMES), in.frames - offset);
+            const float* src = in.ptr + static_cast<ptrdiff_t>(offset) * in.frameStride;
+
+            // Mix -> soft clip
+            for (size_t i = 0; i < n; i++) {
+                const float* frame = src + static_cast<ptrdiff_t>(i) * in.frameStride;
+                float l = 0.0f, r = 0.0f;
+                for (int c = 0; c < mixChannels; c++) {
+                    const float x = frame[c * in.channelStride];
+                    l += x * gainL[c];
+                    r += x * gainR[c];
+                }
+                mixL[i] = softClip(l);
+                mixR[i] = softClip(r);
+            }
 
-        // Track LENGTH changes separately (don't trigger redistribution)
-        bool lengthChanged = std::abs(sliceLength - lastSliceLength) > 0.0001f;
-        // Track SCAN changes separately (do trigger redistribution for Seq1 control)
-        bool scanChanged = std::abs(scanValue - lastScanForSlicing) > 0.001f;
+            // Alien4 straight into outputs 0/1
+            float* dst = out.ptr + static_cast<ptrdiff_t>(offset) * out.frameStride;
+            engine.processBlock(mixL.data(), mixR.data(), dst, dst + out.channelStride, n,
+                                1, 1, out.frameStride, out.frameStride);
 
-        if (!isRecording && recordedLength > 0 && (lengthChanged || scanChanged)) {
-            std::cout << "[DEBUG] LENGTH or SCAN changed: length=" << sliceLength
-                      << "s, scan=" << scanValue << std::endl;
-            rescanSlices(sliceLength);
-            lastSliceLength = sliceLength;
-            lastScanForSlicing = scanValue;
+            // Envelopes keep running for the meters even without CV outputs
+            for (int e = 0; e < ChainParams::NUM_ENVELOPES; e++) {
+                envelopes.render(e, params.decayCoeff[e], envelope(e), n, 1);
+            }
 
-            // After rescan, ensure voice 0 is still valid
-            if (numVoices > 1 && !voices.empty() && !slices.empty()) {
-                // Keep voice 0 on a valid slice
-                if (currentSliceIndex >= static_cast<int>(slices.size())) {
-                    currentSliceIndex = 0;
+            // CV outputs, silence on everything else
+            const bool cvOut = out.channels >= CV_MIN_CHANNELS;
+            for (int c = CV_FIRST_OUTPUT; c < out.channels; c++) {
+                float* column = dst + c * out.channelStride;
+                const int cv = c - CV_FIRST_OUTPUT;
+                if (cvOut && cv < ChainParams::NUM_ENVELOPES) {
+                    const float* env = envelope(cv);
+                    for (size_t i = 0; i < n; i++) column[i * out.frameStride] = env[i];
+                } else {
+                    const float v = !cvOut || cv >= CV_OUTPUTS ? 0.0f
+                                  : cv == ChainParams::NUM_ENVELOPES ? seq1 : seq2;
+                    for (size_t i = 0; i < n; i++) column[i * out.frameStride] = v;
                 }
-                voices[0].sliceIndex = currentSliceIndex;
-                voices[0].playbackPosition = slices[currentSliceIndex].startSample;
-                voices[0].playbackPhase = 0.0f;
             }
 
-            // Only SCAN triggers redistribution (for Seq1 control), not LENGTH
-            if (scanChanged) {
-                redistributeVoices();
+            if (params.cvRing != nullptr && params.cvRingInterval > 0) {
+                pushCvRecords(n, seq1, seq2);
             }
         }
 
-        // Apply SCAN parameter to jump to target slice
-        if (slices.size() > 1) {
-            bool useManualScan = scanValue > 0.01f;
-
-            if (useManualScan) {
-                int targetSliceIndex = static_cast<int>(
-                    std::round(scanValue * (slices.size() - 1)));
-                targetSliceIndex = clamp(targetSliceIndex, 0,
-                                       static_cast<int>(slices.size()) - 1);
+        for (int e = 0; e < ChainParams::NUM_ENVELOPES; e++) {
+            lastCv[e] = static_cast<float>(envelopes.value[e]);
+        }
+        lastCv[ChainParams::NUM_ENVELOPES] = seq1;
+        lastCv[ChainParams::NUM_ENVELOPES + 1] = seq2;
+        if (params.cvRing != nullptr && params.cvRingInterval == 0) {
+            params.cvRing->pushRecords(lastCv, 1);
+        }
+    }
 
-                if (targetSliceIndex != lastScanTargetIndex &&
-                    slices[targetSliceIndex].active) {
-                    currentSliceIndex = targetSliceIndex;
-                    playbackPosition = slices[targetSliceIndex].startSample;
-                    playbackPhase = 0.0f;
-                    lastScanTargetIndex = targetSliceIndex;
+private:
+    float* envelope(int index) { return envScratch.data() + index * SCRATCH_FRAMES; }
+
+    // Sample the chunk's envelopes every cvRingInterval frames, carrying the
+    // phase across chunks and blocks
+    void pushCvRecords(size_t n, float seq1, float seq2) {
+        if (params.cvRingInterval != cvRingIntervalUsed) {
+            cvRingIntervalUsed = params.cvRingInterval;
+            cvRingPhase = 0;
+        }
+        size_t count = 0;
+        for (; cvRingPhase < n; cvRingPhase += static_cast<size_t>(params.cvRingInterval)) {
+            float* record = cvRecords.data() + count * CV_OUTPUTS;
+            for (int e = 0; e < ChainParams::NUM_ENVELOPES; e++) record[e] = envelope(e)[cvRingPhase];
+            record[ChainParams::NUM_ENVELOPES] = seq1;
+            record[ChainParams::NUM_ENVELOPES + 1] = seq2;
+            count++;
+        }
+        cvRingPhase -= n;
+        params.cvRing->pushRecords(cvRecords.data(), count);
+    }
 
-                    if (numVoices > 1 && !voices.empty()) {
-                        voices[0].sliceIndex = targetSliceIndex;
-                        voices[0].playbackPosition = slices[targetSliceIndex].startSample;
-                        voices[0].playbackPhase = 0.0f;
-                    }
-                }
-            } else {
-                lastScanTargetIndex = -1;
-            }
+    static int checkIndex(int index, int count, const char* what) {
+        if (index < 0 || index >= count) {
+            throw py::index_error(std::string(what) + " index out of range");
         }
+        return index;
+    }
 
-        // ====================================================================
-        // Smooth parameters (per-buffer)
-        // ====================================================================
-        const float smoothFactor = 0.2f;  // Smoothing coefficient (higher = faster response)
-        const float delayTimeSmoothFactor = 0.05f;  // Much slower for delay time to prevent clicks
-
-        smoothMix += (mixValue - smoothMix) * smoothFactor;
-        smoothFeedback += (feedbackValue - smoothFeedback) * smoothFactor;
-        smoothSpeed += (speedValue - smoothSpeed) * smoothFactor;
-        smoothEqLow += (eqLowDb - smoothEqLow) * smoothFactor;
-        smoothEqMid += (eqMidDb - smoothEqMid) * smoothFactor;
-        smoothEqHigh += (eqHighDb - smoothEqHigh) * smoothFactor;
-        smoothDelayTimeL += (delayTimeL - smoothDelayTimeL) * delayTimeSmoothFactor;
-        smoothDelayTimeR += (delayTimeR - smoothDelayTimeR) * delayTimeSmoothFactor;
-        smoothDelayFeedback += (delayFeedback - smoothDelayFeedback) * smoothFactor;
-        smoothDelayWet += (delayWet - smoothDelayWet) * smoothFactor;
-        smoothReverbRoom += (reverbRoom - smoothReverbRoom) * smoothFactor;
-        smoothReverbDamping += (reverbDamping - smoothReverbDamping) * smoothFactor;
-        smoothReverbDecay += (reverbDecay - smoothReverbDecay) * smoothFactor;
-        smoothReverbWet += (reverbWet - smoothReverbWet) * smoothFactor;
+    // After `seconds` the envelope is at 1/e of its peak
+    double decayCoeffFor(double seconds) const {
+        return std::exp(-1.0 / (seconds * sampleRate));
+    }
 
-        // ====================================================================
-        // Update EQ parameters (outside sample loop to prevent instability)
-        // ====================================================================
-        // Clamp EQ gains to safe range (cut-only: 0 to -20dB) and convert dB to linear gain
-        float clampedEqLow = clamp(smoothEqLow, -20.0f, 0.0f);
-        float clampedEqMid = clamp(smoothEqMid, -20.0f, 0.0f);
-        float clampedEqHigh = clamp(smoothEqHigh, -20.0f, 0.0f);
+    static FrameBuffer checkFrameBuffer(py::array& arr, const char* name, bool writable) {
+        if (!arr.dtype().is(py::dtype::of<float>())) {
+            throw std::runtime_error(std::string(name) + " must be a float32 array");
+        }
+        if (arr.ndim() != 2) {
+            throw std::runtime_error(std::string(name) + " must have shape (frames, channels)");
+        }
+        if (writable && !arr.writeable()) {
+            throw std::runtime_error(std::string(name) + " must be writable");
+        }
 
-        float eqLowGain = std::pow(10.0f, clampedEqLow / 20.0f);
-        float eqMidGain = std::pow(10.0f, clampedEqMid / 20.0f);
-        float eqHighGain = std::pow(10.0f, clampedEqHigh / 20.0f);
+        ptrdiff_t strides[2];
+        for (int d = 0; d < 2; d++) {
+            ssize_t strideBytes = arr.strides(d);
+            if (strideBytes % static_cast<ssize_t>(sizeof(float)) != 0) {
+                throw std::runtime_error(std::string(name) + " strides must be aligned to float32");
+            }
+            strides[d] = strideBytes / static_cast<ssize_t>(sizeof(float));
+        }
 
-        // Update filter coefficients once per buffer
-        // Low: 200Hz lowshelf, Mid: 2kHz peaking, High: 8kHz highshelf
-        eqLowL.setParameters(BiquadFilter::LOWSHELF, 200.0f / sampleRate, 0.707f, eqLowGain);
-        eqLowR.setParameters(BiquadFilter::LOWSHELF, 200.0f / sampleRate, 0.707f, eqLowGain);
-        eqMidL.setParameters(BiquadFilter::PEAK, 2000.0f / sampleRate, 0.707f, eqMidGain);
-        eqMidR.setParameters(BiquadFilter::PEAK, 2000.0f / sampleRate, 0.707f, eqMidGain);
-        eqHighL.setParameters(BiquadFilter::HIGHSHELF, 8000.0f / sampleRate, 0.707f, eqHighGain);
-        eqHighR.setParameters(BiquadFilter::HIGHSHELF, 8000.0f / sampleRate, 0.707f, eqHighGain);
+        FrameBuffer buf;
+        buf.ptr = writable ? static_cast<float*>(arr.mutable_data())
+                           : const_cast<float*>(static_cast<const float*>(arr.data()));
+        buf.frames = static_cast<size_t>(arr.shape(0));
+        buf.channels = static_cast<int>(arr.shape(1));
+        buf.frameStride = strides[0];
+        buf.channelStride = strides[1];
+        return buf;
+    }
 
-        // ====================================================================
-        // Process each sample
-        // ====================================================================
-        for (size_t i = 0; i < num_samples; i++) {
-            float input = left_in_ptr[i]; // Mono input
-
-            // Recording (no slice detection during recording - done after stop)
-            if (isRecording && tempRecordPosition < LOOP_BUFFER_SIZE) {
-                tempBuffer[tempRecordPosition] = input;
-                tempRecordedLength = tempRecordPosition + 1;
-                tempRecordPosition++;
-            }
-
-            // Playback
-            float loopL = 0.0f;
-            float loopR = 0.0f;
-
-            if (recordedLength > 0) {
-                bool isReverse = smoothSpeed < 0.0f;
-
-                if (numVoices == 1) {
-                    // Single voice mode
-                    playbackPhase += smoothSpeed;
-                    int positionDelta = static_cast<int>(playbackPhase);
-                    playbackPhase -= static_cast<float>(positionDelta);
-                    playbackPosition += positionDelta;
-
-                    // Loop current slice
-                    if (!slices.empty() && currentSliceIndex < static_cast<int>(slices.size())
-                        && slices[currentSliceIndex].active) {
-                        int sliceStart = slices[currentSliceIndex].startSample;
-                        int sliceEnd = slices[currentSliceIndex].endSample;
-
-                        if (isReverse) {
-                            if (playbackPosition < sliceStart) {
-                                playbackPosition = sliceEnd;
-                            }
-                        } else {
-                            if (playbackPosition > sliceEnd) {
-                                playbackPosition = sliceStart;
-                            }
-                        }
-                    } else {
-                        // No slices: loop entire buffer
-                        if (isReverse) {
-                            if (playbackPosition < 0) {
-                                playbackPosition = recordedLength - 1;
-                            }
-                        } else {
-                            if (playbackPosition >= recordedLength) {
-                                playbackPosition = 0;
-                            }
-                        }
-                    }
+    void publishParams() { paramsMailbox.publish(controlParams); }
 
-                    // Read with interpolation
-                    if (recordedLength > 0) {
-                        playbackPosition = clamp(playbackPosition, 0, recordedLength - 1);
-                        int pos0 = playbackPosition;
-                        int pos1 = (recordedLength > 1) ? ((pos0 + 1) % recordedLength) : pos0;
+    AudioEngine& engine;
+    double sampleRate;
 
-                        pos0 = clamp(pos0, 0, LOOP_BUFFER_SIZE - 1);
-                        pos1 = clamp(pos1, 0, LOOP_BUFFER_SIZE - 1);
+    ChainParams controlParams;  // Control thread's copy
+    ChainParams params;         // Audio thread's copy
+    TripleBuffer<ChainParams> paramsMailbox;
+    std::atomic<uint32_t> pendingTriggers{0};
 
-                        float frac = clamp(std::abs(playbackPhase), 0.0f, 1.0f);
+    DecayEnvelopeBank envelopes;
+    std::vector<float> mixL, mixR;
+    std::vector<float> envScratch;  // SCRATCH_FRAMES per envelope
+    float lastCv[CV_OUTPUTS];
 
-                        float sample = loopBuffer[pos0] * (1.0f - frac) +
-                                     loopBuffer[pos1] * frac;
-                        loopL = sample;
-                        loopR = sample;
-                    }
-                } else {
-                    // Multiple voices mode
-                    for (int v = 0; v < numVoices; v++) {
-                        float voiceSpeed = smoothSpeed * voices[v].speedMultiplier;
-                        voiceSpeed = clamp(voiceSpeed, -16.0f, 16.0f);
-                        voices[v].playbackPhase += voiceSpeed;
-
-                        int positionDelta = static_cast<int>(voices[v].playbackPhase);
-                        voices[v].playbackPhase -= static_cast<float>(positionDelta);
-                        voices[v].playbackPosition += positionDelta;
-
-                        // Loop current slice for each voice
-                        if (!slices.empty() && voices[v].sliceIndex < static_cast<int>(slices.size())
-                            && slices[voices[v].sliceIndex].active) {
-                            int sliceStart = slices[voices[v].sliceIndex].startSample;
-                            int sliceEnd = slices[voices[v].sliceIndex].endSample;
-
-                            bool voiceReverse = voiceSpeed < 0.0f;
-                            if (voiceReverse) {
-                                if (voices[v].playbackPosition < sliceStart) {
-                                    voices[v].playbackPosition = sliceEnd;
-                                }
-                            } else {
-                                if (voices[v].playbackPosition > sliceEnd) {
-                                    voices[v].playbackPosition = sliceStart;
-                                }
-                            }
-                        } else {
-                            // No valid slice: loop entire buffer
-                            bool voiceReverse = voiceSpeed < 0.0f;
-                            if (voiceReverse) {
-                                if (voices[v].playbackPosition < 0) {
-                                    voices[v].playbackPosition = recordedLength - 1;
-                                }
-                            } else {
-                                if (voices[v].playbackPosition >= recordedLength) {
-                                    voices[v].playbackPosition = 0;
-                                }
-                            }
-                        }
-
-                        // Read with interpolation
-                        if (recordedLength > 0) {
-                            voices[v].playbackPosition = clamp(voices[v].playbackPosition,
-                                                              0, recordedLength - 1);
-                            int pos0 = voices[v].playbackPosition;
-                            int pos1 = (recordedLength > 1) ? ((pos0 + 1) % recordedLength) : pos0;
-
-                            pos0 = clamp(pos0, 0, LOOP_BUFFER_SIZE - 1);
-                            pos1 = clamp(pos1, 0, LOOP_BUFFER_SIZE - 1);
-
-                            float frac = clamp(std::abs(voices[v].playbackPhase), 0.0f, 1.0f);
-
-                            float sample = loopBuffer[pos0] * (1.0f - frac) +
-                                         loopBuffer[pos1] * frac;
-
-                            if (std::isfinite(sample)) {
-                                // Fixed stereo pan distribution:
-                                // Voice 0: Center, 1: 25%L, 2: 25%R, 3: 50%L, 4: 50%R, 5: 75%L, 6: 75%R, 7: 100%L
-                                float panL, panR;
-
-                                switch(v) {
-                                    case 0: panL = 0.5f;   panR = 0.5f;   break;  // Center
-                                    case 1: panL = 0.75f;  panR = 0.25f;  break;  // 25% Left
-                                    case 2: panL = 0.25f;  panR = 0.75f;  break;  // 25% Right
-                                    case 3: panL = 1.0f;   panR = 0.0f;   break;  // 50% Left (full L)
-                                    case 4: panL = 0.0f;   panR = 1.0f;   break;  // 50% Right (full R)
-                                    case 5: panL = 0.875f; panR = 0.125f; break;  // 75% Left
-                                    case 6: panL = 0.125f; panR = 0.875f; break;  // 75% Right
-                                    case 7: panL = 1.0f;   panR = 0.0f;   break;  // 100% Left
-                                    default: panL = 0.5f;  panR = 0.5f;   break;  // Fallback: center
-                                }
-
-                                loopL += sample * panL;
-                                loopR += sample * panR;
-                            }
-                        }
-                    }
+    std::vector<std::shared_ptr<SharedRing>> cvRings;  // Every ring ever attached
+    std::vector<float> cvRecords;   // One chunk's records at interval 1
+    size_t cvRingPhase = 0;         // Frames into the chunk of the next record
+    int cvRingIntervalUsed = 0;
+};
 
-                    // Normalize by RMS energy per channel
-                    float totalEnergyL = 0.0f;
-                    float totalEnergyR = 0.0f;
-
-                    for (int v = 0; v < numVoices && v < 8; v++) {
-                        float panL, panR;
-                        switch(v) {
-                            case 0: panL = 0.5f;   panR = 0.5f;   break;
-                            case 1: panL = 0.75f;  panR = 0.25f;  break;
-                            case 2: panL = 0.25f;  panR = 0.75f;  break;
-                            case 3: panL = 1.0f;   panR = 0.0f;   break;
-                            case 4: panL = 0.0f;   panR = 1.0f;   break;
-                            case 5: panL = 0.875f; panR = 0.125f; break;
-                            case 6: panL = 0.125f; panR = 0.875f; break;
-                            case 7: panL = 1.0f;   panR = 0.0f;   break;
-                            default: panL = 0.5f;  panR = 0.5f;   break;
-                        }
-                        totalEnergyL += panL * panL;
-                        totalEnergyR += panR * panR;
-                    }
+// ============================================================================
+// Offline rendering - WAV through AudioEngine, faster than realtime
+// ============================================================================
+// Used by render_offline() and the headless tools/alien4_render CLI. Input is
+// streamed in large blocks, so memory stays flat however long the file is.
+// Renders are repeatable: engines are seeded and slice synchronously.
 
-                    if (totalEnergyL > 0.0f) loopL /= std::sqrt(totalEnergyL);
-                    if (totalEnergyR > 0.0f) loopR /= std::sqrt(totalEnergyR);
+// Streaming reader for PCM 16/24/32-bit and float32 WAV files, any channel
+// count (channels beyond the first two are ignored, mono feeds both sides)
+class WavReader {
+public:
+    explicit WavReader(const std::string& path) : file(std::fopen(path.c_str(), "rb")) {
+        if (file == nullptr) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        try {
+            parseHeader(path);
+        } catch (...) {
+            std::fclose(file);
+            throw;
+        }
+    }
 
-                    // Update layer position to voice 0
-                    if (!voices.empty()) {
-                        playbackPosition = voices[0].playbackPosition;
-                        playbackPhase = voices[0].playbackPhase;
-                        currentSliceIndex = voices[0].sliceIndex;
-                    }
-                }
-            }
+    ~WavReader() { std::fclose(file); }
 
-            // MIX control
-            float mixedL = input * (1.0f - smoothMix) + loopL * smoothMix;
-            float mixedR = input * (1.0f - smoothMix) + loopR * smoothMix;
+    WavReader(const WavReader&) = delete;
+    WavReader& operator=(const WavReader&) = delete;
 
-            // FEEDBACK (with 0.8x safety scaling)
-            float fbL = std::tanh(lastOutputL * 0.3f) / 0.3f;
-            float fbR = std::tanh(lastOutputR * 0.3f) / 0.3f;
+    double sampleRate() const { return rate; }
+    int channels() const { return numChannels; }
+    int64_t frames() const { return totalFrames; }
 
-            // Apply 0.8x scaling for additional safety margin
-            mixedL += fbL * smoothFeedback * 0.8f;
-            mixedR += fbR * smoothFeedback * 0.8f;
+    // Decode up to count frames into planar left/right; returns frames read
+    size_t read(float* left, float* right, size_t count) {
+        count = static_cast<size_t>(std::min<int64_t>(static_cast<int64_t>(count), remainingFrames));
+        if (count == 0) return 0;
 
-            // 3-Band EQ - just process, parameters are set outside loop
-            float eqL = eqLowL.process(mixedL);
-            eqL = eqMidL.process(eqL);
-            eqL = eqHighL.process(eqL);
+        raw.resize(count * frameBytes);
+        size_t got = std::fread(raw.data(), frameBytes, count, file);
+        remainingFrames = got < count ? 0 : remainingFrames - static_cast<int64_t>(got);
 
-            float eqR = eqLowR.process(mixedR);
-            eqR = eqMidR.process(eqR);
-            eqR = eqHighR.process(eqR);
+        const size_t sampleBytes = bitsPerSample / 8;
+        const size_t rightOffset = numChannels > 1 ? sampleBytes : 0;
+        for (size_t i = 0; i < got; i++) {
+            const unsigned char* frame = raw.data() + i * frameBytes;
+            left[i] = decode(frame);
+            right[i] = decode(frame + rightOffset);
+        }
+        return got;
+    }
 
-            // ================================================================
-            // Stage 1: Generate chaos signal
-            // ================================================================
-            float chaosRateValue;
-            if (chaosShape) {
-                // Shape ON: 1.0-10.0 range
-                chaosRateValue = 1.0f + chaosRate * 9.0f;
-            } else {
-                // Shape OFF: 0.01-1.0 range
-                chaosRateValue = 0.01f + chaosRate * 0.99f;
-            }
+private:
+    static uint32_t le32(const unsigned char* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
 
-            float chaosRaw = chaos.process(chaosRateValue) * chaosAmount;
+    static uint16_t le16(const unsigned char* p) {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
 
-            // Apply step function if chaosShape is true
-            static float lastStep = 0.0f;
-            static float stepPhase = 0.0f;
-            float chaosOutput;
+    void parseHeader(const std::string& path) {
+        const std::runtime_error invalid("Not a WAV file: " + path);
+        unsigned char head[12];
+        if (std::fread(head, 1, 12, file) != 12 || std::memcmp(head, "RIFF", 4) != 0 ||
+            std::memcmp(head + 8, "WAVE", 4) != 0) {
+            throw invalid;
+        }
 
-            if (chaosShape) {
-                float stepRate = chaosRateValue * 10.0f;
-                stepPhase += stepRate / sampleRate;
-                if (stepPhase >= 1.0f) {
-                    lastStep = chaosRaw;
-                    stepPhase = 0.0f;
+        bool haveFormat = false;
+        unsigned char chunk[8];
+        while (std::fread(chunk, 1, 8, file) == 8) {
+            const uint32_t size = le32(chunk + 4);
+            if (std::memcmp(chunk, "fmt ", 4) == 0) {
+                unsigned char fmt[40] = {};
+                const size_t wanted = std::min<size_t>(size, sizeof(fmt));
+                if (size < 16 || std::fread(fmt, 1, wanted, file) != wanted) throw invalid;
+                formatTag = le16(fmt);
+                numChannels = le16(fmt + 2);
+                rate = le32(fmt + 4);
+                bitsPerSample = le16(fmt + 14);
+                if (formatTag == 0xFFFE && size >= 26) {
+                    formatTag = le16(fmt + 24);  // WAVE_FORMAT_EXTENSIBLE sub-format
                 }
-                chaosOutput = lastStep;
+                skip(size - wanted + (size & 1));
+                haveFormat = true;
+            } else if (std::memcmp(chunk, "data", 4) == 0) {
+                if (!haveFormat) throw invalid;
+                const bool pcm = formatTag == 1 &&
+                                 (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+                const bool ieee = formatTag == 3 && bitsPerSample == 32;
+                if ((!pcm && !ieee) || numChannels == 0 || rate == 0) {
+                    throw std::runtime_error("Unsupported WAV format (PCM 16/24/32-bit or float32 only): " +
+                                             path);
+                }
+                frameBytes = static_cast<size_t>(numChannels) * (bitsPerSample / 8);
+                totalFrames = remainingFrames = static_cast<int64_t>(size / frameBytes);
+                return;
             } else {
-                chaosOutput = chaosRaw;
+                skip(size + (size & 1));  // Chunks are word aligned
             }
+        }
+        throw invalid;
+    }
 
-            // ================================================================
-            // Stage 2: Delay processing with chaos modulation
-            // ================================================================
-            // Apply chaos modulation to delay times if enabled
-            float modDelayTimeL = smoothDelayTimeL;
-            float modDelayTimeR = smoothDelayTimeR;
-            float modDelayFeedback = smoothDelayFeedback;
-
-            if (delayChaosMod) {
-                modDelayTimeL += chaosOutput * 0.1f;
-                modDelayTimeR += chaosOutput * 0.1f;
-                modDelayTimeL = clamp(modDelayTimeL, 0.001f, 2.0f);
-                modDelayTimeR = clamp(modDelayTimeR, 0.001f, 2.0f);
+    void skip(uint32_t bytes) {
+        if (bytes > 0 && std::fseek(file, static_cast<long>(bytes), SEEK_CUR) != 0) {
+            throw std::runtime_error("Truncated WAV file");
+        }
+    }
 
-                modDelayFeedback += chaosOutput * 0.1f;
-                modDelayFeedback = clamp(modDelayFeedback, 0.0f, 0.95f);
+    float decode(const unsigned char* p) const {
+        if (formatTag == 3) {
+            uint32_t bits = le32(p);
+            float x;
+            std::memcpy(&x, &bits, sizeof(x));
+            return x;
+        }
+        switch (bitsPerSample) {
+            case 16: return static_cast<int16_t>(le16(p)) * (1.0f / 32768.0f);
+            case 24: {
+                // Left-align into 32 bits so the sign comes along
+                uint32_t bits = (static_cast<uint32_t>(p[0]) << 8) | (static_cast<uint32_t>(p[1]) << 16) |
+                                (static_cast<uint32_t>(p[2]) << 24);
+                return static_cast<int32_t>(bits) * (1.0f / 2147483648.0f);
             }
+            default: return static_cast<int32_t>(le32(p)) * (1.0f / 2147483648.0f);
+        }
+    }
 
-            auto delayResult = delay.process(eqL, eqR, modDelayTimeL, modDelayTimeR,
-                                            modDelayFeedback, sampleRate);
-            float delayedL = delayResult.first;
-            float delayedR = delayResult.second;
-
-            // Mix delayed signals independently for each channel
-            float delayMixL = eqL * (1.0f - smoothDelayWet) + delayedL * smoothDelayWet;
-            float delayMixR = eqR * (1.0f - smoothDelayWet) + delayedR * smoothDelayWet;
+    std::FILE* file;
+    std::vector<unsigned char> raw;  // One block of undecoded frames
+    uint16_t formatTag = 0;          // 1 = PCM, 3 = IEEE float
+    uint16_t numChannels = 0;
+    uint16_t bitsPerSample = 0;
+    uint32_t rate = 0;
+    size_t frameBytes = 0;
+    int64_t totalFrames = 0;
+    int64_t remainingFrames = 0;
+};
 
-            // ================================================================
-            // Stage 3: Grain processing
-            // ================================================================
-            float leftGrainOutput = leftGrainProcessor.process(delayMixL, grainSize, grainDensity,
-                                                              grainPosition, grainChaosMod,
-                                                              chaosOutput, sampleRate);
-            float rightGrainOutput = rightGrainProcessor.process(delayMixR, grainSize, grainDensity,
-                                                                 grainPosition, grainChaosMod,
-                                                                 chaosOutput * -1.0f, sampleRate);
+// Streaming stereo WAV writer (float32 or 16-bit PCM). It writes to
+// "<path>.part" and close() fills in the header sizes and renames that over
+// path, so the output may be the file being read (an in-place render) and a
+// failed render leaves whatever was at path untouched. A writer destroyed
+// without close() deletes its partial file.
+class WavWriter {
+public:
+    WavWriter(const std::string& path, uint32_t sampleRate, bool int16)
+        : filePath(path), partPath(path + ".part"), pcm16(int16) {
+        file = std::fopen(partPath.c_str(), "wb");
+        if (file == nullptr) {
+            throw std::runtime_error("Cannot create " + partPath);
+        }
+        writeHeader(sampleRate, 0);
+    }
 
-            // Grain wet/dry mix
-            float leftStage2 = delayMixL * (1.0f - grainWetDry) + leftGrainOutput * grainWetDry;
-            float rightStage2 = delayMixR * (1.0f - grainWetDry) + rightGrainOutput * grainWetDry;
-
-            // ================================================================
-            // Stage 4: Reverb processing with chaos modulation
-            // ================================================================
-            float reverbedL = reverbL.process(leftStage2, rightStage2, grainDensity,
-                                             smoothReverbRoom, smoothReverbDamping, smoothReverbDecay,
-                                             true, reverbChaosMod, chaosOutput, sampleRate);
-            float reverbedR = reverbR.process(leftStage2, rightStage2, grainDensity,
-                                             smoothReverbRoom, smoothReverbDamping, smoothReverbDecay,
-                                             false, reverbChaosMod, chaosOutput, sampleRate);
-
-            float outputL = leftStage2 * (1.0f - smoothReverbWet) + reverbedL * smoothReverbWet;
-            float outputR = rightStage2 * (1.0f - smoothReverbWet) + reverbedR * smoothReverbWet;
+    ~WavWriter() {
+        if (file != nullptr) {
+            std::fclose(file);
+            std::remove(partPath.c_str());
+        }
+    }
 
-            // Store for feedback
-            lastOutputL = outputL;
-            lastOutputR = outputR;
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
 
-            // Output (clamp to safe range)
-            left_out_ptr[i] = clamp(outputL, -10.0f, 10.0f);
-            right_out_ptr[i] = clamp(outputR, -10.0f, 10.0f);
+    void write(const float* left, const float* right, size_t count) {
+        const size_t sampleBytes = pcm16 ? 2 : 4;
+        if (dataBytes + count * 2 * sampleBytes > MAX_DATA_BYTES) {
+            throw std::runtime_error("Output exceeds the 4 GB WAV limit: " + filePath);
+        }
+        raw.resize(count * 2 * sampleBytes);
+        unsigned char* out = raw.data();
+        for (size_t i = 0; i < count; i++) {
+            out = encode(out, left[i]);
+            out = encode(out, right[i]);
         }
+        if (std::fwrite(raw.data(), 1, raw.size(), file) != raw.size()) {
+            throw std::runtime_error("Failed to write " + filePath);
+        }
+        dataBytes += raw.size();
+    }
 
-        return std::make_pair(left_out, right_out);
+    void close() {
+        bool ok = std::fseek(file, 0, SEEK_SET) == 0;
+        if (ok) writeHeader(sampleRateHz, dataBytes);
+        ok = ok && !std::ferror(file);
+        ok = (std::fclose(file) == 0) && ok;
+        file = nullptr;
+#if defined(_WIN32)
+        // rename() does not replace an existing file there
+        if (ok) std::remove(filePath.c_str());
+#endif
+        ok = ok && std::rename(partPath.c_str(), filePath.c_str()) == 0;
+        if (!ok) {
+            std::remove(partPath.c_str());
+            throw std::runtime_error("Failed to write " + filePath);
+        }
     }
 
 private:
-    double sampleRate;
-
-    // Loop buffer
-    std::vector<float> loopBuffer;
-    int playbackPosition;
-    float playbackPhase;
-    int recordedLength;
-    int currentSliceIndex;
-    float lastAmplitude;
-    int lastScanTargetIndex;
-
-    // Temp buffer (during recording)
-    std::vector<float> tempBuffer;
-    std::vector<Slice> tempSlices;
-    int tempRecordPosition;
-    int tempRecordedLength;
-    float tempLastAmplitude;
-
-    // Slices
-    std::vector<Slice> slices;
-
-    // Polyphonic voices
-    std::vector<Voice> voices;
-    int numVoices;
-    std::default_random_engine randomEngine;
-    float lastScanValue;
-
-    // EQ filters (stereo, cut-only)
-    BiquadFilter eqLowL, eqLowR;
-    BiquadFilter eqMidL, eqMidR;
-    BiquadFilter eqHighL, eqHighR;
-
-    // Effects processors
-    DelayProcessor delay;  // Single delay processor with L/R separation
-    ReverbProcessor reverbL, reverbR;
+    static constexpr uint64_t MAX_DATA_BYTES = 0xFFFFFFFFull - 36;
 
-    // Chaos and Grain processors
-    ChaosGenerator chaos;
-    GrainProcessor leftGrainProcessor;
-    GrainProcessor rightGrainProcessor;
+    static void put32(unsigned char* p, uint32_t v) {
+        p[0] = v & 0xFF;
+        p[1] = (v >> 8) & 0xFF;
+        p[2] = (v >> 16) & 0xFF;
+        p[3] = (v >> 24) & 0xFF;
+    }
 
-    // State
-    bool isRecording;
-    bool isLooping;
+    static void put16(unsigned char* p, uint16_t v) {
+        p[0] = v & 0xFF;
+        p[1] = (v >> 8) & 0xFF;
+    }
 
-    // Feedback state
-    float lastOutputL;
-    float lastOutputR;
+    void writeHeader(uint32_t sampleRate, uint64_t bytes) {
+        sampleRateHz = sampleRate;
+        const uint16_t blockAlign = pcm16 ? 4 : 8;
+        unsigned char h[44];
+        std::memcpy(h, "RIFF", 4);
+        put32(h + 4, static_cast<uint32_t>(36 + bytes));
+        std::memcpy(h + 8, "WAVEfmt ", 8);
+        put32(h + 16, 16);
+        put16(h + 20, pcm16 ? 1 : 3);  // PCM / IEEE float
+        put16(h + 22, 2);
+        put32(h + 24, sampleRate);
+        put32(h + 28, sampleRate * blockAlign);
+        put16(h + 32, blockAlign);
+        put16(h + 34, pcm16 ? 16 : 32);
+        std::memcpy(h + 36, "data", 4);
+        put32(h + 40, static_cast<uint32_t>(bytes));
+        std::fwrite(h, 1, sizeof(h), file);
+    }
 
-    // Parameters (target values)
-    float scanValue;
-    float gateThresholdKnob;  // Renamed from minSliceTimeKnob
-    float mixValue;
-    float feedbackValue;
-    float speedValue;
-    float eqLowDb, eqMidDb, eqHighDb;  // Cut-only: 0 to -20dB
-    float delayTimeL, delayTimeR, delayFeedback, delayWet;
-    float reverbRoom, reverbDamping, reverbDecay, reverbWet;
-
-    // Chaos parameters
-    float chaosRate = 0.01f;
-    float chaosAmount = 1.0f;
-    bool chaosShape = false;  // false = smooth (0.01-1.0), true = stepped (1.0-10.0)
-    bool delayChaosMod = false;
-    bool grainChaosMod = true;   // 固定 on
-    bool reverbChaosMod = false;
+    unsigned char* encode(unsigned char* out, float x) const {
+        if (pcm16) {
+            float scaled = clamp(x, -1.0f, 1.0f) * 32767.0f;
+            int16_t v = static_cast<int16_t>(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+            put16(out, static_cast<uint16_t>(v));
+            return out + 2;
+        }
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        put32(out, bits);
+        return out + 4;
+    }
 
-    // Grain parameters
-    float grainSize = 0.3f;        // 0.0-1.0
-    float grainDensity = 0.4f;     // Break parameter
-    float grainPosition = 0.5f;    // Shift parameter, 固定 50% = 0.5
-    float grainWetDry = 0.0f;      // Dry/Wet mix
+    std::FILE* file = nullptr;
+    std::string filePath;
+    std::string partPath;  // Written until close()
+    bool pcm16;
+    uint32_t sampleRateHz = 0;
+    uint64_t dataBytes = 0;
+    std::vector<unsigned char> raw;  // One encoded block
+};
 
-    // Smoothed parameters (current values)
-    float smoothMix, smoothFeedback, smoothSpeed;
-    float smoothEqLow, smoothEqMid, smoothEqHigh;
-    float smoothDelayTimeL, smoothDelayTimeR, smoothDelayFeedback, smoothDelayWet;
-    float smoothReverbRoom, smoothReverbDamping, smoothReverbDecay, smoothReverbWet;
+// Parameter automation: one "<seconds> <parameter> <value> [value]" per line,
+// where parameter is an AudioEngine setter without its set_ prefix, e.g.
+//   0.0   recording    1
+//   4.0   recording    0
+//   4.0   delay_time   0.25 0.3
+// Blank lines and # comments are ignored; lines may come in any order.
+struct AutomationTarget {
+    const char* name;
+    int numValues;
+    void (*apply)(AudioEngine& engine, const double* values);
+};
 
-    // Convert LENGTH knob value (0-1) to actual slice length in seconds (0.001-5.0s)
-    // Lower values = shorter slices (more slices)
-    // Higher values = longer slices (fewer slices)
-    float getSliceLength() {
-        // Exponential mapping for better control
-        // 0.0 → 0.001s  (1ms, very short)
-        // ~0.48 → 0.5s   (500ms, medium)
-        // 1.0 → 5.0s   (5 seconds, very long)
-        return 0.001f * std::pow(5000.0f, gateThresholdKnob);
+inline const AutomationTarget* findAutomationTarget(const std::string& name) {
+    static const AutomationTarget targets[] = {
+        {"recording", 1, [](AudioEngine& e, const double* v) { e.set_recording(v[0] != 0.0); }},
+        {"looping", 1, [](AudioEngine& e, const double* v) { e.set_looping(v[0] != 0.0); }},
+        {"clear", 0, [](AudioEngine& e, const double*) { e.clear(); }},
+        {"scan", 1, [](AudioEngine& e, const double* v) { e.set_scan(v[0]); }},
+        {"gate_threshold", 1, [](AudioEngine& e, const double* v) { e.set_gate_threshold(v[0]); }},
+        {"poly", 1, [](AudioEngine& e, const double* v) { e.set_poly(static_cast<int>(v[0])); }},
+        {"mix", 1, [](AudioEngine& e, const double* v) { e.set_mix(v[0]); }},
+        {"feedback", 1, [](AudioEngine& e, const double* v) { e.set_feedback(v[0]); }},
+        {"speed", 1, [](AudioEngine& e, const double* v) { e.set_speed(v[0]); }},
+        {"eq_low", 1, [](AudioEngine& e, const double* v) { e.set_eq_low(v[0]); }},
+        {"eq_mid", 1, [](AudioEngine& e, const double* v) { e.set_eq_mid(v[0]); }},
+        {"eq_high", 1, [](AudioEngine& e, const double* v) { e.set_eq_high(v[0]); }},
+        {"delay_time", 2, [](AudioEngine& e, const double* v) { e.set_delay_time(v[0], v[1]); }},
+        {"delay_feedback", 1, [](AudioEngine& e, const double* v) { e.set_delay_feedback(v[0]); }},
+        {"delay_wet", 1, [](AudioEngine& e, const double* v) { e.set_delay_wet(v[0]); }},
+        {"reverb_room", 1, [](AudioEngine& e, const double* v) { e.set_reverb_room(v[0]); }},
+        {"reverb_damping", 1, [](AudioEngine& e, const double* v) { e.set_reverb_damping(v[0]); }},
+        {"reverb_decay", 1, [](AudioEngine& e, const double* v) { e.set_reverb_decay(v[0]); }},
+        {"reverb_wet", 1, [](AudioEngine& e, const double* v) { e.set_reverb_wet(v[0]); }},
+        {"chaos_rate", 1, [](AudioEngine& e, const double* v) { e.set_chaos_rate(static_cast<float>(v[0])); }},
+        {"chaos_amount", 1, [](AudioEngine& e, const double* v) { e.set_chaos_amount(static_cast<float>(v[0])); }},
+        {"chaos_shape", 1, [](AudioEngine& e, const double* v) { e.set_chaos_shape(v[0] != 0.0); }},
+        {"delay_chaos", 1, [](AudioEngine& e, const double* v) { e.set_delay_chaos(v[0] != 0.0); }},
+        {"reverb_chaos", 1, [](AudioEngine& e, const double* v) { e.set_reverb_chaos(v[0] != 0.0); }},
+        {"control_interval", 1, [](AudioEngine& e, const double* v) { e.set_control_interval(static_cast<int>(v[0])); }},
+        {"mod_cv", 2, [](AudioEngine& e, const double* v) { e.set_mod_cv(static_cast<int>(v[0]), v[1]); }},
+        {"grain_size", 1, [](AudioEngine& e, const double* v) { e.set_grain_size(static_cast<float>(v[0])); }},
+        {"grain_density", 1, [](AudioEngine& e, const double* v) { e.set_grain_density(static_cast<float>(v[0])); }},
+        {"grain_wet_dry", 1, [](AudioEngine& e, const double* v) { e.set_grain_wet_dry(static_cast<float>(v[0])); }},
+    };
+    for (const AutomationTarget& target : targets) {
+        if (name == target.name) return &target;
     }
+    return nullptr;
+}
 
-    void rescanSlices(float sliceLength) {
-        if (recordedLength <= 0) return;
-
-        slices.clear();
+struct AutomationEvent {
+    int64_t frame;
+    const AutomationTarget* target;
+    double values[2];
+};
 
-        // Fixed-length slicing: divide recording into equal-length slices
-        // SCAN parameter determines starting offset (0.0 = start, 1.0 = end)
-        int sliceLengthSamples = static_cast<int>(sliceLength * sampleRate);
+// Events sorted by frame; lines with the same time keep their file order
+inline std::vector<AutomationEvent> loadAutomation(const std::string& path, double sampleRate) {
+    std::FILE* file = std::fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        throw std::runtime_error("Cannot open automation file " + path);
+    }
+    std::vector<AutomationEvent> events;
+    std::string line;
+    int lineNumber = 0;
+    bool eof = false;
+    while (!eof) {
+        line.clear();
+        int c;
+        while ((c = std::fgetc(file)) != EOF && c != '\n') line += static_cast<char>(c);
+        eof = c == EOF;
+        lineNumber++;
+
+        std::istringstream fields(line.substr(0, line.find('#')));
+        double seconds;
+        std::string name;
+        if (!(fields >> seconds)) {
+            fields.clear();
+            if (fields >> name) {
+                std::fclose(file);
+                throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": expected a time");
+            }
+            continue;  // Blank or comment
+        }
 
-        // SCAN offset: shift starting position within first slice
-        int scanOffsetSamples = static_cast<int>(scanValue * sliceLengthSamples);
-        if (scanOffsetSamples >= recordedLength) {
-            scanOffsetSamples = recordedLength - 1;
+        AutomationEvent event{};
+        std::string extra;
+        fields >> name;
+        event.target = findAutomationTarget(name);
+        bool valid = event.target != nullptr && seconds >= 0.0;
+        for (int i = 0; valid && i < event.target->numValues; i++) {
+            valid = static_cast<bool>(fields >> event.values[i]);
+        }
+        if (!valid || fields >> extra) {
+            std::fclose(file);
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) +
+                                     ": expected '<seconds> <parameter> <values>', got '" + line + "'");
         }
+        event.frame = static_cast<int64_t>(std::llround(seconds * sampleRate));
+        events.push_back(event);
+    }
+    std::fclose(file);
 
-        // Create slices starting from scan offset
-        int pos = scanOffsetSamples;
+    std::stable_sort(events.begin(), events.end(),
+                     [](const AutomationEvent& a, const AutomationEvent& b) { return a.frame < b.frame; });
+    return events;
+}
 
-        while (pos < recordedLength) {
-            int sliceStart = pos;
-            int sliceEnd = std::min(pos + sliceLengthSamples - 1, recordedLength - 1);
+struct RenderJob {
+    std::string input;
+    std::string output;
+    std::string automation;  // Optional
+};
 
-            // Calculate peak amplitude for this slice
-            float peakAmp = 0.0f;
-            for (int i = sliceStart; i <= sliceEnd; i++) {
-                peakAmp = std::max(peakAmp, std::abs(loopBuffer[i]));
-            }
+struct RenderOptions {
+    int blockSize = 4096;              // Frames per processBlock() call
+    double tailSeconds = 0.0;          // Silence rendered after the input ends
+    bool int16Output = false;          // Otherwise float32
+    double maxLoopSeconds = AudioEngine::DEFAULT_MAX_LOOP_SECONDS;
+    LoopFormat loopFormat = LoopFormat::FLOAT32;
+    uint32_t seed = 1;
+};
 
-            Slice newSlice;
-            newSlice.startSample = sliceStart;
-            newSlice.endSample = sliceEnd;
-            newSlice.active = true;
-            newSlice.peakAmplitude = peakAmp;
-            slices.push_back(newSlice);
+struct RenderResult {
+    int64_t frames = 0;
+    double sampleRate = 0.0;
+    double wallSeconds = 0.0;
+    std::string error;  // Empty on success
+};
 
-            pos += sliceLengthSamples;
+// Render one job; failures are reported in the result, not thrown
+inline RenderResult renderOffline(const RenderJob& job, const RenderOptions& options) {
+    const auto start = std::chrono::steady_clock::now();
+    RenderResult result;
+    try {
+        WavReader reader(job.input);
+        const double sampleRate = reader.sampleRate();
+        std::vector<AutomationEvent> events;
+        if (!job.automation.empty()) {
+            events = loadAutomation(job.automation, sampleRate);
         }
 
-        // If scan offset > 0, also create slice for the beginning part (wrap around)
-        if (scanOffsetSamples > 0) {
-            int wrapStart = 0;
-            int wrapEnd = std::min(scanOffsetSamples - 1, recordedLength - 1);
-
-            float peakAmp = 0.0f;
-            for (int i = wrapStart; i <= wrapEnd; i++) {
-                peakAmp = std::max(peakAmp, std::abs(loopBuffer[i]));
+        std::unique_ptr<AudioEngine> engine(
+            new AudioEngine(sampleRate, options.maxLoopSeconds, options.loopFormat));
+        engine->seedRandom(options.seed);
+        engine->setSynchronousSlicing(true);
+
+        WavWriter writer(job.output, static_cast<uint32_t>(sampleRate), options.int16Output);
+        const size_t block = static_cast<size_t>(std::max(options.blockSize, 1));
+        std::vector<float> inL(block), inR(block), outL(block), outR(block);
+        int64_t tailLeft = static_cast<int64_t>(std::llround(std::max(options.tailSeconds, 0.0) * sampleRate));
+        size_t nextEvent = 0;
+        int64_t frame = 0;
+
+        for (;;) {
+            size_t n = reader.read(inL.data(), inR.data(), block);
+            if (n == 0) {
+                if (tailLeft <= 0) break;
+                n = static_cast<size_t>(std::min<int64_t>(tailLeft, static_cast<int64_t>(block)));
+                std::fill(inL.begin(), inL.begin() + n, 0.0f);
+                std::fill(inR.begin(), inR.begin() + n, 0.0f);
+                tailLeft -= static_cast<int64_t>(n);
             }
 
-            Slice wrapSlice;
-            wrapSlice.startSample = wrapStart;
-            wrapSlice.endSample = wrapEnd;
-            wrapSlice.active = true;
-            wrapSlice.peakAmplitude = peakAmp;
-            slices.push_back(wrapSlice);
-        }
-
-        std::cout << "[DEBUG] rescanSlices: sliceLength=" << sliceLength << "s"
-                  << ", scan=" << scanValue << " (offset=" << scanOffsetSamples << " samples)"
-                  << ", found " << slices.size() << " slices";
-
-        if (!slices.empty() && slices.size() <= 10) {
-            std::cout << " [lengths: ";
-            for (const auto& s : slices) {
-                float len = (s.endSample - s.startSample + 1) / sampleRate;
-                std::cout << len << "s ";
+            // Split the block at automation events so each lands on its exact frame
+            size_t done = 0;
+            while (done < n) {
+                while (nextEvent < events.size() &&
+                       events[nextEvent].frame <= frame + static_cast<int64_t>(done)) {
+                    events[nextEvent].target->apply(*engine, events[nextEvent].values);
+                    nextEvent++;
+                }
+                size_t end = n;
+                if (nextEvent < events.size()) {
+                    end = static_cast<size_t>(std::min<int64_t>(
+                        static_cast<int64_t>(n), events[nextEvent].frame - frame));
+                }
+                engine->processBlock(inL.data() + done, inR.data() + done,
+                                     outL.data() + done, outR.data() + done, end - done);
+                done = end;
             }
-            std::cout << "]";
-        }
-        std::cout << std::endl;
 
-        if (currentSliceIndex >= static_cast<int>(slices.size())) {
-            currentSliceIndex = slices.empty() ? 0 : static_cast<int>(slices.size()) - 1;
+            writer.write(outL.data(), outR.data(), n);
+            frame += static_cast<int64_t>(n);
         }
+        writer.close();
+
+        result.frames = frame;
+        result.sampleRate = sampleRate;
+    } catch (const std::exception& e) {
+        result.error = job.input + ": " + e.what();
     }
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
 
-    void redistributeVoices() {
-        if (slices.empty() || numVoices <= 1 || voices.empty()) return;
+// Render jobs in parallel, one engine per job. num_threads < 0 uses every core.
+inline std::vector<RenderResult> renderOfflineBatch(const std::vector<RenderJob>& jobs,
+                                                    const RenderOptions& options, int numThreads) {
+    const int count = static_cast<int>(jobs.size());
+    if (numThreads < 0) {
+        numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    std::vector<RenderResult> results(jobs.size());
+    WorkerPool pool(std::max(0, std::min(numThreads, count) - 1), false);
+    pool.run(count, [&](int i) { results[i] = renderOffline(jobs[i], options); });
+    return results;
+}
 
-        std::uniform_int_distribution<int> sliceDist(0, slices.size() - 1);
-        std::uniform_real_distribution<float> speedDist(-4.0f, 4.0f);
+// Python entry point: job i renders inputs[i] to outputs[i] with automations[i]
+// (or the single automation file given for all, or none). The GIL is released
+// while rendering; if any job fails the others still finish, then it raises.
+inline py::list render_offline(const std::vector<std::string>& inputs,
+                               const std::vector<std::string>& outputs,
+                               const std::vector<std::string>& automations,
+                               double tail_seconds, int block_size, int num_threads,
+                               const std::string& output_format, double max_loop_seconds,
+                               const std::string& loop_format, uint32_t seed) {
+    if (outputs.size() != inputs.size()) {
+        throw std::runtime_error("inputs and outputs must have the same length");
+    }
+    if (automations.size() > 1 && automations.size() != inputs.size()) {
+        throw std::runtime_error("automations must be empty, a single file, or one per input");
+    }
+    if (output_format != "float32" && output_format != "int16") {
+        throw std::runtime_error("output_format must be 'float32' or 'int16'");
+    }
 
-        for (int i = 1; i < numVoices; i++) {
-            int targetSliceIndex = sliceDist(randomEngine);
-            int attempts = 0;
-            while (attempts < 20 && (!slices[targetSliceIndex].active ||
-                   slices[targetSliceIndex].startSample >= recordedLength)) {
-                targetSliceIndex = sliceDist(randomEngine);
-                attempts++;
-            }
+    RenderOptions options;
+    options.blockSize = block_size;
+    options.tailSeconds = tail_seconds;
+    options.int16Output = output_format == "int16";
+    options.maxLoopSeconds = max_loop_seconds;
+    options.loopFormat = parseLoopFormat(loop_format);
+    options.seed = seed;
+
+    std::vector<RenderJob> jobs(inputs.size());
+    for (size_t i = 0; i < jobs.size(); i++) {
+        jobs[i].input = inputs[i];
+        jobs[i].output = outputs[i];
+        if (!automations.empty()) {
+            jobs[i].automation = automations.size() == 1 ? automations[0] : automations[i];
+        }
+    }
 
-            if (!slices[targetSliceIndex].active ||
-                slices[targetSliceIndex].startSample >= recordedLength) {
-                continue;
-            }
+    std::vector<RenderResult> results;
+    {
+        py::gil_scoped_release release;
+        results = renderOfflineBatch(jobs, options, num_threads);
+    }
 
-            voices[i].sliceIndex = targetSliceIndex;
-            voices[i].playbackPosition = slices[targetSliceIndex].startSample;
-            voices[i].playbackPhase = 0.0f;
-            voices[i].speedMultiplier = speedDist(randomEngine);
+    std::string errors;
+    py::list report;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const RenderResult& r = results[i];
+        if (!r.error.empty()) {
+            errors += (errors.empty() ? "" : "; ") + r.error;
+            continue;
         }
+        const double seconds = r.frames / r.sampleRate;
+        py::dict d;
+        d["input"] = jobs[i].input;
+        d["output"] = jobs[i].output;
+        d["frames"] = r.frames;
+        d["seconds"] = seconds;
+        d["wall_seconds"] = r.wallSeconds;
+        d["realtime"] = r.wallSeconds > 0.0 ? seconds / r.wallSeconds : 0.0;
+        report.append(d);
     }
-};
+    if (!errors.empty()) {
+        throw std::runtime_error("render_offline failed: " + errors);
+    }
+    return report;
+}
 
 // ============================================================================
 // pybind11 bindings
 // ============================================================================
+// Kernel level in use and every level this CPU could run
+inline py::dict get_cpu_dispatch() {
+    py::dict info;
+    info["selected"] = cpuLevelName(dspKernels().level);
+    py::list supported;
+    for (int i = 0; i < static_cast<int>(CpuLevel::NUM_LEVELS); i++) {
+        if (cpuSupports(static_cast<CpuLevel>(i))) {
+            supported.append(cpuLevelName(static_cast<CpuLevel>(i)));
+        }
+    }
+    info["supported"] = supported;
+    return info;
+}
+
 PYBIND11_MODULE(alien4, m) {
     m.doc() = "Alien4 Audio Engine - Complete VCV Rack port";
 
+    // Pick the DSP kernels now rather than in the first audio callback
+    dspKernels();
+    m.def("get_cpu_dispatch", &get_cpu_dispatch,
+          "Return {selected, supported}: the ISA level the DSP kernels run at (baseline/neon, "
+          "sse4.2, avx2, avx512; ALIEN4_CPU caps it) and the levels this CPU supports");
+
     py::class_<AudioEngine>(m, "AudioEngine")
-        .def(py::init<double>(), py::arg("sample_rate") = 48000.0,
-             "Create AudioEngine with specified sample rate")
+        .def(py::init([](double sample_rate, double max_loop_seconds, const std::string& loop_format) {
+                 return new AudioEngine(sample_rate, max_loop_seconds, parseLoopFormat(loop_format));
+             }),
+             py::arg("sample_rate") = 48000.0,
+             py::arg("max_loop_seconds") = AudioEngine::DEFAULT_MAX_LOOP_SECONDS,
+             py::arg("loop_format") = "float32",
+             "Create AudioEngine with specified sample rate. Loop memory is committed as "
+             "recording proceeds; loop_format='int16' halves it (clips beyond +/-1.0)")
 
         // Recording control
         .def("set_recording", &AudioEngine::set_recording,
@@ -1549,6 +5953,24 @@ PYBIND11_MODULE(alien4, m) {
              py::arg("enabled"),
              "Enable/disable reverb chaos modulation")
 
+        // Modulation (control rate)
+        .def("set_control_interval", &AudioEngine::set_control_interval,
+             py::arg("samples"),
+             "Run chaos and modulation routing once every 1-256 samples (default 32), "
+             "ramping targets linearly in between")
+        .def("get_control_interval", &AudioEngine::get_control_interval)
+        .def("set_mod_route", &AudioEngine::set_mod_route,
+             py::arg("source"), py::arg("target"), py::arg("depth"),
+             "Add depth * source to target; sources: chaos, cv1-cv6; targets: delay_time (seconds), "
+             "delay_feedback, grain_density, grain_position, reverb_room, reverb_decay. 0 removes it")
+        .def("clear_mod_routes", &AudioEngine::clear_mod_routes)
+        .def("get_mod_routes", &AudioEngine::get_mod_routes,
+             "Return {(source, target): depth} for every route set")
+        .def("set_mod_cv", &AudioEngine::set_mod_cv,
+             py::arg("index"), py::arg("value"),
+             "Set modulation source cv1-6 (index 0-5), any thread. A CallbackChain overrides "
+             "them every block with ENV1-4/SEQ1-2")
+
         // Grain parameters
         .def("set_grain_size", &AudioEngine::set_grain_size,
              py::arg("size"),
@@ -1564,14 +5986,144 @@ PYBIND11_MODULE(alien4, m) {
         .def("process", &AudioEngine::process,
              py::arg("left_in"), py::arg("right_in"),
              "Process audio buffers. Returns (left_out, right_out)")
+        .def("process_into", &AudioEngine::process_into,
+             py::arg("left_in"), py::arg("right_in"),
+             py::arg("left_out"), py::arg("right_out"),
+             "Process audio into preallocated float32 buffers (planar or strided "
+             "interleaved views). Releases the GIL while processing")
 
         // Debug / query functions
         .def("get_num_slices", &AudioEngine::get_num_slices,
              "Get number of detected slices")
         .def("get_num_voices", &AudioEngine::get_num_voices,
              "Get current number of voices")
+        .def("get_max_loop_length", &AudioEngine::get_max_loop_length,
+             "Get the maximum loop length in samples")
         .def("get_recorded_length", &AudioEngine::get_recorded_length,
-             "Get recorded buffer length in samples");
+             "Get recorded buffer length in samples")
+        .def("get_waveform_overview", &AudioEngine::get_waveform_overview,
+             py::arg("width"),
+             "Return {length, min, max, slices, current_slice, voices, recording, take_length, "
+             "take_min, take_max} for drawing the loop and the take being recorded: float32 "
+             "min/max per column, int32 (n, 2) slice [start, end] samples and int32 playhead "
+             "samples. Read from what the audio thread publishes; never blocks it")
+        .def("save_loop", &AudioEngine::save_loop,
+             "Save the loop, slice table and playheads to a file",
+             py::arg("path"))
+        .def("load_loop", &AudioEngine::load_loop,
+             "Memory-map a saved loop and play it from the next block",
+             py::arg("path"))
+        .def("drain_events", &AudioEngine::drain_events,
+             "Pop pending engine events as a list of {frame, type, message} dicts")
+        .def("get_stats", &AudioEngine::get_stats,
+             "Per-stage ns, call-duration histogram and deadline misses since reset_stats()")
+        .def("reset_stats", &AudioEngine::reset_stats,
+             "Restart the get_stats() counters")
+        .def("set_stats_deadline", &AudioEngine::set_stats_deadline,
+             "Set the deadline as a fraction of the block duration (default 1.0)",
+             py::arg("fraction"));
+
+    py::class_<EngineGroup>(m, "EngineGroup")
+        .def(py::init([](int count, double sample_rate, int num_threads, bool pin_threads,
+                         double max_loop_seconds, const std::string& loop_format) {
+                 return new EngineGroup(count, sample_rate, num_threads, pin_threads,
+                                        max_loop_seconds, parseLoopFormat(loop_format));
+             }),
+             py::arg("count"), py::arg("sample_rate") = 48000.0,
+             py::arg("num_threads") = -1, py::arg("pin_threads") = true,
+             py::arg("max_loop_seconds") = AudioEngine::DEFAULT_MAX_LOOP_SECONDS,
+             py::arg("loop_format") = "float32",
+             "Create a group of independent AudioEngines processed on a worker pool "
+             "(num_threads=-1: one thread per engine up to the core count)")
+        .def("__len__", &EngineGroup::size)
+        .def("engine", &EngineGroup::engine, py::arg("index"),
+             py::return_value_policy::reference_internal,
+             "Get engine at index (for setting its parameters)")
+        .def("__getitem__", &EngineGroup::engine, py::arg("index"),
+             py::return_value_policy::reference_internal)
+        .def_property_readonly("num_threads", &EngineGroup::num_threads,
+                               "Threads used per call, including the caller")
+        .def("process", &EngineGroup::process, py::arg("input"),
+             "Process (N, 2, frames) float32 input, returns (N, 2, frames) output")
+        .def("process_into", &EngineGroup::process_into,
+             py::arg("input"), py::arg("output"),
+             "Process (N, 2, frames) float32 input into a preallocated output array (GIL released)");
+
+    py::class_<SharedRing, std::shared_ptr<SharedRing>>(m, "SharedRing",
+        "Lock-free single-producer/single-consumer ring of float32 records in POSIX shared memory")
+        .def_static("create", &SharedRing::create,
+                    py::arg("name"), py::arg("record_size"), py::arg("capacity") = 4096,
+                    "Create a ring named \"/name\" holding capacity records (rounded up to a "
+                    "power of two); the name is unlinked when this object goes away")
+        .def_static("attach", &SharedRing::attach, py::arg("name"),
+                    "Attach to a ring created by another process")
+        .def_property_readonly("name", &SharedRing::get_name)
+        .def_property_readonly("record_size", &SharedRing::get_record_size)
+        .def_property_readonly("capacity", &SharedRing::get_capacity)
+        .def_property_readonly("owner", &SharedRing::is_owner)
+        .def_property_readonly("dropped", &SharedRing::get_dropped,
+                               "Records the producer dropped because the ring was full")
+        .def_property_readonly("available", &SharedRing::available,
+                               "Records pushed and not yet released")
+        .def("push", &SharedRing::push, py::arg("records"),
+             "Producer: push a (record_size,) or (n, record_size) array, returns records stored")
+        .def("read", &SharedRing::read, py::arg("max_records") = -1,
+             "Consumer: release the previous read, return 0-2 read-only (n, record_size) views "
+             "of the waiting records, valid until the next read() or release()")
+        .def("release", &SharedRing::release,
+             "Consumer: hand the records of the last read() back to the producer")
+        .def("unlink", &SharedRing::unlink,
+             "Remove the name now; existing mappings stay valid");
+
+    py::class_<CallbackChain>(m, "CallbackChain")
+        .def(py::init<AudioEngine&>(), py::arg("engine"), py::keep_alive<1, 2>(),
+             "Mixer -> engine -> CV outputs for one audio callback, around an existing AudioEngine")
+
+        // Mixer
+        .def("set_channel_level", &CallbackChain::set_channel_level,
+             py::arg("channel"), py::arg("level"),
+             "Set input level of channel 0-3")
+        .def("set_channel_volume", &CallbackChain::set_channel_volume,
+             py::arg("channel"), py::arg("volume"),
+             "Set mixer volume of channel 0-3 (0-2)")
+        .def("set_channel_pan", &CallbackChain::set_channel_pan,
+             py::arg("channel"), py::arg("pan"),
+             "Set mixer pan of channel 0-3 (-1 left to 1 right)")
+        .def("set_channel_mute", &CallbackChain::set_channel_mute,
+             py::arg("channel"), py::arg("mute"))
+        .def("set_channel_solo", &CallbackChain::set_channel_solo,
+             py::arg("channel"), py::arg("solo"))
+        .def("set_master_volume", &CallbackChain::set_master_volume,
+             py::arg("volume"),
+             "Set master volume before the soft clip (0-2)")
+
+        // Envelopes
+        .def("set_envelope_decay", &CallbackChain::set_envelope_decay,
+             py::arg("index"), py::arg("seconds"),
+             "Set decay time of ENV 0-3 (0.01-10 seconds)")
+        .def("trigger_envelope", &CallbackChain::trigger_envelope,
+             py::arg("index"),
+             "Retrigger ENV 0-3 at the start of the next block (any thread)")
+        .def("set_cv_ring", &CallbackChain::set_cv_ring,
+             py::arg("ring"), py::arg("interval_frames") = 0,
+             "Push ENV1-4/SEQ1-2 records into a 6-float SharedRing (None detaches): one per "
+             "block, or one every interval_frames frames")
+
+        .def("process_into", &CallbackChain::process_into,
+             py::arg("indata"), py::arg("outdata"), py::arg("seq1") = 0.0, py::arg("seq2") = 0.0,
+             py::arg("cv_values") = py::none(), py::arg("seq1_to_scan") = true,
+             "Mix (frames, inputs) indata, run the engine and write L/R plus ENV1-4/SEQ1-2 into "
+             "(frames, outputs) outdata (GIL released). cv_values receives the last CV values");
+
+    m.def("render_offline", &render_offline,
+          "Render WAV files through fresh AudioEngines faster than realtime, in parallel. "
+          "Returns one {input, output, frames, seconds, wall_seconds, realtime} dict per job",
+          py::arg("inputs"), py::arg("outputs"),
+          py::arg("automations") = std::vector<std::string>(),
+          py::arg("tail_seconds") = 0.0, py::arg("block_size") = 4096,
+          py::arg("num_threads") = -1, py::arg("output_format") = "float32",
+          py::arg("max_loop_seconds") = AudioEngine::DEFAULT_MAX_LOOP_SECONDS,
+          py::arg("loop_format") = "float32", py::arg("seed") = 1);
 
     m.attr("__version__") = "1.0.0";
     m.attr("LOOP_BUFFER_SIZE") = AudioEngine::LOOP_BUFFER_SIZE;
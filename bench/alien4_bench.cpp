@@ -0,0 +1,325 @@
+/*
+ * Alien4 DSP benchmarks (Google Benchmark)
+ *
+ * Build:  cmake -S . -B build -DALIEN4_BUILD_BENCH=ON && cmake --build build --target alien4_bench
+ * Run:    ./build/alien4_bench --benchmark_out=baseline.json --benchmark_out_format=json
+ * Compare two runs with Google Benchmark's tools/compare.py:
+ *         compare.py benchmarks baseline.json current.json
+ *
+ * Every benchmark reports:
+ * - ns_per_sample: wall time per stereo frame
+ * - realtime:      seconds of 48 kHz audio processed per wall-clock second
+ *                  (a 128-frame callback has 1/realtime of its budget in use)
+ */
+
+// The engine and stages live in the extension translation unit; PYBIND11_MODULE
+// there is never called, it only needs libpython at link time
+#include "alien4_extension.cpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr double BENCH_SAMPLE_RATE = 48000.0;
+
+// Deterministic stand-in for program material
+std::vector<float> makeNoise(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> out(count);
+    for (float& v : out) v = dist(rng);
+    return out;
+}
+
+void setSampleCounters(benchmark::State& state, int64_t framesPerIteration) {
+    const double frames = static_cast<double>(state.iterations() * framesPerIteration);
+    state.SetItemsProcessed(static_cast<int64_t>(frames));
+    state.counters["ns_per_sample"] = benchmark::Counter(
+        frames / 1e9, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["realtime"] = benchmark::Counter(
+        frames / BENCH_SAMPLE_RATE, benchmark::Counter::kIsRate);
+}
+
+// ============================================================================
+// Stages
+// ============================================================================
+void BM_Reverb(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    auto in = makeNoise(static_cast<size_t>(n) * 2, 1);
+    std::vector<float> chaos(n, 0.0f), outL(n), outR(n);
+    ReverbProcessor reverb;
+
+    for (auto _ : state) {
+        reverb.process(in.data(), in.data() + n, outL.data(), outR.data(), chaos.data(), n,
+                       0.7f, 0.5f, 0.8f, false, static_cast<float>(BENCH_SAMPLE_RATE));
+        benchmark::DoNotOptimize(outL.data());
+        benchmark::ClobberMemory();
+    }
+    setSampleCounters(state, n);
+}
+
+void BM_Grain(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    auto in = makeNoise(static_cast<size_t>(n), 2);
+    std::vector<float> out(n);
+    GrainProcessor grain;
+
+    for (auto _ : state) {
+        for (int i = 0; i < n; i++) {
+            out[i] = grain.process(in[i], 0.3f, 0.6f, 0.5f, true, 0.1f,
+                                   static_cast<float>(BENCH_SAMPLE_RATE));
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    setSampleCounters(state, n);
+}
+
+// range(1) = 0: fixed delay times (fast path), 1: per-sample modulated times
+void BM_Delay(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const bool modulated = state.range(1) != 0;
+    auto in = makeNoise(static_cast<size_t>(n) * 2, 3);
+    std::vector<float> outL(n), outR(n), timeL(n), timeR(n), feedback(n, 0.4f);
+    for (int i = 0; i < n; i++) {
+        timeL[i] = 12000.0f + 40.0f * std::sin(0.01f * i);
+        timeR[i] = 14400.0f + 40.0f * std::cos(0.01f * i);
+    }
+    DelayProcessor delay;
+
+    for (auto _ : state) {
+        if (modulated) {
+            delay.process(in.data(), in.data() + n, outL.data(), outR.data(), n,
+                          timeL.data(), timeR.data(), feedback.data());
+        } else {
+            delay.processFixed(in.data(), in.data() + n, outL.data(), outR.data(), n,
+                               12000.0f, 14400.0f, 0.4f);
+        }
+        benchmark::DoNotOptimize(outL.data());
+        benchmark::ClobberMemory();
+    }
+    setSampleCounters(state, n);
+}
+
+// 3-band EQ cascade (three biquads per channel)
+void BM_Biquad(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const float sr = static_cast<float>(BENCH_SAMPLE_RATE);
+    auto source = makeNoise(static_cast<size_t>(n) * 2, 4);
+    std::vector<float> bufL(n), bufR(n);
+    StereoEqCascade eq;
+    eq.setBand(0, BiquadCoefficients::LOWSHELF, 200.0f / sr, 0.707f, std::pow(10.0f, -6.0f / 20.0f));
+    eq.setBand(1, BiquadCoefficients::PEAK, 2000.0f / sr, 0.707f, std::pow(10.0f, -3.0f / 20.0f));
+    eq.setBand(2, BiquadCoefficients::HIGHSHELF, 8000.0f / sr, 0.707f, std::pow(10.0f, -9.0f / 20.0f));
+
+    for (auto _ : state) {
+        std::copy(source.begin(), source.begin() + n, bufL.begin());
+        std::copy(source.begin() + n, source.end(), bufR.begin());
+        eq.process(bufL.data(), bufR.data(), n);
+        benchmark::DoNotOptimize(bufL.data());
+        benchmark::ClobberMemory();
+    }
+    setSampleCounters(state, n);
+}
+
+void BM_Chaos(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::vector<float> out(n);
+    ChaosGenerator chaos;
+
+    for (auto _ : state) {
+        for (int i = 0; i < n; i++) {
+            out[i] = chaos.process(0.5f);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    setSampleCounters(state, n);
+}
+
+// Chaos plus one routed target; range(1) = control interval (1 = per sample)
+void BM_Modulation(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::vector<float> chaosOut(n), delayOut(n);
+    float depth[ModulationEngine::NUM_SOURCES][ModulationEngine::NUM_TARGETS] = {};
+    depth[ModulationEngine::SOURCE_CHAOS][ModulationEngine::TARGET_DELAY_TIME] = 0.1f;
+    const float cv[ModulationEngine::NUM_CV] = {};
+
+    ModulationEngine::Inputs in;
+    in.interval = static_cast<int>(state.range(1));
+    in.chaosRate = 0.5f;
+    in.chaosAmount = 1.0f;
+    in.chaosShape = false;
+    in.sampleRate = 48000.0f;
+    in.depth = depth;
+    in.cv = cv;
+
+    ModulationEngine modulation;
+    float* lanes[ModulationEngine::NUM_LANES] = {};
+    lanes[ModulationEngine::TARGET_DELAY_TIME] = delayOut.data();
+    lanes[ModulationEngine::CHAOS_LANE] = chaosOut.data();
+    const uint32_t mask = (1u << ModulationEngine::TARGET_DELAY_TIME) |
+                          (1u << ModulationEngine::CHAOS_LANE);
+
+    for (auto _ : state) {
+        modulation.render(lanes, mask, n, in);
+        benchmark::DoNotOptimize(chaosOut.data());
+        benchmark::DoNotOptimize(delayOut.data());
+        benchmark::ClobberMemory();
+    }
+    setSampleCounters(state, n);
+}
+
+// ============================================================================
+// Denormals: range(0) = seconds the tail has already decayed. Time per sample
+// should not grow with it. BM_ReverbTail range(1) = 0 runs with FTZ/DAZ
+// cleared, so only the explicit denormal handling protects the tail.
+// ============================================================================
+void BM_ReverbTail(benchmark::State& state) {
+    constexpr int n = 128;
+    const int64_t tailBlocks = state.range(0) * static_cast<int64_t>(BENCH_SAMPLE_RATE) / n;
+    ScopedFlushToZero mode(state.range(1) != 0);
+    auto noise = makeNoise(static_cast<size_t>(n) * 2, 6);
+    std::vector<float> silence(n, 0.0f), chaos(n, 0.0f), outL(n), outR(n);
+    std::unique_ptr<ReverbProcessor> reverb(new ReverbProcessor());
+    auto run = [&](const float* inL, const float* inR) {
+        reverb->process(inL, inR, outL.data(), outR.data(), chaos.data(), n,
+                        0.9f, 0.3f, 0.95f, false, static_cast<float>(BENCH_SAMPLE_RATE));
+    };
+
+    for (int i = 0; i < static_cast<int>(BENCH_SAMPLE_RATE) / n; i++) {
+        run(noise.data(), noise.data() + n);  // One second of excitation
+    }
+    for (int64_t i = 0; i < tailBlocks; i++) {
+        run(silence.data(), silence.data());
+    }
+
+    for (auto _ : state) {
+        run(silence.data(), silence.data());
+        benchmark::DoNotOptimize(outL.data());
+        benchmark::ClobberMemory();
+    }
+    setSampleCounters(state, n);
+}
+
+// Delay feedback, reverb and EQ ringing out through the whole engine
+void BM_EngineTail(benchmark::State& state) {
+    constexpr int n = 128;
+    const int64_t tailBlocks = state.range(0) * static_cast<int64_t>(BENCH_SAMPLE_RATE) / n;
+    auto noise = makeNoise(static_cast<size_t>(BENCH_SAMPLE_RATE), 7);
+    std::vector<float> silence(n, 0.0f), outL(n), outR(n);
+
+    AudioEngine engine(BENCH_SAMPLE_RATE);
+    engine.set_mix(0.0);
+    engine.set_eq_low(-3.0);
+    engine.set_eq_high(-6.0);
+    engine.set_delay_time(0.25, 0.3);
+    engine.set_delay_feedback(0.7);
+    engine.set_delay_wet(0.4);
+    engine.set_reverb_decay(0.95);
+    engine.set_reverb_wet(0.5);
+
+    for (size_t offset = 0; offset + n <= noise.size(); offset += n) {
+        engine.processBlock(noise.data() + offset, noise.data() + offset, outL.data(), outR.data(), n);
+    }
+    for (int64_t i = 0; i < tailBlocks; i++) {
+        engine.processBlock(silence.data(), silence.data(), outL.data(), outR.data(), n);
+    }
+
+    for (auto _ : state) {
+        engine.processBlock(silence.data(), silence.data(), outL.data(), outR.data(), n);
+        benchmark::DoNotOptimize(outL.data());
+        benchmark::ClobberMemory();
+    }
+    setSampleCounters(state, n);
+}
+
+// ============================================================================
+// Full engine: range(0) = block size, range(1) = poly voices
+// ============================================================================
+void BM_AudioEngine(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const int voices = static_cast<int>(state.range(1));
+    auto in = makeNoise(static_cast<size_t>(BENCH_SAMPLE_RATE), 5);
+    std::vector<float> outL(n), outR(n);
+
+    AudioEngine engine(BENCH_SAMPLE_RATE);
+    engine.set_mix(0.7);
+    engine.set_speed(1.0);
+    engine.set_eq_low(-3.0);
+    engine.set_eq_high(-6.0);
+    engine.set_delay_time(0.25, 0.3);
+    engine.set_delay_feedback(0.4);
+    engine.set_delay_wet(0.3);
+    engine.set_reverb_wet(0.3);
+    engine.set_grain_wet_dry(0.2f);
+    engine.set_chaos_amount(0.5f);
+    engine.set_delay_chaos(true);
+
+    // Record one second of material and let the background scanner slice it
+    engine.set_recording(true);
+    for (size_t offset = 0; offset + n <= in.size(); offset += n) {
+        engine.processBlock(in.data() + offset, in.data() + offset, outL.data(), outR.data(), n);
+    }
+    engine.set_recording(false);
+    engine.set_poly(voices);
+    engine.processBlock(in.data(), in.data(), outL.data(), outR.data(), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    size_t offset = 0;
+    for (auto _ : state) {
+        if (offset + n > in.size()) offset = 0;
+        engine.processBlock(in.data() + offset, in.data() + offset, outL.data(), outR.data(), n);
+        offset += n;
+        benchmark::DoNotOptimize(outL.data());
+        benchmark::ClobberMemory();
+    }
+    setSampleCounters(state, n);
+    state.counters["slices"] = engine.get_num_slices();
+}
+
+// Whole VAV callback: 4-in mixer -> engine -> CV on interleaved (frames, 8) buffers
+void BM_CallbackChain(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    constexpr int inChannels = 4, outChannels = 8;
+    auto in = makeNoise(static_cast<size_t>(n) * inChannels, 8);
+    std::vector<float> out(static_cast<size_t>(n) * outChannels);
+
+    AudioEngine engine(BENCH_SAMPLE_RATE);
+    engine.set_mix(0.7);
+    engine.set_delay_wet(0.3);
+    engine.set_reverb_wet(0.3);
+    CallbackChain chain(engine);
+    const CallbackChain::FrameBuffer inBuf{in.data(), static_cast<size_t>(n), inChannels,
+                                           inChannels, 1};
+    const CallbackChain::FrameBuffer outBuf{out.data(), static_cast<size_t>(n), outChannels,
+                                            outChannels, 1};
+
+    int64_t block = 0;
+    for (auto _ : state) {
+        if (block++ % 64 == 0) chain.trigger_envelope(0);
+        chain.processFrames(inBuf, outBuf, 0.3f, 0.6f);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    setSampleCounters(state, n);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Reverb)->Arg(32)->Arg(64)->Arg(128)->Arg(512);
+BENCHMARK(BM_Grain)->Arg(32)->Arg(64)->Arg(128)->Arg(512);
+BENCHMARK(BM_Delay)->ArgsProduct({{32, 64, 128, 512}, {0, 1}});
+BENCHMARK(BM_Biquad)->Arg(32)->Arg(64)->Arg(128)->Arg(512);
+BENCHMARK(BM_Chaos)->Arg(32)->Arg(64)->Arg(128)->Arg(512);
+BENCHMARK(BM_Modulation)->ArgsProduct({{128, 512}, {1, 16, 32}});
+BENCHMARK(BM_ReverbTail)->ArgsProduct({{0, 2, 8, 30}, {0, 1}});
+BENCHMARK(BM_EngineTail)->Arg(0)->Arg(2)->Arg(8)->Arg(30);
+BENCHMARK(BM_AudioEngine)->ArgsProduct({{32, 64, 128, 512}, {1, 4, 8}});
+BENCHMARK(BM_CallbackChain)->Arg(128)->Arg(256)->Arg(512);
+
+BENCHMARK_MAIN();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "alien4_core.hpp"
 #include "three_band_eq.hpp"
 #include "ripley/stereo_delay.hpp"
 #include "ripley/reverb_processor.hpp"
@@ -8,16 +9,6 @@
 #include <cmath>
 #include <random>
 
-/**
- * Slice structure (from VCV Rack Alien4.cpp)
- */
-struct Slice {
-    int startSample = 0;
-    int endSample = 0;
-    float peakAmplitude = 0.0f;
-    bool active = false;
-};
-
 /**
  * Voice structure for polyphonic playback (from VCV Rack Alien4.cpp)
  */
@@ -100,12 +91,6 @@ private:
         }
     }
 
-    // Clamp utility
-    template<typename T>
-    T clamp(T value, T min, T max) {
-        return std::max(min, std::min(value, max));
-    }
-
 public:
     Alien4AudioEngine(float sr = 48000.0f)
         : sampleRate(sr), playbackPosition(0), playbackPhase(0.0f), recordedLength(0),
@@ -436,117 +421,31 @@ public:
 
             if (recordedLength > 0) {
                 float playbackSpeed = speed;
-                bool isReverse = playbackSpeed < 0.0f;
 
                 if (numVoices == 1 || voices.empty()) {
                     // Single voice mode
-                    playbackPhase += playbackSpeed;
-                    int positionDelta = (int)playbackPhase;
-                    playbackPhase -= (float)positionDelta;
-                    playbackPosition += positionDelta;
-
-                    // Loop current slice
-                    if (!slices.empty() && currentSliceIndex < (int)slices.size() && slices[currentSliceIndex].active) {
-                        int sliceStart = slices[currentSliceIndex].startSample;
-                        int sliceEnd = slices[currentSliceIndex].endSample;
-
-                        if (isReverse) {
-                            if (playbackPosition < sliceStart) {
-                                playbackPosition = sliceEnd;
-                            }
-                        } else {
-                            if (playbackPosition > sliceEnd) {
-                                playbackPosition = sliceStart;
-                            }
-                        }
-                    } else {
-                        // No slices: loop entire buffer
-                        if (isReverse) {
-                            if (playbackPosition < 0) {
-                                playbackPosition = recordedLength - 1;
-                            }
-                        } else {
-                            if (playbackPosition >= recordedLength) {
-                                playbackPosition = 0;
-                            }
-                        }
-                    }
-
-                    // Read with interpolation
-                    if (recordedLength > 0) {
-                        playbackPosition = clamp(playbackPosition, 0, recordedLength - 1);
-                        int pos0 = playbackPosition;
-                        int pos1 = (recordedLength > 1) ? ((pos0 + 1) % recordedLength) : pos0;
-
-                        pos0 = clamp(pos0, 0, LOOP_BUFFER_SIZE - 1);
-                        pos1 = clamp(pos1, 0, LOOP_BUFFER_SIZE - 1);
-
-                        float frac = clamp(std::abs(playbackPhase), 0.0f, 1.0f);
-
-                        float sample = loopBuffer[pos0] * (1.0f - frac) + loopBuffer[pos1] * frac;
-                        loopL = sample;
-                        loopR = sample;
-                    }
+                    float sample = advanceLoopPlayhead(loopBuffer.data(), recordedLength, slices,
+                                                       currentSliceIndex, playbackSpeed,
+                                                       playbackPosition, playbackPhase);
+                    loopL = sample;
+                    loopR = sample;
                 } else {
                     // Multiple voices mode (from lines 692-771)
                     for (int v = 0; v < numVoices; v++) {
                         float voiceSpeed = playbackSpeed * voices[v].speedMultiplier;
                         voiceSpeed = clamp(voiceSpeed, -16.0f, 16.0f);
-                        voices[v].playbackPhase += voiceSpeed;
-
-                        int positionDelta = (int)voices[v].playbackPhase;
-                        voices[v].playbackPhase -= (float)positionDelta;
-                        voices[v].playbackPosition += positionDelta;
-
-                        // Loop current slice for each voice
-                        if (!slices.empty() && voices[v].sliceIndex < (int)slices.size() && slices[voices[v].sliceIndex].active) {
-                            int sliceStart = slices[voices[v].sliceIndex].startSample;
-                            int sliceEnd = slices[voices[v].sliceIndex].endSample;
-
-                            bool voiceReverse = voiceSpeed < 0.0f;
-                            if (voiceReverse) {
-                                if (voices[v].playbackPosition < sliceStart) {
-                                    voices[v].playbackPosition = sliceEnd;
-                                }
-                            } else {
-                                if (voices[v].playbackPosition > sliceEnd) {
-                                    voices[v].playbackPosition = sliceStart;
-                                }
-                            }
-                        } else {
-                            // No valid slice: loop entire buffer
-                            bool voiceReverse = voiceSpeed < 0.0f;
-                            if (voiceReverse) {
-                                if (voices[v].playbackPosition < 0) {
-                                    voices[v].playbackPosition = recordedLength - 1;
-                                }
-                            } else {
-                                if (voices[v].playbackPosition >= recordedLength) {
-                                    voices[v].playbackPosition = 0;
-                                }
-                            }
-                        }
-
-                        // Read with interpolation and distribute to L/R alternately
-                        if (recordedLength > 0) {
-                            voices[v].playbackPosition = clamp(voices[v].playbackPosition, 0, recordedLength - 1);
-                            int pos0 = voices[v].playbackPosition;
-                            int pos1 = (recordedLength > 1) ? ((pos0 + 1) % recordedLength) : pos0;
 
-                            pos0 = clamp(pos0, 0, LOOP_BUFFER_SIZE - 1);
-                            pos1 = clamp(pos1, 0, LOOP_BUFFER_SIZE - 1);
+                        float sample = advanceLoopPlayhead(loopBuffer.data(), recordedLength, slices,
+                                                           voices[v].sliceIndex, voiceSpeed,
+                                                           voices[v].playbackPosition,
+                                                           voices[v].playbackPhase);
 
-                            float frac = clamp(std::abs(voices[v].playbackPhase), 0.0f, 1.0f);
-
-                            float sample = loopBuffer[pos0] * (1.0f - frac) + loopBuffer[pos1] * frac;
-
-                            if (std::isfinite(sample)) {
-                                // Alternate voices between L and R
-                                if (v % 2 == 0) {
-                                    loopL += sample;
-                                } else {
-                                    loopR += sample;
-                                }
+                        if (std::isfinite(sample)) {
+                            // Alternate voices between L and R
+                            if (v % 2 == 0) {
+                                loopL += sample;
+                            } else {
+                                loopR += sample;
                             }
                         }
                     }
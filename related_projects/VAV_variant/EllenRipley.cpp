@@ -1,10 +1,16 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
 #include "widgets/PanelTheme.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
+#include <memory>
+#include <new>
 
 using namespace rack;
 using namespace rack::engine;
 using namespace rack::math;
+using simd::float_4;
 
 struct EnhancedTextLabel : TransparentWidget {
     std::string text;
@@ -62,10 +68,26 @@ struct WhiteBackgroundBox : Widget {
 // StandardBlackKnob 現在從 widgets/Knobs.hpp 引入
 
 
+// The processors below run four polyphony channels at once, one per float_4
+// lane. Delay, comb, allpass and grain lines are interleaved (one float_4 per
+// sample), so a write is a single vector store and a read is a single vector
+// load whenever all lanes tap the same position.
+inline float_4 readInterleaved(const float_4* line, const int index[4]) {
+    if (index[0] == index[1] && index[0] == index[2] && index[0] == index[3]) {
+        return line[index[0]];
+    }
+    return float_4(line[index[0]][0], line[index[1]][1], line[index[2]][2], line[index[3]][3]);
+}
+
+// NaN and +-inf become 0
+inline float_4 finiteOrZero(float_4 v) {
+    return simd::ifelse(simd::abs(v) <= FLT_MAX, v, 0.0f);
+}
+
 struct ChaosGenerator {
-    float x = 0.1f;
-    float y = 0.1f;
-    float z = 0.1f;
+    float_4 x = 0.1f;
+    float_4 y = 0.1f;
+    float_4 z = 0.1f;
     
     void reset() {
         x = 0.1f;
@@ -73,24 +95,25 @@ struct ChaosGenerator {
         z = 0.1f;
     }
     
-    float process(float rate) {
+    float_4 process(float rate) {
         float dt = rate * 0.001f;
         
-        float dx = 7.5f * (y - x);
-        float dy = x * (30.9f - z) - y;
-        float dz = x * y - 1.02f * z;
+        float_4 dx = 7.5f * (y - x);
+        float_4 dy = x * (30.9f - z) - y;
+        float_4 dz = x * y - 1.02f * z;
         
         x += dx * dt;
         y += dy * dt;
         z += dz * dt;
         
-        // Prevent numerical explosion
-        if (std::isnan(x) || std::isnan(y) || std::isnan(z) || 
-            std::abs(x) > 100.0f || std::abs(y) > 100.0f || std::abs(z) > 100.0f) {
-            reset();
-        }
+        // Prevent numerical explosion (per lane)
+        float_4 exploded = (x != x) | (y != y) | (z != z) |
+                           (simd::abs(x) > 100.0f) | (simd::abs(y) > 100.0f) | (simd::abs(z) > 100.0f);
+        x = simd::ifelse(exploded, 0.1f, x);
+        y = simd::ifelse(exploded, 0.1f, y);
+        z = simd::ifelse(exploded, 0.1f, z);
         
-        return clamp(x * 0.1f, -1.0f, 1.0f);
+        return simd::clamp(x * 0.1f, -1.0f, 1.0f);
     }
 };
 
@@ -105,24 +128,24 @@ struct ReverbProcessor {
     static constexpr int COMB_7_SIZE = 1188;  // ~25ms (for stereo)
     static constexpr int COMB_8_SIZE = 1116;  // ~23ms (for stereo)
     
-    float combBuffer1[COMB_1_SIZE];
-    float combBuffer2[COMB_2_SIZE];
-    float combBuffer3[COMB_3_SIZE];
-    float combBuffer4[COMB_4_SIZE];
-    float combBuffer5[COMB_5_SIZE];
-    float combBuffer6[COMB_6_SIZE];
-    float combBuffer7[COMB_7_SIZE];
-    float combBuffer8[COMB_8_SIZE];
+    float_4 combBuffer1[COMB_1_SIZE];
+    float_4 combBuffer2[COMB_2_SIZE];
+    float_4 combBuffer3[COMB_3_SIZE];
+    float_4 combBuffer4[COMB_4_SIZE];
+    float_4 combBuffer5[COMB_5_SIZE];
+    float_4 combBuffer6[COMB_6_SIZE];
+    float_4 combBuffer7[COMB_7_SIZE];
+    float_4 combBuffer8[COMB_8_SIZE];
     
     int combIndex1 = 0, combIndex2 = 0, combIndex3 = 0, combIndex4 = 0;
     int combIndex5 = 0, combIndex6 = 0, combIndex7 = 0, combIndex8 = 0;
     
     // Lowpass filters in comb feedback loops
-    float combLp1 = 0.0f, combLp2 = 0.0f, combLp3 = 0.0f, combLp4 = 0.0f;
-    float combLp5 = 0.0f, combLp6 = 0.0f, combLp7 = 0.0f, combLp8 = 0.0f;
+    float_4 combLp1 = 0.0f, combLp2 = 0.0f, combLp3 = 0.0f, combLp4 = 0.0f;
+    float_4 combLp5 = 0.0f, combLp6 = 0.0f, combLp7 = 0.0f, combLp8 = 0.0f;
     
     // Highpass filter for reverb output (to remove sub-100Hz)
-    float hpState = 0.0f;
+    float_4 hpState = 0.0f;
     
     // Series allpass filters for diffusion
     static constexpr int ALLPASS_1_SIZE = 556;
@@ -130,29 +153,39 @@ struct ReverbProcessor {
     static constexpr int ALLPASS_3_SIZE = 341;
     static constexpr int ALLPASS_4_SIZE = 225;
     
-    float allpassBuffer1[ALLPASS_1_SIZE];
-    float allpassBuffer2[ALLPASS_2_SIZE];
-    float allpassBuffer3[ALLPASS_3_SIZE];
-    float allpassBuffer4[ALLPASS_4_SIZE];
+    float_4 allpassBuffer1[ALLPASS_1_SIZE];
+    float_4 allpassBuffer2[ALLPASS_2_SIZE];
+    float_4 allpassBuffer3[ALLPASS_3_SIZE];
+    float_4 allpassBuffer4[ALLPASS_4_SIZE];
     
     int allpassIndex1 = 0, allpassIndex2 = 0, allpassIndex3 = 0, allpassIndex4 = 0;
     
+    // Lines are written in order from index 0, so only the first
+    // writtenSamples of each need clearing (all of them before the first reset)
+    static constexpr int MAX_LINE_SIZE = COMB_2_SIZE;
+    int writtenSamples = MAX_LINE_SIZE;
+    
     ReverbProcessor() { reset(); }
     
+    static void clearLine(float_4* buffer, int size, int written) {
+        std::fill(buffer, buffer + std::min(size, written), float_4(0.0f));
+    }
+    
     void reset() {
-        for (int i = 0; i < COMB_1_SIZE; i++) combBuffer1[i] = 0.0f;
-        for (int i = 0; i < COMB_2_SIZE; i++) combBuffer2[i] = 0.0f;
-        for (int i = 0; i < COMB_3_SIZE; i++) combBuffer3[i] = 0.0f;
-        for (int i = 0; i < COMB_4_SIZE; i++) combBuffer4[i] = 0.0f;
-        for (int i = 0; i < COMB_5_SIZE; i++) combBuffer5[i] = 0.0f;
-        for (int i = 0; i < COMB_6_SIZE; i++) combBuffer6[i] = 0.0f;
-        for (int i = 0; i < COMB_7_SIZE; i++) combBuffer7[i] = 0.0f;
-        for (int i = 0; i < COMB_8_SIZE; i++) combBuffer8[i] = 0.0f;
-        
-        for (int i = 0; i < ALLPASS_1_SIZE; i++) allpassBuffer1[i] = 0.0f;
-        for (int i = 0; i < ALLPASS_2_SIZE; i++) allpassBuffer2[i] = 0.0f;
-        for (int i = 0; i < ALLPASS_3_SIZE; i++) allpassBuffer3[i] = 0.0f;
-        for (int i = 0; i < ALLPASS_4_SIZE; i++) allpassBuffer4[i] = 0.0f;
+        clearLine(combBuffer1, COMB_1_SIZE, writtenSamples);
+        clearLine(combBuffer2, COMB_2_SIZE, writtenSamples);
+        clearLine(combBuffer3, COMB_3_SIZE, writtenSamples);
+        clearLine(combBuffer4, COMB_4_SIZE, writtenSamples);
+        clearLine(combBuffer5, COMB_5_SIZE, writtenSamples);
+        clearLine(combBuffer6, COMB_6_SIZE, writtenSamples);
+        clearLine(combBuffer7, COMB_7_SIZE, writtenSamples);
+        clearLine(combBuffer8, COMB_8_SIZE, writtenSamples);
+        
+        clearLine(allpassBuffer1, ALLPASS_1_SIZE, writtenSamples);
+        clearLine(allpassBuffer2, ALLPASS_2_SIZE, writtenSamples);
+        clearLine(allpassBuffer3, ALLPASS_3_SIZE, writtenSamples);
+        clearLine(allpassBuffer4, ALLPASS_4_SIZE, writtenSamples);
+        writtenSamples = 0;
         
         combIndex1 = combIndex2 = combIndex3 = combIndex4 = 0;
         combIndex5 = combIndex6 = combIndex7 = combIndex8 = 0;
@@ -163,8 +196,8 @@ struct ReverbProcessor {
         hpState = 0.0f;
     }
     
-    float processComb(float input, float* buffer, int size, int& index, float feedback, float& lp, float damping) {
-        float output = buffer[index];
+    float_4 processComb(float_4 input, float_4* buffer, int size, int& index, float_4 feedback, float_4& lp, float_4 damping) {
+        float_4 output = buffer[index];
         
         // Apply lowpass filter to feedback signal
         lp = lp + (output - lp) * damping;
@@ -176,93 +209,84 @@ struct ReverbProcessor {
         return output;
     }
     
-    float processAllpass(float input, float* buffer, int size, int& index, float gain) {
-        float delayed = buffer[index];
-        float output = -input * gain + delayed;
+    float_4 processAllpass(float_4 input, float_4* buffer, int size, int& index, float gain) {
+        float_4 delayed = buffer[index];
+        float_4 output = -input * gain + delayed;
         buffer[index] = input + delayed * gain;
         index = (index + 1) % size;
         return output;
     }
     
-    float process(float inputL, float inputR, float grainDensity,
-                  float roomSize, float damping, float decay, bool isLeftChannel,
-                  bool chaosEnabled, float chaosOutput, float sampleRate) {
+    // Room reflection tap, offset per lane by room size and chaos
+    static float_4 readRoomTap(const float_4* buffer, int size, int index, float_4 offset) {
+        int taps[4];
+        for (int lane = 0; lane < 4; lane++) {
+            // Ensure room offsets are always positive
+            int roomOffset = std::max(0, (int)offset[lane]);
+            taps[lane] = ((index - roomOffset) % size + size) % size;
+        }
+        return readInterleaved(buffer, taps);
+    }
+    
+    float_4 process(float_4 inputL, float_4 inputR, float_4 grainDensity,
+                    float_4 roomSize, float_4 damping, float_4 decay, bool isLeftChannel,
+                    bool chaosEnabled, float_4 chaosOutput, float sampleRate) {
+        
+        if (writtenSamples < MAX_LINE_SIZE) writtenSamples++;
         
         // Use proper stereo input instead of mixing to mono
-        float input = isLeftChannel ? inputL : inputR;
+        float_4 input = isLeftChannel ? inputL : inputR;
         
         // Calculate feedback based on decay - much wider range for 10+ second tails
-        float feedback = 0.5f + decay * 0.485f; // 0.5 to 0.985 (near infinite at max)
+        float_4 feedback = 0.5f + decay * 0.485f; // 0.5 to 0.985 (near infinite at max)
         if (chaosEnabled) {
             feedback += chaosOutput * 0.5f; // Enhanced chaos effect 10x from 0.05f
-            feedback = clamp(feedback, 0.0f, 0.995f);
+            feedback = simd::clamp(feedback, 0.0f, 0.995f);
         }
         
         // Damping: low value = more damping (darker), high value = less damping (brighter)
-        float dampingCoeff = 0.05f + damping * 0.9f;
+        float_4 dampingCoeff = 0.05f + damping * 0.9f;
         
         // Room size affects delay buffer read positions dramatically
-        float roomScale = 0.3f + roomSize * 1.4f; // 0.3 to 1.7 scaling
+        float_4 roomScale = 0.3f + roomSize * 1.4f; // 0.3 to 1.7 scaling
         
-        float combOut = 0.0f;
+        float_4 combOut = 0.0f;
         
         if (isLeftChannel) {
-            // Room size creates variable delay taps for room simulation
-            // Ensure room offsets are always positive
-            int roomOffset1 = std::max(0, (int)(roomSize * 400 + chaosOutput * 50)); // 0-450 samples
-            int roomOffset2 = std::max(0, (int)(roomSize * 350 + chaosOutput * 40));
-            // Unused room offsets (corresponding read indices are not used)
-            // int roomOffset3 = std::max(0, (int)(roomSize * 300 + chaosOutput * 60));
-            // int roomOffset4 = std::max(0, (int)(roomSize * 500 + chaosOutput * 70));
-            
-            // Use room-modulated delay reads with safe modulo operation
-            int readIdx1 = ((combIndex1 - roomOffset1) % COMB_1_SIZE + COMB_1_SIZE) % COMB_1_SIZE;
-            int readIdx2 = ((combIndex2 - roomOffset2) % COMB_2_SIZE + COMB_2_SIZE) % COMB_2_SIZE;
-            // Unused read indices
-            // int readIdx3 = ((combIndex3 - roomOffset3) % COMB_3_SIZE + COMB_3_SIZE) % COMB_3_SIZE;
-            // int readIdx4 = ((combIndex4 - roomOffset4) % COMB_4_SIZE + COMB_4_SIZE) % COMB_4_SIZE;
+            // Room size creates variable delay taps for room simulation (read before the comb writes)
+            float_4 reflection1 = readRoomTap(combBuffer1, COMB_1_SIZE, combIndex1, roomSize * 400 + chaosOutput * 50); // 0-450 samples
+            float_4 reflection2 = readRoomTap(combBuffer2, COMB_2_SIZE, combIndex2, roomSize * 350 + chaosOutput * 40);
             
-            float roomInput = input * roomScale;
+            float_4 roomInput = input * roomScale;
             combOut += processComb(roomInput, combBuffer1, COMB_1_SIZE, combIndex1, feedback, combLp1, dampingCoeff);
             combOut += processComb(roomInput, combBuffer2, COMB_2_SIZE, combIndex2, feedback, combLp2, dampingCoeff);
             combOut += processComb(roomInput, combBuffer3, COMB_3_SIZE, combIndex3, feedback, combLp3, dampingCoeff);
             combOut += processComb(roomInput, combBuffer4, COMB_4_SIZE, combIndex4, feedback, combLp4, dampingCoeff);
             
             // Add room reflections
-            combOut += combBuffer1[readIdx1] * roomSize * 0.15f;
-            combOut += combBuffer2[readIdx2] * roomSize * 0.12f;
+            combOut += reflection1 * roomSize * 0.15f;
+            combOut += reflection2 * roomSize * 0.12f;
         } else {
             // Right channel: different room characteristics
-            // Ensure room offsets are always positive
-            int roomOffset5 = std::max(0, (int)(roomSize * 380 + chaosOutput * 45));
-            int roomOffset6 = std::max(0, (int)(roomSize * 420 + chaosOutput * 55));
-            // Unused room offsets (corresponding read indices are not used)
-            // int roomOffset7 = std::max(0, (int)(roomSize * 280 + chaosOutput * 35));
-            // int roomOffset8 = std::max(0, (int)(roomSize * 460 + chaosOutput * 65));
+            float_4 reflection5 = readRoomTap(combBuffer5, COMB_5_SIZE, combIndex5, roomSize * 380 + chaosOutput * 45);
+            float_4 reflection6 = readRoomTap(combBuffer6, COMB_6_SIZE, combIndex6, roomSize * 420 + chaosOutput * 55);
             
-            // Use safe modulo operation
-            int readIdx5 = ((combIndex5 - roomOffset5) % COMB_5_SIZE + COMB_5_SIZE) % COMB_5_SIZE;
-            int readIdx6 = ((combIndex6 - roomOffset6) % COMB_6_SIZE + COMB_6_SIZE) % COMB_6_SIZE;
-            // Unused read indices
-            // int readIdx7 = ((combIndex7 - roomOffset7) % COMB_7_SIZE + COMB_7_SIZE) % COMB_7_SIZE;
-            // int readIdx8 = ((combIndex8 - roomOffset8) % COMB_8_SIZE + COMB_8_SIZE) % COMB_8_SIZE;
-            
-            float roomInput = input * roomScale;
+            float_4 roomInput = input * roomScale;
             combOut += processComb(roomInput, combBuffer5, COMB_5_SIZE, combIndex5, feedback, combLp5, dampingCoeff);
             combOut += processComb(roomInput, combBuffer6, COMB_6_SIZE, combIndex6, feedback, combLp6, dampingCoeff);
             combOut += processComb(roomInput, combBuffer7, COMB_7_SIZE, combIndex7, feedback, combLp7, dampingCoeff);
             combOut += processComb(roomInput, combBuffer8, COMB_8_SIZE, combIndex8, feedback, combLp8, dampingCoeff);
             
             // Add room reflections
-            combOut += combBuffer5[readIdx5] * roomSize * 0.13f;
-            combOut += combBuffer6[readIdx6] * roomSize * 0.11f;
+            combOut += reflection5 * roomSize * 0.13f;
+            combOut += reflection6 * roomSize * 0.11f;
         }
         
         // Scale comb output
         combOut *= 0.25f;
         
         // Series allpass diffusion
-        float diffused = combOut;
+        float_4 diffused = combOut;
         diffused = processAllpass(diffused, allpassBuffer1, ALLPASS_1_SIZE, allpassIndex1, 0.5f);
         diffused = processAllpass(diffused, allpassBuffer2, ALLPASS_2_SIZE, allpassIndex2, 0.5f);
         diffused = processAllpass(diffused, allpassBuffer3, ALLPASS_3_SIZE, allpassIndex3, 0.5f);
@@ -273,7 +297,7 @@ struct ReverbProcessor {
         float hpCutoff = 100.0f / (sampleRate * 0.5f); // Normalized frequency
         hpCutoff = clamp(hpCutoff, 0.001f, 0.1f); // Safety clamp
         hpState += (diffused - hpState) * hpCutoff;
-        float hpOutput = diffused - hpState;
+        float_4 hpOutput = diffused - hpState;
         
         return hpOutput;
     }
@@ -281,129 +305,141 @@ struct ReverbProcessor {
 
 struct GrainProcessor {
     static constexpr int GRAIN_BUFFER_SIZE = 8192;
-    float grainBuffer[GRAIN_BUFFER_SIZE];
+    float_4 grainBuffer[GRAIN_BUFFER_SIZE];
     int grainWriteIndex = 0;
     
+    // One grain slot for each of the 4 lanes
     struct Grain {
-        bool active = false;
-        float position = 0.0f;
-        float size = 0.0f;
-        float envelope = 0.0f;
-        float direction = 1.0f;
-        float pitch = 1.0f;
+        float_4 active = 0.0f;  // 1 = playing
+        float_4 position = 0.0f;
+        float_4 size = 1.0f;
+        float_4 envelope = 0.0f;
+        float_4 direction = 1.0f;
+        float_4 pitch = 1.0f;
     };
     
     static constexpr int MAX_GRAINS = 16;
     Grain grains[MAX_GRAINS];
     
-    float phase = 0.0f;
-    dsp::SchmittTrigger grainTrigger;
+    float_4 phase = 0.0f;
+    
+    // grainBuffer is written in order from index 0, so reset only clears the
+    // first writtenSamples (all of it before the first reset)
+    int writtenSamples = GRAIN_BUFFER_SIZE;
+    
+    GrainProcessor() { reset(); }
     
     void reset() {
-        for (int i = 0; i < GRAIN_BUFFER_SIZE; i++) {
-            grainBuffer[i] = 0.0f;
-        }
+        std::fill(grainBuffer, grainBuffer + writtenSamples, float_4(0.0f));
+        writtenSamples = 0;
         grainWriteIndex = 0;
         
         for (int i = 0; i < MAX_GRAINS; i++) {
-            grains[i].active = false;
+            grains[i].active = 0.0f;
         }
         phase = 0.0f;
     }
     
-    float process(float input, float grainSize, float density, float position, 
-                  bool chaosEnabled, float chaosOutput, float sampleRate) {
+    // Start a grain on one lane in its first free slot
+    void startGrain(int lane, float grainSamples, float densityValue, float position,
+                    bool chaosEnabled, float chaosOutput) {
+        for (int i = 0; i < MAX_GRAINS; i++) {
+            Grain& grain = grains[i];
+            if (grain.active[lane] == 0.0f) {
+                grain.active[lane] = 1.0f;
+                grain.size[lane] = grainSamples;
+                grain.envelope[lane] = 0.0f;
+                
+                float pos = position;
+                if (chaosEnabled) {
+                    pos += chaosOutput * 20.0f; // Enhanced shift 10x from 2.0f
+                    if (random::uniform() < 0.3f) {
+                        grain.direction[lane] = -1.0f;
+                    } else {
+                        grain.direction[lane] = 1.0f;
+                    }
+                    
+                    if (densityValue > 0.7f && random::uniform() < 0.2f) {
+                        grain.pitch[lane] = random::uniform() < 0.5f ? 0.5f : 2.0f;
+                    } else {
+                        grain.pitch[lane] = 1.0f;
+                    }
+                } else {
+                    grain.direction[lane] = 1.0f;
+                    grain.pitch[lane] = 1.0f;
+                }
+                
+                pos = clamp(pos, 0.0f, 1.0f);
+                grain.position[lane] = pos * GRAIN_BUFFER_SIZE;
+                break;
+            }
+        }
+    }
+    
+    float_4 process(float_4 input, float_4 grainSize, float_4 density, float_4 position, 
+                    bool chaosEnabled, float_4 chaosOutput, float sampleRate) {
         
         grainBuffer[grainWriteIndex] = input;
         grainWriteIndex = (grainWriteIndex + 1) % GRAIN_BUFFER_SIZE;
+        if (writtenSamples < GRAIN_BUFFER_SIZE) writtenSamples++;
         
-        float grainSizeMs = grainSize * 99.0f + 1.0f;
-        float grainSamples = (grainSizeMs / 1000.0f) * sampleRate;
+        float_4 grainSizeMs = grainSize * 99.0f + 1.0f;
+        float_4 grainSamples = (grainSizeMs / 1000.0f) * sampleRate;
         
-        float densityValue = density;
+        float_4 densityValue = density;
         if (chaosEnabled) {
             densityValue += chaosOutput * 0.3f;
         }
-        densityValue = clamp(densityValue, 0.0f, 1.0f);
+        densityValue = simd::clamp(densityValue, 0.0f, 1.0f);
         
-        float triggerRate = densityValue * 50.0f + 1.0f;
+        float_4 triggerRate = densityValue * 50.0f + 1.0f;
         phase += triggerRate / sampleRate;
         
-        if (phase >= 1.0f) {
-            phase -= 1.0f;
-            
-            for (int i = 0; i < MAX_GRAINS; i++) {
-                if (!grains[i].active) {
-                    grains[i].active = true;
-                    grains[i].size = grainSamples;
-                    grains[i].envelope = 0.0f;
-                    
-                    float pos = position;
-                    if (chaosEnabled) {
-                        pos += chaosOutput * 20.0f; // Enhanced shift 10x from 2.0f
-                        if (random::uniform() < 0.3f) {
-                            grains[i].direction = -1.0f;
-                        } else {
-                            grains[i].direction = 1.0f;
-                        }
-                        
-                        if (densityValue > 0.7f && random::uniform() < 0.2f) {
-                            grains[i].pitch = random::uniform() < 0.5f ? 0.5f : 2.0f;
-                        } else {
-                            grains[i].pitch = 1.0f;
-                        }
-                    } else {
-                        grains[i].direction = 1.0f;
-                        grains[i].pitch = 1.0f;
-                    }
-                    
-                    pos = clamp(pos, 0.0f, 1.0f);
-                    grains[i].position = pos * GRAIN_BUFFER_SIZE;
-                    break;
+        float_4 triggered = phase >= 1.0f;
+        int triggeredLanes = simd::movemask(triggered);
+        if (triggeredLanes) {
+            phase -= simd::ifelse(triggered, 1.0f, 0.0f);
+            for (int lane = 0; lane < 4; lane++) {
+                if (triggeredLanes & (1 << lane)) {
+                    startGrain(lane, grainSamples[lane], densityValue[lane], position[lane],
+                               chaosEnabled, chaosOutput[lane]);
                 }
             }
         }
         
-        float output = 0.0f;
-        int activeGrains = 0;
+        float_4 output = 0.0f;
+        float_4 activeGrains = 0.0f;
         
         for (int i = 0; i < MAX_GRAINS; i++) {
-            if (grains[i].active) {
-                float envPhase = grains[i].envelope / grains[i].size;
-                
-                if (envPhase >= 1.0f) {
-                    grains[i].active = false;
-                    continue;
-                }
-                
-                float env = 0.5f * (1.0f - cos(envPhase * 2.0f * M_PI));
-                
-                int readPos = (int)grains[i].position;
+            Grain& grain = grains[i];
+            float_4 envPhase = grain.envelope / grain.size;
+            grain.active = simd::ifelse(envPhase >= 1.0f, 0.0f, grain.active);
+            
+            float_4 playing = grain.active > 0.0f;
+            if (!simd::movemask(playing)) continue;
+            
+            float_4 env = 0.5f * (1.0f - simd::cos(envPhase * (2.0f * M_PI)));
+            
+            int readPos[4];
+            for (int lane = 0; lane < 4; lane++) {
                 // Ensure readPos is always valid
-                readPos = ((readPos % GRAIN_BUFFER_SIZE) + GRAIN_BUFFER_SIZE) % GRAIN_BUFFER_SIZE;
-                
-                float sample = grainBuffer[readPos];
-                output += sample * env;
-                
-                // Update position with proper boundary handling
-                grains[i].position += grains[i].direction * grains[i].pitch;
-                
-                // Handle position wrapping to prevent accumulated floating point errors
-                while (grains[i].position >= GRAIN_BUFFER_SIZE) {
-                    grains[i].position -= GRAIN_BUFFER_SIZE;
-                }
-                while (grains[i].position < 0) {
-                    grains[i].position += GRAIN_BUFFER_SIZE;
-                }
-                
-                grains[i].envelope += 1.0f;
-                activeGrains++;
+                int pos = (int)grain.position[lane];
+                readPos[lane] = ((pos % GRAIN_BUFFER_SIZE) + GRAIN_BUFFER_SIZE) % GRAIN_BUFFER_SIZE;
             }
+            
+            float_4 sample = readInterleaved(grainBuffer, readPos);
+            output += simd::ifelse(playing, sample * env, 0.0f);
+            
+            // Update position with proper boundary handling (steps are at most 2 samples)
+            grain.position += simd::ifelse(playing, grain.direction * grain.pitch, 0.0f);
+            grain.position = simd::ifelse(grain.position >= GRAIN_BUFFER_SIZE, grain.position - GRAIN_BUFFER_SIZE, grain.position);
+            grain.position = simd::ifelse(grain.position < 0.0f, grain.position + GRAIN_BUFFER_SIZE, grain.position);
+            
+            grain.envelope += simd::ifelse(playing, 1.0f, 0.0f);
+            activeGrains += simd::ifelse(playing, 1.0f, 0.0f);
         }
         
-        if (activeGrains > 0) {
-            output /= sqrt(activeGrains);
-        }
+        output = simd::ifelse(activeGrains > 0.0f, output / simd::sqrt(activeGrains), output);
         
         return output;
     }
@@ -463,15 +499,65 @@ struct EllenRipley : rack::engine::Module {
 
     static constexpr int DELAY_BUFFER_SIZE = 96000;
     static constexpr int MAX_POLY = 16;
-    float leftDelayBuffer[MAX_POLY][DELAY_BUFFER_SIZE];
-    float rightDelayBuffer[MAX_POLY][DELAY_BUFFER_SIZE];
-    int delayWriteIndex[MAX_POLY];
+    static constexpr int MAX_GROUPS = MAX_POLY / 4;  // float_4 lane groups
+
+    // State for channels 4g..4g+3. All groups are allocated by the
+    // constructor, never by process()
+    struct ChannelGroup {
+        // Interleaved: element i holds sample i of the group's 4 channels.
+        // calloc'd, so the pages stay untouched until the delay reaches them
+        float_4* leftDelayBuffer = nullptr;
+        float_4* rightDelayBuffer = nullptr;
+        int delayWriteIndex = 0;
+        int delayWritten = 0;  // Written from index 0 since the last clear
+
+        ChaosGenerator chaosGen;
+        GrainProcessor leftGrainProcessor;
+        GrainProcessor rightGrainProcessor;
+        ReverbProcessor leftReverbProcessor;
+        ReverbProcessor rightReverbProcessor;
+
+        // Chaos shape (step) state
+        float_4 chaosLastStep = 0.0f;
+        float_4 chaosStepPhase = 0.0f;
+
+        ChannelGroup() {
+            leftDelayBuffer = (float_4*)std::calloc(DELAY_BUFFER_SIZE, sizeof(float_4));
+            rightDelayBuffer = (float_4*)std::calloc(DELAY_BUFFER_SIZE, sizeof(float_4));
+            if (!leftDelayBuffer || !rightDelayBuffer) {
+                std::free(leftDelayBuffer);
+                std::free(rightDelayBuffer);
+                throw std::bad_alloc();
+            }
+        }
+
+        ~ChannelGroup() {
+            std::free(leftDelayBuffer);
+            std::free(rightDelayBuffer);
+        }
+
+        ChannelGroup(const ChannelGroup&) = delete;
+        ChannelGroup& operator=(const ChannelGroup&) = delete;
+
+        void reset() {
+            chaosGen.reset();
+            leftGrainProcessor.reset();
+            rightGrainProcessor.reset();
+            leftReverbProcessor.reset();
+            rightReverbProcessor.reset();
+
+            // The reverb feedback also lands one past the written region
+            int dirty = std::min(delayWritten + 1, DELAY_BUFFER_SIZE);
+            std::fill(leftDelayBuffer, leftDelayBuffer + dirty, float_4(0.0f));
+            std::fill(rightDelayBuffer, rightDelayBuffer + dirty, float_4(0.0f));
+            delayWriteIndex = 0;
+            delayWritten = 0;
+            chaosLastStep = 0.0f;
+            chaosStepPhase = 0.0f;
+        }
+    };
 
-    ChaosGenerator chaosGen[MAX_POLY];
-    GrainProcessor leftGrainProcessor[MAX_POLY];
-    GrainProcessor rightGrainProcessor[MAX_POLY];
-    ReverbProcessor leftReverbProcessor[MAX_POLY];
-    ReverbProcessor rightReverbProcessor[MAX_POLY];
+    std::unique_ptr<ChannelGroup> groups[MAX_GROUPS];
     
     bool delayChaosMod = false;
     bool grainChaosMod = false;
@@ -522,28 +608,16 @@ struct EllenRipley : rack::engine::Module {
         configLight(REVERB_CHAOS_LIGHT, "Reverb Chaos");
         configLight(CHAOS_SHAPE_LIGHT, "Chaos Shape");
 
-        // Initialize buffers for all polyphonic channels
-        for (int c = 0; c < MAX_POLY; c++) {
-            for (int i = 0; i < DELAY_BUFFER_SIZE; i++) {
-                leftDelayBuffer[c][i] = 0.0f;
-                rightDelayBuffer[c][i] = 0.0f;
-            }
-            delayWriteIndex[c] = 0;
+        // Delay lines of groups a cable never reaches stay untouched calloc pages
+        for (int g = 0; g < MAX_GROUPS; g++) {
+            groups[g].reset(new ChannelGroup());
         }
     }
     
     void onReset() override {
-        for (int c = 0; c < MAX_POLY; c++) {
-            chaosGen[c].reset();
-            leftGrainProcessor[c].reset();
-            rightGrainProcessor[c].reset();
-            leftReverbProcessor[c].reset();
-            rightReverbProcessor[c].reset();
-            for (int i = 0; i < DELAY_BUFFER_SIZE; i++) {
-                leftDelayBuffer[c][i] = 0.0f;
-                rightDelayBuffer[c][i] = 0.0f;
-            }
-            delayWriteIndex[c] = 0;
+        // Only clears what each group has written, so unused groups cost nothing
+        for (int g = 0; g < MAX_GROUPS; g++) {
+            groups[g]->reset();
         }
     }
 
@@ -560,6 +634,35 @@ struct EllenRipley : rack::engine::Module {
         }
     }
     
+    // 4 channels of a poly input starting at c; lanes past the cable's channel count read 0
+    static float_4 getPolyInput4(Input& input, int c, int inputChannels) {
+        float_4 v = input.getVoltageSimd<float_4>(c);
+        float_4 lane = float_4(0.0f, 1.0f, 2.0f, 3.0f) + (float)c;
+        return simd::ifelse(lane < (float)inputChannels, v, 0.0f);
+    }
+
+    // Get CV inputs (use channel 0 if polyphonic CV not available for this channel)
+    static float_4 getCVInput4(Input& input, int c) {
+        if (!input.isConnected()) return 0.0f;
+        int cvChannels = input.getChannels();
+        if (c + 4 <= cvChannels) return input.getVoltageSimd<float_4>(c);
+        float_4 v;
+        for (int lane = 0; lane < 4; lane++) {
+            int useChan = (c + lane < cvChannels) ? c + lane : 0;
+            v[lane] = input.getVoltage(useChan);
+        }
+        return v;
+    }
+
+    // Per-lane delay read taps for delay times in seconds
+    static void delayTaps(const ChannelGroup& group, float_4 delayTime, float sampleRate, int taps[4]) {
+        for (int lane = 0; lane < 4; lane++) {
+            int delaySamples = (int)(delayTime[lane] * sampleRate);
+            delaySamples = clamp(delaySamples, 1, DELAY_BUFFER_SIZE - 1);
+            taps[lane] = (group.delayWriteIndex - delaySamples + DELAY_BUFFER_SIZE) % DELAY_BUFFER_SIZE;
+        }
+    }
+    
     void process(const ProcessArgs& args) override {
         // Defensive checks
         if (args.sampleRate <= 0) return;
@@ -585,181 +688,147 @@ struct EllenRipley : rack::engine::Module {
         lights[REVERB_CHAOS_LIGHT].setBrightness(reverbChaosMod ? 1.0f : 0.0f);
         lights[CHAOS_SHAPE_LIGHT].setBrightness(params[CHAOS_SHAPE_PARAM].getValue() > 0.5f ? 1.0f : 0.0f);
 
-        // Process each polyphonic channel
-        for (int c = 0; c < channels; c++) {
-            float chaosRateParam = params[CHAOS_RATE_PARAM].getValue();
-            bool chaosStep = params[CHAOS_SHAPE_PARAM].getValue() > 0.5f;
-            float chaosRate;
+        // Parameters shared by all channels
+        float chaosRateParam = params[CHAOS_RATE_PARAM].getValue();
+        bool chaosStep = params[CHAOS_SHAPE_PARAM].getValue() > 0.5f;
+        float chaosRate;
 
-            if (chaosStep) {
-                // Shape ON: 1.0-10.0 range
-                chaosRate = 1.0f + chaosRateParam * 9.0f;
-            } else {
-                // Shape OFF: 0.01-1.0 range
-                chaosRate = 0.01f + chaosRateParam * 0.99f;
-            }
-            float chaosAmount = params[CHAOS_AMOUNT_PARAM].getValue();
-            float chaosRaw = chaosGen[c].process(chaosRate) * chaosAmount;
-
-            float chaosOutput;
+        if (chaosStep) {
+            // Shape ON: 1.0-10.0 range
+            chaosRate = 1.0f + chaosRateParam * 9.0f;
+        } else {
+            // Shape OFF: 0.01-1.0 range
+            chaosRate = 0.01f + chaosRateParam * 0.99f;
+        }
+        float chaosAmount = params[CHAOS_AMOUNT_PARAM].getValue();
+        float delayWetDryMix = params[WET_DRY_PARAM].getValue();
+        float grainWetDryMix = params[GRAIN_WET_DRY_PARAM].getValue();
+        float reverbWetDryMix = params[REVERB_WET_DRY_PARAM].getValue();
+
+        // Process 4 polyphonic channels per group
+        int activeGroups = std::min((channels + 3) / 4, MAX_GROUPS);
+        for (int g = 0; g < activeGroups; g++) {
+            ChannelGroup& group = *groups[g];
+            int c = g * 4;
+            float_4 chaosRaw = group.chaosGen.process(chaosRate) * chaosAmount;
+
+            float_4 chaosOutput;
             if (chaosStep) {
                 // Use chaos rate to control step update frequency per channel
-                static float lastStep[MAX_POLY] = {};
-                static float stepPhase[MAX_POLY] = {};
                 float stepRate = chaosRate * 10.0f; // Scale rate for step frequency
-                stepPhase[c] += stepRate / args.sampleRate;
-                if (stepPhase[c] >= 1.0f) {
-                    lastStep[c] = chaosRaw;
-                    stepPhase[c] = 0.0f;
-                }
-                chaosOutput = lastStep[c];
+                group.chaosStepPhase += stepRate / args.sampleRate;
+                float_4 stepped = group.chaosStepPhase >= 1.0f;
+                group.chaosLastStep = simd::ifelse(stepped, chaosRaw, group.chaosLastStep);
+                group.chaosStepPhase = simd::ifelse(stepped, 0.0f, group.chaosStepPhase);
+                chaosOutput = group.chaosLastStep;
             } else {
                 chaosOutput = chaosRaw;
             }
 
-            outputs[CHAOS_CV_OUTPUT].setVoltage(chaosOutput * 5.0f, c);
+            outputs[CHAOS_CV_OUTPUT].setVoltageSimd(chaosOutput * 5.0f, c);
 
-            // Get input voltages for this channel
-            float leftInput = (c < leftChannels) ? inputs[LEFT_AUDIO_INPUT].getPolyVoltage(c) : 0.0f;
-            float rightInput = 0.0f;
+            // Get input voltages for these channels
+            float_4 leftInput = getPolyInput4(inputs[LEFT_AUDIO_INPUT], c, leftChannels);
+            float_4 rightInput;
             if (inputs[RIGHT_AUDIO_INPUT].isConnected()) {
-                rightInput = (c < rightChannels) ? inputs[RIGHT_AUDIO_INPUT].getPolyVoltage(c) : 0.0f;
+                rightInput = getPolyInput4(inputs[RIGHT_AUDIO_INPUT], c, rightChannels);
             } else {
                 rightInput = leftInput;
             }
 
             // Validate input signals
-            if (!std::isfinite(leftInput)) leftInput = 0.0f;
-            if (!std::isfinite(rightInput)) rightInput = 0.0f;
-
-            // Get CV inputs (use channel 0 if polyphonic CV not available for this channel)
-            auto getCVInput = [](Input& input, int channel) -> float {
-                if (!input.isConnected()) return 0.0f;
-                int cvChannels = input.getChannels();
-                int useChan = (channel < cvChannels) ? channel : 0;
-                return input.getPolyVoltage(useChan);
-            };
-
-            float delayTimeL = params[DELAY_TIME_L_PARAM].getValue();
-            if (inputs[DELAY_TIME_L_CV_INPUT].isConnected()) {
-                float cv = getCVInput(inputs[DELAY_TIME_L_CV_INPUT], c);
-                delayTimeL += cv * 0.2f;
-            }
+            leftInput = finiteOrZero(leftInput);
+            rightInput = finiteOrZero(rightInput);
+
+            float_4 delayTimeL = params[DELAY_TIME_L_PARAM].getValue();
+            delayTimeL += getCVInput4(inputs[DELAY_TIME_L_CV_INPUT], c) * 0.2f;
             if (delayChaosMod) {
                 delayTimeL += chaosOutput * 0.1f;
             }
-            delayTimeL = clamp(delayTimeL, 0.001f, 2.0f);
+            delayTimeL = simd::clamp(delayTimeL, 0.001f, 2.0f);
 
-            float delayTimeR = params[DELAY_TIME_R_PARAM].getValue();
-            if (inputs[DELAY_TIME_R_CV_INPUT].isConnected()) {
-                float cv = getCVInput(inputs[DELAY_TIME_R_CV_INPUT], c);
-                delayTimeR += cv * 0.2f;
-            }
+            float_4 delayTimeR = params[DELAY_TIME_R_PARAM].getValue();
+            delayTimeR += getCVInput4(inputs[DELAY_TIME_R_CV_INPUT], c) * 0.2f;
             if (delayChaosMod) {
                 delayTimeR += chaosOutput * 0.1f;
             }
-            delayTimeR = clamp(delayTimeR, 0.001f, 2.0f);
+            delayTimeR = simd::clamp(delayTimeR, 0.001f, 2.0f);
 
-            float feedback = params[DELAY_FEEDBACK_PARAM].getValue();
-            if (inputs[DELAY_FEEDBACK_CV_INPUT].isConnected()) {
-                float cv = getCVInput(inputs[DELAY_FEEDBACK_CV_INPUT], c);
-                feedback += cv * 0.1f;
-            }
+            float_4 feedback = params[DELAY_FEEDBACK_PARAM].getValue();
+            feedback += getCVInput4(inputs[DELAY_FEEDBACK_CV_INPUT], c) * 0.1f;
             if (delayChaosMod) {
                 feedback += chaosOutput * 0.1f;
             }
-            feedback = clamp(feedback, 0.0f, 0.95f);
+            feedback = simd::clamp(feedback, 0.0f, 0.95f);
 
-            int delaySamplesL = (int)(delayTimeL * args.sampleRate);
-            delaySamplesL = clamp(delaySamplesL, 1, DELAY_BUFFER_SIZE - 1);
+            int readIndexL[4], readIndexR[4];
+            delayTaps(group, delayTimeL, args.sampleRate, readIndexL);
+            delayTaps(group, delayTimeR, args.sampleRate, readIndexR);
 
-            int delaySamplesR = (int)(delayTimeR * args.sampleRate);
-            delaySamplesR = clamp(delaySamplesR, 1, DELAY_BUFFER_SIZE - 1);
+            float_4 leftDelayedSignal = readInterleaved(group.leftDelayBuffer, readIndexL);
+            float_4 rightDelayedSignal = readInterleaved(group.rightDelayBuffer, readIndexR);
 
-            int readIndexL = (delayWriteIndex[c] - delaySamplesL + DELAY_BUFFER_SIZE) % DELAY_BUFFER_SIZE;
-            int readIndexR = (delayWriteIndex[c] - delaySamplesR + DELAY_BUFFER_SIZE) % DELAY_BUFFER_SIZE;
+            float_4 grainSize = params[GRAIN_SIZE_PARAM].getValue();
+            grainSize += getCVInput4(inputs[GRAIN_SIZE_CV_INPUT], c) * 0.1f;
+            grainSize = simd::clamp(grainSize, 0.0f, 1.0f);
 
-            float leftDelayedSignal = leftDelayBuffer[c][readIndexL];
-            float rightDelayedSignal = rightDelayBuffer[c][readIndexR];
+            float_4 grainDensity = params[GRAIN_DENSITY_PARAM].getValue();
+            grainDensity += getCVInput4(inputs[GRAIN_DENSITY_CV_INPUT], c) * 0.1f;
+            grainDensity = simd::clamp(grainDensity, 0.0f, 1.0f);
 
-            float grainSize = params[GRAIN_SIZE_PARAM].getValue();
-            if (inputs[GRAIN_SIZE_CV_INPUT].isConnected()) {
-                grainSize += getCVInput(inputs[GRAIN_SIZE_CV_INPUT], c) * 0.1f;
-            }
-            grainSize = clamp(grainSize, 0.0f, 1.0f);
+            float_4 grainPosition = params[GRAIN_POSITION_PARAM].getValue();
+            grainPosition += getCVInput4(inputs[GRAIN_POSITION_CV_INPUT], c) * 0.1f;
+            grainPosition = simd::clamp(grainPosition, 0.0f, 1.0f);
 
-            float grainDensity = params[GRAIN_DENSITY_PARAM].getValue();
-            if (inputs[GRAIN_DENSITY_CV_INPUT].isConnected()) {
-                grainDensity += getCVInput(inputs[GRAIN_DENSITY_CV_INPUT], c) * 0.1f;
-            }
-            grainDensity = clamp(grainDensity, 0.0f, 1.0f);
+            float_4 reverbRoomSize = params[REVERB_ROOM_SIZE_PARAM].getValue();
+            reverbRoomSize += getCVInput4(inputs[REVERB_ROOM_SIZE_CV_INPUT], c) * 0.1f;
+            reverbRoomSize = simd::clamp(reverbRoomSize, 0.0f, 1.0f);
 
-            float grainPosition = params[GRAIN_POSITION_PARAM].getValue();
-            if (inputs[GRAIN_POSITION_CV_INPUT].isConnected()) {
-                grainPosition += getCVInput(inputs[GRAIN_POSITION_CV_INPUT], c) * 0.1f;
-            }
-            grainPosition = clamp(grainPosition, 0.0f, 1.0f);
+            float_4 reverbDamping = params[REVERB_DAMPING_PARAM].getValue();
+            reverbDamping += getCVInput4(inputs[REVERB_DAMPING_CV_INPUT], c) * 0.1f;
+            reverbDamping = simd::clamp(reverbDamping, 0.0f, 1.0f);
 
-            float reverbRoomSize = params[REVERB_ROOM_SIZE_PARAM].getValue();
-            if (inputs[REVERB_ROOM_SIZE_CV_INPUT].isConnected()) {
-                reverbRoomSize += getCVInput(inputs[REVERB_ROOM_SIZE_CV_INPUT], c) * 0.1f;
-            }
-            reverbRoomSize = clamp(reverbRoomSize, 0.0f, 1.0f);
+            float_4 reverbDecay = params[REVERB_DECAY_PARAM].getValue();
+            reverbDecay += getCVInput4(inputs[REVERB_DECAY_CV_INPUT], c) * 0.1f;
+            reverbDecay = simd::clamp(reverbDecay, 0.0f, 1.0f);
 
-            float reverbDamping = params[REVERB_DAMPING_PARAM].getValue();
-            if (inputs[REVERB_DAMPING_CV_INPUT].isConnected()) {
-                reverbDamping += getCVInput(inputs[REVERB_DAMPING_CV_INPUT], c) * 0.1f;
-            }
-            reverbDamping = clamp(reverbDamping, 0.0f, 1.0f);
-
-            float reverbDecay = params[REVERB_DECAY_PARAM].getValue();
-            if (inputs[REVERB_DECAY_CV_INPUT].isConnected()) {
-                reverbDecay += getCVInput(inputs[REVERB_DECAY_CV_INPUT], c) * 0.1f;
-            }
-            reverbDecay = clamp(reverbDecay, 0.0f, 1.0f);
+            float_4 leftDelayInput = leftInput + leftDelayedSignal * feedback;
+            float_4 rightDelayInput = rightInput + rightDelayedSignal * feedback;
 
-            float leftDelayInput = leftInput + leftDelayedSignal * feedback;
-            float rightDelayInput = rightInput + rightDelayedSignal * feedback;
-
-            leftDelayBuffer[c][delayWriteIndex[c]] = leftDelayInput;
-            rightDelayBuffer[c][delayWriteIndex[c]] = rightDelayInput;
-            delayWriteIndex[c] = (delayWriteIndex[c] + 1) % DELAY_BUFFER_SIZE;
+            group.leftDelayBuffer[group.delayWriteIndex] = leftDelayInput;
+            group.rightDelayBuffer[group.delayWriteIndex] = rightDelayInput;
+            group.delayWriteIndex = (group.delayWriteIndex + 1) % DELAY_BUFFER_SIZE;
+            if (group.delayWritten < DELAY_BUFFER_SIZE) group.delayWritten++;
 
             // True serial chain: each stage feeds the next
 
             // Stage 1: Delay wet/dry mix
-            float delayWetDryMix = params[WET_DRY_PARAM].getValue();
-            float leftStage1 = leftInput * (1.0f - delayWetDryMix) + leftDelayedSignal * delayWetDryMix;
-            float rightStage1 = rightInput * (1.0f - delayWetDryMix) + rightDelayedSignal * delayWetDryMix;
+            float_4 leftStage1 = leftInput * (1.0f - delayWetDryMix) + leftDelayedSignal * delayWetDryMix;
+            float_4 rightStage1 = rightInput * (1.0f - delayWetDryMix) + rightDelayedSignal * delayWetDryMix;
 
             // Stage 2: Grain processing on stage 1 output
-            float leftGrainOutput = leftGrainProcessor[c].process(leftStage1, grainSize, grainDensity, grainPosition, grainChaosMod, chaosOutput, args.sampleRate);
-            float rightGrainOutput = rightGrainProcessor[c].process(rightStage1, grainSize, grainDensity, grainPosition, grainChaosMod, chaosOutput * -1.0f, args.sampleRate);
+            float_4 leftGrainOutput = group.leftGrainProcessor.process(leftStage1, grainSize, grainDensity, grainPosition, grainChaosMod, chaosOutput, args.sampleRate);
+            float_4 rightGrainOutput = group.rightGrainProcessor.process(rightStage1, grainSize, grainDensity, grainPosition, grainChaosMod, chaosOutput * -1.0f, args.sampleRate);
 
-            float grainWetDryMix = params[GRAIN_WET_DRY_PARAM].getValue();
-            float leftStage2 = leftStage1 * (1.0f - grainWetDryMix) + leftGrainOutput * grainWetDryMix;
-            float rightStage2 = rightStage1 * (1.0f - grainWetDryMix) + rightGrainOutput * grainWetDryMix;
+            float_4 leftStage2 = leftStage1 * (1.0f - grainWetDryMix) + leftGrainOutput * grainWetDryMix;
+            float_4 rightStage2 = rightStage1 * (1.0f - grainWetDryMix) + rightGrainOutput * grainWetDryMix;
 
             // Stage 3: Reverb processing on stage 2 output
-            float leftReverbOutput = leftReverbProcessor[c].process(leftStage2, rightStage2, grainDensity, reverbRoomSize, reverbDamping, reverbDecay, true, reverbChaosMod, chaosOutput, args.sampleRate);
-            float rightReverbOutput = rightReverbProcessor[c].process(leftStage2, rightStage2, grainDensity, reverbRoomSize, reverbDamping, reverbDecay, false, reverbChaosMod, chaosOutput, args.sampleRate);
+            float_4 leftReverbOutput = group.leftReverbProcessor.process(leftStage2, rightStage2, grainDensity, reverbRoomSize, reverbDamping, reverbDecay, true, reverbChaosMod, chaosOutput, args.sampleRate);
+            float_4 rightReverbOutput = group.rightReverbProcessor.process(leftStage2, rightStage2, grainDensity, reverbRoomSize, reverbDamping, reverbDecay, false, reverbChaosMod, chaosOutput, args.sampleRate);
 
-            float reverbWetDryMix = params[REVERB_WET_DRY_PARAM].getValue();
-            float leftFinal = leftStage2 * (1.0f - reverbWetDryMix) + leftReverbOutput * reverbWetDryMix;
-            float rightFinal = rightStage2 * (1.0f - reverbWetDryMix) + rightReverbOutput * reverbWetDryMix;
+            float_4 leftFinal = leftStage2 * (1.0f - reverbWetDryMix) + leftReverbOutput * reverbWetDryMix;
+            float_4 rightFinal = rightStage2 * (1.0f - reverbWetDryMix) + rightReverbOutput * reverbWetDryMix;
 
             // Add reverb feedback to delay input for next frame (creates extended decay)
-            float reverbFeedbackAmount = reverbDecay * 0.3f;
-            leftDelayBuffer[c][delayWriteIndex[c]] += leftReverbOutput * reverbFeedbackAmount;
-            rightDelayBuffer[c][delayWriteIndex[c]] += rightReverbOutput * reverbFeedbackAmount;
+            float_4 reverbFeedbackAmount = reverbDecay * 0.3f;
+            group.leftDelayBuffer[group.delayWriteIndex] += leftReverbOutput * reverbFeedbackAmount;
+            group.rightDelayBuffer[group.delayWriteIndex] += rightReverbOutput * reverbFeedbackAmount;
 
             // Final output validation
-            if (!std::isfinite(leftFinal)) leftFinal = 0.0f;
-            if (!std::isfinite(rightFinal)) rightFinal = 0.0f;
-
-            outputs[LEFT_AUDIO_OUTPUT].setVoltage(leftFinal, c);
-            outputs[RIGHT_AUDIO_OUTPUT].setVoltage(rightFinal, c);
-        } // End of polyphonic channel loop
+            outputs[LEFT_AUDIO_OUTPUT].setVoltageSimd(finiteOrZero(leftFinal), c);
+            outputs[RIGHT_AUDIO_OUTPUT].setVoltageSimd(finiteOrZero(rightFinal), c);
+        } // End of polyphonic group loop
     }
 
     void processBypass(const ProcessArgs& args) override {
@@ -3,6 +3,8 @@
 #include "widgets/PanelTheme.hpp"
 #include <cmath>
 
+using simd::float_4;
+
 // Enhanced text label (same as other modules)
 struct EnhancedTextLabel : TransparentWidget {
     std::string text;
@@ -56,132 +58,106 @@ struct WhiteBackgroundBox : Widget {
     }
 };
 
-// AD Envelope class (based on ADGenerator)
-struct ADEnvelope {
-    enum Phase {
-        IDLE,
-        ATTACK,
-        DECAY
-    };
-
-    Phase phase = IDLE;
-    float triggerOutput = 0.0f;
-    float followerOutput = 0.0f;
-    float attackTime = 0.01f;
-    float decayTime = 1.0f;
-    float phaseTime = 0.0f;
-    float curve = -0.9f;  // Default shape
-    float followerState = 0.0f;
-    float attackCoeff = 0.0f;
-    float releaseCoeff = 0.0f;
-
-    dsp::SchmittTrigger trigger;
-
-    void reset() {
-        phase = IDLE;
-        triggerOutput = 0.0f;
-        followerOutput = 0.0f;
-        phaseTime = 0.0f;
-        followerState = 0.0f;
-    }
-
-    float applyCurve(float x, float curvature) {
-        x = clamp(x, 0.0f, 1.0f);
-
-        if (curvature == 0.0f) {
-            return x;
+// AD envelope bank (based on ADGenerator): the 6 channels' envelopes in SoA
+// layout, padded to 8 lanes so each state variable is two float_4 groups.
+// Lanes 6 and 7 never receive a gate and stay idle.
+struct EnvelopeBank {
+    static const int CHANNELS = 6;
+    static const int GROUPS = 2;
+
+    // Lane values of phase
+    static constexpr float IDLE = 0.0f;
+    static constexpr float ATTACK = 1.0f;
+    static constexpr float DECAY = 2.0f;
+
+    float_4 phase[GROUPS];
+    float_4 phaseTime[GROUPS];
+    float_4 output[GROUPS];
+    float_4 attackTime[GROUPS];
+    float_4 decayTime[GROUPS];
+    float_4 invAttackTime[GROUPS];
+    float_4 invDecayTime[GROUPS];
+    float_4 curve = -0.9f;  // Default shape
+
+    dsp::TSchmittTrigger<float_4> triggers[GROUPS];
+
+    // Knob positions the cached times were computed from (NAN = not yet)
+    float attackParam[GROUPS * 4];
+    float decayParam[GROUPS * 4];
+
+    EnvelopeBank() {
+        for (int g = 0; g < GROUPS; g++) {
+            attackTime[g] = decayTime[g] = 1.0f;
+            invAttackTime[g] = invDecayTime[g] = 1.0f;
         }
-
-        float k = curvature;
-        float abs_x = std::abs(x);
-        float denominator = k - 2.0f * k * abs_x + 1.0f;
-
-        if (std::abs(denominator) < 1e-6f) {
-            return x;
+        for (int lane = 0; lane < GROUPS * 4; lane++) {
+            attackParam[lane] = decayParam[lane] = NAN;
         }
-
-        return (x - k * x) / denominator;
+        reset();
     }
 
-    float processEnvelopeFollower(float triggerVoltage, float sampleTime, float attackTime, float releaseTime, float curve) {
-        attackCoeff = 1.0f - std::exp(-sampleTime / std::max(0.0005f, attackTime * 0.1f));
-        releaseCoeff = 1.0f - std::exp(-sampleTime / std::max(0.001f, releaseTime * 0.5f));
-
-        attackCoeff = clamp(attackCoeff, 0.0f, 1.0f);
-        releaseCoeff = clamp(releaseCoeff, 0.0f, 1.0f);
-
-        float rectified = std::abs(triggerVoltage) / 10.0f;
-        rectified = clamp(rectified, 0.0f, 1.0f);
-
-        float targetCoeff;
-        if (rectified > followerState) {
-            float progress = attackCoeff;
-            targetCoeff = applyCurve(progress, curve);
-        } else {
-            float progress = releaseCoeff;
-            targetCoeff = applyCurve(progress, curve);
+    void reset() {
+        for (int g = 0; g < GROUPS; g++) {
+            phase[g] = IDLE;
+            phaseTime[g] = 0.0f;
+            output[g] = 0.0f;
         }
+    }
 
-        targetCoeff = clamp(targetCoeff, 0.0f, 1.0f);
-
-        followerState += (rectified - followerState) * targetCoeff;
-        followerState = clamp(followerState, 0.0f, 1.0f);
-
-        return followerState;
+    // Knob (0-1) to seconds, 1ms-1000s on a log scale. Only recomputed when the knob moves
+    void setTimes(int lane, float attack, float decay) {
+        if (attack == attackParam[lane] && decay == decayParam[lane]) return;
+        attackParam[lane] = attack;
+        decayParam[lane] = decay;
+
+        float attackSeconds = std::max(0.001f, std::pow(10.0f, (attack - 0.5f) * 6.0f));
+        float decaySeconds = std::max(0.001f, std::pow(10.0f, (decay - 0.5f) * 6.0f));
+        int g = lane / 4;
+        attackTime[g][lane % 4] = attackSeconds;
+        decayTime[g][lane % 4] = decaySeconds;
+        invAttackTime[g][lane % 4] = 1.0f / attackSeconds;
+        invDecayTime[g][lane % 4] = 1.0f / decaySeconds;
     }
 
-    float processTriggerEnvelope(float triggerVoltage, float sampleTime, float attack, float decay, float curve) {
-        // Trigger on rising edge (SchmittTrigger uses 0.1V low / 2.0V high thresholds)
-        if (trigger.process(triggerVoltage)) {
-            phase = ATTACK;
-            phaseTime = 0.0f;
-        }
+    // (x - kx) / (k - 2k|x| + 1) on [0, 1]; k = 0 is linear, a vanishing
+    // denominator falls back to linear
+    static float_4 applyCurve(float_4 x, float_4 k) {
+        x = simd::clamp(x, 0.0f, 1.0f);
+        float_4 denominator = k - 2.0f * k * x + 1.0f;
+        float_4 safe = simd::abs(denominator) >= 1e-6f;
+        return simd::ifelse(safe, (x - k * x) / simd::ifelse(safe, denominator, 1.0f), x);
+    }
 
-        switch (phase) {
-            case IDLE:
-                triggerOutput = 0.0f;
-                break;
-
-            case ATTACK:
-                phaseTime += sampleTime;
-                if (phaseTime >= attack) {
-                    phase = DECAY;
-                    phaseTime = 0.0f;
-                    triggerOutput = 1.0f;
-                } else {
-                    float t = phaseTime / attack;
-                    triggerOutput = applyCurve(t, curve);
-                }
-                break;
-
-            case DECAY:
-                phaseTime += sampleTime;
-                if (phaseTime >= decay) {
-                    triggerOutput = 0.0f;
-                    phase = IDLE;
-                    phaseTime = 0.0f;
-                } else {
-                    float t = phaseTime / decay;
-                    triggerOutput = 1.0f - applyCurve(t, curve);
-                }
-                break;
+    // Only the trigger envelope - gate voltage amplitude should NOT affect envelope output
+    void process(const float_4* gates, float sampleTime) {
+        for (int g = 0; g < GROUPS; g++) {
+            // Trigger on rising edge (default SchmittTrigger thresholds)
+            float_4 triggered = triggers[g].process(gates[g]);
+            phase[g] = simd::ifelse(triggered, ATTACK, phase[g]);
+            phaseTime[g] = simd::ifelse(triggered, 0.0f, phaseTime[g]);
+
+            float_4 attacking = phase[g] == ATTACK;
+            float_4 decaying = phase[g] == DECAY;
+            phaseTime[g] += simd::ifelse(attacking | decaying, sampleTime, 0.0f);
+
+            float_4 attackDone = attacking & (phaseTime[g] >= attackTime[g]);
+            float_4 decayDone = decaying & (phaseTime[g] >= decayTime[g]);
+
+            float_4 t = phaseTime[g] * simd::ifelse(attacking, invAttackTime[g], invDecayTime[g]);
+            float_4 shaped = applyCurve(t, curve);
+            float_4 out = simd::ifelse(attacking, shaped, 1.0f - shaped);
+            out = simd::ifelse(attackDone, 1.0f, out);
+            out = simd::ifelse(attacking | decaying, out, 0.0f);
+            out = simd::ifelse(decayDone, 0.0f, out);
+            output[g] = simd::clamp(out, 0.0f, 1.0f);
+
+            phase[g] = simd::ifelse(attackDone, DECAY, simd::ifelse(decayDone, IDLE, phase[g]));
+            phaseTime[g] = simd::ifelse(attackDone | decayDone, 0.0f, phaseTime[g]);
         }
-
-        return clamp(triggerOutput, 0.0f, 1.0f);
     }
 
-    float process(float sampleTime, float triggerVoltage, float attack, float decay) {
-        float attackTime = std::pow(10.0f, (attack - 0.5f) * 6.0f);
-        float decayTime = std::pow(10.0f, (decay - 0.5f) * 6.0f);
-
-        attackTime = std::max(0.001f, attackTime);
-        decayTime = std::max(0.001f, decayTime);
-
-        // Only use trigger envelope - gate voltage amplitude should NOT affect envelope output
-        float triggerEnv = processTriggerEnvelope(triggerVoltage, sampleTime, attackTime, decayTime, curve);
-
-        return triggerEnv;
-    }
+    float getOutput(int lane) { return output[lane / 4][lane % 4]; }
+    bool isIdle(int lane) { return phase[lane / 4][lane % 4] == IDLE; }
 };
 
 
@@ -304,7 +280,7 @@ struct EnvVCA6 : Module {
         LIGHTS_LEN
     };
 
-    ADEnvelope envelopes[6];
+    EnvelopeBank envelopes;
     dsp::SchmittTrigger sumLatchTriggers[6]; // Only for sum latch buttons
     bool gateOutputStates[6] = {false}; // Track gate output states
     bool lastEnvelopeActive[6] = {false}; // Track envelope state for end-of-cycle trigger
@@ -369,50 +345,63 @@ struct EnvVCA6 : Module {
     }
 
     void process(const ProcessArgs& args) override {
+        // Gather the 6 channels into lanes, then run the envelope bank and VCAs 4 lanes at a time
+        float_4 gates[EnvelopeBank::GROUPS] = {};
+        float_4 inL[EnvelopeBank::GROUPS] = {};
+        float_4 inR[EnvelopeBank::GROUPS] = {};
+        float_4 gain[EnvelopeBank::GROUPS] = {};
+
         for (int i = 0; i < 6; i++) {
             // Get parameters for this channel
             float attackParam = params[CH1_ATTACK_PARAM + i * 5].getValue();
             float releaseParam = params[CH1_RELEASE_PARAM + i * 5].getValue();
             float outVolParam = params[CH1_OUT_VOL_PARAM + i * 5].getValue();
-            bool manualGatePressed = params[CH1_GATE_TRIG_PARAM + i * 5].getValue() > 0.5f;
-            bool sumLatchPressed = params[CH1_SUM_LATCH_PARAM + i * 5].getValue() > 0.5f;
+            envelopes.setTimes(i, attackParam, releaseParam);
 
             // Get inputs
-            float inL = inputs[CH1_IN_L_INPUT + i * 4].getVoltage();
-            float inR = inputs[CH1_IN_R_INPUT + i * 4].getVoltage();
+            float left = inputs[CH1_IN_L_INPUT + i * 4].getVoltage();
+            float right = inputs[CH1_IN_R_INPUT + i * 4].getVoltage();
             float gateIn = inputs[CH1_GATE_INPUT + i * 4].getVoltage();
-            float volCtrl = inputs[CH1_VOL_CTRL_INPUT + i * 4].getVoltage();
 
             // Mono-to-stereo: if only L input connected, copy to R
             if (!inputs[CH1_IN_R_INPUT + i * 4].isConnected() && inputs[CH1_IN_L_INPUT + i * 4].isConnected()) {
-                inR = inL;
+                right = left;
             }
 
             // Manual gate logic: momentary (only while button pressed)
             bool manualGateActive = params[CH1_GATE_TRIG_PARAM + i * 5].getValue() > 0.5f;
 
             // Combine gate sources (input + momentary manual gate)
-            float combinedGate = std::max(gateIn, manualGateActive ? 10.f : 0.f);
-
-            // Process envelope
-            float envelopeOutput = envelopes[i].process(args.sampleTime, combinedGate, attackParam, releaseParam);
-
-            // Apply VCA (envelope controls volume)
-            float vcaGain = envelopeOutput;
+            gates[i / 4][i % 4] = std::max(gateIn, manualGateActive ? 10.f : 0.f);
 
             // Apply volume control CV (0-10V range) - default to 1.0 if not connected
             float volCtrlGain = 1.f;
             if (inputs[CH1_VOL_CTRL_INPUT + i * 4].isConnected()) {
-                volCtrlGain = clamp(volCtrl / 10.f, 0.f, 1.f);
+                volCtrlGain = clamp(inputs[CH1_VOL_CTRL_INPUT + i * 4].getVoltage() / 10.f, 0.f, 1.f);
             }
-            vcaGain *= volCtrlGain;
 
-            // Apply output volume knob
-            vcaGain *= outVolParam;
+            inL[i / 4][i % 4] = left;
+            inR[i / 4][i % 4] = right;
+            // Output volume knob times volume CV
+            gain[i / 4][i % 4] = volCtrlGain * outVolParam;
+        }
 
-            // Process audio
-            float outL = inL * vcaGain;
-            float outR = inR * vcaGain;
+        // Process envelopes
+        envelopes.process(gates, args.sampleTime);
+
+        // Apply VCA (envelope controls volume)
+        float_4 outL[EnvelopeBank::GROUPS];
+        float_4 outR[EnvelopeBank::GROUPS];
+        for (int g = 0; g < EnvelopeBank::GROUPS; g++) {
+            gain[g] *= envelopes.output[g];
+            outL[g] = inL[g] * gain[g];
+            outR[g] = inR[g] * gain[g];
+        }
+
+        for (int i = 0; i < 6; i++) {
+            float envelopeOutput = envelopes.getOutput(i);
+            float combinedGate = gates[i / 4][i % 4];
+            float vcaGain = gain[i / 4][i % 4];
 
             // Gate output logic (three modes)
             int gateMode = (int)params[GATE_MODE_PARAM].getValue(); // 0 = full cycle, 1 = end trigger, 2 = start+end
@@ -423,7 +412,7 @@ struct EnvVCA6 : Module {
                 if (combinedGate > 1.f) {
                     gateOutputStates[i] = true;
                 }
-                if (envelopes[i].phase == ADEnvelope::IDLE && envelopeOutput <= 0.001f) {
+                if (envelopes.isIdle(i) && envelopeOutput <= 0.001f) {
                     gateOutputStates[i] = false;
                 }
                 gateOutputVoltage = gateOutputStates[i] ? 10.f : 0.f;
@@ -462,8 +451,8 @@ struct EnvVCA6 : Module {
             // Set outputs
             outputs[CH1_GATE_OUTPUT + i * 4].setVoltage(gateOutputVoltage);
             outputs[CH1_ENV_OUTPUT + i * 4].setVoltage(envelopeOutput * 10.f);
-            outputs[CH1_OUT_L_OUTPUT + i * 4].setVoltage(outL);
-            outputs[CH1_OUT_R_OUTPUT + i * 4].setVoltage(outR);
+            outputs[CH1_OUT_L_OUTPUT + i * 4].setVoltage(outL[i / 4][i % 4]);
+            outputs[CH1_OUT_R_OUTPUT + i * 4].setVoltage(outR[i / 4][i % 4]);
 
             // VCA light shows current VCA level
             lights[CH1_VCA_LIGHT + i].setBrightness(vcaGain);
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <vector>
 #include <cstring>
+#include <algorithm>
 
 #ifdef __APPLE__
 // External window functions for macOS
@@ -32,6 +33,107 @@ struct MixModeParamQuantity : ParamQuantity {
     }
 };
 
+// YIN pitch detector. Every HOP_SIZE samples the last ANALYSIS_SIZE samples
+// are snapshotted, then each process() call evaluates one lag of the cumulative
+// mean normalized difference function, so the ~WINDOW_SIZE^2 multiply-adds are
+// spread over the following hop instead of landing in a single sample.
+struct PitchTracker {
+    static const int HOP_SIZE = 1024;
+    static const int ANALYSIS_SIZE = 1024;
+    static const int WINDOW_SIZE = ANALYSIS_SIZE / 2;  // Also bounds the longest lag
+    static constexpr float THRESHOLD = 0.15f;
+    static constexpr float MIN_RMS = 0.01f;
+
+    float history[ANALYSIS_SIZE] = {};
+    int historyIndex = 0;
+    int hopCounter = 0;
+
+    // Analysis in progress (nextLag == 0 when idle)
+    float analysis[ANALYSIS_SIZE] = {};
+    float cmnd[WINDOW_SIZE + 1] = {};
+    float differenceSum = 0.0f;
+    int nextLag = 0;
+    int minLag = 0;
+    int maxLag = 0;
+
+    // Returns true and sets frequency when an analysis finishes
+    bool process(float x, float sampleRate, float& frequency) {
+        history[historyIndex++] = x;
+        if (historyIndex >= ANALYSIS_SIZE) {
+            historyIndex = 0;
+        }
+
+        if (++hopCounter >= HOP_SIZE) {
+            hopCounter = 0;
+            startAnalysis(sampleRate);
+        }
+        if (nextLag == 0) return false;
+
+        computeLag(nextLag);
+        // One lag past maxLag is needed for the interpolation
+        if (nextLag++ <= maxLag) return false;
+        nextLag = 0;
+        return findPitch(sampleRate, frequency);
+    }
+
+    void startAnalysis(float sampleRate) {
+        // Unroll the ring oldest first
+        int tail = ANALYSIS_SIZE - historyIndex;
+        std::memcpy(analysis, history + historyIndex, tail * sizeof(float));
+        std::memcpy(analysis + tail, history, historyIndex * sizeof(float));
+
+        // Only detect frequency if signal is strong enough
+        float energy = 0.0f;
+        for (int i = 0; i < ANALYSIS_SIZE; i++) {
+            energy += analysis[i] * analysis[i];
+        }
+        if (std::sqrt(energy / ANALYSIS_SIZE) <= MIN_RMS) return;
+
+        // Search for period between 20Hz and 2000Hz
+        minLag = std::max(2, (int)(sampleRate / 2000.0f));
+        maxLag = std::min((int)(sampleRate / 20.0f), WINDOW_SIZE - 1);
+        if (minLag >= maxLag) return;
+
+        cmnd[0] = 1.0f;
+        differenceSum = 0.0f;
+        nextLag = 1;
+    }
+
+    void computeLag(int lag) {
+        float difference = 0.0f;
+        for (int i = 0; i < WINDOW_SIZE; i++) {
+            float delta = analysis[i] - analysis[i + lag];
+            difference += delta * delta;
+        }
+        differenceSum += difference;
+        cmnd[lag] = differenceSum > 0.0f ? difference * lag / differenceSum : 1.0f;
+    }
+
+    bool findPitch(float sampleRate, float& frequency) {
+        // First dip under the threshold, followed down to its minimum
+        int lag = minLag;
+        while (lag <= maxLag && cmnd[lag] >= THRESHOLD) lag++;
+        if (lag <= maxLag) {
+            while (lag < maxLag && cmnd[lag + 1] < cmnd[lag]) lag++;
+        } else {
+            // No clear period: use the deepest dip
+            lag = minLag;
+            for (int i = minLag + 1; i <= maxLag; i++) {
+                if (cmnd[i] < cmnd[lag]) lag = i;
+            }
+        }
+
+        // Parabolic interpolation for sub-sample period
+        float prev = cmnd[lag - 1];
+        float next = cmnd[lag + 1];
+        float curvature = prev - 2.0f * cmnd[lag] + next;
+        float offset = curvature > 1e-6f ? clamp(0.5f * (prev - next) / curvature, -0.5f, 0.5f) : 0.0f;
+
+        frequency = sampleRate / (lag + offset);
+        return true;
+    }
+};
+
 struct Multiverse : Module {
     int panelTheme = 0; // 0 = Sashimi, 1 = Boring
 
@@ -102,6 +204,7 @@ struct Multiverse : Module {
     struct Channel {
         float displayBuffer[DISPLAY_WIDTH];
         int bufferIndex = 0;
+        uint32_t writeCount = 0;  // Columns written; the display re-uploads when it changes
         int frameIndex = 0;
         float dominantFrequency = 440.0f;
 
@@ -111,12 +214,8 @@ struct Multiverse : Module {
         int pitchWriteIndex = 0;
         float pitchReadIndex = 0.0f;  // Float for fractional sample reading
 
-        // Improved frequency detection using autocorrelation
-        static const int FREQ_BUFFER_SIZE = 1024;
-        float freqBuffer[FREQ_BUFFER_SIZE];
-        int freqBufferIndex = 0;
-        float runningRMS = 0.0f;
-        int freqUpdateCounter = 0;
+        // Frequency detection for the color mapping
+        PitchTracker pitchTracker;
     };
 
     Channel channels[4];
@@ -233,50 +332,11 @@ struct Multiverse : Module {
                 }
             }
 
-            // Improved frequency detection using autocorrelation
-            channel.freqBuffer[channel.freqBufferIndex++] = voltage;
-            if (channel.freqBufferIndex >= Channel::FREQ_BUFFER_SIZE) {
-                channel.freqBufferIndex = 0;
-            }
-
-            // Update frequency every 1024 samples using autocorrelation
-            channel.freqUpdateCounter++;
-            if (channel.freqUpdateCounter >= Channel::FREQ_BUFFER_SIZE) {
-                channel.freqUpdateCounter = 0;
-
-                // Calculate RMS for signal strength
-                float rms = 0.0f;
-                for (int i = 0; i < Channel::FREQ_BUFFER_SIZE; i++) {
-                    rms += channel.freqBuffer[i] * channel.freqBuffer[i];
-                }
-                rms = std::sqrt(rms / Channel::FREQ_BUFFER_SIZE);
-
-                if (rms > 0.01f) {  // Only detect frequency if signal is strong enough
-                    // Autocorrelation for pitch detection
-                    float maxCorr = 0.0f;
-                    int bestPeriod = 0;
-
-                    // Search for period between 20Hz and 2000Hz
-                    int minPeriod = (int)(args.sampleRate / 2000.0f);
-                    int maxPeriod = (int)(args.sampleRate / 20.0f);
-
-                    for (int period = minPeriod; period < maxPeriod && period < Channel::FREQ_BUFFER_SIZE/2; period++) {
-                        float corr = 0.0f;
-                        for (int i = 0; i < Channel::FREQ_BUFFER_SIZE - period; i++) {
-                            corr += channel.freqBuffer[i] * channel.freqBuffer[i + period];
-                        }
-                        if (corr > maxCorr) {
-                            maxCorr = corr;
-                            bestPeriod = period;
-                        }
-                    }
-
-                    if (bestPeriod > 0) {
-                        float detectedFreq = args.sampleRate / bestPeriod;
-                        // Smooth frequency changes
-                        channel.dominantFrequency = 0.7f * channel.dominantFrequency + 0.3f * detectedFreq;
-                    }
-                }
+            // Frequency detection (YIN, spread over the hop)
+            float detectedFreq;
+            if (channel.pitchTracker.process(voltage, args.sampleRate, detectedFreq)) {
+                // Smooth frequency changes
+                channel.dominantFrequency = 0.7f * channel.dominantFrequency + 0.3f * detectedFreq;
             }
 
             // Write original signal to pitch buffer
@@ -326,6 +386,7 @@ struct Multiverse : Module {
                 }
                 channel.displayBuffer[channel.bufferIndex] = pitchedVoltage;
                 channel.bufferIndex++;
+                channel.writeCount++;
                 channel.frameIndex = 0;
             }
         }
@@ -396,87 +457,218 @@ struct Multiverse : Module {
         // Map to full spectrum without rotation
         return octavePosition * 360.0f;
     }
+};
 
-    NVGcolor blendColors(NVGcolor c1, NVGcolor c2, float mixMode, float factor) {
-        int mode = (int)std::round(mixMode);
-        mode = clamp(mode, 0, 3);
-
-        float r1 = c1.r, g1 = c1.g, b1 = c1.b, a1 = c1.a;
-        float r2 = c2.r, g2 = c2.g, b2 = c2.b, a2 = c2.a;
-        float r, g, b, a;
-
-        switch (mode) {
-            case 0: // Add
-                r = std::min(1.0f, r1 + r2);
-                g = std::min(1.0f, g1 + g2);
-                b = std::min(1.0f, b1 + b2);
-                a = std::min(1.0f, a1 + a2);
-                break;
-            case 1: // Screen
-                r = 1 - (1 - r1) * (1 - r2);
-                g = 1 - (1 - g1) * (1 - g2);
-                b = 1 - (1 - b1) * (1 - b2);
-                a = 1 - (1 - a1) * (1 - a2);
-                break;
-            case 2: // Difference
-                r = std::abs(r1 - r2);
-                g = std::abs(g1 - g2);
-                b = std::abs(b1 - b2);
-                a = std::max(a1, a2);
-                break;
-            case 3: // Color Dodge
-                r = (r2 < 0.999f) ? std::min(1.0f, r1 / std::max(0.001f, 1.0f - r2)) : 1.0f;
-                g = (g2 < 0.999f) ? std::min(1.0f, g1 / std::max(0.001f, 1.0f - g2)) : 1.0f;
-                b = (b2 < 0.999f) ? std::min(1.0f, b1 / std::max(0.001f, 1.0f - b2)) : 1.0f;
-                a = std::max(a1, a2);
-                break;
-            default:
-                r = r1; g = g1; b = b1; a = a1;
-                break;
-        }
+// Layers are composited on the GPU. displayBuffer is constant down each column,
+// so every layer is one row of a persistent DISPLAY_WIDTH x 4 texture that only
+// receives the columns written since the last frame; rotation, tint and the mix
+// modes run per pixel in the fragment shader.
+static const char* MULTIVERSE_VERTEX_SHADER = R"(#version 120
+varying vec2 uv;
+void main() {
+    // Display row 0 is the top of the widget
+    uv = vec2(gl_Vertex.x + 1.0, 1.0 - gl_Vertex.y) * 0.5;
+    gl_Position = gl_Vertex;
+}
+)";
+
+static const char* MULTIVERSE_FRAGMENT_SHADER = R"(#version 120
+uniform sampler2D layers;
+uniform vec2 displaySize;
+uniform vec4 layerTransform[4];  // cos / scale, sin / scale, intensity, enabled
+uniform vec3 layerColor[4];
+uniform int mixMode;
+varying vec2 uv;
+
+vec3 blendColors(vec3 a, vec3 b) {
+    if (mixMode == 0) return min(a + b, 1.0);                // Add
+    if (mixMode == 1) return 1.0 - (1.0 - a) * (1.0 - b);    // Screen
+    if (mixMode == 2) return abs(a - b);                     // Difference
+    vec3 dodge = min(a / max(1.0 - b, 0.001), 1.0);          // Color Dodge
+    return mix(dodge, vec3(1.0), step(0.999, b));
+}
+
+void main() {
+    vec2 center = floor(displaySize * 0.5);
+    vec2 d = floor(uv * displaySize) - center;
+    vec3 color = vec3(0.0);
+
+    for (int i = 0; i < 4; i++) {
+        vec4 t = layerTransform[i];
+        if (t.w == 0.0) continue;
+
+        // Rotate about the center, scaled so the layer covers the display
+        vec2 src = floor(center + vec2(d.x * t.x + d.y * t.y, d.y * t.x - d.x * t.y));
+        if (any(lessThan(src, vec2(0.0))) || any(greaterThanEqual(src, displaySize))) continue;
 
-        return nvgRGBAf(r, g, b, a);
+        // Texels hold (voltage + 20) / 40
+        float encoded = texture2D(layers, vec2((src.x + 0.5) / displaySize.x, (float(i) + 0.5) * 0.25)).r;
+        float value = clamp((encoded * 2.0 - 0.5) * t.z, 0.0, 1.0);
+        if (value > 0.0) color = blendColors(color, layerColor[i] * value);
     }
-};
+    gl_FragColor = vec4(color, 1.0);
+}
+)";
 
-struct MultiverseDisplay : Widget {
+struct MultiverseDisplay : OpenGlWidget {
     Multiverse* module = nullptr;
 
-    // Framebuffer for smooth rendering
-    int imageHandle = -1;
-    std::vector<unsigned char> pixelData;
+    GLuint program = 0;
+    GLuint layerTexture = 0;
+    bool programFailed = false;
+    GLint displaySizeLocation = -1;
+    GLint layerTransformLocation = -1;
+    GLint layerColorLocation = -1;
+    GLint mixModeLocation = -1;
+
+    // Channel::writeCount of the displayBuffer in layerTexture, per layer
+    uint32_t uploadedCount[4] = {0, 0, 0, 0};
+    uint16_t rowScratch[Multiverse::DISPLAY_WIDTH];
 
     MultiverseDisplay() {
         box.size = Vec(400, 380);
-        size_t pixelCount = (size_t)Multiverse::DISPLAY_WIDTH * (size_t)Multiverse::DISPLAY_HEIGHT * 4;
-        pixelData.resize(pixelCount);
     }
 
     ~MultiverseDisplay() {
-        if (imageHandle >= 0 && APP && APP->window && APP->window->vg) {
-            nvgDeleteImage(APP->window->vg, imageHandle);
+        if (APP && APP->window && APP->window->vg) {
+            deleteGlObjects();
+        }
+    }
+
+    void onContextDestroy(const ContextDestroyEvent& e) override {
+        deleteGlObjects();
+        OpenGlWidget::onContextDestroy(e);
+    }
+
+    void deleteGlObjects() {
+        if (layerTexture) glDeleteTextures(1, &layerTexture);
+        if (program) glDeleteProgram(program);
+        layerTexture = 0;
+        program = 0;
+    }
+
+    static GLuint compileShader(GLenum type, const char* source) {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        GLint status = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status != GL_TRUE) {
+            char log[1024];
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            WARN("Multiverse shader compile failed: %s", log);
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    bool createProgram() {
+        GLuint vertex = compileShader(GL_VERTEX_SHADER, MULTIVERSE_VERTEX_SHADER);
+        GLuint fragment = compileShader(GL_FRAGMENT_SHADER, MULTIVERSE_FRAGMENT_SHADER);
+        if (vertex && fragment) {
+            program = glCreateProgram();
+            glAttachShader(program, vertex);
+            glAttachShader(program, fragment);
+            glLinkProgram(program);
+            GLint status = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &status);
+            if (status != GL_TRUE) {
+                WARN("Multiverse shader link failed");
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+        if (vertex) glDeleteShader(vertex);
+        if (fragment) glDeleteShader(fragment);
+        if (!program) return false;
+
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "layers"), 0);
+        displaySizeLocation = glGetUniformLocation(program, "displaySize");
+        layerTransformLocation = glGetUniformLocation(program, "layerTransform");
+        layerColorLocation = glGetUniformLocation(program, "layerColor");
+        mixModeLocation = glGetUniformLocation(program, "mixMode");
+        return true;
+    }
+
+    void createTexture() {
+        glGenTextures(1, &layerTexture);
+        glBindTexture(GL_TEXTURE_2D, layerTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE16, Multiverse::DISPLAY_WIDTH, 4, 0,
+                     GL_LUMINANCE, GL_UNSIGNED_SHORT, nullptr);
+
+        for (int layer = 0; layer < 4; layer++) {
+            uploadRow(layer);
+        }
+    }
+
+    // One 1024-texel row (2 KB). Whole rows only: after a wrap or a
+    // retrigger, bufferIndex alone can't tell which columns changed
+    void uploadRow(int layer) {
+        const Multiverse::Channel& channel = module->channels[layer];
+        uploadedCount[layer] = channel.writeCount;
+        for (int x = 0; x < Multiverse::DISPLAY_WIDTH; x++) {
+            float encoded = clamp((channel.displayBuffer[x] + 20.0f) / 40.0f, 0.0f, 1.0f);
+            rowScratch[x] = (uint16_t)(encoded * 65535.0f + 0.5f);
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, layer, Multiverse::DISPLAY_WIDTH, 1,
+                        GL_LUMINANCE, GL_UNSIGNED_SHORT, rowScratch);
+    }
+
+    // Re-upload the layers the audio thread wrote since the last frame
+    void updateLayer(int layer) {
+        if (module->channels[layer].writeCount != uploadedCount[layer]) {
+            uploadRow(layer);
         }
     }
 
     void draw(const DrawArgs &args) override {
-        // Draw background
+        if (module) {
+            // Composite layers into the framebuffer
+            OpenGlWidget::draw(args);
+        } else {
+            // Draw background
+            nvgBeginPath(args.vg);
+            nvgRect(args.vg, 0, 0, box.size.x, box.size.y);
+            nvgFillColor(args.vg, nvgRGB(0, 0, 0));
+            nvgFill(args.vg);
+        }
+
+        // Draw border
         nvgBeginPath(args.vg);
         nvgRect(args.vg, 0, 0, box.size.x, box.size.y);
-        nvgFillColor(args.vg, nvgRGB(0, 0, 0));
-        nvgFill(args.vg);
+        nvgStrokeColor(args.vg, nvgRGBA(60, 60, 60, 255));
+        nvgStrokeWidth(args.vg, 1.0f);
+        nvgStroke(args.vg);
+    }
 
-        if (!module) {
-            // Draw border
-            nvgBeginPath(args.vg);
-            nvgRect(args.vg, 0, 0, box.size.x, box.size.y);
-            nvgStrokeColor(args.vg, nvgRGBA(60, 60, 60, 255));
-            nvgStrokeWidth(args.vg, 1.0f);
-            nvgStroke(args.vg);
+    void drawFramebuffer() override {
+        math::Vec fbSize = getFramebufferSize();
+        glViewport(0.0, 0.0, fbSize.x, fbSize.y);
+        glClearColor(0.0, 0.0, 0.0, 1.0);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        if (!module || programFailed) return;
+        if (!program && !createProgram()) {
+            programFailed = true;
             return;
         }
 
-        // Clear pixel data
-        std::fill(pixelData.begin(), pixelData.end(), 0);
+        glUseProgram(program);
+        glActiveTexture(GL_TEXTURE0);
+        if (layerTexture) {
+            glBindTexture(GL_TEXTURE_2D, layerTexture);
+            for (int layer = 0; layer < 4; layer++) {
+                updateLayer(layer);
+            }
+        } else {
+            createTexture();
+        }
 
         // Get global parameters
         float mixMode = module->params[Multiverse::MIX_PARAM].getValue();
@@ -485,17 +677,11 @@ struct MultiverseDisplay : Widget {
             mixMode = clamp(mixMode, 0.f, 3.f);
         }
 
-        // Process each layer
+        float transforms[4 * 4] = {};
+        float colors[4 * 3] = {};
         for (int layer = 0; layer < 4; layer++) {
             if (!module->inputs[Multiverse::AUDIO_INPUT_1 + layer].isConnected()) continue;
 
-            // Get parameters
-            float curve = module->params[Multiverse::CURVE_PARAM_1 + layer * 4].getValue();
-            if (module->inputs[Multiverse::CURVE_CV_1 + layer * 4].isConnected()) {
-                curve += module->inputs[Multiverse::CURVE_CV_1 + layer * 4].getVoltage() * 0.1f;
-                curve = clamp(curve, 0.0f, 1.0f);
-            }
-
             float angle = module->params[Multiverse::ANGLE_PARAM_1 + layer * 4].getValue();
             angle = (angle - 0.5f) * 360.0f;
             if (module->inputs[Multiverse::ANGLE_CV_1 + layer * 4].isConnected()) {
@@ -509,11 +695,30 @@ struct MultiverseDisplay : Widget {
                 intensity = clamp(intensity, 0.0f, 1.5f);
             }
 
-            // Get frequency for color
+            // Scale the rotated layer so it still covers the display
+            float cosA = 1.0f, sinA = 0.0f, scale = 1.0f;
+            if (std::abs(angle) > 0.01f) {
+                float angleRad = angle * M_PI / 180.0f;
+                cosA = std::cos(angleRad);
+                sinA = std::sin(angleRad);
+
+                float w = Multiverse::DISPLAY_WIDTH;
+                float h = Multiverse::DISPLAY_HEIGHT;
+                float absCosA = std::abs(cosA);
+                float absSinA = std::abs(sinA);
+                float scaleX = (w * absCosA + h * absSinA) / w;
+                float scaleY = (w * absSinA + h * absCosA) / h;
+                scale = std::max(scaleX, scaleY);
+            }
+            transforms[layer * 4 + 0] = cosA / scale;
+            transforms[layer * 4 + 1] = sinA / scale;
+            transforms[layer * 4 + 2] = intensity;
+            transforms[layer * 4 + 3] = 1.0f;
+
+            // Get frequency for color, one HSV conversion per layer
             float freq = module->channels[layer].dominantFrequency;
             float hue = module->getHueFromFrequency(freq);
 
-            // Convert HSV to RGB
             float c = 1.0f;
             float x = c * (1 - std::abs(std::fmod(hue / 60.0f, 2) - 1));
             float r, g, b;
@@ -530,118 +735,26 @@ struct MultiverseDisplay : Widget {
             } else {
                 r = c; g = 0; b = x;
             }
-
-            // Create layer buffer
-            std::vector<float> layerBuffer(Multiverse::DISPLAY_WIDTH * Multiverse::DISPLAY_HEIGHT, 0.0f);
-
-            // Fill layer buffer (no phase shift in widget display)
-            float phaseOffset = 0.0f;
-            for (int x = 0; x < Multiverse::DISPLAY_WIDTH; x++) {
-                int srcX = (int)(x + phaseOffset) % Multiverse::DISPLAY_WIDTH;
-                if (srcX < 0) srcX += Multiverse::DISPLAY_WIDTH;
-
-                float voltage = module->channels[layer].displayBuffer[srcX];
-                float normalizedVoltage = clamp((voltage + 10.0f) * 0.05f * intensity, 0.0f, 1.0f);
-
-                // Fill column
-                for (int y = 0; y < Multiverse::DISPLAY_HEIGHT; y++) {
-                    size_t idx = (size_t)y * Multiverse::DISPLAY_WIDTH + (size_t)x;
-                    layerBuffer[idx] = normalizedVoltage;
-                }
-            }
-
-            // Apply rotation if needed
-            if (std::abs(angle) > 0.01f) {
-                float angleRad = angle * M_PI / 180.0f;
-                float cosA = std::cos(angleRad);
-                float sinA = std::sin(angleRad);
-
-                float w = Multiverse::DISPLAY_WIDTH;
-                float h = Multiverse::DISPLAY_HEIGHT;
-                float absCosA = std::abs(cosA);
-                float absSinA = std::abs(sinA);
-                float scaleX = (w * absCosA + h * absSinA) / w;
-                float scaleY = (w * absSinA + h * absCosA) / h;
-                float scale = std::max(scaleX, scaleY);
-
-                int centerX = Multiverse::DISPLAY_WIDTH / 2;
-                int centerY = Multiverse::DISPLAY_HEIGHT / 2;
-
-                for (int y = 0; y < Multiverse::DISPLAY_HEIGHT; y++) {
-                    for (int x = 0; x < Multiverse::DISPLAY_WIDTH; x++) {
-                        float dx = (x - centerX) / scale;
-                        float dy = (y - centerY) / scale;
-                        int srcX = (int)(centerX + dx * cosA + dy * sinA);
-                        int srcY = (int)(centerY - dx * sinA + dy * cosA);
-
-                        if (srcX >= 0 && srcX < Multiverse::DISPLAY_WIDTH &&
-                            srcY >= 0 && srcY < Multiverse::DISPLAY_HEIGHT) {
-                            size_t srcIdx = (size_t)srcY * Multiverse::DISPLAY_WIDTH + (size_t)srcX;
-                            if (layerBuffer[srcIdx] > 0.0f) {
-                                size_t dstIdx = ((size_t)y * Multiverse::DISPLAY_WIDTH + (size_t)x) * 4;
-
-                                NVGcolor existing = nvgRGBA(pixelData[dstIdx], pixelData[dstIdx + 1],
-                                                           pixelData[dstIdx + 2], pixelData[dstIdx + 3] / 255.0f);
-                                NVGcolor newColor = nvgRGBAf(r * layerBuffer[srcIdx], g * layerBuffer[srcIdx],
-                                                            b * layerBuffer[srcIdx], layerBuffer[srcIdx]);
-                                NVGcolor blended = module->blendColors(existing, newColor, mixMode, 1.0f);
-
-                                pixelData[dstIdx + 0] = (unsigned char)(blended.r * 255);
-                                pixelData[dstIdx + 1] = (unsigned char)(blended.g * 255);
-                                pixelData[dstIdx + 2] = (unsigned char)(blended.b * 255);
-                                pixelData[dstIdx + 3] = 255;
-                            }
-                        }
-                    }
-                }
-            } else {
-                // No rotation - direct copy
-                for (size_t i = 0; i < layerBuffer.size(); i++) {
-                    if (layerBuffer[i] > 0.0f) {
-                        size_t idx = i * 4;
-
-                        NVGcolor existing = nvgRGBA(pixelData[idx], pixelData[idx + 1],
-                                                   pixelData[idx + 2], pixelData[idx + 3] / 255.0f);
-                        NVGcolor newColor = nvgRGBAf(r * layerBuffer[i], g * layerBuffer[i],
-                                                    b * layerBuffer[i], layerBuffer[i]);
-                        NVGcolor blended = module->blendColors(existing, newColor, mixMode, 1.0f);
-
-                        pixelData[idx + 0] = (unsigned char)(blended.r * 255);
-                        pixelData[idx + 1] = (unsigned char)(blended.g * 255);
-                        pixelData[idx + 2] = (unsigned char)(blended.b * 255);
-                        pixelData[idx + 3] = 255;
-                    }
-                }
-            }
-        }
-
-        // Create or update NanoVG image
-        if (imageHandle >= 0) {
-            nvgUpdateImage(args.vg, imageHandle, pixelData.data());
-        } else {
-            imageHandle = nvgCreateImageRGBA(args.vg, Multiverse::DISPLAY_WIDTH, Multiverse::DISPLAY_HEIGHT,
-                                            0, pixelData.data());
-        }
-
-        // Draw the image scaled to widget size
-        if (imageHandle >= 0) {
-            nvgBeginPath(args.vg);
-            nvgRect(args.vg, 0, 0, box.size.x, box.size.y);
-            float scaleX = box.size.x / Multiverse::DISPLAY_WIDTH;
-            float scaleY = box.size.y / Multiverse::DISPLAY_HEIGHT;
-            NVGpaint paint = nvgImagePattern(args.vg, 0, 0,
-                                            box.size.x / scaleX, box.size.y / scaleY,
-                                            0, imageHandle, 1.0f);
-            nvgFillPaint(args.vg, paint);
-            nvgFill(args.vg);
+            colors[layer * 3 + 0] = r;
+            colors[layer * 3 + 1] = g;
+            colors[layer * 3 + 2] = b;
         }
 
-        // Draw border
-        nvgBeginPath(args.vg);
-        nvgRect(args.vg, 0, 0, box.size.x, box.size.y);
-        nvgStrokeColor(args.vg, nvgRGBA(60, 60, 60, 255));
-        nvgStrokeWidth(args.vg, 1.0f);
-        nvgStroke(args.vg);
+        glUniform2f(displaySizeLocation, (float)Multiverse::DISPLAY_WIDTH, (float)Multiverse::DISPLAY_HEIGHT);
+        glUniform4fv(layerTransformLocation, 4, transforms);
+        glUniform3fv(layerColorLocation, 4, colors);
+        glUniform1i(mixModeLocation, clamp((int)std::round(mixMode), 0, 3));
+
+        glBegin(GL_QUADS);
+        glVertex2f(-1.0f, -1.0f);
+        glVertex2f(1.0f, -1.0f);
+        glVertex2f(1.0f, 1.0f);
+        glVertex2f(-1.0f, 1.0f);
+        glEnd();
+
+        // Leave the GL state NanoVG expects
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glUseProgram(0);
     }
 };
 
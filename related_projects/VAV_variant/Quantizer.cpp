@@ -1,6 +1,9 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
 #include "widgets/PanelTheme.hpp"
+#include <atomic>
+
+using simd::float_4;
 struct EnhancedTextLabel : TransparentWidget {
     std::string text;
     float fontSize;
@@ -99,6 +102,13 @@ struct Quantizer : Module {
     // Intervals [i / 24, (i+1) / 24) V mapping to the closest enabled note
     int ranges[24];
     bool playingNotes[12];
+
+    // Output voltage above the octave (note + microtune) and note bit per range.
+    // Rebuilt on the audio thread when the enabled notes or a microtune knob change
+    float rangeVoltages[24];
+    int rangeNoteMasks[24];
+    float tableMicrotune[12];
+    std::atomic<bool> tableDirty{true};
     
     // Microtune presets (in cents)
     static const float EQUAL_TEMPERAMENT[12];
@@ -152,7 +162,15 @@ struct Quantizer : Module {
     }
 
     void process(const ProcessArgs& args) override {
-        bool playingNotes[12] = {};
+        bool dirty = tableDirty.exchange(false);
+        for (int i = 0; i < 12 && !dirty; i++) {
+            dirty = params[C_MICROTUNE_PARAM + i].getValue() != tableMicrotune[i];
+        }
+        if (dirty) {
+            updateTable();
+        }
+
+        int playingMask = 0;
         float scaleParam = params[SCALE_PARAM].getValue();
         float offsetParam = params[OFFSET_PARAM].getValue();
         
@@ -161,39 +179,54 @@ struct Quantizer : Module {
             offsetParam += inputs[OFFSET_CV_INPUT].getVoltage();
         }
 
-        // Process all three tracks
+        // Process all three tracks, 4 channels at a time
         for (int track = 0; track < 3; track++) {
             int inputId = PITCH_INPUT + track;
             int outputId = PITCH_OUTPUT + track;
             
             int channels = std::max(inputs[inputId].getChannels(), 1);
             
-            for (int c = 0; c < channels; c++) {
-                float pitch = inputs[inputId].getVoltage(c);
-
-                // Apply offset first (before quantization)
-                pitch += offsetParam;
-
-                // Apply scale
-                pitch *= scaleParam;
-
-                // Quantize to enabled notes
-                int range = std::floor(pitch * 24);
-                int octave = eucDiv(range, 24);
-                range -= octave * 24;
-                int quantizedNote = ranges[range] + octave * 12;
-                int noteInOctave = eucMod(quantizedNote, 12);
-                playingNotes[noteInOctave] = true;
-
-                // Apply microtune to the quantized note
-                float microtuneOffset = params[C_MICROTUNE_PARAM + noteInOctave].getValue() / 1200.f; // Convert cents to volts (1200 cents = 1V)
-                pitch = float(quantizedNote) / 12.f + microtuneOffset;
+            for (int c = 0; c < channels; c += 4) {
+                float_4 pitch = inputs[inputId].getVoltageSimd<float_4>(c);
+
+                // Apply offset first (before quantization), then scale
+                pitch = (pitch + offsetParam) * scaleParam;
+
+                // Split into octave and one of its 24 ranges
+                float_4 range = simd::floor(pitch * 24.f);
+                float_4 octave = simd::floor(range / 24.f);
+                float_4 index = simd::clamp(range - octave * 24.f, 0.f, 23.f);
+
+                // Look up the quantized, microtuned note
+                float_4 noteVoltage;
+                int lanes = std::min(channels - c, 4);
+                for (int l = 0; l < 4; l++) {
+                    int i = (int)index[l];
+                    noteVoltage[l] = rangeVoltages[i];
+                    if (l < lanes) {
+                        playingMask |= rangeNoteMasks[i];
+                    }
+                }
 
-                outputs[outputId].setVoltage(pitch, c);
+                outputs[outputId].setVoltageSimd(octave + noteVoltage, c);
             }
             outputs[outputId].setChannels(channels);
         }
-        std::memcpy(this->playingNotes, playingNotes, sizeof(playingNotes));
+        for (int note = 0; note < 12; note++) {
+            playingNotes[note] = (playingMask >> note) & 1;
+        }
+    }
+
+    void updateTable() {
+        for (int note = 0; note < 12; note++) {
+            tableMicrotune[note] = params[C_MICROTUNE_PARAM + note].getValue();
+        }
+        for (int i = 0; i < 24; i++) {
+            int noteInOctave = eucMod(ranges[i], 12);
+            // Convert cents to volts (1200 cents = 1V)
+            rangeVoltages[i] = float(ranges[i]) / 12.f + tableMicrotune[noteInOctave] / 1200.f;
+            rangeNoteMasks[i] = 1 << noteInOctave;
+        }
     }
     
     void updateRanges() {
@@ -226,6 +259,7 @@ struct Quantizer : Module {
             }
             ranges[i] = closestNote;
         }
+        tableDirty = true;
     }
 
     void applyMicrotunePreset(int presetIndex) {
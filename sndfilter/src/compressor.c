@@ -6,6 +6,7 @@
 //
 
 #include "compressor.h"
+#include "simd.h"
 #include <math.h>
 #include <string.h>
 
@@ -167,6 +168,9 @@ void sf_advancecomp(sf_compressor_state_st *state, int rate, float pregain, floa
 	state->detectoravg          = 0.0f;
 	state->compgain             = 1.0f;
 	state->maxcompdiffdb        = -1.0f;
+	state->scaleddesiredgain    = 1.0f;
+	state->enveloperate         = 1.0f;
+	state->chunkpos             = 0;
 	state->delaybufsize         = delaybufsize;
 	state->delaywritepos        = 0;
 	state->delayreadpos         = delaybufsize > 1 ? 1 : 0;
@@ -195,8 +199,29 @@ static inline float fixf(float v, float def){
 	return v;
 }
 
-void sf_compressor_process(sf_compressor_state_st *state, int size, sf_sample_st *input,
-	sf_sample_st *output){
+// apply the pregain and find the louder channel for the detector, 4 samples at a time
+static inline void detectorinput(int size, float linearpregain, const float *inputL,
+	const float *inputR, float *pregainL, float *pregainR, float *inputmax){
+	sf_v4 pregain = sf_v4_set1(linearpregain);
+	int i = 0;
+	for (; i + 4 <= size; i += 4){
+		sf_v4 L = sf_v4_mul(sf_v4_load(inputL + i), pregain);
+		sf_v4 R = sf_v4_mul(sf_v4_load(inputR + i), pregain);
+		sf_v4_store(pregainL + i, L);
+		sf_v4_store(pregainR + i, R);
+		sf_v4_store(inputmax + i, sf_v4_max(sf_v4_abs(L), sf_v4_abs(R)));
+	}
+	for (; i < size; i++){
+		pregainL[i] = inputL[i] * linearpregain;
+		pregainR[i] = inputR[i] * linearpregain;
+		float absL = absf(pregainL[i]);
+		float absR = absf(pregainR[i]);
+		inputmax[i] = absL > absR ? absL : absR;
+	}
+}
+
+void sf_compressor_process_planar(sf_compressor_state_st *state, int size, const float *inputL,
+	const float *inputR, float *outputL, float *outputR){
 
 	// pull out the state into local variables
 	float metergain            = state->metergain;
@@ -221,65 +246,72 @@ void sf_compressor_process(sf_compressor_state_st *state, int size, sf_sample_st
 	float detectoravg          = state->detectoravg;
 	float compgain             = state->compgain;
 	float maxcompdiffdb        = state->maxcompdiffdb;
+	float scaleddesiredgain    = state->scaleddesiredgain;
+	float enveloperate         = state->enveloperate;
+	int chunkpos               = state->chunkpos;
 	int delaybufsize           = state->delaybufsize;
 	int delaywritepos          = state->delaywritepos;
 	int delayreadpos           = state->delayreadpos;
 	sf_sample_st *delaybuf     = state->delaybuf;
 
 	int samplesperchunk = SF_COMPRESSOR_SPU;
-	int chunks = size / samplesperchunk;
 	float ang90 = (float)M_PI * 0.5f;
 	float ang90inv = 2.0f / (float)M_PI;
 	int samplepos = 0;
 	float spacingdb = SF_COMPRESSOR_SPACINGDB;
 
-	for (int ch = 0; ch < chunks; ch++){
-		detectoravg = fixf(detectoravg, 1.0f);
-		float desiredgain = detectoravg;
-		float scaleddesiredgain = asinf(desiredgain) * ang90inv;
-		float compdiffdb = lin2db(compgain / scaleddesiredgain);
-
-		// calculate envelope rate based on whether we're attacking or releasing
-		float enveloperate;
-		if (compdiffdb < 0.0f){ // compgain < scaleddesiredgain, so we're releasing
-			compdiffdb = fixf(compdiffdb, -1.0f);
-			maxcompdiffdb = -1; // reset for a future attack mode
-			// apply the adaptive release curve
-			// scale compdiffdb between 0-3
-			float x = (clampf(compdiffdb, -12.0f, 0.0f) + 12.0f) * 0.25f;
-			float releasesamples = adaptivereleasecurve(x, a, b, c, d);
-			enveloperate = db2lin(spacingdb / releasesamples);
-		}
-		else{ // compresorgain > scaleddesiredgain, so we're attacking
-			compdiffdb = fixf(compdiffdb, 1.0f);
-			if (maxcompdiffdb == -1 || maxcompdiffdb < compdiffdb)
-				maxcompdiffdb = compdiffdb;
-			float attenuate = maxcompdiffdb;
-			if (attenuate < 0.5f)
-				attenuate = 0.5f;
-			enveloperate = 1.0f - powf(0.25f / attenuate, attacksamplesinv);
+	// pregained input and detector level for the current mini-chunk
+	float pregainL[SF_COMPRESSOR_SPU], pregainR[SF_COMPRESSOR_SPU], inputmax[SF_COMPRESSOR_SPU];
+
+	while (samplepos < size){
+		if (chunkpos == 0){
+			// start of a mini-chunk
+			detectoravg = fixf(detectoravg, 1.0f);
+			float desiredgain = detectoravg;
+			scaleddesiredgain = asinf(desiredgain) * ang90inv;
+			float compdiffdb = lin2db(compgain / scaleddesiredgain);
+
+			// calculate envelope rate based on whether we're attacking or releasing
+			if (compdiffdb < 0.0f){ // compgain < scaleddesiredgain, so we're releasing
+				compdiffdb = fixf(compdiffdb, -1.0f);
+				maxcompdiffdb = -1; // reset for a future attack mode
+				// apply the adaptive release curve
+				// scale compdiffdb between 0-3
+				float x = (clampf(compdiffdb, -12.0f, 0.0f) + 12.0f) * 0.25f;
+				float releasesamples = adaptivereleasecurve(x, a, b, c, d);
+				enveloperate = db2lin(spacingdb / releasesamples);
+			}
+			else{ // compresorgain > scaleddesiredgain, so we're attacking
+				compdiffdb = fixf(compdiffdb, 1.0f);
+				if (maxcompdiffdb == -1 || maxcompdiffdb < compdiffdb)
+					maxcompdiffdb = compdiffdb;
+				float attenuate = maxcompdiffdb;
+				if (attenuate < 0.5f)
+					attenuate = 0.5f;
+				enveloperate = 1.0f - powf(0.25f / attenuate, attacksamplesinv);
+			}
 		}
 
-		// process the chunk
-		for (int chi = 0; chi < samplesperchunk; chi++, samplepos++,
+		// process the rest of the mini-chunk, or as much of it as we were given
+		int len = samplesperchunk - chunkpos;
+		if (len > size - samplepos)
+			len = size - samplepos;
+		detectorinput(len, linearpregain, inputL + samplepos, inputR + samplepos, pregainL,
+			pregainR, inputmax);
+
+		for (int chi = 0; chi < len; chi++, samplepos++,
 			delayreadpos = (delayreadpos + 1) % delaybufsize,
 			delaywritepos = (delaywritepos + 1) % delaybufsize){
 
-			float inputL = input[samplepos].L * linearpregain;
-			float inputR = input[samplepos].R * linearpregain;
-			delaybuf[delaywritepos] = (sf_sample_st){ .L = inputL, .R = inputR };
-
-			inputL = absf(inputL);
-			inputR = absf(inputR);
-			float inputmax = inputL > inputR ? inputL : inputR;
+			delaybuf[delaywritepos] = (sf_sample_st){ .L = pregainL[chi], .R = pregainR[chi] };
 
 			float attenuation;
-			if (inputmax < 0.0001f)
+			if (inputmax[chi] < 0.0001f)
 				attenuation = 1.0f;
 			else{
-				float inputcomp = compcurve(inputmax, k, slope, linearthreshold,
+				float inputcomp = compcurve(inputmax[chi], k, slope, linearthreshold,
 					linearthresholdknee, threshold, knee, kneedboffset);
-				attenuation = inputcomp / inputmax;
+				attenuation = inputcomp / inputmax[chi];
 			}
 
 			float rate;
@@ -318,17 +350,35 @@ void sf_compressor_process(sf_compressor_state_st *state, int size, sf_sample_st
 				metergain += (premixgaindb - metergain) * meterrelease; // fall slowly
 
 			// apply the gain
-			output[samplepos] = (sf_sample_st){
-				.L = delaybuf[delayreadpos].L * gain,
-				.R = delaybuf[delayreadpos].R * gain
-			};
+			outputL[samplepos] = delaybuf[delayreadpos].L * gain;
+			outputR[samplepos] = delaybuf[delayreadpos].R * gain;
 		}
+		chunkpos = (chunkpos + len) % samplesperchunk;
 	}
 
-	state->metergain     = metergain;
-	state->detectoravg   = detectoravg;
-	state->compgain      = compgain;
-	state->maxcompdiffdb = maxcompdiffdb;
-	state->delaywritepos = delaywritepos;
-	state->delayreadpos  = delayreadpos;
+	state->metergain         = metergain;
+	state->detectoravg       = detectoravg;
+	state->compgain          = compgain;
+	state->maxcompdiffdb     = maxcompdiffdb;
+	state->scaleddesiredgain = scaleddesiredgain;
+	state->enveloperate      = enveloperate;
+	state->chunkpos          = chunkpos;
+	state->delaywritepos     = delaywritepos;
+	state->delayreadpos      = delayreadpos;
+}
+
+void sf_compressor_process(sf_compressor_state_st *state, int size, sf_sample_st *input,
+	sf_sample_st *output){
+	// split the interleaved samples into planar blocks
+	float inL[128], inR[128], outL[128], outR[128];
+	for (int start = 0; start < size; start += 128){
+		int len = size - start < 128 ? size - start : 128;
+		for (int i = 0; i < len; i++){
+			inL[i] = input[start + i].L;
+			inR[i] = input[start + i].R;
+		}
+		sf_compressor_process_planar(state, len, inL, inR, outL, outR);
+		for (int i = 0; i < len; i++)
+			output[start + i] = (sf_sample_st){ outL[i], outR[i] };
+	}
 }
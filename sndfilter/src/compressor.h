@@ -30,8 +30,16 @@
 // structure, since these values must be carried over across chunk boundaries
 //
 // also notice that the choice to divide the sound into chunks of 128 samples is completely
-// arbitrary from the compressor's perspective, however, the size should be divisible by the SPU
-// value below (defaults to 32):
+// arbitrary from the compressor's perspective; the state remembers where it is inside the current
+// SPU-sized mini-chunk (see below), so any size works
+//
+// for real-time use there is also a planar version that takes separate left/right float buffers,
+// which is what audio callbacks usually hand out:
+//
+//   for each callback:
+//     sf_compressor_process_planar(&simplecomp, frames, inL, inR, outL, outR);
+//
+// neither version allocates memory or does any setup per call
 
 // maximum number of samples in the delay buffer
 #define SF_COMPRESSOR_MAXDELAY   1024
@@ -72,6 +80,9 @@ typedef struct {
 	float detectoravg;
 	float compgain;
 	float maxcompdiffdb;
+	float scaleddesiredgain; // envelope of the current mini-chunk
+	float enveloperate;
+	int chunkpos;            // samples already processed in the current mini-chunk
 	int delaybufsize;
 	int delaywritepos;
 	int delayreadpos;
@@ -111,4 +122,9 @@ void sf_advancecomp(sf_compressor_state_st *state,
 void sf_compressor_process(sf_compressor_state_st *state, int size, sf_sample_st *input,
 	sf_sample_st *output);
 
+// same as above, with separate left/right buffers of `size` samples each
+// the output buffers may be the same as the input buffers
+void sf_compressor_process_planar(sf_compressor_state_st *state, int size, const float *inputL,
+	const float *inputR, float *outputL, float *outputR);
+
 #endif // SNDFILTER_COMPRESSOR__H
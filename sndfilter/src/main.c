@@ -11,9 +11,19 @@
 #include "biquad.h"
 #include "compressor.h"
 #include "reverb.h"
+#include "mem.h"
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// samples read, filtered, and written per step; memory use doesn't depend on file length
+#define STREAM_BLOCK  4096
 
 static int printabout(){
 	printf(
@@ -30,10 +40,14 @@ static int printhelp(){
 	printf("\n"
 		"Usage:\n"
 		"  sndfilter input.wav output.wav <filter> <...>\n"
+		"  sndfilter [-j <threads>] inputdir outputdir <filter> <...>\n"
 		"\n"
 		"Where:\n"
 		"  input.wav    Input WAV file to process\n"
 		"  output.wav   Output WAV file of filtered results\n"
+		"  inputdir     Directory of WAV files to process, each with the same filter\n"
+		"  outputdir    Directory to write the results to (created if needed)\n"
+		"  <threads>    Number of files to process at once (default: one per CPU)\n"
 		"  <filter>     One of the available filters (see below)\n"
 		"  <...>        Additional parameters for the particular filter\n"
 		"\n"
@@ -116,113 +130,225 @@ static inline int badargs(const char *filter){
 	return 1;
 }
 
-static inline int biquad(sf_snd input_snd, sf_biquad_state_st *state, const char *output){
-	sf_snd output_snd = sf_snd_new(input_snd->size, input_snd->rate, false);
-	if (output_snd == NULL){
-		sf_snd_free(input_snd);
-		fprintf(stderr, "Error: Failed to apply filter\n");
-		return 1;
-	}
+typedef enum {
+	FILTER_LOWPASS,
+	FILTER_HIGHPASS,
+	FILTER_BANDPASS,
+	FILTER_NOTCH,
+	FILTER_PEAKING,
+	FILTER_ALLPASS,
+	FILTER_LOWSHELF,
+	FILTER_HIGHSHELF,
+	FILTER_COMPRESSOR,
+	FILTER_REVERB
+} filter_type;
 
-	// process the filter in one sweep
-	sf_biquad_process(state, input_snd->size, input_snd->samples, output_snd->samples);
+// filter settings from the command line; the filter state itself is created per file, since
+// every file can have a different sample rate
+typedef struct {
+	filter_type type;
+	float params[6];
+	sf_reverb_preset preset; // reverb only
+} filter_st;
 
-	bool res = sf_wavsave(output_snd, output);
-	sf_snd_free(input_snd);
-	sf_snd_free(output_snd);
-	if (!res){
-		fprintf(stderr, "Error: Failed to save WAV: %s\n", output);
-		return 1;
+// per-file filter state
+typedef union {
+	sf_biquad_state_st bq;
+	sf_compressor_state_st cm;
+	sf_reverb_state_st rv;
+} filterstate_un;
+
+static inline bool getpreset(const char *preset, sf_reverb_preset *p){
+	if      (strcmp(preset, "default"    ) == 0) *p = SF_REVERB_PRESET_DEFAULT;
+	else if (strcmp(preset, "smallhall1" ) == 0) *p = SF_REVERB_PRESET_SMALLHALL1;
+	else if (strcmp(preset, "smallhall2" ) == 0) *p = SF_REVERB_PRESET_SMALLHALL2;
+	else if (strcmp(preset, "mediumhall1") == 0) *p = SF_REVERB_PRESET_MEDIUMHALL1;
+	else if (strcmp(preset, "mediumhall2") == 0) *p = SF_REVERB_PRESET_MEDIUMHALL2;
+	else if (strcmp(preset, "largehall1" ) == 0) *p = SF_REVERB_PRESET_LARGEHALL1;
+	else if (strcmp(preset, "largehall2" ) == 0) *p = SF_REVERB_PRESET_LARGEHALL2;
+	else if (strcmp(preset, "smallroom1" ) == 0) *p = SF_REVERB_PRESET_SMALLROOM1;
+	else if (strcmp(preset, "smallroom2" ) == 0) *p = SF_REVERB_PRESET_SMALLROOM2;
+	else if (strcmp(preset, "mediumroom1") == 0) *p = SF_REVERB_PRESET_MEDIUMROOM1;
+	else if (strcmp(preset, "mediumroom2") == 0) *p = SF_REVERB_PRESET_MEDIUMROOM2;
+	else if (strcmp(preset, "largeroom1" ) == 0) *p = SF_REVERB_PRESET_LARGEROOM1;
+	else if (strcmp(preset, "largeroom2" ) == 0) *p = SF_REVERB_PRESET_LARGEROOM2;
+	else if (strcmp(preset, "mediumer1"  ) == 0) *p = SF_REVERB_PRESET_MEDIUMER1;
+	else if (strcmp(preset, "mediumer2"  ) == 0) *p = SF_REVERB_PRESET_MEDIUMER2;
+	else if (strcmp(preset, "platehigh"  ) == 0) *p = SF_REVERB_PRESET_PLATEHIGH;
+	else if (strcmp(preset, "platelow"   ) == 0) *p = SF_REVERB_PRESET_PLATELOW;
+	else if (strcmp(preset, "longreverb1") == 0) *p = SF_REVERB_PRESET_LONGREVERB1;
+	else if (strcmp(preset, "longreverb2") == 0) *p = SF_REVERB_PRESET_LONGREVERB2;
+	else
+		return false;
+	return true;
+}
+
+// parse the filter and its parameters (returns an exit code, 0 for success)
+static int parsefilter(int argc, char **argv, filter_st *f){
+	static const struct {
+		const char *name;
+		filter_type type;
+		int params;
+	} filters[] = {
+		{ "lowpass"   , FILTER_LOWPASS   , 2 },
+		{ "highpass"  , FILTER_HIGHPASS  , 2 },
+		{ "bandpass"  , FILTER_BANDPASS  , 2 },
+		{ "notch"     , FILTER_NOTCH     , 2 },
+		{ "peaking"   , FILTER_PEAKING   , 3 },
+		{ "allpass"   , FILTER_ALLPASS   , 2 },
+		{ "lowshelf"  , FILTER_LOWSHELF  , 3 },
+		{ "highshelf" , FILTER_HIGHSHELF , 3 },
+		{ "compressor", FILTER_COMPRESSOR, 6 },
+		{ "reverb"    , FILTER_REVERB    , 1 }
+	};
+
+	const char *filter = argv[3];
+	for (int i = 0; i < (int)(sizeof(filters) / sizeof(filters[0])); i++){
+		if (strcmp(filter, filters[i].name) != 0)
+			continue;
+		f->type = filters[i].type;
+		if (!getargs(argc, argv, filters[i].params, f->params))
+			return badargs(filter);
+		if (f->type == FILTER_REVERB){
+			if (argc < 6)
+				return badargs(filter);
+			if (!getpreset(argv[5], &f->preset)){
+				fprintf(stderr, "Error: Invalid reverb preset: %s\n", argv[5]);
+				return 1;
+			}
+		}
+		return 0;
 	}
-	return 0;
+
+	printhelp();
+	fprintf(stderr, "Error: Bad filter \"%s\"\n", filter);
+	return 1;
 }
 
-static inline int compressor(sf_snd input_snd, sf_compressor_state_st *state, const char *output){
-	sf_snd output_snd = sf_snd_new(input_snd->size, input_snd->rate, true);
-	if (output_snd == NULL){
-		sf_snd_free(input_snd);
-		fprintf(stderr, "Error: Failed to apply filter\n");
-		return 1;
+static void initfilter(const filter_st *f, filterstate_un *st, int rate){
+	const float *p = f->params;
+	switch (f->type){
+		case FILTER_LOWPASS   : sf_lowpass  (&st->bq, rate, p[0], p[1]);       break;
+		case FILTER_HIGHPASS  : sf_highpass (&st->bq, rate, p[0], p[1]);       break;
+		case FILTER_BANDPASS  : sf_bandpass (&st->bq, rate, p[0], p[1]);       break;
+		case FILTER_NOTCH     : sf_notch    (&st->bq, rate, p[0], p[1]);       break;
+		case FILTER_PEAKING   : sf_peaking  (&st->bq, rate, p[0], p[1], p[2]); break;
+		case FILTER_ALLPASS   : sf_allpass  (&st->bq, rate, p[0], p[1]);       break;
+		case FILTER_LOWSHELF  : sf_lowshelf (&st->bq, rate, p[0], p[1], p[2]); break;
+		case FILTER_HIGHSHELF : sf_highshelf(&st->bq, rate, p[0], p[1], p[2]); break;
+		case FILTER_COMPRESSOR:
+			sf_simplecomp(&st->cm, rate, p[0], p[1], p[2], p[3], p[4], p[5]);
+			break;
+		case FILTER_REVERB:
+			sf_presetreverb(&st->rv, rate, f->preset);
+			break;
 	}
+}
 
-	// process the compressor in one sweep
-	sf_compressor_process(state, input_snd->size, input_snd->samples, output_snd->samples);
+static void stepfilter(const filter_st *f, filterstate_un *st, int size, sf_sample_st *input,
+	sf_sample_st *output){
+	switch (f->type){
+		case FILTER_COMPRESSOR:
+			sf_compressor_process(&st->cm, size, input, output);
+			break;
+		case FILTER_REVERB:
+			sf_reverb_process(&st->rv, size, input, output);
+			break;
+		default:
+			sf_biquad_process(&st->bq, size, input, output);
+			break;
+	}
+}
 
-	// note that the compressor does not output one sample per input sample, because the compressor
-	// works in subchunks of 32 samples (this is defined via SF_COMPRESSOR_SPU in compressor.c)
-	//
-	// that means the output size will be floor(input_size / 32) * 32
+// whether two paths name the same file (hard links and symlinks included)
+static bool samefile(const char *a, const char *b){
+	struct stat sa, sb;
+	return stat(a, &sa) == 0 && stat(b, &sb) == 0 &&
+		sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+}
 
-	bool res = sf_wavsave(output_snd, output);
-	sf_snd_free(input_snd);
-	sf_snd_free(output_snd);
-	if (!res){
-		fprintf(stderr, "Error: Failed to save WAV: %s\n", output);
-		return 1;
+// the reader maps the input, so writing over it would truncate it under the reader; an in-place
+// run renders to a temporary file next to the target instead, with the input's permissions
+static char *tempoutput(const char *input, const char *output){
+	struct stat st;
+	size_t len = strlen(output);
+	char *path = malloc(len + 8);
+	if (path == NULL || stat(input, &st) != 0){
+		free(path);
+		return NULL;
 	}
-	return 0;
+	memcpy(path, output, len);
+	memcpy(&path[len], ".XXXXXX", 8);
+	int fd = mkstemp(path);
+	if (fd < 0){
+		free(path);
+		return NULL;
+	}
+	fchmod(fd, st.st_mode & 07777);
+	close(fd);
+	return path;
 }
 
-static inline int reverb(sf_snd input_snd, float tail, const char *preset, const char *output){
-	sf_reverb_preset p;
-	if      (strcmp(preset, "default"    ) == 0) p = SF_REVERB_PRESET_DEFAULT;
-	else if (strcmp(preset, "smallhall1" ) == 0) p = SF_REVERB_PRESET_SMALLHALL1;
-	else if (strcmp(preset, "smallhall2" ) == 0) p = SF_REVERB_PRESET_SMALLHALL2;
-	else if (strcmp(preset, "mediumhall1") == 0) p = SF_REVERB_PRESET_MEDIUMHALL1;
-	else if (strcmp(preset, "mediumhall2") == 0) p = SF_REVERB_PRESET_MEDIUMHALL2;
-	else if (strcmp(preset, "largehall1" ) == 0) p = SF_REVERB_PRESET_LARGEHALL1;
-	else if (strcmp(preset, "largehall2" ) == 0) p = SF_REVERB_PRESET_LARGEHALL2;
-	else if (strcmp(preset, "smallroom1" ) == 0) p = SF_REVERB_PRESET_SMALLROOM1;
-	else if (strcmp(preset, "smallroom2" ) == 0) p = SF_REVERB_PRESET_SMALLROOM2;
-	else if (strcmp(preset, "mediumroom1") == 0) p = SF_REVERB_PRESET_MEDIUMROOM1;
-	else if (strcmp(preset, "mediumroom2") == 0) p = SF_REVERB_PRESET_MEDIUMROOM2;
-	else if (strcmp(preset, "largeroom1" ) == 0) p = SF_REVERB_PRESET_LARGEROOM1;
-	else if (strcmp(preset, "largeroom2" ) == 0) p = SF_REVERB_PRESET_LARGEROOM2;
-	else if (strcmp(preset, "mediumer1"  ) == 0) p = SF_REVERB_PRESET_MEDIUMER1;
-	else if (strcmp(preset, "mediumer2"  ) == 0) p = SF_REVERB_PRESET_MEDIUMER2;
-	else if (strcmp(preset, "platehigh"  ) == 0) p = SF_REVERB_PRESET_PLATEHIGH;
-	else if (strcmp(preset, "platelow"   ) == 0) p = SF_REVERB_PRESET_PLATELOW;
-	else if (strcmp(preset, "longreverb1") == 0) p = SF_REVERB_PRESET_LONGREVERB1;
-	else if (strcmp(preset, "longreverb2") == 0) p = SF_REVERB_PRESET_LONGREVERB2;
-	else{
-		fprintf(stderr, "Error: Invalid reverb preset: %s\n", preset);
+// stream one file through the filter, STREAM_BLOCK samples at a time
+static int runfilter(const filter_st *f, const char *input, const char *output){
+	sf_wavreader wr = sf_wavreader_open(input);
+	if (wr == NULL){
+		fprintf(stderr, "Error: Failed to load WAV: %s\n", input);
 		return 1;
 	}
+	int rate = sf_wavreader_rate(wr);
 
-	int tailsmp = tail * input_snd->rate;
-	sf_snd output_snd = sf_snd_new(input_snd->size + tailsmp, input_snd->rate, true);
-	if (output_snd == NULL){
-		sf_snd_free(input_snd);
+	filterstate_un *st = sf_malloc(sizeof(filterstate_un));
+	sf_sample_st *inbuf = sf_malloc(sizeof(sf_sample_st) * STREAM_BLOCK * 2);
+	if (st == NULL || inbuf == NULL){
+		if (st)
+			sf_free(st);
+		if (inbuf)
+			sf_free(inbuf);
+		sf_wavreader_close(wr);
 		fprintf(stderr, "Error: Failed to apply filter\n");
 		return 1;
 	}
+	sf_sample_st *outbuf = inbuf + STREAM_BLOCK;
+	initfilter(f, st, rate);
 
-	// process the reverb in one sweep
-	sf_reverb_state_st rv;
-	sf_presetreverb(&rv, input_snd->rate, p);
-	sf_reverb_process(&rv, input_snd->size, input_snd->samples, output_snd->samples);
-
-	// append the tail
-	if (tailsmp > 0){
-		int pos = input_snd->size;
-		sf_sample_st empty[48000];
-		memset(empty, 0, sizeof(sf_sample_st) * 48000);
-		while (tailsmp > 0){
-			if (tailsmp <= 48000){
-				sf_reverb_process(&rv, tailsmp, empty, &output_snd->samples[pos]);
+	char *tmppath = NULL;
+	bool res = true;
+	if (samefile(input, output)){
+		tmppath = tempoutput(input, output);
+		res = tmppath != NULL;
+	}
+	sf_wavwriter ww = res ? sf_wavwriter_open(tmppath ? tmppath : output, rate) : NULL;
+	res = ww != NULL;
+
+	// the reverb keeps going for <tail> seconds of silence after the input ends
+	int tailsmp = f->type == FILTER_REVERB ? f->params[0] * rate : 0;
+	while (res){
+		int size = sf_wavreader_read(wr, STREAM_BLOCK, inbuf);
+		if (size <= 0){
+			if (tailsmp <= 0)
 				break;
-			}
-			else{
-				sf_reverb_process(&rv, 48000, empty, &output_snd->samples[pos]);
-				tailsmp -= 48000;
-				pos += 48000;
-			}
+			size = tailsmp < STREAM_BLOCK ? tailsmp : STREAM_BLOCK;
+			memset(inbuf, 0, sizeof(sf_sample_st) * size);
+			tailsmp -= size;
 		}
+		stepfilter(f, st, size, inbuf, outbuf);
+		res = sf_wavwriter_write(ww, size, outbuf);
 	}
 
-	bool res = sf_wavsave(output_snd, output);
-	sf_snd_free(input_snd);
-	sf_snd_free(output_snd);
+	if (ww != NULL && !sf_wavwriter_close(ww))
+		res = false;
+	sf_wavreader_close(wr);
+	sf_free(st);
+	sf_free(inbuf);
+	if (tmppath != NULL){
+		// the input stays whole until the finished output replaces it
+		if (res && rename(tmppath, output) != 0)
+			res = false;
+		if (!res)
+			unlink(tmppath);
+		free(tmppath);
+	}
 	if (!res){
 		fprintf(stderr, "Error: Failed to save WAV: %s\n", output);
 		return 1;
@@ -230,85 +356,226 @@ static inline int reverb(sf_snd input_snd, float tail, const char *preset, const
 	return 0;
 }
 
-int main(int argc, char **argv){
-	if (argc < 4)
-		return printhelp();
+//
+// batch mode
+//
+// every worker thread gets its own arena for the library's allocations, installed through the
+// sf_malloc/sf_free hooks and selected by a thread-local pointer; the arena is reset between files,
+// so after the first file a worker never touches the system allocator (or contends on its locks)
+// for the multi-megabyte filter state again
+//
 
-	const char *input  = argv[1];
-	const char *output = argv[2];
-	const char *filter = argv[3];
+typedef struct {
+	unsigned char *base;
+	size_t size;
+	size_t used;
+} arena_st;
 
-	sf_snd input_snd = sf_wavload(input);
-	if (input_snd == NULL){
-		fprintf(stderr, "Error: Failed to load WAV: %s\n", input);
-		return 1;
-	}
+static _Thread_local arena_st *tl_arena = NULL;
 
-	float params[6];
-	sf_biquad_state_st bq_state;
-	if (strcmp(filter, "lowpass") == 0){
-		if (!getargs(argc, argv, 2, params))
-			return badargs(filter);
-		sf_lowpass(&bq_state, input_snd->rate, params[0], params[1]);
-		return biquad(input_snd, &bq_state, output);
+static void *arena_malloc(size_t size){
+	arena_st *a = tl_arena;
+	size = (size + 63) & ~(size_t)63; // keep allocations on their own cache lines
+	if (a == NULL || size > a->size - a->used)
+		return malloc(size); // not a worker, or the arena is full
+	void *ptr = a->base + a->used;
+	a->used += size;
+	return ptr;
+}
+
+static void arena_free(void *ptr){
+	arena_st *a = tl_arena;
+	if (a != NULL && (unsigned char *)ptr >= a->base && (unsigned char *)ptr < a->base + a->size)
+		return; // released all at once when the arena is reset
+	free(ptr);
+}
+
+typedef struct {
+	const filter_st *filter;
+	char **inputs;
+	char **outputs;
+	int count;
+	atomic_int next;   // next file to hand out
+	atomic_int failed;
+} batch_st;
+
+static void *batchworker(void *arg){
+	batch_st *b = arg;
+
+	// room for everything runfilter allocates, with headroom for the wav reader/writer
+	arena_st arena;
+	arena.size = sizeof(filterstate_un) + sizeof(sf_sample_st) * STREAM_BLOCK * 2 + (1 << 16);
+	arena.base = malloc(arena.size);
+	arena.used = 0;
+	if (arena.base != NULL)
+		tl_arena = &arena;
+
+	while (1){
+		int i = atomic_fetch_add(&b->next, 1);
+		if (i >= b->count)
+			break;
+		arena.used = 0;
+		if (runfilter(b->filter, b->inputs[i], b->outputs[i]) != 0)
+			atomic_fetch_add(&b->failed, 1);
 	}
-	else if (strcmp(filter, "highpass") == 0){
-		if (!getargs(argc, argv, 2, params))
-			return badargs(filter);
-		sf_highpass(&bq_state, input_snd->rate, params[0], params[1]);
-		return biquad(input_snd, &bq_state, output);
+
+	tl_arena = NULL;
+	free(arena.base);
+	return NULL;
+}
+
+static char *joinpath(const char *dir, const char *name){
+	size_t dlen = strlen(dir);
+	size_t nlen = strlen(name);
+	char *path = malloc(dlen + nlen + 2);
+	if (path == NULL)
+		return NULL;
+	memcpy(path, dir, dlen);
+	path[dlen] = '/';
+	memcpy(&path[dlen + 1], name, nlen + 1);
+	return path;
+}
+
+static int cmpstr(const void *a, const void *b){
+	return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+// process every .wav file in inputdir into outputdir, across a pool of threads
+static int batch(const filter_st *f, const char *inputdir, const char *outputdir, int threads){
+	// writing over the inputs while they're being read would destroy them
+	mkdir(outputdir, 0777);
+	char *inreal = realpath(inputdir, NULL);
+	char *outreal = realpath(outputdir, NULL);
+	bool same = inreal && outreal && strcmp(inreal, outreal) == 0;
+	free(inreal);
+	free(outreal);
+	struct stat st;
+	if (stat(outputdir, &st) != 0 || !S_ISDIR(st.st_mode)){
+		fprintf(stderr, "Error: Bad output directory: %s\n", outputdir);
+		return 1;
 	}
-	else if (strcmp(filter, "bandpass") == 0){
-		if (!getargs(argc, argv, 2, params))
-			return badargs(filter);
-		sf_bandpass(&bq_state, input_snd->rate, params[0], params[1]);
-		return biquad(input_snd, &bq_state, output);
+	if (same){
+		fprintf(stderr, "Error: Output directory must differ from the input directory\n");
+		return 1;
 	}
-	else if (strcmp(filter, "notch") == 0){
-		if (!getargs(argc, argv, 2, params))
-			return badargs(filter);
-		sf_notch(&bq_state, input_snd->rate, params[0], params[1]);
-		return biquad(input_snd, &bq_state, output);
+
+	// collect the file names
+	DIR *dir = opendir(inputdir);
+	if (dir == NULL){
+		fprintf(stderr, "Error: Failed to open directory: %s\n", inputdir);
+		return 1;
 	}
-	else if (strcmp(filter, "peaking") == 0){
-		if (!getargs(argc, argv, 3, params))
-			return badargs(filter);
-		sf_peaking(&bq_state, input_snd->rate, params[0], params[1], params[2]);
-		return biquad(input_snd, &bq_state, output);
+	char **names = NULL;
+	int count = 0;
+	int cap = 0;
+	struct dirent *ent;
+	while ((ent = readdir(dir)) != NULL){
+		size_t len = strlen(ent->d_name);
+		if (len < 5 || strcasecmp(&ent->d_name[len - 4], ".wav") != 0)
+			continue;
+		if (count >= cap){
+			cap = cap ? cap * 2 : 64;
+			char **n = realloc(names, sizeof(char *) * cap);
+			if (n == NULL)
+				break;
+			names = n;
+		}
+		names[count] = strdup(ent->d_name);
+		if (names[count] != NULL)
+			count++;
 	}
-	else if (strcmp(filter, "allpass") == 0){
-		if (!getargs(argc, argv, 2, params))
-			return badargs(filter);
-		sf_allpass(&bq_state, input_snd->rate, params[0], params[1]);
-		return biquad(input_snd, &bq_state, output);
+	closedir(dir);
+	qsort(names, count, sizeof(char *), cmpstr);
+
+	batch_st b;
+	b.filter = f;
+	b.inputs = malloc(sizeof(char *) * (count ? count : 1));
+	b.outputs = malloc(sizeof(char *) * (count ? count : 1));
+	b.count = 0;
+	atomic_init(&b.next, 0);
+	atomic_init(&b.failed, 0);
+	int res = 0;
+	if (b.inputs == NULL || b.outputs == NULL)
+		count = 0, res = 1;
+	for (int i = 0; i < count; i++){
+		b.inputs[b.count] = joinpath(inputdir, names[i]);
+		b.outputs[b.count] = joinpath(outputdir, names[i]);
+		if (b.inputs[b.count] && b.outputs[b.count])
+			b.count++;
+		else{
+			free(b.inputs[b.count]);
+			free(b.outputs[b.count]);
+			res = 1;
+		}
 	}
-	else if (strcmp(filter, "lowshelf") == 0){
-		if (!getargs(argc, argv, 3, params))
-			return badargs(filter);
-		sf_lowshelf(&bq_state, input_snd->rate, params[0], params[1], params[2]);
-		return biquad(input_snd, &bq_state, output);
+
+	if (threads <= 0)
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads > b.count)
+		threads = b.count;
+	if (threads < 1)
+		threads = 1;
+
+	// the hooks are global, so install them before any worker starts
+	sf_malloc = arena_malloc;
+	sf_free = arena_free;
+	pthread_t *pool = malloc(sizeof(pthread_t) * threads);
+	int started = 0;
+	if (pool != NULL){
+		for (; started < threads; started++){
+			if (pthread_create(&pool[started], NULL, batchworker, &b) != 0)
+				break;
+		}
 	}
-	else if (strcmp(filter, "highshelf") == 0){
-		if (!getargs(argc, argv, 3, params))
-			return badargs(filter);
-		sf_highshelf(&bq_state, input_snd->rate, params[0], params[1], params[2]);
-		return biquad(input_snd, &bq_state, output);
+	if (started == 0)
+		batchworker(&b); // no threads available, so do the work here
+	for (int i = 0; i < started; i++)
+		pthread_join(pool[i], NULL);
+	free(pool);
+	sf_malloc = malloc;
+	sf_free = free;
+
+	int failed = atomic_load(&b.failed);
+	if (failed > 0){
+		fprintf(stderr, "Error: Failed to process %d of %d files\n", failed, b.count);
+		res = 1;
 	}
-	else if (strcmp(filter, "compressor") == 0){
-		if (!getargs(argc, argv, 6, params))
-			return badargs(filter);
-		sf_compressor_state_st cm_state;
-		sf_simplecomp(&cm_state, input_snd->rate, params[0], params[1], params[2], params[3],
-			params[4], params[5]);
-		return compressor(input_snd, &cm_state, output);
+
+	for (int i = 0; i < b.count; i++){
+		free(b.inputs[i]);
+		free(b.outputs[i]);
 	}
-	else if (strcmp(filter, "reverb") == 0){
-		if (argc < 6 || !getargs(argc, argv, 1, params))
-			return badargs(filter);
-		return reverb(input_snd, params[0], argv[5], output);
+	for (int i = 0; i < count; i++)
+		free(names[i]);
+	free(names);
+	free(b.inputs);
+	free(b.outputs);
+	return res;
+}
+
+int main(int argc, char **argv){
+	// pull out the thread count, so the rest of the arguments line up the same in both modes
+	int threads = 0;
+	if (argc >= 3 && strcmp(argv[1], "-j") == 0){
+		threads = atoi(argv[2]);
+		argv[2] = argv[0];
+		argv += 2;
+		argc -= 2;
 	}
 
-	printhelp();
-	fprintf(stderr, "Error: Bad filter \"%s\"\n", filter);
-	return 1;
+	if (argc < 4)
+		return printhelp();
+
+	const char *input  = argv[1];
+	const char *output = argv[2];
+
+	filter_st f;
+	int res = parsefilter(argc, argv, &f);
+	if (res != 0)
+		return res;
+
+	struct stat st;
+	if (stat(input, &st) == 0 && S_ISDIR(st.st_mode))
+		return batch(&f, input, output, threads);
+	return runfilter(&f, input, output);
 }
@@ -6,6 +6,7 @@
 //
 
 #include "reverb.h"
+#include "simd.h"
 #include <math.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -48,13 +49,11 @@ static inline int nextprime(int v){
 }
 
 // generate a random float [0, 1) using a simple (but good quality) RNG
-static inline float randfloat(){
-	static uint32_t seed = 123; // doesn't matter
-	static uint32_t i = 456; // doesn't matter
+static inline float randfloat(uint32_t *seed, uint32_t *i){
 	uint32_t m = 0x5bd1e995;
-	uint32_t k = i++ * m;
-	seed = (k ^ (k >> 24) ^ (seed * m)) * m;
-	uint32_t R = (seed ^ (seed >> 13)) & 0x007FFFFF; // get 23 random bits
+	uint32_t k = (*i)++ * m;
+	*seed = (k ^ (k >> 24) ^ (*seed * m)) * m;
+	uint32_t R = (*seed ^ (*seed >> 13)) & 0x007FFFFF; // get 23 random bits
 	union { uint32_t i; float f; } u = { .i = 0x3F800000 | R };
 	return u.f - 1.0;
 }
@@ -102,6 +101,48 @@ static inline float delay_getlast(sf_rv_delay_st *delay){
 	return delay->buf[delay->pos];
 }
 
+//
+// taps
+//
+static inline void taps_make(sf_rv_taps_st *taps, int maxoffset){
+	taps->pos = 0;
+	taps->size = clampi(maxoffset, 1, SF_REVERB_DS) + SF_REVERB_BLOCK;
+	memset(taps->buf, 0, sizeof(float) * taps->size * 2);
+}
+
+// write a block of up to SF_REVERB_BLOCK samples, then sum the taps for each of them:
+//   output[n] = sum of gain[i] * (sample written offset[i] - 1 samples before input[n])
+// an offset of 1 is input[n] itself; offsets must be between 1 and the maxoffset used for make
+static inline void taps_block(sf_rv_taps_st *taps, int size, const float *input,
+	const int *offset, const float *gain, int count, float *output){
+	int pos = taps->pos;
+	for (int n = 0; n < size; n++){
+		taps->buf[pos] = taps->buf[pos + taps->size] = input[n];
+		if (++pos >= taps->size)
+			pos = 0;
+	}
+
+	// start of each tap's run; input[n]'s tap is at read[i][n]
+	const float *read[32];
+	for (int i = 0; i < count; i++)
+		read[i] = taps->buf + (taps->pos - offset[i] + 1 + taps->size) % taps->size;
+	taps->pos = pos;
+
+	int n = 0;
+	for (; n + 4 <= size; n += 4){
+		sf_v4 acc = sf_v4_set1(0.0f);
+		for (int i = 0; i < count; i++)
+			acc = sf_v4_add(acc, sf_v4_mul(sf_v4_set1(gain[i]), sf_v4_load(read[i] + n)));
+		sf_v4_store(output + n, acc);
+	}
+	for (; n < size; n++){
+		float acc = 0;
+		for (int i = 0; i < count; i++)
+			acc += gain[i] * read[i][n];
+		output[n] = acc;
+	}
+}
+
 //
 // iir1
 //
@@ -235,8 +276,15 @@ static inline void earlyref_make(sf_rv_earlyref_st *earlyref, int rate, float fa
 		earlyref->delaytblL[i] = delaytbl[i].L * factor;
 		earlyref->delaytblR[i] = delaytbl[i].R * factor;
 	}
-	delay_make(&earlyref->delayPWL, earlyref->delaytblL[17] + 10);
-	delay_make(&earlyref->delayPWR, earlyref->delaytblR[17] + 10);
+	// the taps look back at most the delay size (see delay_get), and at least 1 sample
+	int sizeL = clampi(earlyref->delaytblL[17] + 10, 1, SF_REVERB_DS);
+	int sizeR = clampi(earlyref->delaytblR[17] + 10, 1, SF_REVERB_DS);
+	for (int i = 0; i < 18; i++){
+		earlyref->delaytblL[i] = clampi(earlyref->delaytblL[i], 1, sizeL);
+		earlyref->delaytblR[i] = clampi(earlyref->delaytblR[i], 1, sizeR);
+	}
+	taps_make(&earlyref->delayPWL, sizeL);
+	taps_make(&earlyref->delayPWR, sizeR);
 
 	iir1_makeLPF(&earlyref->lpfL, rate, 20000.0f);
 	earlyref->lpfR = earlyref->lpfL;
@@ -245,22 +293,24 @@ static inline void earlyref_make(sf_rv_earlyref_st *earlyref, int rate, float fa
 	earlyref->hpfR = earlyref->hpfL;
 }
 
-static inline sf_sample_st earlyref_step(sf_rv_earlyref_st *earlyref, sf_sample_st input){
-	static const sf_sample_st gaintbl[18] = {
-		{ 0.841f, 0.842f }, { 0.504f, 0.506f }, { 0.491f, 0.489f }, { 0.379f, 0.382f },
-		{ 0.380f, 0.300f }, { 0.346f, 0.346f }, { 0.289f, 0.290f }, { 0.272f, 0.271f },
-		{ 0.192f, 0.193f }, { 0.193f, 0.192f }, { 0.217f, 0.217f }, { 0.181f, 0.195f },
-		{ 0.180f, 0.192f }, { 0.181f, 0.166f }, { 0.176f, 0.186f }, { 0.142f, 0.131f },
-		{ 0.167f, 0.168f }, { 0.134f, 0.133f }
+// the multi-tap part of the early reflections, for a block of up to SF_REVERB_BLOCK samples
+static inline void earlyref_taps(sf_rv_earlyref_st *earlyref, int size, const float *inputL,
+	const float *inputR, float *wetL, float *wetR){
+	static const float gaintblL[18] = {
+		0.841f, 0.504f, 0.491f, 0.379f, 0.380f, 0.346f, 0.289f, 0.272f, 0.192f,
+		0.193f, 0.217f, 0.181f, 0.180f, 0.181f, 0.176f, 0.142f, 0.167f, 0.134f
 	};
+	static const float gaintblR[18] = {
+		0.842f, 0.506f, 0.489f, 0.382f, 0.300f, 0.346f, 0.290f, 0.271f, 0.193f,
+		0.192f, 0.217f, 0.195f, 0.192f, 0.166f, 0.186f, 0.131f, 0.168f, 0.133f
+	};
+	taps_block(&earlyref->delayPWL, size, inputL, earlyref->delaytblL, gaintblL, 18, wetL);
+	taps_block(&earlyref->delayPWR, size, inputR, earlyref->delaytblR, gaintblR, 18, wetR);
+}
 
-	float wetL = 0, wetR = 0;
-	delay_step(&earlyref->delayPWL, input.L);
-	delay_step(&earlyref->delayPWR, input.R);
-	for (int i = 0; i < 18; i++){
-		wetL += gaintbl[i].L * delay_get(&earlyref->delayPWL, earlyref->delaytblL[i]);
-		wetR += gaintbl[i].R * delay_get(&earlyref->delayPWR, earlyref->delaytblR[i]);
-	}
+// the rest of the early reflections, one sample at a time, given that sample's taps from above
+static inline sf_sample_st earlyref_step(sf_rv_earlyref_st *earlyref, sf_sample_st input,
+	float wetL, float wetR){
 
 	float L = delay_step(&earlyref->delayRL, input.R + wetR);
 	L = biquad_step(&earlyref->allpassXL, L);
@@ -333,6 +383,8 @@ static inline float dccut_step(sf_rv_dccut_st *dccut, float v){
 //
 static inline void noise_make(sf_rv_noise_st *noise){
 	noise->pos = SF_REVERB_NS;
+	noise->seed = 123; // doesn't matter
+	noise->i = 456; // doesn't matter
 }
 
 static inline float noise_step(sf_rv_noise_st *noise){
@@ -350,7 +402,8 @@ static inline float noise_step(sf_rv_noise_st *noise){
 				float right = left;
 				left = noise->buf[i * len];
 				float midpoint = (left + right) * 0.5f;
-				float newv = midpoint + r * (2.0f * randfloat() - 1.0f); // displace by random amt
+				// displace by random amt
+				float newv = midpoint + r * (2.0f * randfloat(&noise->seed, &noise->i) - 1.0f);
 				noise->buf[i * len + (len / 2)] = clampf(newv, -1.0f, 1.0f);
 			}
 			len /= 2;
@@ -793,7 +846,9 @@ void sf_advancereverb(sf_reverb_state_st *rv, int rate,
 	}
 }
 
-void sf_reverb_process(sf_reverb_state_st *rv, int size, sf_sample_st *input, sf_sample_st *output){
+// process one sample, given the early reflection taps for it (see earlyref_taps)
+static inline sf_sample_st reverb_step(sf_reverb_state_st *rv, sf_sample_st input, float wetL,
+	float wetR){
 	// extra hardcoded constants
 	const float modnoise1 = 0.09f;
 	const float modnoise2 = 0.06f;
@@ -802,140 +857,169 @@ void sf_reverb_process(sf_reverb_state_st *rv, int size, sf_sample_st *input, sf
 	// oversample buffer
 	float osL[SF_REVERB_OF], osR[SF_REVERB_OF];
 
-	for (int i = 0; i < size; i++){
-		// early reflection
-		sf_sample_st er = earlyref_step(&rv->earlyref, input[i]);
-		float erL = er.L * rv->ertolate + input[i].L;
-		float erR = er.R * rv->ertolate + input[i].R;
-
-		// oversample the single input into multiple outputs
-		oversample_stepup(&rv->oversampleL, erL, osL);
-		oversample_stepup(&rv->oversampleR, erR, osR);
-
-		// for each oversampled sample...
-		for (int i2 = 0; i2 < rv->oversampleL.factor; i2++){
-			// dc cut
-			float outL = dccut_step(&rv->dccutL, osL[i2]);
-			float outR = dccut_step(&rv->dccutR, osR[i2]);
-
-			// noise
-			float mnoise = noise_step(&rv->noise);
-			float lfo = (lfo_step(&rv->lfo1) + modnoise1 * mnoise) * rv->wander;
-			lfo = iir1_step(&rv->lfo1_lpf, lfo);
-			mnoise *= modnoise2;
-
-			// diffusion
-			for (int i = 0, s = -1; i < 10; i++, s = -s){
-				outL = allpassm_step(&rv->diffL[i], outL, lfo * s, mnoise);
-				outR = allpassm_step(&rv->diffR[i], outR, lfo, mnoise * s);
-			}
+	// early reflection
+	sf_sample_st er = earlyref_step(&rv->earlyref, input, wetL, wetR);
+	float erL = er.L * rv->ertolate + input.L;
+	float erR = er.R * rv->ertolate + input.R;
+
+	// oversample the single input into multiple outputs
+	oversample_stepup(&rv->oversampleL, erL, osL);
+	oversample_stepup(&rv->oversampleR, erR, osR);
+
+	// for each oversampled sample...
+	for (int i2 = 0; i2 < rv->oversampleL.factor; i2++){
+		// dc cut
+		float outL = dccut_step(&rv->dccutL, osL[i2]);
+		float outR = dccut_step(&rv->dccutR, osR[i2]);
+
+		// noise
+		float mnoise = noise_step(&rv->noise);
+		float lfo = (lfo_step(&rv->lfo1) + modnoise1 * mnoise) * rv->wander;
+		lfo = iir1_step(&rv->lfo1_lpf, lfo);
+		mnoise *= modnoise2;
+
+		// diffusion
+		for (int i = 0, s = -1; i < 10; i++, s = -s){
+			outL = allpassm_step(&rv->diffL[i], outL, lfo * s, mnoise);
+			outR = allpassm_step(&rv->diffR[i], outR, lfo, mnoise * s);
+		}
 
-			// cross fade
-			float crossL = outL, crossR = outR;
-			for (int i = 0; i < 4; i++){
-				crossL = allpass_step(&rv->crossL[i], crossL);
-				crossR = allpass_step(&rv->crossR[i], crossR);
-			}
-			outL = iir1_step(&rv->clpfL, outL + crossfeed * crossR);
-			outR = iir1_step(&rv->clpfR, outR + crossfeed * crossL);
-
-			// bass boost
-			crossL = delay_getlast(&rv->cdelayL);
-			crossR = delay_getlast(&rv->cdelayR);
-			outL += rv->loopdecay *
-				(crossR + rv->bassb * biquad_step(&rv->basslpL, biquad_step(&rv->bassapL, crossR)));
-			outR += rv->loopdecay *
-				(crossL + rv->bassb * biquad_step(&rv->basslpR, biquad_step(&rv->bassapR, crossL)));
-
-			// dampening
-			outL = allpassm_step(&rv->dampap2L,
-				delay_step(&rv->dampdL,
-				allpassm_step(&rv->dampap1L,
-				iir1_step(&rv->damplpL, outL), lfo, mnoise)),
-				-lfo, -mnoise);
-			outR = allpassm_step(&rv->dampap2R,
-				delay_step(&rv->dampdR,
-				allpassm_step(&rv->dampap1R,
-				iir1_step(&rv->damplpR, outR), -lfo, -mnoise)),
-				lfo, mnoise);
-
-			// update cross fade bass boost delay
-			delay_step(&rv->cdelayL,
-				allpass3_step(&rv->cbassap2L,
-				delay_step(&rv->cbassd2L,
-				allpass2_step(&rv->cbassap1L,
-				delay_step(&rv->cbassd1L, outL))),
-					lfo));
-			delay_step(&rv->cdelayR,
-				allpass3_step(&rv->cbassap2R,
-				delay_step(&rv->cbassd2R,
-				allpass2_step(&rv->cbassap1R,
-				delay_step(&rv->cbassd1R, outR))),
-					-lfo));
-
-			//
-			float D1 =
-				delay_get    (&rv->cbassd1L , rv->outco[ 0]);
-			float D2 =
-				delay_get    (&rv->cbassd2L , rv->outco[ 1]) -
-				delay_get    (&rv->cbassd2R , rv->outco[ 2]) +
-				delay_get    (&rv->cbassd2L , rv->outco[ 3]) -
-				delay_get    (&rv->cdelayR  , rv->outco[ 4]) -
-				delay_get    (&rv->cbassd1R , rv->outco[ 5]) -
-				delay_get    (&rv->cbassd2R , rv->outco[ 6]);
-			float D3 =
-				delay_get    (&rv->cdelayL  , rv->outco[ 7]) +
-				allpass2_get1(&rv->cbassap1L, rv->outco[ 8]) +
-				allpass2_get2(&rv->cbassap1L, rv->outco[ 9]) -
-				allpass2_get2(&rv->cbassap1R, rv->outco[10]) +
-				allpass3_get1(&rv->cbassap2L, rv->outco[11]) +
-				allpass3_get2(&rv->cbassap2L, rv->outco[12]) +
-				allpass3_get3(&rv->cbassap2L, rv->outco[13]) -
-				allpass3_get2(&rv->cbassap2R, rv->outco[14]);
-			float D4 =
-				delay_get    (&rv->cdelayL  , rv->outco[15]);
-
-			float B1 =
-				delay_get    (&rv->cbassd1R , rv->outco[16]);
-			float B2 =
-				delay_get    (&rv->cbassd2R , rv->outco[17]) -
-				delay_get    (&rv->cbassd2L , rv->outco[18]) +
-				delay_get    (&rv->cbassd2R , rv->outco[19]) -
-				delay_get    (&rv->cdelayL  , rv->outco[20]) -
-				delay_get    (&rv->cbassd1L , rv->outco[21]) -
-				delay_get    (&rv->cbassd2L , rv->outco[22]);
-			float B3 =
-				delay_get    (&rv->cdelayR  , rv->outco[23]) +
-				allpass2_get1(&rv->cbassap1R, rv->outco[24]) +
-				allpass2_get2(&rv->cbassap1R, rv->outco[25]) -
-				allpass2_get2(&rv->cbassap1L, rv->outco[26]) +
-				allpass3_get1(&rv->cbassap2R, rv->outco[27]) +
-				allpass3_get2(&rv->cbassap2R, rv->outco[28]) +
-				allpass3_get3(&rv->cbassap2R, rv->outco[29]) -
-				allpass3_get2(&rv->cbassap2L, rv->outco[30]);
-			float B4 =
-				delay_get    (&rv->cdelayR  , rv->outco[31]);
-
-			float D = D1 * 0.469f + D2 * 0.219f + D3 * 0.064f + D4 * 0.045f;
-			float B = B1 * 0.469f + B2 * 0.219f + B3 * 0.064f + B4 * 0.045f;
-
-			lfo = iir1_step(&rv->lfo2_lpf, lfo_step(&rv->lfo2) * rv->wander);
-			outL = comb_step(&rv->combL, D, lfo);
-			outR = comb_step(&rv->combR, B, -lfo);
-
-			outL = delay_step(&rv->lastdelayL, biquad_step(&rv->lastlpfL, outL));
-			outR = delay_step(&rv->lastdelayR, biquad_step(&rv->lastlpfR, outR));
-
-			osL[i2] = outL * rv->wet1 + outR * rv->wet2 +
-				delay_step(&rv->inpdelayL, osL[i2]) * rv->dry;
-			osR[i2] = outR * rv->wet1 + outL * rv->wet2 +
-				delay_step(&rv->inpdelayR, osR[i2]) * rv->dry;
+		// cross fade
+		float crossL = outL, crossR = outR;
+		for (int i = 0; i < 4; i++){
+			crossL = allpass_step(&rv->crossL[i], crossL);
+			crossR = allpass_step(&rv->crossR[i], crossR);
+		}
+		outL = iir1_step(&rv->clpfL, outL + crossfeed * crossR);
+		outR = iir1_step(&rv->clpfR, outR + crossfeed * crossL);
+
+		// bass boost
+		crossL = delay_getlast(&rv->cdelayL);
+		crossR = delay_getlast(&rv->cdelayR);
+		outL += rv->loopdecay *
+			(crossR + rv->bassb * biquad_step(&rv->basslpL, biquad_step(&rv->bassapL, crossR)));
+		outR += rv->loopdecay *
+			(crossL + rv->bassb * biquad_step(&rv->basslpR, biquad_step(&rv->bassapR, crossL)));
+
+		// dampening
+		outL = allpassm_step(&rv->dampap2L,
+			delay_step(&rv->dampdL,
+			allpassm_step(&rv->dampap1L,
+			iir1_step(&rv->damplpL, outL), lfo, mnoise)),
+			-lfo, -mnoise);
+		outR = allpassm_step(&rv->dampap2R,
+			delay_step(&rv->dampdR,
+			allpassm_step(&rv->dampap1R,
+			iir1_step(&rv->damplpR, outR), -lfo, -mnoise)),
+			lfo, mnoise);
+
+		// update cross fade bass boost delay
+		delay_step(&rv->cdelayL,
+			allpass3_step(&rv->cbassap2L,
+			delay_step(&rv->cbassd2L,
+			allpass2_step(&rv->cbassap1L,
+			delay_step(&rv->cbassd1L, outL))),
+				lfo));
+		delay_step(&rv->cdelayR,
+			allpass3_step(&rv->cbassap2R,
+			delay_step(&rv->cbassd2R,
+			allpass2_step(&rv->cbassap1R,
+			delay_step(&rv->cbassd1R, outR))),
+				-lfo));
+
+		//
+		float D1 =
+			delay_get    (&rv->cbassd1L , rv->outco[ 0]);
+		float D2 =
+			delay_get    (&rv->cbassd2L , rv->outco[ 1]) -
+			delay_get    (&rv->cbassd2R , rv->outco[ 2]) +
+			delay_get    (&rv->cbassd2L , rv->outco[ 3]) -
+			delay_get    (&rv->cdelayR  , rv->outco[ 4]) -
+			delay_get    (&rv->cbassd1R , rv->outco[ 5]) -
+			delay_get    (&rv->cbassd2R , rv->outco[ 6]);
+		float D3 =
+			delay_get    (&rv->cdelayL  , rv->outco[ 7]) +
+			allpass2_get1(&rv->cbassap1L, rv->outco[ 8]) +
+			allpass2_get2(&rv->cbassap1L, rv->outco[ 9]) -
+			allpass2_get2(&rv->cbassap1R, rv->outco[10]) +
+			allpass3_get1(&rv->cbassap2L, rv->outco[11]) +
+			allpass3_get2(&rv->cbassap2L, rv->outco[12]) +
+			allpass3_get3(&rv->cbassap2L, rv->outco[13]) -
+			allpass3_get2(&rv->cbassap2R, rv->outco[14]);
+		float D4 =
+			delay_get    (&rv->cdelayL  , rv->outco[15]);
+
+		float B1 =
+			delay_get    (&rv->cbassd1R , rv->outco[16]);
+		float B2 =
+			delay_get    (&rv->cbassd2R , rv->outco[17]) -
+			delay_get    (&rv->cbassd2L , rv->outco[18]) +
+			delay_get    (&rv->cbassd2R , rv->outco[19]) -
+			delay_get    (&rv->cdelayL  , rv->outco[20]) -
+			delay_get    (&rv->cbassd1L , rv->outco[21]) -
+			delay_get    (&rv->cbassd2L , rv->outco[22]);
+		float B3 =
+			delay_get    (&rv->cdelayR  , rv->outco[23]) +
+			allpass2_get1(&rv->cbassap1R, rv->outco[24]) +
+			allpass2_get2(&rv->cbassap1R, rv->outco[25]) -
+			allpass2_get2(&rv->cbassap1L, rv->outco[26]) +
+			allpass3_get1(&rv->cbassap2R, rv->outco[27]) +
+			allpass3_get2(&rv->cbassap2R, rv->outco[28]) +
+			allpass3_get3(&rv->cbassap2R, rv->outco[29]) -
+			allpass3_get2(&rv->cbassap2L, rv->outco[30]);
+		float B4 =
+			delay_get    (&rv->cdelayR  , rv->outco[31]);
+
+		float D = D1 * 0.469f + D2 * 0.219f + D3 * 0.064f + D4 * 0.045f;
+		float B = B1 * 0.469f + B2 * 0.219f + B3 * 0.064f + B4 * 0.045f;
+
+		lfo = iir1_step(&rv->lfo2_lpf, lfo_step(&rv->lfo2) * rv->wander);
+		outL = comb_step(&rv->combL, D, lfo);
+		outR = comb_step(&rv->combR, B, -lfo);
+
+		outL = delay_step(&rv->lastdelayL, biquad_step(&rv->lastlpfL, outL));
+		outR = delay_step(&rv->lastdelayR, biquad_step(&rv->lastlpfR, outR));
+
+		osL[i2] = outL * rv->wet1 + outR * rv->wet2 +
+			delay_step(&rv->inpdelayL, osL[i2]) * rv->dry;
+		osR[i2] = outR * rv->wet1 + outL * rv->wet2 +
+			delay_step(&rv->inpdelayR, osR[i2]) * rv->dry;
+	}
+
+	float outL = oversample_stepdown(&rv->oversampleL, osL);
+	float outR = oversample_stepdown(&rv->oversampleR, osR);
+	outL += er.L * rv->erefwet + input.L * rv->dry;
+	outR += er.R * rv->erefwet + input.R * rv->dry;
+	return (sf_sample_st){ outL, outR };
+}
+
+void sf_reverb_process_planar(sf_reverb_state_st *rv, int size, const float *inputL,
+	const float *inputR, float *outputL, float *outputR){
+	float wetL[SF_REVERB_BLOCK], wetR[SF_REVERB_BLOCK];
+	for (int start = 0; start < size; start += SF_REVERB_BLOCK){
+		int len = size - start < SF_REVERB_BLOCK ? size - start : SF_REVERB_BLOCK;
+		earlyref_taps(&rv->earlyref, len, inputL + start, inputR + start, wetL, wetR);
+		for (int i = 0; i < len; i++){
+			sf_sample_st out = reverb_step(rv,
+				(sf_sample_st){ inputL[start + i], inputR[start + i] }, wetL[i], wetR[i]);
+			outputL[start + i] = out.L;
+			outputR[start + i] = out.R;
 		}
+	}
+}
 
-		float outL = oversample_stepdown(&rv->oversampleL, osL);
-		float outR = oversample_stepdown(&rv->oversampleR, osR);
-		outL += er.L * rv->erefwet + input[i].L * rv->dry;
-		outR += er.R * rv->erefwet + input[i].R * rv->dry;
-		output[i] = (sf_sample_st){ outL, outR };
+void sf_reverb_process(sf_reverb_state_st *rv, int size, sf_sample_st *input, sf_sample_st *output){
+	// split the interleaved samples into planar blocks
+	float inL[SF_REVERB_BLOCK], inR[SF_REVERB_BLOCK];
+	for (int start = 0; start < size; start += SF_REVERB_BLOCK){
+		int len = size - start < SF_REVERB_BLOCK ? size - start : SF_REVERB_BLOCK;
+		for (int i = 0; i < len; i++){
+			inL[i] = input[start + i].L;
+			inR[i] = input[start + i].R;
+		}
+		float wetL[SF_REVERB_BLOCK], wetR[SF_REVERB_BLOCK];
+		earlyref_taps(&rv->earlyref, len, inL, inR, wetL, wetR);
+		for (int i = 0; i < len; i++)
+			output[start + i] = reverb_step(rv, (sf_sample_st){ inL[i], inR[i] }, wetL[i], wetR[i]);
 	}
 }
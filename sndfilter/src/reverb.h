@@ -12,6 +12,7 @@
 #define SNDFILTER_REVERB__H
 
 #include "snd.h"
+#include <stdint.h>
 
 // this API works by first initializing an sf_reverb_state_st structure, then using it to process a
 // sample in chunks
@@ -30,6 +31,15 @@
 // also notice that the choice to divide the sound into chunks of 128 samples is completely
 // arbitrary from the reverb's perspective
 //
+// for real-time use there is also a planar version that takes separate left/right float buffers,
+// which is what audio callbacks usually hand out:
+//
+//   for each callback:
+//     sf_reverb_process_planar(&rv, frames, inL, inR, outL, outR);
+//
+// neither version allocates memory or does any setup per call; the state structure holds
+// everything, so allocate it once (it's big, see below) and reuse it
+//
 // ---
 //
 // non-convolution based reverb effects are made up from a lot of smaller effects
@@ -57,6 +67,13 @@
 //
 // each component is designed to work one step at a time, so any size sample can be streamed through
 // in one pass
+//
+// the exception is the multi-tap delay in the early reflections, which is only fed by the input, so
+// its taps are summed for a block of samples at a time (with SSE/NEON, see simd.h); the process
+// functions split their input into blocks of SF_REVERB_BLOCK samples for this
+
+// samples per internal block
+#define SF_REVERB_BLOCK     128
 
 // delay
 // delay buffer size; maximum size allowed for a delay
@@ -67,6 +84,16 @@ typedef struct {
 	float buf[SF_REVERB_DS]; // delay buffer
 } sf_rv_delay_st;
 
+// multi-tap delay
+// every sample is stored twice (at pos and pos + size), so the taps for a whole block can be read
+// from one contiguous run of the buffer, without wrapping around
+#define SF_REVERB_TS        (SF_REVERB_DS + SF_REVERB_BLOCK)
+typedef struct {
+	int pos;                     // next write position
+	int size;                    // ring size; longest tap plus SF_REVERB_BLOCK
+	float buf[SF_REVERB_TS * 2]; // ring, stored twice
+} sf_rv_taps_st;
+
 // 1st order IIR filter
 typedef struct {
 	float a2; // coefficients
@@ -92,8 +119,8 @@ typedef struct {
 
 // early reflection
 typedef struct {
-	int             delaytblL[18], delaytblR[18];
-	sf_rv_delay_st  delayPWL     , delayPWR     ;
+	int             delaytblL[18], delaytblR[18]; // tap offsets (1 = newest sample)
+	sf_rv_taps_st   delayPWL     , delayPWR     ;
 	sf_rv_delay_st  delayRL      , delayLR      ;
 	sf_rv_biquad_st allpassXL    , allpassXR    ;
 	sf_rv_biquad_st allpassL     , allpassR     ;
@@ -123,6 +150,8 @@ typedef struct {
 #define SF_REVERB_NS        (1<<15)
 typedef struct {
 	int pos;                 // current read position in the buffer
+	uint32_t seed;           // RNG state, kept per reverb so separate reverbs can run on
+	uint32_t i;              //   separate threads, and each one is reproducible
 	float buf[SF_REVERB_NS]; // buffer filled with noise
 } sf_rv_noise_st;
 
@@ -289,4 +318,9 @@ void sf_advancereverb(sf_reverb_state_st *rv,
 void sf_reverb_process(sf_reverb_state_st *state, int size, sf_sample_st *input,
 	sf_sample_st *output);
 
+// same as above, with separate left/right buffers of `size` samples each
+// the output buffers may be the same as the input buffers
+void sf_reverb_process_planar(sf_reverb_state_st *state, int size, const float *inputL,
+	const float *inputR, float *outputL, float *outputR);
+
 #endif // SNDFILTER_REVERB__H
@@ -0,0 +1,111 @@
+//
+// sndfilter - Algorithms for sound filters, like reverb, lowpass, etc
+// by Sean Connelly (@velipso), https://sean.fun
+// Project Home: https://github.com/velipso/sndfilter
+// SPDX-License-Identifier: 0BSD
+//
+
+// 4-wide float vectors used by the block processing paths
+//
+// SSE on x86, NEON on ARM, and a plain struct everywhere else (or when SF_NO_SIMD is defined), so
+// the results are the same on every platform: only adds, multiplies, abs and max are used, in the
+// same order as the scalar code they replace
+
+#ifndef SNDFILTER_SIMD__H
+#define SNDFILTER_SIMD__H
+
+#if !defined(SF_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64))
+#	define SF_SIMD_SSE
+#	include <emmintrin.h>
+typedef __m128 sf_v4;
+#elif !defined(SF_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#	define SF_SIMD_NEON
+#	include <arm_neon.h>
+typedef float32x4_t sf_v4;
+#else
+typedef struct { float v[4]; } sf_v4;
+#endif
+
+static inline sf_v4 sf_v4_load(const float *p){
+#if defined(SF_SIMD_SSE)
+	return _mm_loadu_ps(p);
+#elif defined(SF_SIMD_NEON)
+	return vld1q_f32(p);
+#else
+	sf_v4 r = {{ p[0], p[1], p[2], p[3] }};
+	return r;
+#endif
+}
+
+static inline void sf_v4_store(float *p, sf_v4 a){
+#if defined(SF_SIMD_SSE)
+	_mm_storeu_ps(p, a);
+#elif defined(SF_SIMD_NEON)
+	vst1q_f32(p, a);
+#else
+	for (int i = 0; i < 4; i++)
+		p[i] = a.v[i];
+#endif
+}
+
+static inline sf_v4 sf_v4_set1(float x){
+#if defined(SF_SIMD_SSE)
+	return _mm_set1_ps(x);
+#elif defined(SF_SIMD_NEON)
+	return vdupq_n_f32(x);
+#else
+	sf_v4 r = {{ x, x, x, x }};
+	return r;
+#endif
+}
+
+static inline sf_v4 sf_v4_add(sf_v4 a, sf_v4 b){
+#if defined(SF_SIMD_SSE)
+	return _mm_add_ps(a, b);
+#elif defined(SF_SIMD_NEON)
+	return vaddq_f32(a, b);
+#else
+	for (int i = 0; i < 4; i++)
+		a.v[i] += b.v[i];
+	return a;
+#endif
+}
+
+static inline sf_v4 sf_v4_mul(sf_v4 a, sf_v4 b){
+#if defined(SF_SIMD_SSE)
+	return _mm_mul_ps(a, b);
+#elif defined(SF_SIMD_NEON)
+	return vmulq_f32(a, b);
+#else
+	for (int i = 0; i < 4; i++)
+		a.v[i] *= b.v[i];
+	return a;
+#endif
+}
+
+static inline sf_v4 sf_v4_abs(sf_v4 a){
+#if defined(SF_SIMD_SSE)
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+#elif defined(SF_SIMD_NEON)
+	return vabsq_f32(a);
+#else
+	for (int i = 0; i < 4; i++)
+		a.v[i] = a.v[i] < 0.0f ? -a.v[i] : a.v[i];
+	return a;
+#endif
+}
+
+// a > b ? a : b, per lane
+static inline sf_v4 sf_v4_max(sf_v4 a, sf_v4 b){
+#if defined(SF_SIMD_SSE)
+	return _mm_max_ps(a, b);
+#elif defined(SF_SIMD_NEON)
+	return vbslq_f32(vcgtq_f32(a, b), a, b);
+#else
+	for (int i = 0; i < 4; i++)
+		a.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+	return a;
+#endif
+}
+
+#endif // SNDFILTER_SIMD__H
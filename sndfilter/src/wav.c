@@ -6,8 +6,44 @@
 //
 
 #include "wav.h"
+#include "mem.h"
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
+
+#if !defined(SF_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#	define SF_WAV_MMAP
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+// bytes converted per stdio read/write
+#define SF_WAV_BUFSIZE  16384
+
+// how far the reader gets past mapped data before returning those pages to the OS
+#define SF_WAV_RELEASE  (1 << 20)
+
+struct sf_wavreader_st {
+	int rate;
+	int size;               // total number of samples
+	int pos;                // next sample to read
+	int numchannels;
+	FILE *fp;               // stdio fallback, NULL when mapped
+	const uint8_t *map;     // whole file, when mapped
+	size_t mapsize;
+	size_t dataofs;         // offset of the first sample in the file
+	size_t released;        // bytes at the start of the map already given back
+	uint8_t buf[SF_WAV_BUFSIZE];
+};
+
+struct sf_wavwriter_st {
+	FILE *fp;
+	int rate;
+	uint32_t datasize;      // bytes of sample data written so far
+	bool error;
+	uint8_t buf[SF_WAV_BUFSIZE];
+};
 
 // read an unsigned 32-bit integer in little endian format
 static inline uint32_t read_u32le(FILE *fp){
@@ -39,8 +75,44 @@ static inline void write_u16le(FILE *fp, uint16_t v){
 	fputc((v >> 8) & 0xFF, fp);
 }
 
-// load a WAV file (returns NULL for error)
-sf_snd sf_wavload(const char *file){
+// convert a sample to floating point
+// notice that int16 samples range from -32768 to 32767, therefore we have a different divisor
+// depending on whether the value is negative or not
+static inline float s16tof(int16_t v){
+	if (v < 0)
+		return (float)v / 32768.0f;
+	return (float)v / 32767.0f;
+}
+
+static float clampf(float v, float min, float max){
+	return v < min ? min : (v > max ? max : v);
+}
+
+// convert a floating point sample to 16-bit
+// once again, int16 samples range from -32768 to 32767, so we need to scale the floating point
+// sample by a different factor depending on whether it's negative
+static inline int16_t ftos16(float v){
+	v = clampf(v, -1, 1);
+	if (v < 0)
+		return (int16_t)(v * 32768.0f);
+	return (int16_t)(v * 32767.0f);
+}
+
+// convert little endian 16-bit samples to stereo floating point
+static inline void decode(const uint8_t *data, int numchannels, int size, sf_sample_st *samples){
+	for (int i = 0; i < size; i++){
+		int16_t L = (int16_t)(data[0] | (data[1] << 8));
+		int16_t R = L; // expand to stereo
+		if (numchannels == 2)
+			R = (int16_t)(data[2] | (data[3] << 8));
+		data += numchannels * 2;
+		samples[i].L = s16tof(L);
+		samples[i].R = s16tof(R);
+	}
+}
+
+// open a WAV file and find its data chunk (returns NULL for error)
+sf_wavreader sf_wavreader_open(const char *file){
 	FILE *fp = fopen(file, "rb");
 	if (fp == NULL)
 		return NULL;
@@ -105,40 +177,44 @@ sf_snd sf_wavload(const char *file){
 				return NULL;
 			}
 
-			// calculate the number of samples based on the chunk size and allocate the space
-			int scount = chunksize / (numchannels * bps / 8);
-			sf_snd snd = sf_snd_new(scount, samplerate, false);
-			if (snd == NULL){
+			sf_wavreader wr = sf_malloc(sizeof(struct sf_wavreader_st));
+			if (wr == NULL){
 				fclose(fp);
 				return NULL;
 			}
+			wr->rate = samplerate;
+			wr->size = chunksize / (numchannels * bps / 8);
+			wr->pos = 0;
+			wr->numchannels = numchannels;
+			wr->fp = fp;
+			wr->map = NULL;
+			wr->mapsize = 0;
+			wr->dataofs = ftell(fp);
+			wr->released = 0;
+
+			#ifdef SF_WAV_MMAP
+			// map the file if we can; otherwise keep reading through stdio
+			struct stat st;
+			if (fstat(fileno(fp), &st) == 0 && st.st_size > 0){
+				void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+				if (map != MAP_FAILED){
+					#ifdef MADV_SEQUENTIAL
+					madvise(map, st.st_size, MADV_SEQUENTIAL);
+					#endif
+					wr->map = map;
+					wr->mapsize = st.st_size;
+					wr->fp = NULL;
+					fclose(fp);
 
-			// read the data and convert to stereo floating point
-			int16_t L, R;
-			for (int i = 0; i < scount; i++){
-				// read the sample
-				L = (int16_t)read_u16le(fp);
-				if (numchannels == 1)
-					R = L; // expand to stereo
-				else
-					R = (int16_t)read_u16le(fp);
-
-				// convert the sample to floating point
-				// notice that int16 samples range from -32768 to 32767, therefore we have a
-				// different divisor depending on whether the value is negative or not
-				if (L < 0)
-					snd->samples[i].L = (float)L / 32768.0f;
-				else
-					snd->samples[i].L = (float)L / 32767.0f;
-				if (R < 0)
-					snd->samples[i].R = (float)R / 32768.0f;
-				else
-					snd->samples[i].R = (float)R / 32767.0f;
+					// a truncated file only yields the samples it actually has
+					size_t avail = wr->dataofs < wr->mapsize ? wr->mapsize - wr->dataofs : 0;
+					if ((size_t)wr->size > avail / (numchannels * 2))
+						wr->size = avail / (numchannels * 2);
+				}
 			}
+			#endif
 
-			// we've loaded the wav data, so just return now
-			fclose(fp);
-			return snd;
+			return wr;
 		}
 		else{ // skip an unknown chunk
 			if (chunksize > 0)
@@ -151,55 +227,175 @@ sf_snd sf_wavload(const char *file){
 	return NULL;
 }
 
-static float clampf(float v, float min, float max){
-	return v < min ? min : (v > max ? max : v);
+int sf_wavreader_rate(sf_wavreader wr){
+	return wr->rate;
 }
 
-// save a WAV file (returns false for error)
-bool sf_wavsave(sf_snd snd, const char *file){
-	FILE *fp = fopen(file, "wb");
-	if (fp == NULL)
-		return false;
+int sf_wavreader_size(sf_wavreader wr){
+	return wr->size;
+}
+
+int sf_wavreader_read(sf_wavreader wr, int size, sf_sample_st *samples){
+	if (size > wr->size - wr->pos)
+		size = wr->size - wr->pos;
+	if (size <= 0)
+		return 0;
+	int blockalign = wr->numchannels * 2;
+
+	if (wr->map){
+		size_t ofs = wr->dataofs + (size_t)wr->pos * blockalign;
+		decode(wr->map + ofs, wr->numchannels, size, samples);
+		wr->pos += size;
+
+		#if defined(SF_WAV_MMAP) && defined(MADV_DONTNEED)
+		// hand the pages we're done with back to the OS, so a long file doesn't stay resident
+		ofs += (size_t)size * blockalign;
+		if (ofs - wr->released >= SF_WAV_RELEASE){
+			size_t pagesize = sysconf(_SC_PAGESIZE);
+			size_t end = ofs & ~(pagesize - 1);
+			madvise((void *)(wr->map + wr->released), end - wr->released, MADV_DONTNEED);
+			wr->released = end;
+		}
+		#endif
+		return size;
+	}
+
+	// read through stdio one buffer at a time
+	int total = 0;
+	int bufsamples = SF_WAV_BUFSIZE / blockalign;
+	while (total < size){
+		int len = size - total;
+		if (len > bufsamples)
+			len = bufsamples;
+		len = fread(wr->buf, blockalign, len, wr->fp);
+		if (len <= 0){
+			// the file ended before the data chunk said it would
+			wr->size = wr->pos;
+			break;
+		}
+		decode(wr->buf, wr->numchannels, len, &samples[total]);
+		wr->pos += len;
+		total += len;
+	}
+	return total;
+}
+
+void sf_wavreader_close(sf_wavreader wr){
+	#ifdef SF_WAV_MMAP
+	if (wr->map)
+		munmap((void *)wr->map, wr->mapsize);
+	#endif
+	if (wr->fp)
+		fclose(wr->fp);
+	sf_free(wr);
+}
 
-	// calculate the different file sizes based on sample size
-	uint32_t size2 = snd->size * 4; // total bytes of data
-	uint32_t sizeall = size2 + 36; // total file size minus 8
-	if (snd->size > size2 || snd->size > sizeall || size2 > sizeall)
-		return false; // sample too large
+// load a WAV file (returns NULL for error)
+sf_snd sf_wavload(const char *file){
+	sf_wavreader wr = sf_wavreader_open(file);
+	if (wr == NULL)
+		return NULL;
+
+	sf_snd snd = sf_snd_new(wr->size, wr->rate, false);
+	if (snd == NULL){
+		sf_wavreader_close(wr);
+		return NULL;
+	}
 
+	// a short read leaves the rest of the sound silent
+	int size = sf_wavreader_read(wr, snd->size, snd->samples);
+	if (size < snd->size)
+		memset(&snd->samples[size], 0, sizeof(sf_sample_st) * (snd->size - size));
+
+	sf_wavreader_close(wr);
+	return snd;
+}
+
+static void write_header(FILE *fp, int rate, uint32_t datasize){
 	write_u32le(fp, 0x46464952);    // 'RIFF'
-	write_u32le(fp, sizeall);       // rest of file size
+	write_u32le(fp, datasize + 36); // rest of file size
 	write_u32le(fp, 0x45564157);    // 'WAVE'
 	write_u32le(fp, 0x20746D66);    // 'fmt '
 	write_u32le(fp, 16);            // size of fmt chunk
 	write_u16le(fp, 1);             // audio format
 	write_u16le(fp, 2);             // stereo
-	write_u32le(fp, snd->rate);     // sample rate
-	write_u32le(fp, snd->rate * 4); // bytes per second
+	write_u32le(fp, rate);          // sample rate
+	write_u32le(fp, rate * 4);      // bytes per second
 	write_u16le(fp, 4);             // block align
 	write_u16le(fp, 16);            // bits per sample
 	write_u32le(fp, 0x61746164);    // 'data'
-	write_u32le(fp, size2);         // size of data chunk
+	write_u32le(fp, datasize);      // size of data chunk
+}
 
-	// convert the sample to stereo 16-bit, and write to file
-	for (int i = 0; i < snd->size; i++){
-		float L = clampf(snd->samples[i].L, -1, 1);
-		float R = clampf(snd->samples[i].R, -1, 1);
-		int16_t Lv, Rv;
-		// once again, int16 samples range from -32768 to 32767, so we need to scale the floating
-		// point sample by a different factor depending on whether it's negative
-		if (L < 0)
-			Lv = (int16_t)(L * 32768.0f);
-		else
-			Lv = (int16_t)(L * 32767.0f);
-		if (R < 0)
-			Rv = (int16_t)(R * 32768.0f);
-		else
-			Rv = (int16_t)(R * 32767.0f);
-		write_u16le(fp, (uint16_t)Lv);
-		write_u16le(fp, (uint16_t)Rv);
+// create a WAV file, with the sizes in the header left at zero until it's closed
+sf_wavwriter sf_wavwriter_open(const char *file, int rate){
+	sf_wavwriter ww = sf_malloc(sizeof(struct sf_wavwriter_st));
+	if (ww == NULL)
+		return NULL;
+	ww->fp = fopen(file, "wb");
+	if (ww->fp == NULL){
+		sf_free(ww);
+		return NULL;
+	}
+	ww->rate = rate;
+	ww->datasize = 0;
+	ww->error = false;
+	write_header(ww->fp, rate, 0);
+	return ww;
+}
+
+bool sf_wavwriter_write(sf_wavwriter ww, int size, const sf_sample_st *samples){
+	if (ww->error)
+		return false;
+
+	// the data and the file sizes must both fit in 32 bits
+	if (size < 0 || (uint64_t)ww->datasize + (uint64_t)size * 4 > 0xFFFFFFFFu - 36){
+		ww->error = true; // sample too large
+		return false;
 	}
 
-	fclose(fp);
+	// convert the sample to stereo 16-bit, and write to file
+	int bufsamples = SF_WAV_BUFSIZE / 4;
+	for (int start = 0; start < size; start += bufsamples){
+		int len = size - start < bufsamples ? size - start : bufsamples;
+		uint8_t *p = ww->buf;
+		for (int i = 0; i < len; i++, p += 4){
+			uint16_t Lv = (uint16_t)ftos16(samples[start + i].L);
+			uint16_t Rv = (uint16_t)ftos16(samples[start + i].R);
+			p[0] = Lv & 0xFF;
+			p[1] = (Lv >> 8) & 0xFF;
+			p[2] = Rv & 0xFF;
+			p[3] = (Rv >> 8) & 0xFF;
+		}
+		if (fwrite(ww->buf, 4, len, ww->fp) != (size_t)len){
+			ww->error = true;
+			return false;
+		}
+		ww->datasize += len * 4;
+	}
 	return true;
 }
+
+bool sf_wavwriter_close(sf_wavwriter ww){
+	// go back and fill in the sizes now that we know them
+	bool res = !ww->error;
+	if (fseek(ww->fp, 0, SEEK_SET) == 0)
+		write_header(ww->fp, ww->rate, ww->datasize);
+	else
+		res = false;
+	if (ferror(ww->fp))
+		res = false;
+	if (fclose(ww->fp) != 0)
+		res = false;
+	sf_free(ww);
+	return res;
+}
+
+// save a WAV file (returns false for error)
+bool sf_wavsave(sf_snd snd, const char *file){
+	sf_wavwriter ww = sf_wavwriter_open(file, snd->rate);
+	if (ww == NULL)
+		return false;
+	bool res = sf_wavwriter_write(ww, snd->size, snd->samples);
+	return sf_wavwriter_close(ww) && res;
+}
@@ -8,6 +8,29 @@
 // simple .wav file loading and saving
 // only handles loading 1 or 2 channel WAVs with 16-bit samples
 // only saves 2 channel WAVs with 16-bit samples
+//
+// sf_wavload/sf_wavsave move the whole sound through memory at once; for long files use the
+// streaming reader and writer instead, which only ever hold a small buffer:
+//
+//   sf_wavreader wr = sf_wavreader_open("in.wav");
+//   sf_wavwriter ww = sf_wavwriter_open("out.wav", sf_wavreader_rate(wr));
+//   sf_sample_st chunk[4096];
+//   int size;
+//   while ((size = sf_wavreader_read(wr, 4096, chunk)) > 0){
+//     ...process chunk...
+//     sf_wavwriter_write(ww, size, chunk);
+//   }
+//   sf_wavreader_close(wr);
+//   sf_wavwriter_close(ww);
+//
+// the reader memory-maps the file where available (define SF_NO_MMAP to always use stdio), and
+// gives pages it has already consumed back to the OS, so resident memory stays flat no matter how
+// long the input is
+//
+// the writer leaves the header sizes empty until sf_wavwriter_close, so the output file must be
+// seekable, and it only contains a valid WAV once closed
+//
+// readers and writers are allocated with sf_malloc
 
 #ifndef SNDFILTER_WAV__H
 #define SNDFILTER_WAV__H
@@ -17,4 +40,21 @@
 sf_snd sf_wavload(const char *file);
 bool   sf_wavsave(sf_snd snd, const char *file);
 
+typedef struct sf_wavreader_st *sf_wavreader;
+typedef struct sf_wavwriter_st *sf_wavwriter;
+
+// returns NULL for error
+sf_wavreader sf_wavreader_open(const char *file);
+int          sf_wavreader_rate(sf_wavreader wr);
+int          sf_wavreader_size(sf_wavreader wr); // total number of samples in the file
+// reads up to size samples (expanded to stereo), returns the number read, 0 at the end of the data
+int          sf_wavreader_read(sf_wavreader wr, int size, sf_sample_st *samples);
+void         sf_wavreader_close(sf_wavreader wr);
+
+// returns NULL for error
+sf_wavwriter sf_wavwriter_open(const char *file, int rate);
+bool         sf_wavwriter_write(sf_wavwriter ww, int size, const sf_sample_st *samples);
+// finishes the header and closes the file, returns false if any write failed
+bool         sf_wavwriter_close(sf_wavwriter ww);
+
 #endif // SNDFILTER_WAV__H
@@ -0,0 +1,300 @@
+/*
+ * sndfilter C++ Extension for Python
+ * Real-time bindings for the sndfilter reverb and compressor (sndfilter/src)
+ *
+ * Features:
+ * - Progenitor2-style algorithmic reverb with the 19 sndfilter presets
+ * - WebAudio-style dynamics compressor with gain metering
+ * - Planar float32 buffers processed in place of the caller's arrays (no copies)
+ * - State allocated once per object; parameter changes are prepared off the
+ *   audio thread and swapped in between calls
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+extern "C" {
+#include "compressor.h"
+#include "reverb.h"
+}
+
+namespace py = pybind11;
+
+namespace {
+
+// ============================================================================
+// Buffer checks
+// ============================================================================
+// Contiguous 1-D float32 array: the sndfilter block API reads and writes it directly
+float* planarBuffer(py::array& arr, const char* name, bool writable, size_t& length) {
+    if (!arr.dtype().is(py::dtype::of<float>())) {
+        throw std::runtime_error(std::string(name) + " must be a float32 array");
+    }
+    if (arr.ndim() != 1) {
+        throw std::runtime_error(std::string(name) + " must be 1-dimensional");
+    }
+    if (!(arr.flags() & py::array::c_style)) {
+        throw std::runtime_error(std::string(name) + " must be contiguous (planar)");
+    }
+    if (writable && !arr.writeable()) {
+        throw std::runtime_error(std::string(name) + " must be writable");
+    }
+    length = static_cast<size_t>(arr.shape(0));
+    return writable ? static_cast<float*>(arr.mutable_data())
+                    : const_cast<float*>(static_cast<const float*>(arr.data()));
+}
+
+struct PlanarBlock {
+    const float* inL;
+    const float* inR;
+    float* outL;
+    float* outR;
+    int length;
+};
+
+PlanarBlock checkPlanarBlock(py::array& left_in, py::array& right_in,
+                             py::array& left_out, py::array& right_out) {
+    size_t lengths[4];
+    PlanarBlock block;
+    block.inL = planarBuffer(left_in, "left_in", false, lengths[0]);
+    block.inR = planarBuffer(right_in, "right_in", false, lengths[1]);
+    block.outL = planarBuffer(left_out, "left_out", true, lengths[2]);
+    block.outR = planarBuffer(right_out, "right_out", true, lengths[3]);
+    if (lengths[1] != lengths[0] || lengths[2] != lengths[0] || lengths[3] != lengths[0]) {
+        throw std::runtime_error("All input and output arrays must have same length");
+    }
+    if (lengths[0] > static_cast<size_t>(INT_MAX)) {
+        throw std::runtime_error("Block too long");
+    }
+    if (block.outL == block.outR && lengths[0] > 0) {
+        throw std::runtime_error("left_out and right_out must not share memory");
+    }
+    block.length = static_cast<int>(lengths[0]);
+    return block;
+}
+
+// ============================================================================
+// Double-buffered filter state
+// ============================================================================
+// Parameter changes initialize the spare state outside the lock (the reverb
+// state is ~2 MB and its setup clears every delay line), then swap it in, so
+// process_into() only ever waits for a pointer swap
+template<typename State>
+class StatePair {
+public:
+    StatePair() : active(new State()), spare(new State()) {}
+
+    template<typename Init>
+    void replace(Init init) {
+        std::lock_guard<std::mutex> setupLock(setupMutex);
+        init(spare.get());
+        std::lock_guard<std::mutex> lock(processMutex);
+        std::swap(active, spare);
+    }
+
+    template<typename Process>
+    void process(Process run) {
+        std::lock_guard<std::mutex> lock(processMutex);
+        run(active.get());
+    }
+
+private:
+    std::unique_ptr<State> active;
+    std::unique_ptr<State> spare;
+    std::mutex setupMutex;    // One parameter change at a time
+    std::mutex processMutex;  // Held while processing and while swapping
+};
+
+// ============================================================================
+// Reverb
+// ============================================================================
+struct ReverbPresetName {
+    const char* name;
+    sf_reverb_preset preset;
+};
+
+const ReverbPresetName REVERB_PRESETS[] = {
+    {"default", SF_REVERB_PRESET_DEFAULT},
+    {"small_hall_1", SF_REVERB_PRESET_SMALLHALL1},
+    {"small_hall_2", SF_REVERB_PRESET_SMALLHALL2},
+    {"medium_hall_1", SF_REVERB_PRESET_MEDIUMHALL1},
+    {"medium_hall_2", SF_REVERB_PRESET_MEDIUMHALL2},
+    {"large_hall_1", SF_REVERB_PRESET_LARGEHALL1},
+    {"large_hall_2", SF_REVERB_PRESET_LARGEHALL2},
+    {"small_room_1", SF_REVERB_PRESET_SMALLROOM1},
+    {"small_room_2", SF_REVERB_PRESET_SMALLROOM2},
+    {"medium_room_1", SF_REVERB_PRESET_MEDIUMROOM1},
+    {"medium_room_2", SF_REVERB_PRESET_MEDIUMROOM2},
+    {"large_room_1", SF_REVERB_PRESET_LARGEROOM1},
+    {"large_room_2", SF_REVERB_PRESET_LARGEROOM2},
+    {"medium_er_1", SF_REVERB_PRESET_MEDIUMER1},
+    {"medium_er_2", SF_REVERB_PRESET_MEDIUMER2},
+    {"plate_high", SF_REVERB_PRESET_PLATEHIGH},
+    {"plate_low", SF_REVERB_PRESET_PLATELOW},
+    {"long_reverb_1", SF_REVERB_PRESET_LONGREVERB1},
+    {"long_reverb_2", SF_REVERB_PRESET_LONGREVERB2},
+};
+
+sf_reverb_preset parseReverbPreset(const std::string& name) {
+    for (const ReverbPresetName& entry : REVERB_PRESETS) {
+        if (name == entry.name) return entry.preset;
+    }
+    throw std::runtime_error("Unknown reverb preset '" + name + "'");
+}
+
+int checkSampleRate(double sample_rate) {
+    if (!(sample_rate >= 8000.0 && sample_rate <= 384000.0)) {
+        throw std::runtime_error("sample_rate must be between 8000 and 384000");
+    }
+    return static_cast<int>(sample_rate);
+}
+
+class Reverb {
+public:
+    Reverb(double sample_rate, const std::string& preset)
+        : sampleRate(checkSampleRate(sample_rate)) {
+        set_preset(preset);
+    }
+
+    void set_preset(const std::string& name) {
+        const sf_reverb_preset preset = parseReverbPreset(name);
+        const int rate = sampleRate;
+        state.replace([=](sf_reverb_state_st* rv) { sf_presetreverb(rv, rate, preset); });
+    }
+
+    void set_params(int oversample_factor, float er_to_late, float er_wet, float dry,
+                    float er_factor, float er_width, float width, float wet, float wander,
+                    float bass_boost, float spin, float input_lpf, float bass_lpf,
+                    float damp_lpf, float output_lpf, float rt60, float delay) {
+        const int rate = sampleRate;
+        state.replace([=](sf_reverb_state_st* rv) {
+            sf_advancereverb(rv, rate, oversample_factor, er_to_late, er_wet, dry, er_factor,
+                             er_width, width, wet, wander, bass_boost, spin, input_lpf,
+                             bass_lpf, damp_lpf, output_lpf, rt60, delay);
+        });
+    }
+
+    void process_into(py::array left_in, py::array right_in,
+                      py::array left_out, py::array right_out) {
+        PlanarBlock block = checkPlanarBlock(left_in, right_in, left_out, right_out);
+        py::gil_scoped_release release;
+        state.process([&](sf_reverb_state_st* rv) {
+            sf_reverb_process_planar(rv, block.length, block.inL, block.inR,
+                                     block.outL, block.outR);
+        });
+    }
+
+    int sample_rate() const { return sampleRate; }
+
+private:
+    const int sampleRate;
+    StatePair<sf_reverb_state_st> state;
+};
+
+// ============================================================================
+// Compressor
+// ============================================================================
+class Compressor {
+public:
+    Compressor(double sample_rate, float pregain, float threshold, float knee, float ratio,
+               float attack, float release, float predelay, float postgain, float wet)
+        : sampleRate(checkSampleRate(sample_rate)) {
+        set_params(pregain, threshold, knee, ratio, attack, release, predelay, postgain, wet);
+    }
+
+    void set_params(float pregain, float threshold, float knee, float ratio, float attack,
+                    float release, float predelay, float postgain, float wet) {
+        if (!(ratio >= 1.0f)) {
+            throw std::runtime_error("ratio must be >= 1");
+        }
+        const int rate = sampleRate;
+        state.replace([=](sf_compressor_state_st* cs) {
+            // Release zones: sndfilter's defaults (see adaptive-release-curve.html)
+            sf_advancecomp(cs, rate, pregain, threshold, knee, ratio, attack, release, predelay,
+                           0.090f, 0.160f, 0.420f, 0.980f, postgain, wet);
+        });
+    }
+
+    void process_into(py::array left_in, py::array right_in,
+                      py::array left_out, py::array right_out) {
+        PlanarBlock block = checkPlanarBlock(left_in, right_in, left_out, right_out);
+        py::gil_scoped_release release;
+        state.process([&](sf_compressor_state_st* cs) {
+            sf_compressor_process_planar(cs, block.length, block.inL, block.inR,
+                                         block.outL, block.outR);
+            meterGain.store(std::min(cs->metergain, 0.0f), std::memory_order_relaxed);
+        });
+    }
+
+    // dB of gain reduction the compressor applied recently (0 or below)
+    float meter_gain() const { return meterGain.load(std::memory_order_relaxed); }
+
+    int sample_rate() const { return sampleRate; }
+
+private:
+    const int sampleRate;
+    StatePair<sf_compressor_state_st> state;
+    std::atomic<float> meterGain{0.0f};
+};
+
+}  // namespace
+
+PYBIND11_MODULE(sndfilter, m) {
+    m.doc() = "sndfilter reverb and compressor - block processing on planar float32 buffers";
+
+    py::class_<Reverb>(m, "Reverb")
+        .def(py::init<double, const std::string&>(),
+             py::arg("sample_rate") = 48000.0, py::arg("preset") = "default",
+             "Create a reverb with one of the presets listed in REVERB_PRESETS")
+        .def("set_preset", &Reverb::set_preset, py::arg("name"),
+             "Switch preset (clears the tail)")
+        .def("set_params", &Reverb::set_params,
+             py::arg("oversample_factor") = 1, py::arg("er_to_late") = 0.4f,
+             py::arg("er_wet") = -9.0f, py::arg("dry") = -10.0f, py::arg("er_factor") = 1.6f,
+             py::arg("er_width") = 0.7f, py::arg("width") = 1.0f, py::arg("wet") = 0.0f,
+             py::arg("wander") = 0.27f, py::arg("bass_boost") = 0.15f, py::arg("spin") = 0.7f,
+             py::arg("input_lpf") = 17000.0f, py::arg("bass_lpf") = 500.0f,
+             py::arg("damp_lpf") = 7000.0f, py::arg("output_lpf") = 10000.0f,
+             py::arg("rt60") = 3.2f, py::arg("delay") = 0.02f,
+             "Set every reverb parameter (defaults are the 'default' preset; wet/dry "
+             "levels in dB, filters in Hz, rt60 and delay in seconds). Clears the tail")
+        .def("process_into", &Reverb::process_into,
+             py::arg("left_in"), py::arg("right_in"),
+             py::arg("left_out"), py::arg("right_out"),
+             "Process contiguous float32 buffers of equal length into preallocated outputs "
+             "(outputs may be the inputs). Releases the GIL while processing")
+        .def_property_readonly("sample_rate", &Reverb::sample_rate);
+
+    py::class_<Compressor>(m, "Compressor")
+        .def(py::init<double, float, float, float, float, float, float, float, float, float>(),
+             py::arg("sample_rate") = 48000.0, py::arg("pregain") = 0.0f,
+             py::arg("threshold") = -24.0f, py::arg("knee") = 30.0f, py::arg("ratio") = 12.0f,
+             py::arg("attack") = 0.003f, py::arg("release") = 0.25f,
+             py::arg("predelay") = 0.006f, py::arg("postgain") = 0.0f, py::arg("wet") = 1.0f,
+             "Create a compressor (gains and threshold in dB, times in seconds)")
+        .def("set_params", &Compressor::set_params,
+             py::arg("pregain") = 0.0f, py::arg("threshold") = -24.0f, py::arg("knee") = 30.0f,
+             py::arg("ratio") = 12.0f, py::arg("attack") = 0.003f, py::arg("release") = 0.25f,
+             py::arg("predelay") = 0.006f, py::arg("postgain") = 0.0f, py::arg("wet") = 1.0f,
+             "Set every compressor parameter (resets the envelope)")
+        .def("process_into", &Compressor::process_into,
+             py::arg("left_in"), py::arg("right_in"),
+             py::arg("left_out"), py::arg("right_out"),
+             "Process contiguous float32 buffers of equal length into preallocated outputs "
+             "(outputs may be the inputs). Releases the GIL while processing")
+        .def_property_readonly("meter_gain", &Compressor::meter_gain,
+                               "Gain reduction in dB after the last block (<= 0)")
+        .def_property_readonly("sample_rate", &Compressor::sample_rate);
+
+    py::list presets;
+    for (const ReverbPresetName& entry : REVERB_PRESETS) presets.append(entry.name);
+    m.attr("REVERB_PRESETS") = presets;
+    m.attr("__version__") = "1.0.0";
+}
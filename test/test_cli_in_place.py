@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""
+In-place runs of the command line tools (output path == input path)
+
+- alien4_render: the input is replaced by the full render, identical to an
+  out-of-place render of the same file, with no <output>.part left behind
+- A failed render leaves the input byte for byte as it was
+- sndfilter: the same for its temp-file-and-rename path, including the
+  same file spelled differently and a write that fails partway through;
+  batch mode refuses an output directory that is the input directory
+
+Run:  python3 test/test_cli_in_place.py --render build/alien4_render \
+          --sndfilter build/sndfilter_cli
+"""
+
+import argparse
+import os
+import random
+import shutil
+import signal
+import struct
+import subprocess
+import sys
+import tempfile
+import wave
+
+SAMPLE_RATE = 48000
+FRAMES = SAMPLE_RATE + 1234  # Not a multiple of any block size
+
+failures = 0
+
+
+def check(condition, what):
+    global failures
+    if not condition:
+        print(f"CHECK failed: {what}", file=sys.stderr)
+        failures += 1
+
+
+def write_input(path):
+    """16-bit stereo noise, deterministic"""
+    rng = random.Random(3)
+    samples = [rng.randint(-16000, 16000) for _ in range(FRAMES * 2)]
+    with wave.open(path, "wb") as out:
+        out.setnchannels(2)
+        out.setsampwidth(2)
+        out.setframerate(SAMPLE_RATE)
+        out.writeframes(struct.pack(f"<{len(samples)}h", *samples))
+
+
+def wav_info(path):
+    """(format tag, channels, rate, bits, frames) from the fmt and data chunks"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"RIFF" or data[8:12] != b"WAVE":
+        return None
+    pos, fmt = 12, None
+    while pos + 8 <= len(data):
+        chunk, size = data[pos:pos + 4], struct.unpack_from("<I", data, pos + 4)[0]
+        if chunk == b"fmt ":
+            fmt = struct.unpack_from("<HHIIHH", data, pos + 8)
+        elif chunk == b"data" and fmt is not None:
+            tag, channels, rate, _, block_align, bits = fmt
+            if size > len(data) - pos - 8:
+                return None  # Header claims more than the file holds
+            return tag, channels, rate, bits, size // block_align
+        pos += 8 + size + (size & 1)
+    return None
+
+
+def read_bytes(path):
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def leftovers(directory, name):
+    """Files next to name that a run left behind (temporary outputs)"""
+    return sorted(f for f in os.listdir(directory) if f.startswith(name) and f != name)
+
+
+def run(command, max_file_bytes=None):
+    """Exit code; max_file_bytes makes writes past that size fail (EFBIG)"""
+    def limit():
+        import resource  # POSIX only, like preexec_fn
+        signal.signal(signal.SIGXFSZ, signal.SIG_IGN)
+        resource.setrlimit(resource.RLIMIT_FSIZE, (max_file_bytes, max_file_bytes))
+    return subprocess.run(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                          preexec_fn=limit if max_file_bytes else None).returncode
+
+
+def test_render(render, directory):
+    source = os.path.join(directory, "source.wav")
+    write_input(source)
+    original = read_bytes(source)
+
+    # The reference: the same file rendered to a separate output
+    reference = os.path.join(directory, "reference.wav")
+    check(run([render, "-t", "0.25", source, reference]) == 0, "out-of-place render succeeds")
+    check(wav_info(reference) == (3, 2, SAMPLE_RATE, 32, FRAMES + SAMPLE_RATE // 4),
+          "reference render is float32 stereo, input length plus the tail")
+
+    target = os.path.join(directory, "render.wav")
+    shutil.copyfile(source, target)
+    check(run([render, "-t", "0.25", target, target]) == 0, "in-place render succeeds")
+    check(read_bytes(target) == read_bytes(reference), "in-place render matches the reference")
+    check(leftovers(directory, "render.wav") == [], "in-place render leaves no .part file")
+
+    # Fails before any output is written: a bad automation file
+    shutil.copyfile(source, target)
+    automation = os.path.join(directory, "bad_automation.txt")
+    with open(automation, "w") as f:
+        f.write("0.0 no_such_parameter 1\n")
+    check(run([render, "-a", automation, target, target]) != 0, "bad automation fails")
+    check(read_bytes(target) == original, "failed render leaves the input untouched")
+    check(leftovers(directory, "render.wav") == [], "failed render leaves no .part file")
+
+    # Fails to create the output: its .part path is taken by a directory
+    os.mkdir(target + ".part")
+    check(run([render, target, target]) != 0, "unwritable output fails")
+    check(read_bytes(target) == original, "failed write leaves the input untouched")
+    os.rmdir(target + ".part")
+
+
+def test_sndfilter(sndfilter, directory):
+    source = os.path.join(directory, "source.wav")
+    write_input(source)
+    original = read_bytes(source)
+    lowpass = ["lowpass", "1000", "0.7"]
+
+    reference = os.path.join(directory, "reference.wav")
+    check(run([sndfilter, source, reference] + lowpass) == 0, "out-of-place sndfilter succeeds")
+    check(wav_info(reference) == (1, 2, SAMPLE_RATE, 16, FRAMES),
+          "reference output is 16-bit stereo at the input length")
+
+    target = os.path.join(directory, "filter.wav")
+    shutil.copyfile(source, target)
+    check(run([sndfilter, target, target] + lowpass) == 0, "in-place sndfilter succeeds")
+    check(read_bytes(target) == read_bytes(reference), "in-place output matches the reference")
+    check(leftovers(directory, "filter.wav") == [], "in-place run leaves no temp file")
+
+    # The same file under another spelling is still in place
+    shutil.copyfile(source, target)
+    respelled = os.path.join(directory, ".", "filter.wav")
+    check(run([sndfilter, respelled, target] + lowpass) == 0, "respelled in-place run succeeds")
+    check(read_bytes(target) == read_bytes(reference), "respelled run matches the reference")
+
+    # A write that fails partway: the temp file is dropped, the input kept
+    shutil.copyfile(source, target)
+    check(run([sndfilter, target, target] + lowpass, max_file_bytes=65536) != 0,
+          "write past the file size limit fails")
+    check(read_bytes(target) == original, "failed write leaves the input untouched")
+    check(leftovers(directory, "filter.wav") == [], "failed write leaves no temp file")
+
+    # Batch mode would overwrite the files it is still reading
+    batch = os.path.join(directory, "batch")
+    os.mkdir(batch)
+    shutil.copyfile(source, os.path.join(batch, "a.wav"))
+    check(run([sndfilter, batch, batch] + lowpass) != 0, "batch into its input directory fails")
+    check(read_bytes(os.path.join(batch, "a.wav")) == original, "refused batch leaves inputs")
+    check(os.listdir(batch) == ["a.wav"], "refused batch writes nothing")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--render", help="alien4_render executable")
+    parser.add_argument("--sndfilter", help="sndfilter command line executable")
+    args = parser.parse_args()
+    if not (args.render or args.sndfilter):
+        parser.error("nothing to test: pass --render and/or --sndfilter")
+
+    if args.render:
+        with tempfile.TemporaryDirectory() as directory:
+            test_render(os.path.abspath(args.render), directory)
+    if args.sndfilter:
+        with tempfile.TemporaryDirectory() as directory:
+            test_sndfilter(os.path.abspath(args.sndfilter), directory)
+
+    if failures:
+        print(f"test_cli_in_place: {failures} check(s) failed")
+        return 1
+    print("test_cli_in_place: all checks passed")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
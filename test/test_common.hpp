@@ -0,0 +1,73 @@
+/*
+ * Shared helpers for the Alien4 test executables
+ *
+ * Each test is one executable that returns non-zero when a CHECK failed, so
+ * ctest can run it directly. Like the bench, tests include the extension
+ * translation unit and exercise the engine through its public C++ API.
+ *
+ * Build:  cmake -S . -B build -DALIEN4_BUILD_TESTS=ON && cmake --build build
+ * Run:    ctest --test-dir build --output-on-failure
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline int finish(const char* name) {
+    if (failures() == 0) {
+        std::printf("%s: all checks passed\n", name);
+        return 0;
+    }
+    std::printf("%s: %d check(s) failed\n", name, failures());
+    return 1;
+}
+
+// Deterministic stand-in for program material
+inline std::vector<float> makeNoise(size_t count, uint32_t seed, float amplitude = 0.5f) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+    std::vector<float> out(count);
+    for (float& v : out) v = dist(rng);
+    return out;
+}
+
+inline float maxAbsDiff(const std::vector<float>& a, const std::vector<float>& b) {
+    if (a.size() != b.size()) return INFINITY;
+    float worst = 0.0f;
+    for (size_t i = 0; i < a.size(); i++) worst = std::max(worst, std::abs(a[i] - b[i]));
+    return worst;
+}
+
+}  // namespace test
+
+#define CHECK(condition)                                                                 \
+    do {                                                                                 \
+        if (!(condition)) {                                                              \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__,        \
+                         #condition);                                                    \
+            ++test::failures();                                                          \
+        }                                                                                \
+    } while (0)
+
+// Float comparison that reports both values
+#define CHECK_NEAR(actual, expected, tolerance)                                          \
+    do {                                                                                 \
+        const double checkActual = (actual);                                             \
+        const double checkExpected = (expected);                                         \
+        if (!(std::abs(checkActual - checkExpected) <= (tolerance))) {                   \
+            std::fprintf(stderr, "%s:%d: CHECK_NEAR failed: %s = %g, expected %g +/- %g\n", \
+                         __FILE__, __LINE__, #actual, checkActual, checkExpected,        \
+                         static_cast<double>(tolerance));                                \
+            ++test::failures();                                                          \
+        }                                                                                \
+    } while (0)
@@ -0,0 +1,150 @@
+/*
+ * AudioEngine parameter snapshot and ramps
+ *
+ * - A setter takes effect at the start of the next block and glides over
+ *   PARAM_RAMP_SECONDS, sample by sample
+ * - The glide does not depend on the host buffer size
+ * - Setters from a control thread while another thread processes leave the
+ *   engine in the state of the last snapshot
+ */
+
+#include "alien4_extension.cpp"
+
+#include "test_common.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+constexpr double SAMPLE_RATE = 48000.0;
+
+void process(AudioEngine& engine, const float* in, float* outL, float* outR, size_t n) {
+    engine.processBlock(in, in, outL, outR, n);
+}
+
+// With no loop recorded, MIX crossfades the input against silence
+void testMixRamp() {
+    AudioEngine engine(SAMPLE_RATE);
+    const int ramp = static_cast<int>(AudioEngine::PARAM_RAMP_SECONDS * SAMPLE_RATE);
+    const size_t block = 64;
+    std::vector<float> in(block, 1.0f), outL(block), outR(block);
+
+    process(engine, in.data(), outL.data(), outR.data(), block);
+    CHECK(outL[block - 1] == 1.0f);
+
+    // Picked up by the next block, whose first sample is one ramp step in
+    engine.set_mix(1.0);
+    std::vector<float> output;
+    for (int done = 0; done < 2 * ramp; done += static_cast<int>(block)) {
+        process(engine, in.data(), outL.data(), outR.data(), block);
+        output.insert(output.end(), outL.begin(), outL.end());
+    }
+
+    float worst = 0.0f;
+    for (int i = 0; i < ramp; i++) {
+        const float expected = 1.0f - static_cast<float>(i + 1) / static_cast<float>(ramp);
+        worst = std::max(worst, std::abs(output[i] - expected));
+    }
+    CHECK(worst < 1e-4f);
+    for (size_t i = ramp; i < output.size(); i++) CHECK(output[i] == 0.0f);
+}
+
+struct Stereo {
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+// Record a loop, then play it back with per-sample ramped controls moving
+// every 2048 frames; changes land on the same frames for every host size
+Stereo renderScripted(size_t block) {
+    AudioEngine engine(SAMPLE_RATE);
+    engine.seedRandom(7);
+    engine.setSynchronousSlicing(true);
+
+    const size_t total = 3 * 48000;
+    const std::vector<float> input = test::makeNoise(total, 11);
+    Stereo output;
+    output.left.resize(total);
+    output.right.resize(total);
+
+    for (size_t frame = 0; frame < total; frame += block) {
+        if (frame % 2048 == 0) {
+            const int step = static_cast<int>(frame / 2048);
+            if (step == 0) engine.set_recording(true);
+            if (step == 23) engine.set_recording(false);
+            if (step == 24) {
+                engine.set_mix(0.8);
+                engine.set_feedback(0.3);
+                engine.set_delay_wet(0.4);
+                engine.set_delay_feedback(0.5);
+            }
+            if (step > 24) {
+                engine.set_speed(0.5 + 0.1 * (step % 7));
+                engine.set_delay_time(0.05 + 0.01 * (step % 5), 0.08);
+                engine.set_mix(0.5 + 0.05 * (step % 3));
+            }
+        }
+        const size_t n = std::min(block, total - frame);
+        process(engine, input.data() + frame, output.left.data() + frame,
+                output.right.data() + frame, n);
+    }
+    return output;
+}
+
+void testBlockSizeIndependence() {
+    const Stereo reference = renderScripted(256);
+    for (size_t block : {64, 128, 2048}) {
+        const Stereo output = renderScripted(block);
+        CHECK(test::maxAbsDiff(reference.left, output.left) < 1e-5f);
+        CHECK(test::maxAbsDiff(reference.right, output.right) < 1e-5f);
+    }
+}
+
+void testControlThread() {
+    AudioEngine engine(SAMPLE_RATE);
+    const size_t block = 128;
+    const std::vector<float> input = test::makeNoise(block, 3);
+    std::vector<float> outL(block), outR(block);
+
+    std::atomic<bool> running{true};
+    std::thread audio([&] {
+        while (running.load(std::memory_order_relaxed)) {
+            process(engine, input.data(), outL.data(), outR.data(), block);
+        }
+    });
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int i = 0; i < 20000; i++) {
+        engine.set_mix(unit(rng));
+        engine.set_feedback(unit(rng) * 0.5);
+        engine.set_delay_time(0.01 + unit(rng) * 0.5, 0.01 + unit(rng) * 0.5);
+        engine.set_delay_wet(unit(rng));
+        engine.set_eq_low(-12.0 * unit(rng));
+    }
+    // Last snapshot: everything back at rest, so the engine passes the input
+    engine.set_mix(0.0);
+    engine.set_feedback(0.0);
+    engine.set_delay_wet(0.0);
+    engine.set_eq_low(0.0);
+    running.store(false, std::memory_order_relaxed);
+    audio.join();
+
+    // Ramps settle within a second. An EQ that has not bypassed yet is a
+    // 0 dB identity filter up to coefficient rounding (around -100 dB)
+    for (int i = 0; i < 48000 / static_cast<int>(block); i++) {
+        process(engine, input.data(), outL.data(), outR.data(), block);
+    }
+    CHECK(test::maxAbsDiff(outL, input) < 1e-4f);
+    CHECK(test::maxAbsDiff(outR, input) < 1e-4f);
+}
+
+}  // namespace
+
+int main() {
+    testMixRamp();
+    testBlockSizeIndependence();
+    testControlThread();
+    return test::finish("test_engine_params");
+}
@@ -0,0 +1,245 @@
+/*
+ * DSP kernels against their references
+ *
+ * - Every CPU level this machine supports gives the baseline kernels'
+ *   output (to within FMA contraction)
+ * - Fast paths match the general code they stand in for: the fixed-time
+ *   delay against the modulated one, the Float4 EQ against its per-frame
+ *   form, FEEDBACK's chunked per-sample loop against one-frame blocks
+ */
+
+#include "alien4_extension.cpp"
+
+#include "test_common.hpp"
+
+#include <memory>
+
+namespace {
+
+constexpr float SAMPLE_RATE = 48000.0f;
+constexpr int BLOCK = 256;
+constexpr int BLOCKS = 64;
+constexpr float TOLERANCE = 1e-4f;
+
+struct KernelInput {
+    std::vector<float> left = test::makeNoise(BLOCK * BLOCKS, 1);
+    std::vector<float> right = test::makeNoise(BLOCK * BLOCKS, 2);
+    std::vector<float> chaos = test::makeNoise(BLOCK * BLOCKS, 3, 1.0f);
+    std::vector<float> zero = std::vector<float>(BLOCK, 0.0f);
+};
+
+std::vector<float> runEq(const DspKernels& kernels, const KernelInput& in) {
+    StereoEqCascade eq;
+    eq.setBand(0, BiquadCoefficients::LOWSHELF, 200.0f / SAMPLE_RATE, 0.707f, 0.5f);
+    eq.setBand(1, BiquadCoefficients::PEAK, 2000.0f / SAMPLE_RATE, 0.707f, 1.5f);
+    eq.setBand(2, BiquadCoefficients::HIGHSHELF, 8000.0f / SAMPLE_RATE, 0.707f, 0.25f);
+    std::vector<float> left = in.left, right = in.right;
+    for (int b = 0; b < BLOCKS; b++) {
+        kernels.eq(eq, left.data() + b * BLOCK, right.data() + b * BLOCK, BLOCK);
+    }
+    left.insert(left.end(), right.begin(), right.end());
+    return left;
+}
+
+std::vector<float> runReverb(const DspKernels& kernels, const KernelInput& in) {
+    auto reverb = std::make_unique<ReverbProcessor>();
+    std::vector<float> left(in.left.size()), right(in.right.size());
+    for (int b = 0; b < BLOCKS; b++) {
+        const int offset = b * BLOCK;
+        kernels.reverb(*reverb, in.left.data() + offset, in.right.data() + offset,
+                       left.data() + offset, right.data() + offset, in.chaos.data() + offset,
+                       BLOCK, 0.7f, 0.4f, 0.8f, true, SAMPLE_RATE);
+    }
+    left.insert(left.end(), right.begin(), right.end());
+    return left;
+}
+
+std::vector<float> runGrain(const DspKernels& kernels, const KernelInput& in) {
+    auto grain = std::make_unique<GrainProcessor>();
+    grain->randomEngine.seed(9);  // Seeded from random_device otherwise
+    std::vector<float> out(in.left.size());
+    for (int b = 0; b < BLOCKS; b++) {
+        const int offset = b * BLOCK;
+        kernels.grain(*grain, in.left.data() + offset, out.data() + offset, BLOCK, 0.3f, 0.6f,
+                      in.zero.data(), 0.4f, in.zero.data(), true, in.chaos.data() + offset,
+                      1.0f, SAMPLE_RATE);
+    }
+    return out;
+}
+
+template<typename Sample>
+std::vector<float> runVoices(const DspKernels& kernels, const KernelInput& in) {
+    // A loop of the input, four slices, eight voices at different speeds
+    const int length = BLOCK * BLOCKS;
+    std::vector<Sample> loop(length);
+    for (int i = 0; i < length; i++) {
+        if constexpr (std::is_same_v<Sample, int16_t>) {
+            loop[i] = static_cast<int16_t>(in.left[i] * 32767.0f);
+        } else {
+            loop[i] = in.left[i];
+        }
+    }
+    std::vector<Slice> slices(4);
+    for (int s = 0; s < 4; s++) {
+        slices[s].startSample = s * length / 4;
+        slices[s].endSample = (s + 1) * length / 4 - 1;
+        slices[s].active = true;
+    }
+
+    VoiceBank voices;
+    voices.setVoiceCount(VoiceBank::MAX_VOICES);
+    for (int v = 0; v < VoiceBank::MAX_VOICES; v++) {
+        voices.reset(v, v % 4, slices[v % 4].startSample + 37 * v, 0.5f + 0.25f * v - (v % 2) * 2.5f);
+    }
+    voices.updateBounds(slices, length);
+
+    std::vector<float> speed(BLOCK);
+    std::vector<float> left(length), right(length);
+    for (int b = 0; b < BLOCKS; b++) {
+        for (int i = 0; i < BLOCK; i++) speed[i] = 0.8f + 0.4f * static_cast<float>(b % 3);
+        if constexpr (std::is_same_v<Sample, int16_t>) {
+            kernels.voicesI16(voices, loop.data(), length, speed.data(), left.data() + b * BLOCK,
+                              right.data() + b * BLOCK, BLOCK);
+        } else {
+            kernels.voicesF32(voices, loop.data(), length, speed.data(), left.data() + b * BLOCK,
+                              right.data() + b * BLOCK, BLOCK);
+        }
+    }
+    left.insert(left.end(), right.begin(), right.end());
+    return left;
+}
+
+float peak(const std::vector<float>& values) {
+    float worst = 0.0f;
+    for (float v : values) worst = std::max(worst, std::abs(v));
+    return worst;
+}
+
+void testCpuLevels() {
+    const KernelInput in;
+    const DspKernels& baseline = kernelsFor(CpuLevel::BASELINE);
+    const std::vector<float> eq = runEq(baseline, in);
+    const std::vector<float> reverb = runReverb(baseline, in);
+    const std::vector<float> grain = runGrain(baseline, in);
+    const std::vector<float> voicesF32 = runVoices<float>(baseline, in);
+    const std::vector<float> voicesI16 = runVoices<int16_t>(baseline, in);
+
+    // Reference outputs are not silent, or the comparisons prove nothing
+    CHECK(peak(eq) > 0.1f);
+    CHECK(peak(reverb) > 0.01f);
+    CHECK(peak(grain) > 0.01f);
+    CHECK(peak(voicesF32) > 0.1f);
+    CHECK(peak(voicesI16) > 0.1f);
+
+    for (int i = 1; i < static_cast<int>(CpuLevel::NUM_LEVELS); i++) {
+        const CpuLevel level = static_cast<CpuLevel>(i);
+        if (!cpuSupports(level)) {
+            std::printf("  %s: not supported here, skipped\n", cpuLevelName(level));
+            continue;
+        }
+        const DspKernels& kernels = kernelsFor(level);
+        CHECK(kernels.level == level);
+        CHECK(test::maxAbsDiff(runEq(kernels, in), eq) < TOLERANCE);
+        CHECK(test::maxAbsDiff(runReverb(kernels, in), reverb) < TOLERANCE);
+        CHECK(test::maxAbsDiff(runGrain(kernels, in), grain) < TOLERANCE);
+        CHECK(test::maxAbsDiff(runVoices<float>(kernels, in), voicesF32) < TOLERANCE);
+        CHECK(test::maxAbsDiff(runVoices<int16_t>(kernels, in), voicesI16) < TOLERANCE);
+        std::printf("  %s: matches baseline\n", cpuLevelName(level));
+    }
+    CHECK(cpuSupports(dspKernels().level));
+}
+
+void testEqFrame() {
+    const KernelInput in;
+    StereoEqCascade block, frame;
+    for (StereoEqCascade* eq : {&block, &frame}) {
+        eq->setBand(0, BiquadCoefficients::LOWSHELF, 200.0f / SAMPLE_RATE, 0.707f, 2.0f);
+        eq->setBand(2, BiquadCoefficients::HIGHSHELF, 8000.0f / SAMPLE_RATE, 0.707f, 0.3f);
+    }
+    std::vector<float> blockL = in.left, blockR = in.right;
+    std::vector<float> frameL = in.left, frameR = in.right;
+    for (int b = 0; b < BLOCKS; b++) {
+        block.process(blockL.data() + b * BLOCK, blockR.data() + b * BLOCK, BLOCK);
+        for (int i = b * BLOCK; i < (b + 1) * BLOCK; i++) frame.processFrame(frameL[i], frameR[i]);
+        frame.flushState();
+    }
+    CHECK(test::maxAbsDiff(blockL, frameL) < TOLERANCE);
+    CHECK(test::maxAbsDiff(blockR, frameR) < TOLERANCE);
+}
+
+// FEEDBACK's per-sample loop in 256-frame chunks against one-frame host
+// blocks, where every stage sees a single sample. Chaos is left off: its
+// lanes are rendered per chunk, so they legitimately differ
+std::vector<float> renderFeedback(size_t block, int poly, double feedback) {
+    AudioEngine engine(SAMPLE_RATE);
+    engine.seedRandom(4);
+    engine.setSynchronousSlicing(true);
+    const size_t total = 2 * 48000;
+    const std::vector<float> input = test::makeNoise(total, 5);
+    std::vector<float> left(total), right(total);
+
+    for (size_t frame = 0; frame < total; frame += block) {
+        if (frame == 0) engine.set_recording(true);
+        if (frame == 24576) {
+            engine.set_recording(false);
+            engine.set_poly(poly);
+            engine.set_mix(0.6);
+            engine.set_feedback(feedback);
+            engine.set_delay_time(0.013, 0.021);
+            engine.set_delay_feedback(0.4);
+            engine.set_delay_wet(0.3);
+        }
+        if (frame == 61440) engine.set_feedback(0.0);  // Ramps out mid-run
+        const size_t n = std::min(block, total - frame);
+        engine.processBlock(input.data() + frame, input.data() + frame, left.data() + frame,
+                            right.data() + frame, n);
+    }
+    left.insert(left.end(), right.begin(), right.end());
+    return left;
+}
+
+void testFeedbackChunks() {
+    for (int poly : {1, 4}) {
+        const std::vector<float> chunked = renderFeedback(256, poly, 0.7);
+        const std::vector<float> perSample = renderFeedback(1, poly, 0.7);
+        CHECK(test::maxAbsDiff(chunked, perSample) < TOLERANCE);
+        // ...and FEEDBACK is audible in both
+        CHECK(test::maxAbsDiff(chunked, renderFeedback(256, poly, 0.0)) > 0.1f);
+    }
+}
+
+void testDelayFixed() {
+    const KernelInput in;
+    auto fixed = std::make_unique<DelayProcessor>();
+    auto modulated = std::make_unique<DelayProcessor>();
+    const float delayL = 0.0123f * SAMPLE_RATE;  // Fractional sample positions
+    const float delayR = 0.2571f * SAMPLE_RATE;
+    const float feedback = 0.6f;
+    const std::vector<float> timesL(BLOCK, delayL), timesR(BLOCK, delayR);
+    const std::vector<float> feedbacks(BLOCK, feedback);
+
+    std::vector<float> fixedL(in.left.size()), fixedR(in.left.size());
+    std::vector<float> modL(in.left.size()), modR(in.left.size());
+    for (int b = 0; b < BLOCKS; b++) {
+        const int offset = b * BLOCK;
+        fixed->processFixed(in.left.data() + offset, in.right.data() + offset,
+                            fixedL.data() + offset, fixedR.data() + offset, BLOCK,
+                            delayL, delayR, feedback);
+        modulated->process(in.left.data() + offset, in.right.data() + offset,
+                           modL.data() + offset, modR.data() + offset, BLOCK,
+                           timesL.data(), timesR.data(), feedbacks.data());
+    }
+    CHECK(peak(fixedR) > 0.1f);
+    CHECK(test::maxAbsDiff(fixedL, modL) < TOLERANCE);
+    CHECK(test::maxAbsDiff(fixedR, modR) < TOLERANCE);
+}
+
+}  // namespace
+
+int main() {
+    testCpuLevels();
+    testDelayFixed();
+    testEqFrame();
+    testFeedbackChunks();
+    return test::finish("test_kernels");
+}
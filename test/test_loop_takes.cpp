@@ -0,0 +1,98 @@
+/*
+ * Takes recorded while the slice scanner is busy
+ *
+ * - A take started while a superseded scan still reads the buffer the take
+ *   goes to waits in the backlog until the scan lets go, then comes out
+ *   whole: the loop's slice table matches the samples that were recorded
+ *
+ * Run under -fsanitize=thread as well: the take overwriting a buffer the
+ * scanner still reads shows up there as a data race.
+ */
+
+#include "alien4_extension.cpp"
+
+#include "test_common.hpp"
+
+namespace {
+
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr size_t BLOCK = 256;
+
+void process(AudioEngine& engine, const float* in, size_t n) {
+    static std::vector<float> outL(BLOCK), outR(BLOCK);
+    engine.processBlock(in, in, outL.data(), outR.data(), n);
+}
+
+void record(AudioEngine& engine, const std::vector<float>& take) {
+    engine.set_recording(true);
+    for (size_t frame = 0; frame < take.size(); frame += BLOCK) {
+        process(engine, take.data() + frame, std::min(BLOCK, take.size() - frame));
+    }
+    engine.set_recording(false);
+}
+
+// The slices tile the loop and each peak is that of the recorded samples
+void checkSlices(const AudioEngine& engine, const std::vector<float>& take) {
+    const std::vector<Slice>& slices = engine.getSliceTable();
+    CHECK(engine.get_recorded_length() == static_cast<int>(take.size()));
+    CHECK(!slices.empty());
+
+    size_t covered = 0;
+    float worst = 0.0f;
+    for (const Slice& slice : slices) {
+        CHECK(slice.startSample >= 0 && slice.startSample <= slice.endSample);
+        CHECK(slice.endSample < static_cast<int>(take.size()));
+        if (slice.startSample < 0 || slice.endSample >= static_cast<int>(take.size())) return;
+        float peak = 0.0f;
+        for (int i = slice.startSample; i <= slice.endSample; i++) peak = std::max(peak, std::abs(take[i]));
+        worst = std::max(worst, std::abs(slice.peakAmplitude - peak));
+        covered += static_cast<size_t>(slice.endSample - slice.startSample + 1);
+    }
+    CHECK(covered == take.size());
+    CHECK(worst == 0.0f);
+}
+
+void testTakeDuringScan() {
+    AudioEngine engine(SAMPLE_RATE, 10.0);
+    engine.setSynchronousSlicing(true);
+    const std::vector<float> silence(BLOCK, 0.0f);
+    const std::vector<float> blip = test::makeNoise(BLOCK, 1);
+    std::vector<float> take = test::makeNoise(8 * 48000, 2);
+    record(engine, take);
+    process(engine, silence.data(), BLOCK);
+
+    for (int round = 0; round < 50; round++) {
+        engine.setSynchronousSlicing(false);
+
+        // 1 or 5 ms slices: hundreds to thousands of them, so the scan of
+        // the loop may still be running when the takes below start
+        engine.set_gate_threshold(round % 2 == 0 ? 0.0 : 0.2);
+        process(engine, silence.data(), BLOCK);
+
+        // A one-block take supersedes that scan and swaps the loop's buffer
+        // out to be the next take's, maybe before the scan has bailed out
+        record(engine, blip);
+        process(engine, silence.data(), BLOCK);
+
+        take = test::makeNoise(24000 + 97 * round, 10 + round);
+        record(engine, take);
+        engine.setSynchronousSlicing(true);
+
+        // Blocks here come much faster than real time, so the take may still
+        // wait for its buffer once it has stopped
+        process(engine, silence.data(), BLOCK);
+        for (int wait = 0; wait < 10000 && engine.get_recorded_length() != static_cast<int>(take.size());
+             wait++) {
+            std::this_thread::yield();
+            process(engine, silence.data(), BLOCK);
+        }
+        checkSlices(engine, take);
+    }
+}
+
+}  // namespace
+
+int main() {
+    testTakeDuringScan();
+    return test::finish("test_loop_takes");
+}
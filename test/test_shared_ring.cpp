@@ -0,0 +1,267 @@
+/*
+ * SharedRing producer/consumer
+ *
+ * - Capacity rounds up to a power of two, names are exclusive, and an
+ *   unlinked name can no longer be attached
+ * - Records survive the wrap-around intact; pushes into a full ring are
+ *   dropped and counted, never overwrite waiting records
+ * - A producer thread and a consumer thread (then a producer process)
+ *   stream sequence-numbered records: they arrive in order and untorn, and
+ *   received + dropped == pushed
+ * - CallbackChain pushes one CV record per interval, one per block at 0,
+ *   and none once detached
+ */
+
+#include "alien4_extension.cpp"
+
+#include "test_common.hpp"
+
+#include <atomic>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#endif
+
+namespace {
+
+constexpr int RECORD = 6;
+
+std::string ringName(const char* tag) {
+#if !defined(_WIN32)
+    return std::string("/alien4_test_") + tag + "_" + std::to_string(::getpid());
+#else
+    return std::string("alien4_test_") + tag;
+#endif
+}
+
+// Record k holds k * RECORD + j in field j, so a torn copy shows up
+void fillRecords(std::vector<float>& records, uint64_t first, size_t count) {
+    records.resize(count * RECORD);
+    for (size_t k = 0; k < count; k++) {
+        for (int j = 0; j < RECORD; j++) {
+            records[k * RECORD + j] = static_cast<float>((first + k) * RECORD + j);
+        }
+    }
+}
+
+bool isRecord(const float* record, uint64_t index) {
+    for (int j = 0; j < RECORD; j++) {
+        if (record[j] != static_cast<float>(index * RECORD + j)) return false;
+    }
+    return true;
+}
+
+void testCreateAttach() {
+    const std::string name = ringName("basics");
+    std::shared_ptr<SharedRing> owner = SharedRing::create(name, RECORD, 5);
+    CHECK(owner->get_capacity() == 8);
+    CHECK(owner->get_record_size() == RECORD);
+    CHECK(owner->is_owner());
+
+    bool duplicate = false;
+    try {
+        SharedRing::create(name, RECORD, 8);
+    } catch (const std::runtime_error&) {
+        duplicate = true;
+    }
+    CHECK(duplicate);
+
+    std::shared_ptr<SharedRing> client = SharedRing::attach(name);
+    CHECK(!client->is_owner());
+    CHECK(client->get_capacity() == 8);
+    CHECK(client->get_record_size() == RECORD);
+
+    // Unlinking removes the name, the attached mapping stays usable
+    owner->unlink();
+    bool missing = false;
+    try {
+        SharedRing::attach(name);
+    } catch (const std::runtime_error&) {
+        missing = true;
+    }
+    CHECK(missing);
+
+    std::vector<float> records;
+    fillRecords(records, 0, 1);
+    CHECK(owner->pushRecords(records.data(), 1) == 1);
+    float record[RECORD];
+    CHECK(client->popRecords(record, 1) == 1);
+    CHECK(isRecord(record, 0));
+}
+
+void testWrapAndDrops() {
+    std::shared_ptr<SharedRing> ring = SharedRing::create(ringName("wrap"), RECORD, 8);
+    std::vector<float> records, popped(8 * RECORD);
+
+    // Five at a time through eight slots, so every other batch wraps
+    uint64_t next = 0;
+    for (int round = 0; round < 10; round++) {
+        fillRecords(records, next, 5);
+        CHECK(ring->pushRecords(records.data(), 5) == 5);
+        CHECK(ring->available() == 5);
+        CHECK(ring->popRecords(popped.data(), 8) == 5);
+        for (size_t k = 0; k < 5; k++) CHECK(isRecord(popped.data() + k * RECORD, next + k));
+        next += 5;
+    }
+    CHECK(ring->available() == 0);
+    CHECK(ring->get_dropped() == 0);
+
+    // A full ring keeps the oldest records and counts the rest
+    fillRecords(records, next, 20);
+    CHECK(ring->pushRecords(records.data(), 20) == 8);
+    CHECK(ring->get_dropped() == 12);
+    CHECK(ring->pushRecords(records.data(), 1) == 0);
+    CHECK(ring->get_dropped() == 13);
+    CHECK(ring->popRecords(popped.data(), 3) == 3);
+    CHECK(ring->available() == 5);
+    CHECK(ring->popRecords(popped.data(), 8) == 5);
+    for (size_t k = 0; k < 5; k++) CHECK(isRecord(popped.data() + k * RECORD, next + 3 + k));
+}
+
+// Drain until the producer is done and the ring is empty; returns records
+// received, counts the ones out of order or torn
+uint64_t consume(SharedRing& ring, const std::atomic<bool>& done, uint64_t& bad) {
+    std::vector<float> popped(64 * RECORD);
+    uint64_t received = 0;
+    uint64_t lastIndex = 0;
+    for (;;) {
+        const bool finished = done.load(std::memory_order_acquire);
+        const size_t n = ring.popRecords(popped.data(), 64);
+        for (size_t k = 0; k < n; k++) {
+            const float* record = popped.data() + k * RECORD;
+            const uint64_t index = static_cast<uint64_t>(record[0]) / RECORD;
+            if (!isRecord(record, index) || (received + k > 0 && index <= lastIndex)) bad++;
+            lastIndex = index;
+        }
+        received += n;
+        if (n == 0 && finished) return received;
+        if (n == 0) std::this_thread::yield();
+    }
+}
+
+// Small bursts into a small ring, so both the drop path and the wrap are hit
+constexpr uint64_t STREAM_RECORDS = 200000;
+
+void produce(SharedRing& ring) {
+    std::vector<float> records;
+    for (uint64_t next = 0; next < STREAM_RECORDS;) {
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(1 + next % 7, STREAM_RECORDS - next));
+        fillRecords(records, next, count);
+        ring.pushRecords(records.data(), count);
+        next += count;
+    }
+}
+
+void testThreads() {
+    std::shared_ptr<SharedRing> ring = SharedRing::create(ringName("threads"), RECORD, 32);
+    std::atomic<bool> done{false};
+    std::thread producer([&] {
+        produce(*ring);
+        done.store(true, std::memory_order_release);
+    });
+    uint64_t bad = 0;
+    const uint64_t received = consume(*ring, done, bad);
+    producer.join();
+
+    CHECK(bad == 0);
+    CHECK(received > 0);
+    CHECK(received + ring->get_dropped() == STREAM_RECORDS);
+}
+
+#if !defined(_WIN32)
+// The same stream from a forked process that attaches by name
+void testProcesses() {
+    const std::string name = ringName("fork");
+    std::shared_ptr<SharedRing> ring = SharedRing::create(name, RECORD, 32);
+
+    const pid_t child = ::fork();
+    if (child == 0) {
+        int status = 1;
+        try {
+            std::shared_ptr<SharedRing> producer = SharedRing::attach(name);
+            produce(*producer);
+            status = 0;
+        } catch (const std::exception&) {
+        }
+        ::_exit(status);
+    }
+    CHECK(child > 0);
+    if (child < 0) return;
+
+    // The child's exit stands in for the done flag
+    std::atomic<bool> done{false};
+    std::thread watcher([&] {
+        int status = 1;
+        ::waitpid(child, &status, 0);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        done.store(true, std::memory_order_release);
+    });
+    uint64_t bad = 0;
+    const uint64_t received = consume(*ring, done, bad);
+    watcher.join();
+
+    CHECK(bad == 0);
+    CHECK(received > 0);
+    CHECK(received + ring->get_dropped() == STREAM_RECORDS);
+}
+#endif
+
+void testCallbackChain() {
+    std::shared_ptr<SharedRing> ring = SharedRing::create(ringName("chain"), RECORD, 64);
+    AudioEngine engine(48000.0f);
+    CallbackChain chain(engine);
+    const size_t frames = 256;
+    std::vector<float> in(frames * 4, 0.1f), out(frames * CallbackChain::CV_MIN_CHANNELS);
+    const CallbackChain::FrameBuffer input{in.data(), frames, 4, 4, 1};
+    const CallbackChain::FrameBuffer output{out.data(), frames, CallbackChain::CV_MIN_CHANNELS,
+                                            CallbackChain::CV_MIN_CHANNELS, 1};
+    std::vector<float> popped(64 * RECORD);
+
+    // Every 48 frames, the phase carried across blocks: 0, 48, ..., 480
+    chain.set_cv_ring(ring, 48);
+    chain.trigger_envelope(0);
+    chain.processFrames(input, output, 0.25f, 0.75f);
+    chain.processFrames(input, output, 0.25f, 0.75f);
+    CHECK(ring->available() == 11);
+    CHECK(ring->popRecords(popped.data(), 64) == 11);
+    float envelopePeak = 0.0f;
+    for (int k = 0; k < 11; k++) {
+        envelopePeak = std::max(envelopePeak, popped[k * RECORD]);
+        CHECK(popped[k * RECORD + ChainParams::NUM_ENVELOPES] == 0.25f);
+        CHECK(popped[k * RECORD + ChainParams::NUM_ENVELOPES + 1] == 0.75f);
+    }
+    CHECK(envelopePeak > 0.0f);
+
+    // One record per block, carrying the block's last values
+    chain.set_cv_ring(ring, 0);
+    chain.processFrames(input, output, 0.5f, 0.125f);
+    CHECK(ring->popRecords(popped.data(), 64) == 1);
+    CHECK(popped[ChainParams::NUM_ENVELOPES] == 0.5f);
+    CHECK(popped[ChainParams::NUM_ENVELOPES + 1] == 0.125f);
+
+    chain.set_cv_ring(nullptr, 0);
+    chain.processFrames(input, output, 0.5f, 0.5f);
+    CHECK(ring->available() == 0);
+
+    bool wrongSize = false;
+    try {
+        chain.set_cv_ring(SharedRing::create(ringName("narrow"), 2, 8), 0);
+    } catch (const std::runtime_error&) {
+        wrongSize = true;
+    }
+    CHECK(wrongSize);
+}
+
+}  // namespace
+
+int main() {
+    testCreateAttach();
+    testWrapAndDrops();
+    testThreads();
+#if !defined(_WIN32)
+    testProcesses();
+#endif
+    testCallbackChain();
+    return test::finish("test_shared_ring");
+}
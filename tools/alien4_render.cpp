@@ -0,0 +1,161 @@
+/*
+ * alien4_render - Headless offline renderer for the Alien4 engine
+ *
+ * Streams WAV files through AudioEngine faster than realtime, optionally
+ * driven by a parameter automation file, rendering several jobs in parallel.
+ * Renders are deterministic (fixed seed), so outputs can be diffed between
+ * builds for sound-regression runs.
+ *
+ * Build:  cmake -S . -B build -DALIEN4_BUILD_RENDER=ON && cmake --build build --target alien4_render
+ * Run:    ./build/alien4_render -a patch.txt -t 5 set.wav set_out.wav
+ *         ./build/alien4_render -j 8 --jobs nightly.txt
+ */
+
+// The engine and the renderer live in the extension translation unit;
+// PYBIND11_MODULE there is never called, it only needs libpython at link time
+#include "alien4_extension.cpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+int printHelp() {
+    std::printf(
+        "alien4_render - render WAV files through the Alien4 engine offline\n"
+        "\n"
+        "Usage:\n"
+        "  alien4_render [options] input.wav output.wav [input2.wav output2.wav ...]\n"
+        "  alien4_render [options] --jobs jobs.txt\n"
+        "\n"
+        "Options:\n"
+        "  -a, --automation FILE   Parameter automation applied to every job\n"
+        "  -j, --threads N         Jobs rendered in parallel (default: all cores)\n"
+        "  -t, --tail SECONDS      Silence rendered after each input ends (default: 0)\n"
+        "  -b, --block FRAMES      Frames per engine call (default: 4096)\n"
+        "  -f, --format FORMAT     Output samples: float32 (default) or int16\n"
+        "      --loop-seconds S    Maximum loop length (default: 60)\n"
+        "      --loop-format FMT   Loop memory: float32 (default) or int16\n"
+        "      --seed N            Random seed (default: 1)\n"
+        "      --jobs FILE         One job per line: input.wav output.wav [automation.txt]\n"
+        "\n"
+        "Automation files hold one '<seconds> <parameter> <values>' per line, where\n"
+        "parameter is an AudioEngine setter without set_, e.g.:\n"
+        "  0.0  recording   1\n"
+        "  4.0  recording   0\n"
+        "  4.0  delay_time  0.25 0.3\n"
+        "\n"
+        "The engine takes its input from the left channel, like process_into().\n");
+    return 2;
+}
+
+// Jobs file: whitespace separated, blank lines and # comments ignored
+bool readJobs(const std::string& path, std::vector<RenderJob>& jobs) {
+    std::FILE* file = std::fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        std::fprintf(stderr, "Cannot open jobs file %s\n", path.c_str());
+        return false;
+    }
+    char buffer[4096];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && std::fgets(buffer, sizeof(buffer), file) != nullptr) {
+        lineNumber++;
+        std::string line(buffer);
+        std::istringstream fields(line.substr(0, line.find('#')));
+        RenderJob job;
+        if (!(fields >> job.input)) continue;
+        std::string extra;
+        if (!(fields >> job.output) || (fields >> job.automation && fields >> extra)) {
+            std::fprintf(stderr, "%s:%d: expected 'input.wav output.wav [automation.txt]'\n",
+                         path.c_str(), lineNumber);
+            ok = false;
+        }
+        jobs.push_back(job);
+    }
+    std::fclose(file);
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    RenderOptions options;
+    std::string automation;
+    std::string jobsFile;
+    int numThreads = -1;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "%s needs a value\n", name);
+                std::exit(printHelp());
+            }
+            return argv[++i];
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            printHelp();
+            return 0;
+        } else if (arg == "-a" || arg == "--automation") {
+            automation = value("--automation");
+        } else if (arg == "-j" || arg == "--threads") {
+            numThreads = std::atoi(value("--threads"));
+        } else if (arg == "-t" || arg == "--tail") {
+            options.tailSeconds = std::atof(value("--tail"));
+        } else if (arg == "-b" || arg == "--block") {
+            options.blockSize = std::atoi(value("--block"));
+        } else if (arg == "-f" || arg == "--format") {
+            const std::string format = value("--format");
+            if (format != "float32" && format != "int16") return printHelp();
+            options.int16Output = format == "int16";
+        } else if (arg == "--loop-seconds") {
+            options.maxLoopSeconds = std::atof(value("--loop-seconds"));
+        } else if (arg == "--loop-format") {
+            const std::string format = value("--loop-format");
+            if (format != "float32" && format != "int16") return printHelp();
+            options.loopFormat = parseLoopFormat(format);
+        } else if (arg == "--seed") {
+            options.seed = static_cast<uint32_t>(std::strtoul(value("--seed"), nullptr, 10));
+        } else if (arg == "--jobs") {
+            jobsFile = value("--jobs");
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::fprintf(stderr, "Unknown option %s\n\n", arg.c_str());
+            return printHelp();
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    std::vector<RenderJob> jobs;
+    if (!jobsFile.empty() && !readJobs(jobsFile, jobs)) return 2;
+    if (positional.size() % 2 != 0) return printHelp();
+    for (size_t i = 0; i < positional.size(); i += 2) {
+        jobs.push_back(RenderJob{positional[i], positional[i + 1], std::string()});
+    }
+    if (jobs.empty()) return printHelp();
+    for (RenderJob& job : jobs) {
+        if (job.automation.empty()) job.automation = automation;
+    }
+
+    std::vector<RenderResult> results = renderOfflineBatch(jobs, options, numThreads);
+
+    int failed = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const RenderResult& r = results[i];
+        if (!r.error.empty()) {
+            std::fprintf(stderr, "FAILED %s\n", r.error.c_str());
+            failed++;
+            continue;
+        }
+        const double seconds = r.frames / r.sampleRate;
+        std::printf("%s -> %s: %.1f s of audio in %.2f s (%.1fx realtime)\n",
+                    jobs[i].input.c_str(), jobs[i].output.c_str(), seconds, r.wallSeconds,
+                    r.wallSeconds > 0.0 ? seconds / r.wallSeconds : 0.0);
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -19,13 +19,18 @@ class Alien4EffectChain:
     提供與 EllenRipley 相容的介面
     """
 
-    def __init__(self, sample_rate=48000):
+    def __init__(self, sample_rate=48000, max_loop_seconds=60.0, loop_format="float32"):
         self.sample_rate = sample_rate
 
         if ALIEN4_AVAILABLE:
-            self.engine = alien4.AudioEngine(float(sample_rate))
+            # loop 記憶體隨錄音逐步配置; loop_format="int16" 可省一半 (超過 ±1.0 會削波)
+            self.engine = alien4.AudioEngine(float(sample_rate), float(max_loop_seconds),
+                                             loop_format)
+            # mixer → engine → CV 輸出, 給 process_callback() 用
+            self.chain = alien4.CallbackChain(self.engine)
         else:
             self.engine = None
+            self.chain = None
 
         # 預設參數
         self.recording = True
@@ -114,6 +119,35 @@ class Alien4EffectChain:
         if shape is not None:
             self.engine.set_chaos_shape(bool(shape))
 
+    def set_control_interval(self, samples):
+        """Chaos 與 modulation 每幾個 sample 計算一次 (1-256, 預設 32), 中間線性內插"""
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            return
+        self.engine.set_control_interval(int(samples))
+
+    def set_mod_route(self, source, target, depth):
+        """
+        設定 modulation 路由: target += depth * source (depth 0 = 移除)
+        source: "chaos", "cv1"-"cv6" (process_callback 時為 ENV1-4, SEQ1-2, 即 vision CV)
+        target: "delay_time" (秒), "delay_feedback", "grain_density", "grain_position",
+                "reverb_room", "reverb_decay"
+        """
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            return
+        self.engine.set_mod_route(str(source), str(target), float(depth))
+
+    def clear_mod_routes(self):
+        """清除所有 modulation 路由"""
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            return
+        self.engine.clear_mod_routes()
+
+    def set_mod_cv(self, index, value):
+        """設定 modulation source cv1-6 (index 0-5); 使用 process_callback 時會被 ENV/SEQ 覆寫"""
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            return
+        self.engine.set_mod_cv(int(index), float(value))
+
     def set_documenta_params(self, mix=None, feedback=None, speed=None,
                             eq_low=None, eq_mid=None, eq_high=None, poly=None):
         """設定 Documenta 參數 (新增)"""
@@ -166,6 +200,36 @@ class Alien4EffectChain:
             "recorded_length": self.engine.get_recorded_length(),
         }
 
+    def get_waveform_overview(self, width):
+        """
+        取得 loop 波形概覽 (GUI 繪圖用, 不複製音訊, 不會卡住 audio thread)
+        Returns: {"length", "min", "max" (每個 column 的 min/max), "slices" ((n, 2) start/end sample),
+                  "current_slice", "voices" (playhead sample),
+                  "recording", "take_length", "take_min", "take_max" (錄音中的 take)};
+                 模組不存在時回傳 None
+        """
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            return None
+        return self.engine.get_waveform_overview(int(width))
+
+    def drain_events(self):
+        """取出引擎事件 (debug 用, 在 GUI thread 呼叫)"""
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            return []
+        return self.engine.drain_events()
+
+    def get_stats(self):
+        """取得各 stage 耗時、呼叫耗時分佈與 deadline miss 次數 (GUI 繪圖用)"""
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            return {"enabled": False}
+        return self.engine.get_stats()
+
+    def reset_stats(self):
+        """重設 get_stats() 的計數"""
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            return
+        self.engine.reset_stats()
+
     def set_scan(self, value):
         """設定 Slice Scan (0.0-1.0)"""
         if not ALIEN4_AVAILABLE or self.engine is None:
@@ -204,8 +268,184 @@ class Alien4EffectChain:
         chaos_cv = np.zeros_like(left_out)
         return left_out, right_out, chaos_cv
 
+    def process_into(self, left_in, right_in, left_out, right_out):
+        """
+        處理音訊到預先配置的 buffer (不配置記憶體, 處理期間釋放 GIL)
+        left_out / right_out 可以是 interleaved buffer 的 view, 例如 outdata[:, 0]
+        """
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            # Fallback: passthrough
+            left_out[:] = left_in
+            right_out[:] = right_in
+            return
+
+        # float32 輸入不會複製
+        left_in = np.asarray(left_in, dtype=np.float32)
+        right_in = np.asarray(right_in, dtype=np.float32)
+
+        self.engine.process_into(left_in, right_in, left_out, right_out)
+
+    def set_channel_level(self, channel, level):
+        """設定 input channel level (channel 0-3)"""
+        if not ALIEN4_AVAILABLE or self.chain is None:
+            return
+        if 0 <= channel < 4:
+            self.chain.set_channel_level(int(channel), float(level))
+
+    def set_envelope_decay(self, env_idx, decay_time):
+        """設定 ENV1-4 的 decay time (env_idx 0-3, 0.01-10 秒)"""
+        if not ALIEN4_AVAILABLE or self.chain is None:
+            return
+        if 0 <= env_idx < 4:
+            self.chain.set_envelope_decay(int(env_idx), float(decay_time))
+
+    def trigger_envelope(self, env_idx):
+        """觸發 ENV1-4 (下一個 block 生效)"""
+        if not ALIEN4_AVAILABLE or self.chain is None:
+            return
+        if 0 <= env_idx < 4:
+            self.chain.trigger_envelope(int(env_idx))
+
+    def process_callback(self, indata, outdata, seq1=0.0, seq2=0.0, cv_values=None):
+        """
+        一次 C++ 呼叫處理整個 audio callback: mixer → Alien4 → CV 輸出 (不配置記憶體, 處理期間釋放 GIL)
+        indata: (frames, inputs) float32, input 0-3 進 mixer channel 0-3
+        outdata: (frames, outputs) float32, 整個覆寫: 0/1 為 L/R,
+                 outputs >= 8 時 2-5 為 ENV1-4, 6-7 為 SEQ1-2 (0-1 對應 0-10V)
+        cv_values: None 或長度 6 的 float32 array, 接收這個 block 最後的 ENV1-4/SEQ1-2 值
+        SEQ1 同時控制 Scan 與 Gate Threshold (slice 長度)
+        """
+        if not ALIEN4_AVAILABLE or self.chain is None:
+            # Fallback: 輸入 mono mix 直通, 沒有 CV
+            outdata.fill(0)
+            mono = indata[:, :4].sum(axis=1)
+            outdata[:, 0] = mono
+            outdata[:, 1] = mono
+            return
+
+        indata = np.asarray(indata, dtype=np.float32)
+        self.chain.process_into(indata, outdata, float(seq1), float(seq2), cv_values)
+
+    def set_cv_ring(self, ring, interval_frames=0):
+        """
+        每個 block 把 ENV1-4/SEQ1-2 寫進 SharedRing (6 floats/record, 不 pickle、不上鎖)
+        ring: create_shared_ring() / attach_shared_ring() 的結果, None 取消
+        interval_frames: 0 = 每個 block 一筆, N = 每 N 個 frame 取樣一筆 (給 scope 用)
+        """
+        if not ALIEN4_AVAILABLE or self.chain is None:
+            return
+        self.chain.set_cv_ring(ring, int(interval_frames))
+
     def clear(self):
         """清除 buffer"""
         if not ALIEN4_AVAILABLE or self.engine is None:
             return
         self.engine.clear()
+
+    def save_loop(self, path):
+        """儲存 loop、slice 表與播放位置 (沒有錄音時丟出 RuntimeError)"""
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            return
+        self.engine.save_loop(str(path))
+
+    def load_loop(self, path):
+        """載入 save_loop() 存的檔案 (memory-map, 下一個 block 就能播放)"""
+        if not ALIEN4_AVAILABLE or self.engine is None:
+            return
+        self.engine.load_loop(str(path))
+
+
+class Alien4EngineGroup:
+    """
+    多軌 Alien4 效果鏈 (每軌一個獨立 engine, 在 worker threads 上平行處理)
+    音訊格式: (num_tracks, 2, frames) float32
+    """
+
+    def __init__(self, num_tracks, sample_rate=48000, num_threads=-1,
+                 max_loop_seconds=60.0, loop_format="float32"):
+        self.num_tracks = num_tracks
+        self.sample_rate = sample_rate
+
+        if ALIEN4_AVAILABLE:
+            self.group = alien4.EngineGroup(int(num_tracks), float(sample_rate),
+                                            int(num_threads), True,
+                                            float(max_loop_seconds), loop_format)
+        else:
+            self.group = None
+
+    def engine(self, index):
+        """取得單軌 engine (用於設定參數), 模組不可用時回傳 None"""
+        if not ALIEN4_AVAILABLE or self.group is None:
+            return None
+        return self.group.engine(index)
+
+    def process_into(self, tracks_in, tracks_out):
+        """處理所有軌道到預先配置的 (N, 2, frames) buffer"""
+        if not ALIEN4_AVAILABLE or self.group is None:
+            # Fallback: passthrough
+            tracks_out[:] = tracks_in
+            return
+
+        tracks_in = np.asarray(tracks_in, dtype=np.float32)
+        self.group.process_into(tracks_in, tracks_out)
+
+
+def render_offline(inputs, outputs, automations=None, tail_seconds=0.0, block_size=4096,
+                   num_threads=-1, output_format="float32"):
+    """
+    離線渲染 WAV (不需音訊裝置, 比即時快, 多個檔案平行處理)
+    inputs / outputs: 檔案路徑 list (同一個 input 可搭配不同 automation 重複出現)
+    automations: None, 單一 automation 檔 (全部共用), 或每個 input 一個
+    automation 檔每行: <秒> <參數> <值> [值], 參數為 set_ 之後的名稱 (例如 "4.0 delay_time 0.25 0.3")
+    Returns: 每個 job 一個 dict (frames, seconds, wall_seconds, realtime)
+    """
+    if not ALIEN4_AVAILABLE:
+        raise RuntimeError("Alien4 module not available")
+    if automations is None:
+        automations = []
+    elif isinstance(automations, str):
+        automations = [automations]
+    return alien4.render_offline([str(p) for p in inputs], [str(p) for p in outputs],
+                                 [str(p) for p in automations], float(tail_seconds),
+                                 int(block_size), int(num_threads), output_format)
+
+
+def create_shared_ring(name, record_size, capacity=4096):
+    """
+    建立 shared memory SPSC ring ("/name", 每筆 record_size 個 float32)
+    只能一個 process 寫 (push)、一個 process 讀 (read); 物件消失時移除名稱
+    Returns: alien4.SharedRing, 模組不存在或建立失敗時回傳 None (呼叫端改用 Queue)
+    """
+    if not ALIEN4_AVAILABLE:
+        return None
+    try:
+        return alien4.SharedRing.create(name, int(record_size), int(capacity))
+    except RuntimeError as e:
+        print(f"[WARNING] Shared ring unavailable: {e}")
+        return None
+
+
+def attach_shared_ring(name):
+    """
+    連接另一個 process 建立的 ring
+    read() 回傳直接指向 shared memory 的 (n, record_size) read-only view, 下次 read() 前有效
+    Returns: alien4.SharedRing 或 None
+    """
+    if not ALIEN4_AVAILABLE or not name:
+        return None
+    try:
+        return alien4.SharedRing.attach(name)
+    except RuntimeError as e:
+        print(f"[WARNING] Cannot attach shared ring {name}: {e}")
+        return None
+
+
+def get_cpu_dispatch():
+    """
+    查詢 import 時選到的 DSP kernel 等級
+    Returns: {"selected": "avx2", "supported": [...]}, 模組不存在時回傳 None
+    (環境變數 ALIEN4_CPU=sse4.2 等可在 import 前限制等級)
+    """
+    if not ALIEN4_AVAILABLE:
+        return None
+    return alien4.get_cpu_dispatch()
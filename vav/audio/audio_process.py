@@ -8,6 +8,7 @@ import multiprocessing as mp
 from typing import Optional
 import time
 import sys
+import os
 
 # 設定 multiprocessing 為 spawn 模式避免 macOS fork 問題
 if sys.platform == 'darwin':
@@ -17,10 +18,43 @@ if sys.platform == 'darwin':
         pass  # 已經設定過了
 
 from .io import AudioIO
-from .mixer import StereoMixer
 # from .effects.ellen_ripley import EllenRipleyEffectChain
-from .alien4_wrapper import Alien4EffectChain
-from ..cv_generator.envelope import DecayEnvelope
+from .alien4_wrapper import Alien4EffectChain, create_shared_ring, attach_shared_ring
+
+# Shared memory ring layout (float32 per record)
+CV_RING_RECORD = 6       # ENV1-4, SEQ1-2 (audio process → GUI)
+CONTROL_RING_RECORD = 7  # seq1, seq2, scan_loop_completed, env1-4 trigger (main → audio process)
+
+# Alien4 loop 波形概覽 (audio process → GUI, ~30 Hz)
+# header: length, take_length, recording, current slice start/end, voice 數, 8 個 playhead
+# 之後: min, max, take_min, take_max, slice 起點標記 (各 WAVEFORM_WIDTH 個 column)
+WAVEFORM_WIDTH = 256
+WAVEFORM_MAX_VOICES = 8
+WAVEFORM_HEADER = 6 + WAVEFORM_MAX_VOICES
+WAVEFORM_RING_RECORD = WAVEFORM_HEADER + 5 * WAVEFORM_WIDTH
+WAVEFORM_POLL_INTERVAL = 1.0 / 30.0
+
+
+def _pack_waveform(overview: dict, record: np.ndarray):
+    """把 get_waveform_overview() 的結果寫進一筆 waveform ring record"""
+    record[:] = 0.0
+    length = int(overview["length"])
+    slices = overview["slices"]
+    current = int(overview["current_slice"])
+    voices = overview["voices"][:WAVEFORM_MAX_VOICES]
+    record[0] = length
+    record[1] = overview["take_length"]
+    record[2] = overview["recording"]
+    record[3:5] = slices[current] if 0 <= current < len(slices) else -1
+    record[5] = len(voices)
+    record[6:6 + len(voices)] = voices
+    columns = record[WAVEFORM_HEADER:].reshape(5, WAVEFORM_WIDTH)
+    columns[0] = overview["min"]
+    columns[1] = overview["max"]
+    columns[2] = overview["take_min"]
+    columns[3] = overview["take_max"]
+    if length > 0 and len(slices):
+        columns[4][np.clip(slices[:, 0].astype(np.int64) * WAVEFORM_WIDTH // length, 0, WAVEFORM_WIDTH - 1)] = 1.0
 
 
 def audio_process_worker(
@@ -29,7 +63,8 @@ def audio_process_worker(
     control_queue: mp.Queue,
     config: dict,
     stop_event: mp.Event,
-    shared_audio_buffers: list
+    shared_audio_buffers: list,
+    ring_names: Optional[dict] = None
 ):
     """
     獨立 process 的 worker function
@@ -41,6 +76,8 @@ def audio_process_worker(
         config: 音訊設定
         stop_event: 停止信號
         shared_audio_buffers: shared memory buffers for display (4 channels)
+        ring_names: {'cv': ..., 'control': ..., 'waveform': ...} shared memory ring 名稱;
+                    連接成功時取代 cv_output_queue / cv_queue
     """
 
     # 初始化音訊系統
@@ -85,7 +122,7 @@ def audio_process_worker(
     audio_io.output_device = output_device
 
     # 初始化其他組件
-    mixer = StereoMixer(num_channels=4)
+    # mixer、ENV1-4 與 CV 輸出都在 alien4.process_callback() 內 (C++)
     # ellen_ripley = EllenRipleyEffectChain(sample_rate=sample_rate)
     alien4 = Alien4EffectChain(sample_rate=sample_rate)
 
@@ -93,30 +130,39 @@ def audio_process_worker(
     dummy_audio = np.zeros((256, 2), dtype=np.float32)
     _ = alien4.process(dummy_audio[:, 0], dummy_audio[:, 1])
 
+    # Chaos / modulation 的 control rate (每 N 個 sample 一次)
+    alien4.set_control_interval(audio_config.get("control_interval", 32))
+
     # CV generators (4 envelopes: ENV1-4)
-    envelopes = []
     cv_config = config.get("cv", {})
     for i in range(4):
-        env = DecayEnvelope(
-            sample_rate=sample_rate,
-            decay_time=cv_config.get(f"decay_{i}_time", 1.0),
-        )
-        envelopes.append(env)
+        alien4.set_envelope_decay(i, cv_config.get(f"decay_{i}_time", 1.0))
 
-    # CV values (6 channels: ENV1-4, SEQ1-2)
+    # CV values (6 channels: ENV1-4, SEQ1-2), 每個 callback 由 C++ 填入
     cv_values = np.zeros(6, dtype=np.float32)
 
+    # Shared memory rings: C++ audio path 直接寫 CV record, 不經 pickle / lock
+    ring_names = ring_names or {}
+    cv_ring = attach_shared_ring(ring_names.get('cv'))
+    control_ring = attach_shared_ring(ring_names.get('control'))
+    waveform_ring = attach_shared_ring(ring_names.get('waveform'))
+    if cv_ring is not None:
+        # 預設每 1 ms 一筆 (scope 解析度), 0 = 每個 block 一筆
+        cv_ring_rate = float(audio_config.get("cv_ring_rate", 1000.0))
+        interval = max(1, int(round(sample_rate / cv_ring_rate))) if cv_ring_rate > 0 else 0
+        alien4.set_cv_ring(cv_ring, interval)
+
+    # 輸出 buffer 重複使用 (AudioIO 會複製到 stream 的 outdata)
+    outdata = np.zeros((buffer_size, audio_io.output_channels), dtype=np.float32)
+
     # SEQ1/SEQ2 從 queue 接收
     seq1_value = 0.0
     seq2_value = 0.0
     scan_loop_completed = False  # 掃描循環完成標記
 
-    # Channel levels
-    channel_levels = [1.0, 1.0, 1.0, 1.0]
-
     def audio_callback(indata: np.ndarray, frames: int) -> np.ndarray:
         """Audio callback - 在獨立 process 中執行"""
-        nonlocal cv_values, seq1_value, seq2_value, scan_loop_completed
+        nonlocal outdata, seq1_value, seq2_value, scan_loop_completed
 
         # 處理控制訊息 (non-blocking)
         try:
@@ -127,14 +173,12 @@ def audio_process_worker(
                 if msg_type == 'set_envelope_decay':
                     env_idx = msg['env_idx']
                     decay_time = msg['decay_time']
-                    if 0 <= env_idx < len(envelopes):
-                        envelopes[env_idx].set_decay_time(decay_time)
+                    alien4.set_envelope_decay(env_idx, decay_time)
 
                 elif msg_type == 'set_channel_level':
                     channel = msg['channel']
                     level = msg['level']
-                    if 0 <= channel < len(channel_levels):
-                        channel_levels[channel] = level
+                    alien4.set_channel_level(channel, level)
 
                 elif msg_type == 'set_ellen_ripley_delay':
                     alien4.set_delay_params(
@@ -214,6 +258,12 @@ def audio_process_worker(
                         shape=msg.get('shape')
                     )
 
+                elif msg_type == 'set_alien4_mod_route':
+                    alien4.set_mod_route(msg['source'], msg['target'], msg['depth'])
+
+                elif msg_type == 'set_alien4_control_interval':
+                    alien4.set_control_interval(msg['samples'])
+
                 elif msg_type == 'set_alien4_grain':
                     alien4.set_grain_params(
                         size=msg.get('size'),
@@ -230,8 +280,20 @@ def audio_process_worker(
         env2_trigger = False
         env3_trigger = False
         env4_trigger = False
+        if control_ring is not None:
+            # 所有等待中的 record: SEQ 取最新, 觸發事件取 OR
+            for block in control_ring.read():
+                for record in block:
+                    seq1_value = float(record[0])
+                    seq2_value = float(record[1])
+                    scan_loop_completed = bool(record[2])
+                    env1_trigger |= bool(record[3])
+                    env2_trigger |= bool(record[4])
+                    env3_trigger |= bool(record[5])
+                    env4_trigger |= bool(record[6])
+            control_ring.release()
         try:
-            while not cv_queue.empty():
+            while control_ring is None and not cv_queue.empty():
                 data = cv_queue.get_nowait()
                 if len(data) == 7:
                     seq1_value, seq2_value, scan_loop_completed, env1_trigger, env2_trigger, env3_trigger, env4_trigger = data
@@ -247,84 +309,23 @@ def audio_process_worker(
 
         # Envelope 觸發處理 (完全信任 contour_scanner 的 retrigger 判斷)
         # contour_scanner 已經處理了 retrigger 保護，這裡直接執行觸發
-        # ENV1: 觸發事件
-        if env1_trigger:
-            envelopes[0].trigger()
-            # 立即更新 cv_values 讓 GUI 看到觸發
-            cv_values[0] = envelopes[0].process()
-
-        # ENV2: 觸發事件
-        if env2_trigger:
-            envelopes[1].trigger()
-            # 立即更新 cv_values 讓 GUI 看到觸發
-            cv_values[1] = envelopes[1].process()
-
-        # ENV3: 觸發事件
-        if env3_trigger:
-            envelopes[2].trigger()
-            # 立即更新 cv_values 讓 GUI 看到觸發
-            cv_values[2] = envelopes[2].process()
-
-        # ENV4: 觸發事件
-        if env4_trigger:
-            envelopes[3].trigger()
-            # 立即更新 cv_values 讓 GUI 看到觸發
-            cv_values[3] = envelopes[3].process()
-
-        # Build output array first
-        outdata = np.zeros((frames, audio_io.output_channels), dtype=np.float32)
-
-        # Process CV generators (sample-accurate)
-        for i in range(frames):
-            # Update envelopes (ENV1-4)
-            for j, env in enumerate(envelopes):
-                cv_values[j] = env.process()
-
-            # SEQ1/SEQ2 from queue (不會阻塞)
-            cv_values[4] = seq1_value
-            cv_values[5] = seq2_value
-
-            # Write CV outputs sample-accurately (channels 2-7: ENV1-4, SEQ1-2)
-            # ES-8 使用 -1 到 +1 的音訊範圍對應 -10V 到 +10V
-            # 所以 0-10V 需要映射到 0 到 +1
-            if audio_io.output_channels >= 8:
-                for ch in range(6):
-                    outdata[i, 2 + ch] = cv_values[ch]  # 0-1 範圍對應 0-10V
-
-        # 回傳最後的 CV 值給 GUI (non-blocking)
-        try:
-            cv_output_queue.put_nowait(cv_values.copy())
-        except:
-            pass
-
-        # Mix 4 input channels
-        mixed_mono = np.zeros(frames, dtype=np.float32)
-        for i in range(4):
-            if indata.shape[1] > i:
-                mixed_mono += indata[:, i] * channel_levels[i]
-
-        # Convert mono to stereo
-        mixed_left = mixed_mono
-        mixed_right = mixed_mono
-
-        # Process through mixer
-        track_inputs = [(mixed_left, mixed_right)]
-        for i in range(3):
-            track_inputs.append((np.zeros_like(mixed_left), np.zeros_like(mixed_right)))
+        for env_idx, triggered in enumerate((env1_trigger, env2_trigger, env3_trigger, env4_trigger)):
+            if triggered:
+                alien4.trigger_envelope(env_idx)
 
-        master_left, master_right = mixer.process(track_inputs)
+        if outdata.shape[0] != frames:
+            outdata = np.zeros((frames, audio_io.output_channels), dtype=np.float32)
 
-        # Seq1 controls Alien4 Scan and Len (slice length)
-        # Both use same 0.0-1.0 value from Seq1 CV
-        alien4.set_scan(seq1_value)
-        alien4.set_gate_threshold(seq1_value)  # Controls slice length via gateThresholdKnob
+        # 一次 C++ 呼叫: 4 軌 mixer → Alien4 (L/R) → ENV1-4/SEQ1-2 CV (channels 2-7)
+        # Seq1 同時控制 Alien4 Scan 與 Len (slice 長度)
+        alien4.process_callback(indata, outdata, seq1_value, seq2_value, cv_values)
 
-        # Process through Alien4 (returns 3 values: left, right, chaos_cv)
-        processed_left, processed_right, _ = alien4.process(master_left, master_right)
-
-        # Fill audio outputs (L/R) in outdata (CV已經在上面的loop中填充)
-        outdata[:, 0] = processed_left  # Audio L
-        outdata[:, 1] = processed_right  # Audio R
+        # 回傳最後的 CV 值給 GUI (non-blocking); 有 cv_ring 時 C++ 已寫入
+        if cv_ring is None:
+            try:
+                cv_output_queue.put_nowait(cv_values.copy())
+            except:
+                pass
 
         # Update display buffer (circular buffer with downsampling, matching Multiverse.cpp)
         # This prevents visual flickering by downsampling audio to display resolution
@@ -358,9 +359,18 @@ def audio_process_worker(
         audio_io.start(audio_callback)
         print("[Audio Process] Audio stream started")
 
-        # 等待停止信號
+        # 等待停止信號; 有 waveform ring 時順便把 loop 波形概覽送給 GUI
+        # (get_waveform_overview 只讀 audio thread 發佈的資料, 不會卡住 callback)
+        waveform_record = np.zeros(WAVEFORM_RING_RECORD, dtype=np.float32)
         while not stop_event.is_set():
-            time.sleep(0.1)
+            if waveform_ring is not None:
+                overview = alien4.get_waveform_overview(WAVEFORM_WIDTH)
+                if overview is not None:
+                    _pack_waveform(overview, waveform_record)
+                    waveform_ring.push(waveform_record)  # GUI 沒讀時 ring 滿了就丟棄
+                time.sleep(WAVEFORM_POLL_INTERVAL)
+            else:
+                time.sleep(0.1)
 
         # 停止 audio stream
         print("[Audio Process] Stopping audio stream...")
@@ -388,6 +398,11 @@ class AudioProcess:
         self.stop_event: Optional[mp.Event] = None
         self.running = False
 
+        # Shared memory rings (alien4.SharedRing), 不可用時退回 Queue
+        self.cv_ring = None
+        self.control_ring = None
+        self.waveform_ring = None
+
         # Shared memory for audio buffers (for Multiverse)
         # Use display width from camera config, default to 1920
         camera_config = config.get("camera", {})
@@ -408,10 +423,23 @@ class AudioProcess:
         self.control_queue = mp.Queue(maxsize=20)  # Control messages
         self.stop_event = mp.Event()
 
+        # CV ring: audio process 寫、GUI 讀; control ring: 反方向
+        pid = os.getpid()
+        self.cv_ring = create_shared_ring(f"/vav_cv_{pid}", CV_RING_RECORD, 8192)
+        self.control_ring = create_shared_ring(f"/vav_ctl_{pid}", CONTROL_RING_RECORD, 64)
+        self.waveform_ring = create_shared_ring(f"/vav_wave_{pid}", WAVEFORM_RING_RECORD, 4)
+        ring_names = {
+            'cv': self.cv_ring.name if self.cv_ring is not None else None,
+            'control': self.control_ring.name if self.control_ring is not None else None,
+            'waveform': self.waveform_ring.name if self.waveform_ring is not None else None,
+        }
+        self._control_record = np.zeros(CONTROL_RING_RECORD, dtype=np.float32)
+
         # 啟動 process
         self.process = mp.Process(
             target=audio_process_worker,
-            args=(self.cv_queue, self.cv_output_queue, self.control_queue, self.config, self.stop_event, self.shared_audio_buffers),
+            args=(self.cv_queue, self.cv_output_queue, self.control_queue, self.config, self.stop_event,
+                  self.shared_audio_buffers, ring_names),
             daemon=False  # 不是 daemon，確保正常關閉
         )
         self.process.start()
@@ -434,6 +462,10 @@ class AudioProcess:
                 self.process.kill()
                 self.process.join()
 
+        # 釋放 ring (移除 shared memory 名稱)
+        self.cv_ring = None
+        self.control_ring = None
+        self.waveform_ring = None
         self.running = False
         print("[AudioProcess] Stopped")
 
@@ -455,6 +487,13 @@ class AudioProcess:
         if not self.running:
             return
 
+        if self.control_ring is not None:
+            # Ring 滿時直接丟棄 (與 Queue full 相同), 不阻塞 vision thread
+            self._control_record[:] = (seq1, seq2, scan_loop_completed,
+                                       env1_trigger, env2_trigger, env3_trigger, env4_trigger)
+            self.control_ring.push(self._control_record)
+            return
+
         try:
             # Non-blocking put，避免阻塞 vision thread
             self.cv_queue.put_nowait((seq1, seq2, scan_loop_completed,
@@ -473,12 +512,62 @@ class AudioProcess:
         if not self.running:
             return None
 
+        if self.cv_ring is not None:
+            frames = self.cv_ring.read()
+            latest = frames[-1][-1].copy() if frames else None
+            self.cv_ring.release()
+            return latest
+
         try:
             # Non-blocking get
             return self.cv_output_queue.get_nowait()
         except:
             return None
 
+    def get_cv_frames(self) -> list:
+        """
+        從 CV ring 取得所有新的 CV record (zero copy, controller 給 CV meter 用)
+
+        Returns:
+            0-2 個 read-only (n, 6) view (ENV1-4, SEQ1-2), 依時間排序,
+            下次 get_cv_frames() / get_cv_values() 前有效; 沒有 ring 時為空 list
+        """
+        if not self.running or self.cv_ring is None:
+            return []
+        return self.cv_ring.read()
+
+    def get_alien4_waveform(self) -> Optional[dict]:
+        """
+        取得最新的 Alien4 loop 波形概覽 (for LoopWaveformWidget)
+
+        Returns:
+            {"length", "take_length", "recording", "current_slice" ((start, end) sample, 沒有時 -1),
+             "voices" (playhead sample), "min", "max", "take_min", "take_max", "slice_marks"
+             (各 WAVEFORM_WIDTH 個 column)}; 沒有新資料時回傳 None
+        """
+        if not self.running or self.waveform_ring is None:
+            return None
+        frames = self.waveform_ring.read()
+        record = frames[-1][-1].copy() if frames else None
+        self.waveform_ring.release()
+        if record is None:
+            return None
+
+        voices = int(record[5])
+        columns = record[WAVEFORM_HEADER:].reshape(5, WAVEFORM_WIDTH)
+        return {
+            "length": int(record[0]),
+            "take_length": int(record[1]),
+            "recording": bool(record[2]),
+            "current_slice": (int(record[3]), int(record[4])),
+            "voices": record[6:6 + voices],
+            "min": columns[0],
+            "max": columns[1],
+            "take_min": columns[2],
+            "take_max": columns[3],
+            "slice_marks": columns[4],
+        }
+
     def set_envelope_decay(self, env_idx: int, decay_time: float):
         """設定特定 envelope 的 decay time"""
         if not self.running:
@@ -697,3 +786,31 @@ class AudioProcess:
             self.control_queue.put_nowait(msg)
         except:
             pass
+
+    def set_alien4_mod_route(self, source, target, depth):
+        """設定 Alien4 modulation 路由 (source: chaos / cv1-6 = ENV1-4, SEQ1-2)"""
+        if not self.running:
+            return
+        try:
+            msg = {
+                'type': 'set_alien4_mod_route',
+                'source': source,
+                'target': target,
+                'depth': depth
+            }
+            self.control_queue.put_nowait(msg)
+        except:
+            pass
+
+    def set_alien4_control_interval(self, samples):
+        """設定 Alien4 chaos/modulation control rate (samples per tick)"""
+        if not self.running:
+            return
+        try:
+            msg = {
+                'type': 'set_alien4_control_interval',
+                'samples': samples
+            }
+            self.control_queue.put_nowait(msg)
+        except:
+            pass
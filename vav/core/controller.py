@@ -972,7 +972,11 @@ class VAVController:
             )
 
             # 從 audio process 接收 CV 值用於 GUI 顯示
-            cv_from_audio = self.audio_process.get_cv_values()
+            # CV ring: 取出上次之後的所有 record (複製, view 只在下次 read 前有效),
+            # meter 的 peak hold 涵蓋整段; 沒有 ring 時 get_cv_values() 從 Queue 取
+            cv_frames = self.audio_process.get_cv_frames()
+            cv_block = np.concatenate(cv_frames) if cv_frames else None
+            cv_from_audio = cv_block[-1].copy() if cv_block is not None else self.audio_process.get_cv_values()
             if cv_from_audio is not None:
                 self.cv_values = cv_from_audio
             else:
@@ -986,7 +990,7 @@ class VAVController:
 
             # Trigger CV callback for GUI updates
             if self.cv_callback:
-                self.cv_callback(self.cv_values)
+                self.cv_callback(cv_block if cv_block is not None else self.cv_values)
 
     def _update_lfo_modulation(self):
         """更新 LFO modulation 並計算最終 angle/curve 值"""
@@ -1127,7 +1131,7 @@ class VAVController:
         self.frame_callback = callback
 
     def set_cv_callback(self, callback: Callable):
-        """Set callback for CV updates"""
+        """Set callback for CV updates: 6 values, or the (n, 6) CV ring records since the last call"""
         self.cv_callback = callback
 
     def set_cv_channel_mute(self, channel: int, muted: bool):
@@ -1371,6 +1375,12 @@ class VAVController:
         if self.audio_process:
             self.audio_process.set_alien4_recording(enabled)
 
+    def get_alien4_waveform(self):
+        """Get the latest Alien4 loop waveform overview (None when nothing new)"""
+        if self.audio_process:
+            return self.audio_process.get_alien4_waveform()
+        return None
+
     def set_alien4_delay_params(self, time_l: float = None, time_r: float = None,
                                feedback: float = None, chaos_enabled: bool = None, wet_dry: float = None):
         """Set Alien4 delay parameters"""
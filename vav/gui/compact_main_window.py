@@ -15,6 +15,7 @@ import cv2
 
 from .device_dialog import DeviceSelectionDialog
 from .cv_meter_window import CVMeterWindow
+from .loop_waveform_widget import LoopWaveformWidget
 from ..core.controller import VAVController
 
 
@@ -894,6 +895,13 @@ class CompactMainWindow(QMainWindow):
         row = self._create_control_row("POLY", self.alien4_poly_slider, self.alien4_poly_label, LABEL_WIDTH)
         col4_layout.addLayout(row)
 
+        # Loop waveform (take 錄音中為紅色, slice 起點與 playhead)
+        self.alien4_waveform = LoopWaveformWidget(COLOR_COL4, width=155, height=40)
+        col4_layout.addLayout(self._create_control_row("LOOP", self.alien4_waveform, None, LABEL_WIDTH))
+        self.alien4_waveform_timer = QTimer()
+        self.alien4_waveform_timer.timeout.connect(self._update_alien4_waveform)
+        self.alien4_waveform_timer.start(33)  # ~30 Hz, 與 audio process 送出的頻率相同
+
         # ===== COLUMN 5: Alien4 Delay+Reverb =====
 
         # Delay Time L (0.001-2.0s)
@@ -1955,6 +1963,10 @@ class CompactMainWindow(QMainWindow):
     def _on_frame(self, frame: np.ndarray):
         self.frame_updated.emit(frame)
 
+    def _update_alien4_waveform(self):
+        """Draw the latest loop overview from the audio process (called every 33ms)"""
+        self.alien4_waveform.update_overview(self.controller.get_alien4_waveform())
+
     def _on_cv(self, cv_values: np.ndarray):
         self.cv_updated.emit(cv_values)
 
@@ -2118,9 +2130,11 @@ class CompactMainWindow(QMainWindow):
             self.cv_meter_window.update_visual_preview(frame)
 
     def _update_cv_display(self, cv_values: np.ndarray):
-        """Update CV Meter Window with new CV values"""
+        """Update CV Meter Window with new CV values (6 values or an (n, 6) block)"""
         if self.cv_meter_window:
             self.cv_meter_window.update_values(cv_values)
+        if cv_values.ndim == 2:
+            cv_values = cv_values[-1]
 
         # Update Alien4 Scan and Len sliders from Seq1 (cv_values[4])
         if len(cv_values) > 4:
@@ -2170,6 +2184,7 @@ class CompactMainWindow(QMainWindow):
 
     def closeEvent(self, event):
         """Close all windows and stop controller"""
+        self.alien4_waveform_timer.stop()
         self.controller.stop()
         if self.cv_meter_window:
             self.cv_meter_window.close()
@@ -151,7 +151,7 @@ class CVMeterWindow(QMainWindow):
         self.visual_preview.customContextMenuRequested.connect(show_xy_context_menu)
 
     def update_values(self, samples: np.ndarray):
-        """更新 CV 值"""
+        """更新 CV 值 (6 個值, 或 (n, 6) 的 CV ring block)"""
         self.meter_widget.update_values(samples)
 
     def update_visual_preview(self, frame: np.ndarray):
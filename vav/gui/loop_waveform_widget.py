@@ -0,0 +1,85 @@
+"""
+Alien4 loop waveform widget - draws the loop (or the take being recorded) with slices and playheads
+"""
+
+import numpy as np
+from PyQt6.QtWidgets import QWidget
+from PyQt6.QtCore import Qt
+from PyQt6.QtGui import QPainter, QPen, QColor
+
+
+class LoopWaveformWidget(QWidget):
+    """Min/max per column from AudioProcess.get_alien4_waveform(), no audio copied"""
+
+    def __init__(self, color: str = "#FF8FA3", width: int = 235, height: int = 40):
+        super().__init__()
+        self.setFixedSize(width, height)
+        self.color = QColor(color)
+        self.take_color = QColor(255, 60, 60)
+        self.overview = None
+
+    def update_overview(self, overview: dict):
+        """
+        Update with a new overview
+
+        Args:
+            overview: dict from AudioProcess.get_alien4_waveform(), None keeps the last one
+        """
+        if overview is None:
+            return
+        self.overview = overview
+        self.update()
+
+    def clear(self):
+        """Clear the waveform"""
+        self.overview = None
+        self.update()
+
+    def paintEvent(self, event):
+        """Paint loop columns, current slice, slice marks and playheads"""
+        painter = QPainter(self)
+        width = self.width()
+        height = self.height()
+        painter.fillRect(self.rect(), Qt.GlobalColor.black)
+
+        overview = self.overview
+        if overview is None:
+            return
+
+        # 錄音中畫 take (紅色), 否則畫 loop
+        recording = overview["recording"]
+        length = overview["take_length"] if recording else overview["length"]
+        if length <= 0:
+            return
+        column_min = overview["take_min"] if recording else overview["min"]
+        column_max = overview["take_max"] if recording else overview["max"]
+        columns = len(column_min)
+        scale_x = width / columns
+        mid = height * 0.5
+
+        if not recording:
+            # Current slice 背景
+            start, end = overview["current_slice"]
+            if 0 <= start < end:
+                painter.fillRect(int(start / length * width), 0,
+                                 max(1, int((end - start) / length * width)), height,
+                                 QColor(255, 143, 163, 50))
+
+            # Slice 起點
+            painter.setPen(QPen(QColor(128, 128, 128), 1))
+            for column in np.flatnonzero(overview["slice_marks"]):
+                x = int(column * scale_x)
+                painter.drawLine(x, 0, x, height)
+
+        painter.setPen(QPen(self.take_color if recording else self.color, 1))
+        top = np.clip(mid - column_max * mid, 0, height - 1).astype(np.int32)
+        bottom = np.clip(mid - column_min * mid, 0, height - 1).astype(np.int32)
+        for column in range(columns):
+            x = int(column * scale_x)
+            painter.drawLine(x, int(top[column]), x, int(bottom[column]))
+
+        if not recording:
+            painter.setPen(QPen(QColor(255, 255, 255), 1))
+            for position in overview["voices"]:
+                x = int(position / length * width)
+                painter.drawLine(x, 0, x, height)
@@ -58,18 +58,31 @@ class MeterWidget(QWidget):
         Update meter values
 
         Args:
-            samples: Array of values (0.0-1.0) for each channel
+            samples: Array of values (0.0-1.0) for each channel, or a block of
+                     (n, channels) records (e.g. SharedRing views): the meters show
+                     the newest record, peak hold sees the whole block
         """
+        samples = np.asarray(samples)
+        if samples.ndim == 2:
+            if len(samples) == 0:
+                return
+            block_peaks = np.clip(samples.max(axis=0), 0.0, 1.0)
+            samples = samples[-1]
+        else:
+            block_peaks = None
+
         if len(samples) != self.num_channels:
             print(f"METER DEBUG: Wrong length {len(samples)} != {self.num_channels}")
             return
 
         self.values = np.clip(samples, 0.0, 1.0)
+        if block_peaks is None:
+            block_peaks = self.values
 
         # Update peak hold
         for i in range(self.num_channels):
-            if self.values[i] > self.peaks[i]:
-                self.peaks[i] = self.values[i]
+            if block_peaks[i] > self.peaks[i]:
+                self.peaks[i] = block_peaks[i]
                 self.peak_hold_frames[i] = self.peak_hold_duration
             else:
                 # Decay peak hold